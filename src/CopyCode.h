@@ -19,40 +19,58 @@ DECLARE_COPY(2, 4, 8)
 DECLARE_COPY(4, 2, 8)
 DECLARE_COPY(4, 4, 8)
 DECLARE_COPY(4, 8, 8)
+DECLARE_COPY(4, 16, 8)
 DECLARE_COPY(8, 1, 8)
 DECLARE_COPY(8, 2, 8)
 DECLARE_COPY(8, 4, 8)
 DECLARE_COPY(8, 8, 8)
 DECLARE_COPY(8, 16, 8)
+DECLARE_COPY(8, 32, 8)
 DECLARE_COPY(16, 1, 8)
 DECLARE_COPY(16, 2, 8)
 DECLARE_COPY(16, 4, 8)
 DECLARE_COPY(16, 8, 8)
 DECLARE_COPY(16, 16, 8)
 DECLARE_COPY(16, 32, 8)
+DECLARE_COPY(16, 64, 8)
+DECLARE_COPY(32, 4, 8)
 DECLARE_COPY(32, 8, 8)
 DECLARE_COPY(32, 16, 8)
 DECLARE_COPY(32, 32, 8)
+DECLARE_COPY(32, 64, 8)
+DECLARE_COPY(64, 8, 8)
+DECLARE_COPY(64, 16, 8)
+DECLARE_COPY(64, 32, 8)
+DECLARE_COPY(64, 64, 8)
 
 DECLARE_COPY(2, 2, 16)
 DECLARE_COPY(2, 4, 16)
 DECLARE_COPY(4, 2, 16)
 DECLARE_COPY(4, 4, 16)
 DECLARE_COPY(4, 8, 16)
+DECLARE_COPY(4, 16, 16)
 DECLARE_COPY(8, 1, 16)
 DECLARE_COPY(8, 2, 16)
 DECLARE_COPY(8, 4, 16)
 DECLARE_COPY(8, 8, 16)
 DECLARE_COPY(8, 16, 16)
+DECLARE_COPY(8, 32, 16)
 DECLARE_COPY(16, 1, 16)
 DECLARE_COPY(16, 2, 16)
 DECLARE_COPY(16, 4, 16)
 DECLARE_COPY(16, 8, 16)
 DECLARE_COPY(16, 16, 16)
 DECLARE_COPY(16, 32, 16)
+DECLARE_COPY(16, 64, 16)
+DECLARE_COPY(32, 4, 16)
 DECLARE_COPY(32, 8, 16)
 DECLARE_COPY(32, 16, 16)
 DECLARE_COPY(32, 32, 16)
+DECLARE_COPY(32, 64, 16)
+DECLARE_COPY(64, 8, 16)
+DECLARE_COPY(64, 16, 16)
+DECLARE_COPY(64, 32, 16)
+DECLARE_COPY(64, 64, 16)
 
 #undef DECLARE_COPY
 
@@ -21,12 +21,29 @@
 #include <cmath>
 #include <mutex>
 
+#include "CPU.h"
 #include "DCTFFTW.h"
 
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
 std::mutex g_fftw_plans_mutex;
 
 
-void dctInit(DCTFFTW *dct, int sizex, int sizey, int dctmode, int bitsPerSample) {
+// Unnormalised DCT-II, like FFTW_REDFT10: X[k] = 2 * sum(x[n] * cos(pi * k * (2 * n + 1) / (2 * size))).
+static float *dctMatrix(int size) {
+    float *matrix = (float *)fftwf_malloc(sizeof(float) * size * size);
+
+    for (int n = 0; n < size; n++)
+        for (int k = 0; k < size; k++)
+            matrix[n * size + k] = (float)(2.0 * std::cos(M_PI * k * (2 * n + 1) / (2.0 * size)));
+
+    return matrix;
+}
+
+
+void dctInit(DCTFFTW *dct, int sizex, int sizey, int dctmode, int bitsPerSample, int opt) {
     dct->sizex = sizex;
     dct->sizey = sizey;
     dct->dctmode = dctmode;
@@ -46,7 +63,22 @@ void dctInit(DCTFFTW *dct, int sizex, int sizey, int dctmode, int bitsPerSample)
     dct->fSrc = (float *)fftwf_malloc(sizeof(float) * size2d);
     dct->fSrcDCT = (float *)fftwf_malloc(sizeof(float) * size2d);
 
-    {
+    dct->dctplan = NULL;
+    dct->cosx = NULL;
+    dct->cosy = NULL;
+    dct->avx2 = 0;
+
+    if (sizex <= DCT_MAX_BUILTIN_SIZE && sizey <= DCT_MAX_BUILTIN_SIZE) {
+        dct->cosx = dctMatrix(sizex);
+        dct->cosy = dctMatrix(sizey);
+
+#if defined(MVTOOLS_X86)
+        if (opt && sizex % 8 == 0 && (cpu_detect() & X264_CPU_AVX2))
+            dct->avx2 = 1;
+#else
+        (void)opt;
+#endif
+    } else {
         std::lock_guard<std::mutex> guard(g_fftw_plans_mutex);
         dct->dctplan = fftwf_plan_r2r_2d(sizey, sizex, dct->fSrc, dct->fSrcDCT,
                                          FFTW_REDFT10, FFTW_REDFT10, FFTW_ESTIMATE); // direct fft
@@ -55,9 +87,46 @@ void dctInit(DCTFFTW *dct, int sizex, int sizey, int dctmode, int bitsPerSample)
 
 
 void dctDeinit(DCTFFTW *dct) {
-    fftwf_destroy_plan(dct->dctplan);
+    if (dct->dctplan)
+        fftwf_destroy_plan(dct->dctplan);
     fftwf_free(dct->fSrc);
     fftwf_free(dct->fSrcDCT);
+    fftwf_free(dct->cosx);
+    fftwf_free(dct->cosy);
+}
+
+
+// The built-in transform. The sums are done in the same order as in the AVX2 version,
+// so both give the same results.
+template <typename PixelType>
+static void dctRows(const DCTFFTW *dct, const uint8_t *srcp8, int src_pitch, float *rows) {
+    for (int y = 0; y < dct->sizey; y++) {
+        const PixelType *srcp = (const PixelType *)srcp8;
+
+        for (int k = 0; k < dct->sizex; k++) {
+            float sum = 0.0f;
+            for (int n = 0; n < dct->sizex; n++)
+                sum += srcp[n] * dct->cosx[n * dct->sizex + k];
+            rows[k] = sum;
+        }
+
+        srcp8 += src_pitch;
+        rows += dct->sizex;
+    }
+}
+
+
+static void dctColumns(const DCTFFTW *dct, const float *rows, float *coefs) {
+    for (int k = 0; k < dct->sizey; k++) {
+        for (int x = 0; x < dct->sizex; x++) {
+            float sum = 0.0f;
+            for (int y = 0; y < dct->sizey; y++)
+                sum += rows[y * dct->sizex + x] * dct->cosy[y * dct->sizey + k];
+            coefs[x] = sum;
+        }
+
+        coefs += dct->sizex;
+    }
 }
 
 
@@ -125,13 +194,33 @@ static void Float2Bytes(const DCTFFTW *dct, uint8_t *dstp8, int dst_pitch, float
 
 
 void dctBytes2D(DCTFFTW *dct, const uint8_t *srcp, int src_pitch, uint8_t *dctp, int dct_pitch) {
+#if defined(MVTOOLS_X86)
+    if (dct->avx2) {
+        if (dct->bitsPerSample == 8)
+            mvtools_dct_uint8_t_avx2(dct, srcp, src_pitch, dctp, dct_pitch);
+        else
+            mvtools_dct_uint16_t_avx2(dct, srcp, src_pitch, dctp, dct_pitch);
+        return;
+    }
+#endif
+
     if (dct->bitsPerSample == 8) {
-        Bytes2Float<uint8_t>(dct, srcp, src_pitch, dct->fSrc);
-        fftwf_execute_r2r(dct->dctplan, dct->fSrc, dct->fSrcDCT);
+        if (dct->dctplan) {
+            Bytes2Float<uint8_t>(dct, srcp, src_pitch, dct->fSrc);
+            fftwf_execute_r2r(dct->dctplan, dct->fSrc, dct->fSrcDCT);
+        } else {
+            dctRows<uint8_t>(dct, srcp, src_pitch, dct->fSrc);
+            dctColumns(dct, dct->fSrc, dct->fSrcDCT);
+        }
         Float2Bytes<uint8_t>(dct, dctp, dct_pitch, dct->fSrcDCT);
     } else {
-        Bytes2Float<uint16_t>(dct, srcp, src_pitch, dct->fSrc);
-        fftwf_execute_r2r(dct->dctplan, dct->fSrc, dct->fSrcDCT);
+        if (dct->dctplan) {
+            Bytes2Float<uint16_t>(dct, srcp, src_pitch, dct->fSrc);
+            fftwf_execute_r2r(dct->dctplan, dct->fSrc, dct->fSrcDCT);
+        } else {
+            dctRows<uint16_t>(dct, srcp, src_pitch, dct->fSrc);
+            dctColumns(dct, dct->fSrc, dct->fSrcDCT);
+        }
         Float2Bytes<uint16_t>(dct, dctp, dct_pitch, dct->fSrcDCT);
     }
 }
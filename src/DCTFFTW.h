@@ -28,6 +28,12 @@ extern "C" {
 
 #include <fftw3.h>
 
+// Blocks up to this size in both directions are transformed with a built-in
+// separable DCT-II, computed as two passes of matrix products in single
+// precision, like FFTW does. Bigger ones go through FFTW.
+#define DCT_MAX_BUILTIN_SIZE 32
+
+
 typedef struct DCTFFTW {
     int sizex;
     int sizey;
@@ -35,20 +41,34 @@ typedef struct DCTFFTW {
     int bitsPerSample;
 
     float *fSrc;
-    fftwf_plan dctplan;
+    fftwf_plan dctplan; // NULL with the built-in transform
     float *fSrcDCT;
 
+    // The built-in transform's matrices, transposed: cosx[n * sizex + k] is
+    // the weight of pixel n in coefficient k. NULL when FFTW is used.
+    float *cosx;
+    float *cosy;
+
     int dctshift;
     int dctshift0;
+
+    int avx2;
 } DCTFFTW;
 
 
-void dctInit(DCTFFTW *dct, int sizex, int sizey, int dctmode, int bitsPerSample);
+// opt enables the AVX2 functions, if the CPU supports them.
+void dctInit(DCTFFTW *dct, int sizex, int sizey, int dctmode, int bitsPerSample, int opt);
 
 void dctDeinit(DCTFFTW *dct);
 
 void dctBytes2D(DCTFFTW *dct, const uint8_t *srcp, int src_pitch, uint8_t *dctp, int dct_pitch);
 
+#if defined(MVTOOLS_X86)
+// From DCTFFTW_AVX2.cpp. The built-in transform, for sizex multiple of 8.
+void mvtools_dct_uint8_t_avx2(const DCTFFTW *dct, const uint8_t *srcp, int src_pitch, uint8_t *dctp, int dct_pitch);
+void mvtools_dct_uint16_t_avx2(const DCTFFTW *dct, const uint8_t *srcp, int src_pitch, uint8_t *dctp, int dct_pitch);
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,110 @@
+#if defined(MVTOOLS_X86)
+
+#include <cmath>
+
+#include <immintrin.h>
+
+#include "DCTFFTW.h"
+
+
+#ifdef _WIN32
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+
+// Eight coefficients are computed at a time, with the sums done in the same
+// order as in the C version, without FMA, so the results are the same.
+// This file is compiled with -mfma, so the compiler must be told not to fuse
+// the multiplications and additions by itself.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+
+template <typename PixelType>
+static FORCE_INLINE void storePixels(PixelType *p, __m256i pixels);
+
+template <>
+FORCE_INLINE void storePixels(uint8_t *p, __m256i pixels) {
+    __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm_storel_epi64((__m128i *)p, _mm_packus_epi16(words, words));
+}
+
+template <>
+FORCE_INLINE void storePixels(uint16_t *p, __m256i pixels) {
+    __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm_storeu_si128((__m128i *)p, words);
+}
+
+
+template <typename PixelType>
+static void dct_avx2(const DCTFFTW *dct, const uint8_t *srcp8, int src_pitch, uint8_t *dctp8, int dct_pitch) {
+    const int sizex = dct->sizex;
+    const int sizey = dct->sizey;
+
+    float *rows = dct->fSrc;
+    float *coefs = dct->fSrcDCT;
+
+    for (int y = 0; y < sizey; y++) {
+        const PixelType *srcp = (const PixelType *)(srcp8 + y * src_pitch);
+
+        for (int k = 0; k < sizex; k += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (int n = 0; n < sizex; n++)
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps((float)srcp[n]), _mm256_loadu_ps(dct->cosx + n * sizex + k)));
+            _mm256_storeu_ps(rows + y * sizex + k, sum);
+        }
+    }
+
+    for (int k = 0; k < sizey; k++) {
+        for (int x = 0; x < sizex; x += 8) {
+            __m256 sum = _mm256_setzero_ps();
+            for (int y = 0; y < sizey; y++)
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows + y * sizex + x), _mm256_set1_ps(dct->cosy[y * sizey + k])));
+            _mm256_storeu_ps(coefs + k * sizex + x, sum);
+        }
+    }
+
+    int pixelMax = (1 << dct->bitsPerSample) - 1;
+    int pixelHalf = 1 << (dct->bitsPerSample - 1);
+
+    // Like Float2Bytes: the coefficients are multiplied by 0.707, rounded to
+    // nearest even, shifted, and centred. The DC is done separately, below.
+    const __m256 factor = _mm256_set1_ps(0.707f);
+    const __m128i shift = _mm_cvtsi32_si128(dct->dctshift);
+    const __m256i half = _mm256_set1_epi32(pixelHalf);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi32(pixelMax);
+
+    PixelType *dstp = (PixelType *)dctp8;
+    dct_pitch /= sizeof(PixelType);
+
+    for (int y = 0; y < sizey; y++) {
+        for (int x = 0; x < sizex; x += 8) {
+            __m256i integ = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(coefs + y * sizex + x), factor));
+            __m256i pixels = _mm256_add_epi32(_mm256_sra_epi32(integ, shift), half);
+            pixels = _mm256_min_epi32(_mm256_max_epi32(pixels, zero), max);
+            storePixels(dstp + y * dct_pitch + x, pixels);
+        }
+    }
+
+    int integ = (int)(nearbyintf(coefs[0] * 0.5f));
+    int dc = (integ >> dct->dctshift0) + pixelHalf;
+    dstp[0] = dc < 0 ? 0 : (dc > pixelMax ? pixelMax : dc);
+}
+
+
+void mvtools_dct_uint8_t_avx2(const DCTFFTW *dct, const uint8_t *srcp, int src_pitch, uint8_t *dctp, int dct_pitch) {
+    dct_avx2<uint8_t>(dct, srcp, src_pitch, dctp, dct_pitch);
+}
+
+
+void mvtools_dct_uint16_t_avx2(const DCTFFTW *dct, const uint8_t *srcp, int src_pitch, uint8_t *dctp, int dct_pitch) {
+    dct_avx2<uint16_t>(dct, srcp, src_pitch, dctp, dct_pitch);
+}
+
+#endif // MVTOOLS_X86
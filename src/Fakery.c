@@ -5,15 +5,6 @@
 #include "Fakery.h"
 
 
-// FakeBlockData
-
-void fbdUpdate(FakeBlockData *fbd, const int *array) {
-    fbd->vector.x = array[0];
-    fbd->vector.y = array[1];
-    fbd->vector.sad = array[2];
-}
-
-
 // FakePlaneOfBlocks
 
 void fpobInit(FakePlaneOfBlocks *fpob, int sizeX, int sizeY, int lv, int pel, int nOverlapX, int nOverlapY, int nBlkX, int nBlkY) {
@@ -32,45 +23,30 @@ void fpobInit(FakePlaneOfBlocks *fpob, int sizeX, int sizeY, int lv, int pel, in
     fpob->nLogScale = lv;
     fpob->nScale = iexp2(fpob->nLogScale);
 
-    fpob->blocks = (FakeBlockData *)malloc(fpob->nBlkCount * sizeof(FakeBlockData));
-
-    for (int j = 0, blkIdx = 0; j < fpob->nBlkY; j++) {
-        for (int i = 0; i < fpob->nBlkX; i++, blkIdx++) {
-            fpob->blocks[blkIdx].x = i * (fpob->nBlkSizeX - fpob->nOverlapX);
-            fpob->blocks[blkIdx].y = j * (fpob->nBlkSizeY - fpob->nOverlapY);
-        }
-    }
+    fpob->vectors = NULL;
 }
 
 
 void fpobDeinit(FakePlaneOfBlocks *fpob) {
-    free(fpob->blocks);
+    fpob->vectors = NULL;
 }
 
 
 void fpobUpdate(FakePlaneOfBlocks *fpob, const int *array) {
-    array += 0;
-    for (int i = 0; i < fpob->nBlkCount; i++) {
-        fbdUpdate(&fpob->blocks[i], array);
-        array += N_PER_BLOCK;
-    }
+    // The blocks are stored as N_PER_BLOCK ints, which is exactly a VECTOR.
+    fpob->vectors = (const VECTOR *)array;
 }
 
 
 int fpobIsSceneChange(const FakePlaneOfBlocks *fpob, int nTh1, int nTh2) {
     int sum = 0;
     for (int i = 0; i < fpob->nBlkCount; i++)
-        sum += (fpob->blocks[i].vector.sad > nTh1) ? 1 : 0;
+        sum += (fpob->vectors[i].sad > nTh1) ? 1 : 0;
 
     return (sum > nTh2);
 }
 
 
-const FakeBlockData *fpobGetBlock(const FakePlaneOfBlocks *fpob, int i) {
-    return &fpob->blocks[i];
-}
-
-
 // FakeGroupOfPlanes
 
 void fgopInit(FakeGroupOfPlanes *fgop, const MVAnalysisData *ad) {
@@ -142,16 +118,6 @@ int fgopIsValid(const FakeGroupOfPlanes *fgop) {
 }
 
 
-const FakePlaneOfBlocks *fgopGetPlane(const FakeGroupOfPlanes *fgop, int i) {
-    return fgop->planes[i];
-}
-
-
-const FakeBlockData *fgopGetBlock(const FakeGroupOfPlanes *fgop, int nLevel, int nBlk) {
-    return fpobGetBlock(fgopGetPlane(fgop, nLevel), nBlk);
-}
-
-
 int fgopIsUsable(const FakeGroupOfPlanes *fgop, int thscd1, int thscd2) {
     return !fgopIsSceneChange(fgop, thscd1, thscd2) && fgopIsValid(fgop);
 }
@@ -9,13 +9,6 @@ extern "C" {
 #include "MVAnalysisData.h"
 
 
-typedef struct FakeBlockData {
-    int x;
-    int y;
-    VECTOR vector;
-} FakeBlockData;
-
-
 typedef struct FakePlaneOfBlocks {
     int nWidth_Bi;
     int nHeight_Bi;
@@ -31,7 +24,7 @@ typedef struct FakePlaneOfBlocks {
     int nOverlapX;
     int nOverlapY;
 
-    FakeBlockData *blocks;
+    const VECTOR *vectors; // points into the MVTools_vectors array passed to fgopUpdate, not a copy
 } FakePlaneOfBlocks;
 
 
@@ -45,11 +38,6 @@ typedef struct FakeGroupOfPlanes {
 } FakeGroupOfPlanes;
 
 
-// FakeBlockData
-
-void fbdUpdate(FakeBlockData *fbd, const int *array);
-
-
 // FakePlaneOfBlocks
 
 void fpobInit(FakePlaneOfBlocks *fpob, int sizeX, int sizeY, int lv, int pel, int nOverlapX, int nOverlapY, int nBlkX, int nBlkY);
@@ -60,7 +48,17 @@ void fpobUpdate(FakePlaneOfBlocks *fpob, const int *array);
 
 int fpobIsSceneChange(const FakePlaneOfBlocks *fpob, int nTh1, int nTh2);
 
-const FakeBlockData *fpobGetBlock(const FakePlaneOfBlocks *fpob, int i);
+static inline const VECTOR *fpobGetVector(const FakePlaneOfBlocks *fpob, int i) {
+    return &fpob->vectors[i];
+}
+
+static inline int fpobGetBlockX(const FakePlaneOfBlocks *fpob, int i) {
+    return (i % fpob->nBlkX) * (fpob->nBlkSizeX - fpob->nOverlapX);
+}
+
+static inline int fpobGetBlockY(const FakePlaneOfBlocks *fpob, int i) {
+    return (i / fpob->nBlkX) * (fpob->nBlkSizeY - fpob->nOverlapY);
+}
 
 
 // FakeGroupOfPlanes
@@ -69,15 +67,28 @@ void fgopInit(FakeGroupOfPlanes *fgop, const MVAnalysisData *ad);
 
 void fgopDeinit(FakeGroupOfPlanes *fgop);
 
+// The array is not copied. It must stay alive until fgopDeinit.
 void fgopUpdate(FakeGroupOfPlanes *fgop, const int *array);
 
 int fgopIsSceneChange(const FakeGroupOfPlanes *fgop, int nThSCD1, int nThSCD2);
 
 int fgopIsValid(const FakeGroupOfPlanes *fgop);
 
-const FakePlaneOfBlocks *fgopGetPlane(const FakeGroupOfPlanes *fgop, int i);
+static inline const FakePlaneOfBlocks *fgopGetPlane(const FakeGroupOfPlanes *fgop, int i) {
+    return fgop->planes[i];
+}
+
+static inline const VECTOR *fgopGetVector(const FakeGroupOfPlanes *fgop, int nLevel, int nBlk) {
+    return fpobGetVector(fgop->planes[nLevel], nBlk);
+}
+
+static inline int fgopGetBlockX(const FakeGroupOfPlanes *fgop, int nLevel, int nBlk) {
+    return fpobGetBlockX(fgop->planes[nLevel], nBlk);
+}
 
-const FakeBlockData *fgopGetBlock(const FakeGroupOfPlanes *fgop, int nLevel, int nBlk);
+static inline int fgopGetBlockY(const FakeGroupOfPlanes *fgop, int nLevel, int nBlk) {
+    return fpobGetBlockY(fgop->planes[nLevel], nBlk);
+}
 
 int fgopIsUsable(const FakeGroupOfPlanes *fgop, int thscd1, int thscd2);
 
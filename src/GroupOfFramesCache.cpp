@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "GroupOfFramesCache.h"
+
+
+// Descriptors nobody is using. Enough for the frames around the ones
+// being processed by a few filters with a temporal radius.
+#define MAX_UNUSED_DESCRIPTORS 64
+
+// Those with interpolated subplanes are as big as the super frames.
+#define MAX_UNUSED_LAZY_DESCRIPTORS 8
+
+
+namespace {
+
+enum KeyParameters {
+    KeyPitchY,
+    KeyPitchU,
+    KeyPitchV,
+    KeyLevelCount,
+    KeyWidth,
+    KeyHeight,
+    KeyPel,
+    KeyHPad,
+    KeyVPad,
+    KeyMode,
+    KeyIsse,
+    KeyXRatioUV,
+    KeyYRatioUV,
+    KeyBitsPerSample,
+    KeyLazy,
+    KeySharp,
+    KeyParameterCount
+};
+
+
+struct Key {
+    const uint8_t *planes[3];
+    int64_t serial;
+    int parameters[KeyParameterCount];
+
+    bool operator<(const Key &other) const {
+        for (int i = 0; i < 3; i++)
+            if (planes[i] != other.planes[i])
+                return std::less<const uint8_t *>()(planes[i], other.planes[i]);
+
+        if (serial != other.serial)
+            return serial < other.serial;
+
+        return std::lexicographical_compare(parameters, parameters + KeyParameterCount, other.parameters, other.parameters + KeyParameterCount);
+    }
+};
+
+
+// gof must stay the first member, because gofcRelease gets the entry from it.
+struct Entry {
+    MVGroupOfFrames gof;
+    Key key;
+    int references;
+    uint64_t lastUsed;
+};
+
+
+struct Cache {
+    std::mutex lock;
+    std::map<Key, Entry *> entries;
+    int unused[2] = { 0, 0 }; // indexed by lazy
+    uint64_t clock = 0;
+
+    ~Cache() {
+        for (auto it = entries.begin(); it != entries.end(); it++) {
+            mvgofDeinit(&it->second->gof);
+            delete it->second;
+        }
+    }
+
+    void evictOldest(int lazy) {
+        auto oldest = entries.end();
+
+        for (auto it = entries.begin(); it != entries.end(); it++)
+            if (!it->second->references && it->first.parameters[KeyLazy] == lazy &&
+                (oldest == entries.end() || it->second->lastUsed < oldest->second->lastUsed))
+                oldest = it;
+
+        evict(oldest);
+    }
+
+    void evict(std::map<Key, Entry *>::iterator it) {
+        unused[it->first.parameters[KeyLazy]]--;
+        mvgofDeinit(&it->second->gof);
+        delete it->second;
+        entries.erase(it);
+    }
+
+    void use(Entry *entry) {
+        if (!entry->references++)
+            unused[entry->key.parameters[KeyLazy]]--;
+    }
+};
+
+Cache cache;
+
+std::atomic<int64_t> lastSerial(0);
+
+} // namespace
+
+
+MVGroupOfFrames *gofcAcquire(const uint8_t **pSrc, const int *pitch, int nLevelCount, int nWidth, int nHeight, int nPel, int nHPad, int nVPad, int nMode, int isse, int xRatioUV, int yRatioUV, int bitsPerSample, int lazy, int sharp, int64_t serial) {
+    lazy = !!lazy;
+
+    Key key;
+    key.serial = lazy ? serial : 0;
+    for (int i = 0; i < 3; i++) {
+        key.planes[i] = pSrc[i];
+        key.parameters[KeyPitchY + i] = pSrc[i] ? pitch[i] : 0;
+    }
+    key.parameters[KeyLevelCount] = nLevelCount;
+    key.parameters[KeyWidth] = nWidth;
+    key.parameters[KeyHeight] = nHeight;
+    key.parameters[KeyPel] = nPel;
+    key.parameters[KeyHPad] = nHPad;
+    key.parameters[KeyVPad] = nVPad;
+    key.parameters[KeyMode] = nMode;
+    key.parameters[KeyIsse] = isse;
+    key.parameters[KeyXRatioUV] = xRatioUV;
+    key.parameters[KeyYRatioUV] = yRatioUV;
+    key.parameters[KeyBitsPerSample] = bitsPerSample;
+    key.parameters[KeyLazy] = lazy;
+    key.parameters[KeySharp] = lazy ? sharp : 0;
+
+    {
+        std::lock_guard<std::mutex> guard(cache.lock);
+
+        auto it = cache.entries.find(key);
+        if (it != cache.entries.end()) {
+            cache.use(it->second);
+            return &it->second->gof;
+        }
+    }
+
+    // Built outside the lock, because the interpolation can take a while.
+    // If another thread builds the same one in the meantime, theirs is used.
+    Entry *entry = new Entry;
+    entry->key = key;
+    entry->references = 1;
+    entry->lastUsed = 0;
+
+    mvgofInit(&entry->gof, nLevelCount, nWidth, nHeight, nPel, nHPad, nVPad, nMode, isse, xRatioUV, yRatioUV, bitsPerSample);
+    if (lazy)
+        mvgofUpdateLazy(&entry->gof, (uint8_t **)key.planes, key.parameters + KeyPitchY, sharp);
+    else
+        mvgofUpdate(&entry->gof, (uint8_t **)key.planes, key.parameters + KeyPitchY);
+
+    std::lock_guard<std::mutex> guard(cache.lock);
+
+    auto inserted = cache.entries.insert(std::make_pair(key, entry));
+    if (!inserted.second) {
+        mvgofDeinit(&entry->gof);
+        delete entry;
+
+        entry = inserted.first->second;
+        cache.use(entry);
+    }
+
+    return &entry->gof;
+}
+
+
+void gofcRelease(MVGroupOfFrames *mvgof) {
+    if (!mvgof)
+        return;
+
+    Entry *entry = reinterpret_cast<Entry *>(mvgof);
+
+    std::lock_guard<std::mutex> guard(cache.lock);
+
+    if (--entry->references)
+        return;
+
+    int lazy = entry->key.parameters[KeyLazy];
+
+    entry->lastUsed = ++cache.clock;
+    cache.unused[lazy]++;
+
+    // Without a serial number, its frame's address could be reused by a frame with different contents.
+    if (lazy && !entry->key.serial)
+        cache.evict(cache.entries.find(entry->key));
+    else if (cache.unused[lazy] > (lazy ? MAX_UNUSED_LAZY_DESCRIPTORS : MAX_UNUSED_DESCRIPTORS))
+        cache.evictOldest(lazy);
+}
+
+
+int64_t gofcNewSerial(void) {
+    return ++lastSerial;
+}
@@ -0,0 +1,43 @@
+#ifndef MVTOOLS_GROUPOFFRAMESCACHE_H
+#define MVTOOLS_GROUPOFFRAMESCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "MVFrame.h"
+
+
+// MVGroupOfFrames descriptors of super frames, shared by all the filters
+// looking at the same super frame, so that Analyse, Degrain, Compensate,
+// etc. don't each build their own for every reference of every frame.
+//
+// A descriptor only contains pointers into the super frame, which depend on
+// nothing but the frame's plane pointers, its pitches, and the super clip's
+// geometry. These are the key, so a descriptor stays correct even if its
+// frame was freed and another one was allocated at the same address.
+// Descriptors nobody uses are kept around for a while, then destroyed.
+//
+// Super frames made with lazy=True only contain the pel 1 planes, so their
+// descriptors also contain the interpolated subplanes. Those depend on the
+// frame's contents, so Super gives each frame a serial number, which is
+// added to the key. Without one, the descriptor is destroyed as soon as it
+// is released.
+
+// Returns a descriptor already updated with the super frame's planes.
+// It must not be modified, because other threads may be using it.
+// sharp and serial are only used when lazy is not 0.
+MVGroupOfFrames *gofcAcquire(const uint8_t **pSrc, const int *pitch, int nLevelCount, int nWidth, int nHeight, int nPel, int nHPad, int nVPad, int nMode, int isse, int xRatioUV, int yRatioUV, int bitsPerSample, int lazy, int sharp, int64_t serial);
+
+void gofcRelease(MVGroupOfFrames *mvgof);
+
+// For Super to number its frames. Never returns 0.
+int64_t gofcNewSerial(void);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MVTOOLS_GROUPOFFRAMESCACHE_H
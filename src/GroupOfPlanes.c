@@ -20,7 +20,7 @@
 #include "GroupOfPlanes.h"
 
 
-void gopInit(GroupOfPlanes *gop, int nBlkSizeX, int nBlkSizeY, int nLevelCount, int nPel, int nMotionFlags, int nCPUFlags, int nOverlapX, int nOverlapY, int nBlkX, int nBlkY, int xRatioUV, int yRatioUV, int divideExtra, int bitsPerSample) {
+void gopInit(GroupOfPlanes *gop, int nBlkSizeX, int nBlkSizeY, int nLevelCount, int nPel, int nMotionFlags, int nCPUFlags, int nOverlapX, int nOverlapY, int nBlkX, int nBlkY, int xRatioUV, int yRatioUV, int divideExtra, int bitsPerSample, int nThreads) {
     gop->nBlkSizeX = nBlkSizeX;
     gop->nBlkSizeY = nBlkSizeY;
     gop->nLevelCount = nLevelCount;
@@ -33,6 +33,7 @@ void gopInit(GroupOfPlanes *gop, int nBlkSizeX, int nBlkSizeY, int nLevelCount,
     gop->yRatioUV = yRatioUV;
     gop->divideExtra = divideExtra;
     gop->bitsPerSample = bitsPerSample;
+    gop->nThreads = nThreads;
 
     gop->planes = (PlaneOfBlocks **)malloc(gop->nLevelCount * sizeof(PlaneOfBlocks *));
 
@@ -52,7 +53,7 @@ void gopInit(GroupOfPlanes *gop, int nBlkSizeX, int nBlkSizeY, int nLevelCount,
         nBlkYCurrent = ((nHeight_B >> i) - gop->nOverlapY) / (gop->nBlkSizeY - gop->nOverlapY);
 
         gop->planes[i] = (PlaneOfBlocks *)malloc(sizeof(PlaneOfBlocks));
-        pobInit(gop->planes[i], nBlkXCurrent, nBlkYCurrent, gop->nBlkSizeX, gop->nBlkSizeY, nPelCurrent, i, nMotionFlagsCurrent, gop->nCPUFlags, gop->nOverlapX, gop->nOverlapY, gop->xRatioUV, gop->yRatioUV, gop->bitsPerSample);
+        pobInit(gop->planes[i], nBlkXCurrent, nBlkYCurrent, gop->nBlkSizeX, gop->nBlkSizeY, nPelCurrent, i, nMotionFlagsCurrent, gop->nCPUFlags, gop->nOverlapX, gop->nOverlapY, gop->xRatioUV, gop->yRatioUV, gop->bitsPerSample, gop->nThreads);
         nPelCurrent = 1;
     }
 }
@@ -68,12 +69,50 @@ void gopDeinit(GroupOfPlanes *gop) {
 }
 
 
+void gopSetWavefrontPool(GroupOfPlanes *gop, WavefrontPool *pool) {
+    for (int i = 0; i < gop->nLevelCount; i++)
+        gop->planes[i]->wavefrontPool = pool;
+}
+
+
+// Lowers the search parameters of the plane below coarser, which was just
+// searched. When its vectors barely differ from the global motion and no block
+// needed the wide search, the predictors are almost right, so the radius drops
+// to the plane's pel, the exhaustive search of the coarse planes is replaced
+// with the finest level's search, and the wide search is skipped. When they differ a little
+// more, both are halved. Frames with more motion keep the parameters passed.
+static void gopAdaptSearch(PlaneOfBlocks *coarser, const VECTOR *globalMV, int nPel, int64_t badSAD,
+                           SearchType fineSearchType, SearchType *searchType, int *nSearchParam, int *badrange) {
+    VECTOR estimate;
+    if (!globalMV) {
+        estimate = zeroMV;
+        pobEstimateGlobalMVDoubled(coarser, &estimate);
+        globalMV = &estimate;
+    }
+
+    int spread = pobGetVectorSpread(coarser, globalMV);
+    int64_t meanSAD = coarser->planeSAD / coarser->nBlkCount;
+    int minSearchParam = *nSearchParam < nPel ? *nSearchParam : nPel;
+
+    if (spread <= 16 && coarser->badcount == 0 && meanSAD * 4 <= badSAD) { // under a pixel
+        if (*searchType == SearchExhaustive)
+            *searchType = fineSearchType;
+        *nSearchParam = minSearchParam;
+        *badrange = 0;
+    } else if (spread <= 64 && coarser->badcount * 16 <= coarser->nBlkCount && meanSAD * 2 <= badSAD) { // under 4 pixels
+        *nSearchParam = (*nSearchParam + 1) / 2 > minSearchParam ? (*nSearchParam + 1) / 2 : minSearchParam;
+        *badrange /= 2;
+    }
+}
+
+
 void gopSearchMVs(GroupOfPlanes *gop, MVGroupOfFrames *pSrcGOF, MVGroupOfFrames *pRefGOF,
                   SearchType searchType, int nSearchParam, int nPelSearch, int nLambda,
                   int lsad, int pnew, int plevel, int global,
                   int *out, int fieldShift, DCTFFTW *DCT,
                   int pzero, int pglobal, int64_t badSAD, int badrange, int meander, int tryMany,
-                  SearchType coarseSearchType) {
+                  SearchType coarseSearchType, int adaptive, const int *seed, int seedScale,
+                  const VECTOR *temporal, int temporalScale) {
     int i;
 
     // write group's size
@@ -94,35 +133,61 @@ void gopSearchMVs(GroupOfPlanes *gop, MVGroupOfFrames *pSrcGOF, MVGroupOfFrames
     if (!global)
         pglobal = pzero;
 
-    int meanLumaChange = 0;
+    int meanLumaChange = 0; // stays 0 when the smallest plane is seeded
 
-    // Search the motion vectors, for the low details interpolations first
-    SearchType searchTypeSmallest = (gop->nLevelCount == 1 || searchType == SearchHorizontal || searchType == SearchVertical) ? searchType : coarseSearchType; // full search for smallest coarse plane
-    int nSearchParamSmallest = (gop->nLevelCount == 1) ? nPelSearch : nSearchParam;
-    int tryManyLevel = tryMany && gop->nLevelCount > 1;
-    pobSearchMVs(gop->planes[gop->nLevelCount - 1],
-                 pSrcGOF->frames[gop->nLevelCount - 1],
-                 pRefGOF->frames[gop->nLevelCount - 1],
-                 searchTypeSmallest, nSearchParamSmallest, nLambda, lsad, pnew, plevel,
-                 out, &globalMV, fieldShiftCur, DCT, &meanLumaChange,
-                 pzero, pglobal, badSAD, badrange, meander, tryManyLevel);
-    // Refining the search until we reach the highest detail interpolation.
+    gop->planes[0]->temporal = temporal;
+    gop->planes[0]->temporalScale = temporalScale;
 
-    out += pobGetArraySize(gop->planes[gop->nLevelCount - 1], gop->divideExtra);
+    int tryManyLevel;
+    int adaptLevel; // the coarser level was searched, not seeded
+
+    if (seed && gop->nLevelCount > 2) {
+        seed += 2;
+
+        for (i = gop->nLevelCount - 1; i >= 2; i--) {
+            pobSeedMVs(gop->planes[i], seed, seedScale, out);
+            seed += pobGetArraySize(gop->planes[i], gop->divideExtra);
+            out += pobGetArraySize(gop->planes[i], gop->divideExtra);
+        }
 
-    for (i = gop->nLevelCount - 2; i >= 0; i--) {
+        i = 1;
+        adaptLevel = 0;
+    } else {
+        // Search the motion vectors, for the low details interpolations first
+        SearchType searchTypeSmallest = (gop->nLevelCount == 1 || searchType == SearchHorizontal || searchType == SearchVertical) ? searchType : coarseSearchType; // full search for smallest coarse plane
+        int nSearchParamSmallest = (gop->nLevelCount == 1) ? nPelSearch : nSearchParam;
+        tryManyLevel = tryMany && gop->nLevelCount > 1;
+        pobSearchMVs(gop->planes[gop->nLevelCount - 1],
+                     pSrcGOF->frames[gop->nLevelCount - 1],
+                     pRefGOF->frames[gop->nLevelCount - 1],
+                     searchTypeSmallest, nSearchParamSmallest, nLambda, lsad, pnew, plevel,
+                     out, &globalMV, fieldShiftCur, DCT, &meanLumaChange,
+                     pzero, pglobal, badSAD, badrange, meander, tryManyLevel);
+
+        out += pobGetArraySize(gop->planes[gop->nLevelCount - 1], gop->divideExtra);
+
+        i = gop->nLevelCount - 2;
+        adaptLevel = adaptive;
+    }
+
+    // Refining the search until we reach the highest detail interpolation.
+    for (; i >= 0; i--) {
         SearchType searchTypeLevel = (i == 0 || searchType == SearchHorizontal || searchType == SearchVertical) ? searchType : coarseSearchType; // full search for coarse planes
         int nSearchParamLevel = (i == 0) ? nPelSearch : nSearchParam;                                                            // special case for finest level
+        int badrangeLevel = badrange;
         if (global) {
             pobEstimateGlobalMVDoubled(gop->planes[i + 1], &globalMV); // get updated global MV (doubled)
         }
+        if (adaptLevel)
+            gopAdaptSearch(gop->planes[i + 1], global ? &globalMV : NULL, gop->planes[i]->nPel, badSAD, searchType, &searchTypeLevel, &nSearchParamLevel, &badrangeLevel);
+        adaptLevel = adaptive;
         pobInterpolatePrediction(gop->planes[i], gop->planes[i + 1]);
         fieldShiftCur = (i == 0) ? fieldShift : 0; // may be non zero for finest level only
         tryManyLevel = tryMany && i > 0;           // not for finest level to not decrease speed
         pobSearchMVs(gop->planes[i], pSrcGOF->frames[i], pRefGOF->frames[i],
                      searchTypeLevel, nSearchParamLevel, nLambda, lsad, pnew, plevel,
                      out, &globalMV, fieldShiftCur, DCT, &meanLumaChange,
-                     pzero, pglobal, badSAD, badrange, meander, tryManyLevel);
+                     pzero, pglobal, badSAD, badrangeLevel, meander, tryManyLevel);
         out += pobGetArraySize(gop->planes[i], gop->divideExtra);
     }
 }
@@ -150,6 +215,14 @@ void gopRecalculateMVs(GroupOfPlanes *gop, FakeGroupOfPlanes *fgop, MVGroupOfFra
 }
 
 
+void gopGetDCTCacheStats(const GroupOfPlanes *gop, int64_t *lookups, int64_t *hits) {
+    for (int i = 0; i < gop->nLevelCount; i++) {
+        lookups[i] += gop->planes[i]->dctCacheLookups;
+        hits[i] += gop->planes[i]->dctCacheHits;
+    }
+}
+
+
 void gopWriteDefaultToArray(GroupOfPlanes *gop, int *array) {
     // write group's size
     array[0] = gopGetArraySize(gop);
@@ -41,19 +41,41 @@ typedef struct GroupOfPlanes {
     int yRatioUV;
     int divideExtra;
     int bitsPerSample;
+    int nThreads;
 
     PlaneOfBlocks **planes;
 } GroupOfPlanes;
 
 
-void gopInit(GroupOfPlanes *gop, int nBlkSizeX, int nBlkSizeY, int nLevelCount, int nPel, int nMotionFlags, int nCPUFlags, int nOverlapX, int nOverlapY, int nBlkX, int nBlkY, int xRatioUV, int yRatioUV, int divideExtra, int bitsPerSample);
+void gopInit(GroupOfPlanes *gop, int nBlkSizeX, int nBlkSizeY, int nLevelCount, int nPel, int nMotionFlags, int nCPUFlags, int nOverlapX, int nOverlapY, int nBlkX, int nBlkY, int xRatioUV, int yRatioUV, int divideExtra, int bitsPerSample, int nThreads);
 
 void gopDeinit(GroupOfPlanes *gop);
 
-void gopSearchMVs(GroupOfPlanes *gop, MVGroupOfFrames *pSrcGOF, MVGroupOfFrames *pRefGOF, SearchType searchType, int nSearchParam, int nPelSearch, int nLambda, int lsad, int pnew, int plevel, int global, int *out, int fieldShift, DCTFFTW *DCT, int pzero, int pglobal, int64_t badSAD, int badrange, int meander, int tryMany, SearchType coarseSearchType);
+// Gives the planes the threads to search with when nThreads > 1. The pool
+// must have at least nThreads threads and outlive the GroupOfPlanes.
+void gopSetWavefrontPool(GroupOfPlanes *gop, WavefrontPool *pool);
+
+// With dct != 0, DCT must point to nThreads transforms, one for each worker.
+// If seed is not NULL, it must be the output of another search with the same
+// GroupOfPlanes. Its coarse levels, multiplied by seedScale, are used instead of
+// searching them again, and only the two finest levels are searched.
+// If temporal is not NULL, it must contain one vector for each block of the
+// finest level, which are multiplied by temporalScale and checked as an
+// extra predictor at that level.
+// If adaptive is not 0, nSearchParam, nPelSearch, badrange, and
+// coarseSearchType are the most each level may use, and they are lowered for
+// the levels below a coarser one whose vectors are close to the global motion
+// and matched well.
+void gopSearchMVs(GroupOfPlanes *gop, MVGroupOfFrames *pSrcGOF, MVGroupOfFrames *pRefGOF, SearchType searchType, int nSearchParam, int nPelSearch, int nLambda, int lsad, int pnew, int plevel, int global, int *out, int fieldShift, DCTFFTW *DCT, int pzero, int pglobal, int64_t badSAD, int badrange, int meander, int tryMany, SearchType coarseSearchType, int adaptive, const int *seed, int seedScale, const VECTOR *temporal, int temporalScale);
 
 void gopRecalculateMVs(GroupOfPlanes *gop, FakeGroupOfPlanes *fgop, MVGroupOfFrames *pSrcGOF, MVGroupOfFrames *pRefGOF, SearchType searchType, int nSearchParam, int nLambda, int pnew, int *out, int fieldShift, int thSAD, DCTFFTW *DCT, int smooth, int meander);
 
+// Adds to lookups and hits, which have one element per level, the number of
+// reference blocks whose transform was needed at each level during the last
+// search, and how many of them were already cached. They stay 0 in the dct
+// modes which don't transform the reference blocks.
+void gopGetDCTCacheStats(const GroupOfPlanes *gop, int64_t *lookups, int64_t *hits);
+
 void gopWriteDefaultToArray(GroupOfPlanes *gop, int *array);
 
 int gopGetArraySize(GroupOfPlanes *gop);
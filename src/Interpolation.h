@@ -70,6 +70,31 @@ void mvtools_VerticalWiener_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nP
 void mvtools_HorizontalWiener_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
                                    intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
 
+// From Interpolation_SSE2.c
+void mvtools_Average2_u16_sse2(uint8_t *pDst, const uint8_t *pSrc1, const uint8_t *pSrc2, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight);
+
+void mvtools_VerticalBilinear_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                       intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+void mvtools_HorizontalBilinear_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                         intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+void mvtools_DiagonalBilinear_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                       intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+
+void mvtools_RB2CubicHorizontalInplaceLine_u16_sse2(uint8_t *pSrc, intptr_t nWidthMMX);
+void mvtools_RB2CubicVerticalLine_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nSrcPitch, intptr_t nWidthMMX);
+void mvtools_RB2QuadraticHorizontalInplaceLine_u16_sse2(uint8_t *pSrc, intptr_t nWidthMMX);
+void mvtools_RB2QuadraticVerticalLine_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nSrcPitch, intptr_t nWidthMMX);
+void mvtools_RB2BilinearFilteredVerticalLine_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nSrcPitch, intptr_t nWidthMMX);
+void mvtools_RB2BilinearFilteredHorizontalInplaceLine_u16_sse2(uint8_t *pSrc, intptr_t nWidthMMX);
+void mvtools_VerticalWiener_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                     intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+void mvtools_HorizontalWiener_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                       intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+void mvtools_VerticalBicubic_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                      intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+void mvtools_HorizontalBicubic_u16_sse2(uint8_t *pDst, const uint8_t *pSrc, intptr_t nPitch,
+                                        intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample);
+
 #endif // MVTOOLS_X86
 
 
@@ -281,7 +306,10 @@ RB2Filtered(uint16_t)
 
 #if defined(MVTOOLS_X86)
 #define RB2BilinearFilteredVertical_SIMD \
-    mvtools_RB2BilinearFilteredVerticalLine_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch, nWidthMMX); \
+    if (sizeof(*pSrc) == 1) \
+        mvtools_RB2BilinearFilteredVerticalLine_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch, nWidthMMX); \
+    else \
+        mvtools_RB2BilinearFilteredVerticalLine_u16_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch * sizeof(*pSrc), nWidthMMX); \
     xstart = nWidthMMX;
 #else
 #define RB2BilinearFilteredVertical_SIMD
@@ -311,7 +339,7 @@ static void RB2BilinearFilteredVertical_##PixelType(uint8_t *pDst8, const uint8_
     for (int y = 1; y < nHeight - 1; y++) { \
         int xstart = 0; \
  \
-        if (sizeof(PixelType) == 1 && isse && nWidthMMX >= 8) { \
+        if (isse && nWidthMMX >= 8) { \
             RB2BilinearFilteredVertical_SIMD \
         } \
         for (int x = xstart; x < nWidth; x++) \
@@ -334,7 +362,10 @@ RB2BilinearFilteredVertical(uint16_t)
 
 #if defined(MVTOOLS_X86)
 #define RB2BilinearFilteredHorizontalInplace_SIMD \
-    mvtools_RB2BilinearFilteredHorizontalInplaceLine_sse2((uint8_t *)pSrc, nWidthMMX); /* very first is skipped */ \
+    if (sizeof(*pSrc) == 1) \
+        mvtools_RB2BilinearFilteredHorizontalInplaceLine_sse2((uint8_t *)pSrc, nWidthMMX); /* very first is skipped */ \
+    else \
+        mvtools_RB2BilinearFilteredHorizontalInplaceLine_u16_sse2((uint8_t *)pSrc, nWidthMMX); \
     xstart = nWidthMMX;
 #else
 #define RB2BilinearFilteredHorizontalInplace_SIMD
@@ -357,7 +388,7 @@ static void RB2BilinearFilteredHorizontalInplace_##PixelType(uint8_t *pSrc8, int
  \
         int xstart = 1; \
  \
-        if (sizeof(PixelType) == 1 && isse) { \
+        if (isse) { \
             RB2BilinearFilteredHorizontalInplace_SIMD \
         } \
         for (x = xstart; x < nWidth - 1; x++) \
@@ -391,7 +422,10 @@ RB2BilinearFiltered(uint16_t)
 
 #if defined(MVTOOLS_X86)
 #define RB2QuadraticVertical_SIMD \
-    mvtools_RB2QuadraticVerticalLine_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch, nWidthMMX); \
+    if (sizeof(*pSrc) == 1) \
+        mvtools_RB2QuadraticVerticalLine_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch, nWidthMMX); \
+    else \
+        mvtools_RB2QuadraticVerticalLine_u16_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch * sizeof(*pSrc), nWidthMMX); \
     xstart = nWidthMMX;
 #else
 #define RB2QuadraticVertical_SIMD
@@ -420,7 +454,7 @@ static void RB2QuadraticVertical_##PixelType(uint8_t *pDst8, const uint8_t *pSrc
     for (int y = 1; y < nHeight - 1; y++) { \
         int xstart = 0; \
  \
-        if (sizeof(PixelType) == 1 && isse && nWidthMMX >= 8) { \
+        if (isse && nWidthMMX >= 8) { \
             RB2QuadraticVertical_SIMD \
         } \
  \
@@ -445,7 +479,10 @@ RB2QuadraticVertical(uint16_t)
 
 #if defined(MVTOOLS_X86)
 #define RB2QuadraticHorizontalInplace_SIMD \
-    mvtools_RB2QuadraticHorizontalInplaceLine_sse2((uint8_t *)pSrc, nWidthMMX); \
+    if (sizeof(*pSrc) == 1) \
+        mvtools_RB2QuadraticHorizontalInplaceLine_sse2((uint8_t *)pSrc, nWidthMMX); \
+    else \
+        mvtools_RB2QuadraticHorizontalInplaceLine_u16_sse2((uint8_t *)pSrc, nWidthMMX); \
     xstart = nWidthMMX;
 #else
 #define RB2QuadraticHorizontalInplace_SIMD
@@ -467,7 +504,7 @@ static void RB2QuadraticHorizontalInplace_##PixelType(uint8_t *pSrc8, int nSrcPi
  \
         int xstart = 1; \
  \
-        if (sizeof(PixelType) == 1 && isse) { \
+        if (isse) { \
             RB2QuadraticHorizontalInplace_SIMD \
         } \
  \
@@ -502,7 +539,10 @@ RB2Quadratic(uint16_t)
 
 #if defined(MVTOOLS_X86)
 #define RB2CubicVertical_SIMD \
-    mvtools_RB2CubicVerticalLine_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch, nWidthMMX); \
+    if (sizeof(*pSrc) == 1) \
+        mvtools_RB2CubicVerticalLine_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch, nWidthMMX); \
+    else \
+        mvtools_RB2CubicVerticalLine_u16_sse2((uint8_t *)pDst, (const uint8_t *)pSrc, nSrcPitch * sizeof(*pSrc), nWidthMMX); \
     xstart = nWidthMMX;
 #else
 #define RB2CubicVertical_SIMD
@@ -530,7 +570,7 @@ static void RB2CubicVertical_##PixelType(uint8_t *pDst8, const uint8_t *pSrc8, i
     for (int y = 1; y < nHeight - 1; y++) { \
         int xstart = 0; \
  \
-        if (sizeof(PixelType) == 1 && isse && nWidthMMX >= 8) { \
+        if (isse && nWidthMMX >= 8) { \
             RB2CubicVertical_SIMD \
         } \
  \
@@ -555,7 +595,10 @@ RB2CubicVertical(uint16_t)
 
 #if defined(MVTOOLS_X86)
 #define RB2CubicHorizontalInplace_SIMD \
-    mvtools_RB2CubicHorizontalInplaceLine_sse2((uint8_t *)pSrc, nWidthMMX); \
+    if (sizeof(*pSrc) == 1) \
+        mvtools_RB2CubicHorizontalInplaceLine_sse2((uint8_t *)pSrc, nWidthMMX); \
+    else \
+        mvtools_RB2CubicHorizontalInplaceLine_u16_sse2((uint8_t *)pSrc, nWidthMMX); \
     xstart = nWidthMMX;
 #else
 #define RB2CubicHorizontalInplace_SIMD
@@ -576,7 +619,7 @@ static void RB2CubicHorizontalInplace_##PixelType(uint8_t *pSrc8, int nSrcPitch,
  \
         int xstart = 1; \
  \
-        if (sizeof(PixelType) == 1 && isse) { \
+        if (isse) { \
             RB2CubicHorizontalInplace_SIMD \
         } \
  \
@@ -0,0 +1,479 @@
+// 16 bit versions of the refining and reducing functions from Interpolation.asm.
+// They produce the same results as the C functions in Interpolation.h.
+
+#if defined(MVTOOLS_X86)
+
+#include <emmintrin.h>
+#include <stdint.h>
+#include <string.h>
+
+
+static inline __m128i load(const uint16_t *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+
+static inline void store(uint16_t *p, __m128i v) {
+    _mm_storeu_si128((__m128i *)p, v);
+}
+
+
+static inline __m128i widenLo(__m128i v) {
+    return _mm_unpacklo_epi16(v, _mm_setzero_si128());
+}
+
+
+static inline __m128i widenHi(__m128i v) {
+    return _mm_unpackhi_epi16(v, _mm_setzero_si128());
+}
+
+
+// The even and odd pixels of four consecutive pairs, as 32 bit integers.
+static inline __m128i evenPixels(const uint16_t *p) {
+    return _mm_and_si128(load(p), _mm_set1_epi32(0xffff));
+}
+
+
+static inline __m128i oddPixels(const uint16_t *p) {
+    return _mm_srli_epi32(load(p), 16);
+}
+
+
+// Packs 32 bit integers into unsigned 16 bit integers, clamped to [0, pixelMax].
+// packs_epi32 is signed, hence the bias.
+static inline __m128i packClamp(__m128i lo, __m128i hi, int pixelMax) {
+    const __m128i bias = _mm_set1_epi32(32768);
+
+    __m128i v = _mm_packs_epi32(_mm_sub_epi32(lo, bias), _mm_sub_epi32(hi, bias));
+    v = _mm_min_epi16(v, _mm_set1_epi16(pixelMax - 32768));
+
+    return _mm_xor_si128(v, _mm_set1_epi16(-32768));
+}
+
+
+// Integer arithmetic on 32 bit lanes, matching the C functions.
+
+// (a + b + c + d + 2) >> 2
+static inline __m128i diagonalTaps(__m128i a, __m128i b, __m128i c, __m128i d) {
+    __m128i sum = _mm_add_epi32(_mm_add_epi32(a, b), _mm_add_epi32(c, d));
+
+    return _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(2)), 2);
+}
+
+
+// (a + (-b + c * 4 + d * 4 - e) * 5 + f + 16) >> 5
+static inline __m128i wienerTaps(__m128i a, __m128i b, __m128i c, __m128i d, __m128i e, __m128i f) {
+    __m128i t = _mm_sub_epi32(_mm_slli_epi32(_mm_add_epi32(c, d), 2), _mm_add_epi32(b, e));
+    t = _mm_add_epi32(t, _mm_slli_epi32(t, 2));
+    t = _mm_add_epi32(t, _mm_add_epi32(a, f));
+
+    return _mm_srai_epi32(_mm_add_epi32(t, _mm_set1_epi32(16)), 5);
+}
+
+
+// (-a + b * 9 + c * 9 - d + 8) >> 4
+static inline __m128i bicubicTaps(__m128i a, __m128i b, __m128i c, __m128i d) {
+    __m128i t = _mm_add_epi32(b, c);
+    t = _mm_add_epi32(t, _mm_slli_epi32(t, 3));
+    t = _mm_sub_epi32(t, _mm_add_epi32(a, d));
+
+    return _mm_srai_epi32(_mm_add_epi32(t, _mm_set1_epi32(8)), 4);
+}
+
+
+// (a + b * 3 + c * 3 + d + 4) / 8
+static inline __m128i bilinearFilteredTaps(__m128i a, __m128i b, __m128i c, __m128i d) {
+    __m128i t = _mm_add_epi32(b, c);
+    t = _mm_add_epi32(t, _mm_slli_epi32(t, 1));
+    t = _mm_add_epi32(t, _mm_add_epi32(a, d));
+
+    return _mm_srli_epi32(_mm_add_epi32(t, _mm_set1_epi32(4)), 3);
+}
+
+
+// (a + b * 9 + c * 22 + d * 22 + e * 9 + f + 32) / 64
+static inline __m128i quadraticTaps(__m128i a, __m128i b, __m128i c, __m128i d, __m128i e, __m128i f) {
+    __m128i be = _mm_add_epi32(b, e);
+    __m128i cd = _mm_add_epi32(c, d);
+
+    __m128i t = _mm_add_epi32(a, f);
+    t = _mm_add_epi32(t, _mm_add_epi32(be, _mm_slli_epi32(be, 3)));
+    t = _mm_add_epi32(t, _mm_slli_epi32(cd, 1));
+    t = _mm_add_epi32(t, _mm_slli_epi32(cd, 2));
+    t = _mm_add_epi32(t, _mm_slli_epi32(cd, 4));
+
+    return _mm_srli_epi32(_mm_add_epi32(t, _mm_set1_epi32(32)), 6);
+}
+
+
+// (a + b * 5 + c * 10 + d * 10 + e * 5 + f + 16) / 32
+static inline __m128i cubicTaps(__m128i a, __m128i b, __m128i c, __m128i d, __m128i e, __m128i f) {
+    __m128i t = _mm_add_epi32(_mm_add_epi32(b, e), _mm_slli_epi32(_mm_add_epi32(c, d), 1));
+    t = _mm_add_epi32(t, _mm_slli_epi32(t, 2));
+    t = _mm_add_epi32(t, _mm_add_epi32(a, f));
+
+    return _mm_srli_epi32(_mm_add_epi32(t, _mm_set1_epi32(16)), 5);
+}
+
+
+void mvtools_Average2_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc18, const uint8_t *pSrc28, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight) {
+    for (int y = 0; y < nHeight; y++) {
+        uint16_t *pDst = (uint16_t *)pDst8;
+        const uint16_t *pSrc1 = (const uint16_t *)pSrc18;
+        const uint16_t *pSrc2 = (const uint16_t *)pSrc28;
+
+        int x = 0;
+        for (; x + 8 <= nWidth; x += 8)
+            store(pDst + x, _mm_avg_epu16(load(pSrc1 + x), load(pSrc2 + x)));
+        for (; x < nWidth; x++)
+            pDst[x] = (pSrc1[x] + pSrc2[x] + 1) >> 1;
+
+        pDst8 += nPitch;
+        pSrc18 += nPitch;
+        pSrc28 += nPitch;
+    }
+}
+
+
+static void horizontalBilinearRow(uint16_t *pDst, const uint16_t *pSrc, intptr_t nWidth) {
+    int x = 0;
+    for (; x + 8 <= nWidth - 1; x += 8)
+        store(pDst + x, _mm_avg_epu16(load(pSrc + x), load(pSrc + x + 1)));
+    for (; x < nWidth - 1; x++)
+        pDst[x] = (pSrc[x] + pSrc[x + 1] + 1) >> 1;
+
+    pDst[nWidth - 1] = pSrc[nWidth - 1];
+}
+
+
+void mvtools_HorizontalBilinear_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    (void)bitsPerSample;
+
+    for (int y = 0; y < nHeight; y++) {
+        horizontalBilinearRow((uint16_t *)pDst8, (const uint16_t *)pSrc8, nWidth);
+
+        pDst8 += nPitch;
+        pSrc8 += nPitch;
+    }
+}
+
+
+void mvtools_VerticalBilinear_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    (void)bitsPerSample;
+
+    mvtools_Average2_u16_sse2(pDst8, pSrc8, pSrc8 + nPitch, nPitch, nWidth, nHeight - 1);
+
+    /* last row */
+    memcpy(pDst8 + (nHeight - 1) * nPitch, pSrc8 + (nHeight - 1) * nPitch, nWidth * sizeof(uint16_t));
+}
+
+
+void mvtools_DiagonalBilinear_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    (void)bitsPerSample;
+
+    uint16_t *pDst = (uint16_t *)pDst8;
+    const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+    nPitch /= sizeof(uint16_t);
+
+    for (int y = 0; y < nHeight - 1; y++) {
+        int x = 0;
+        for (; x + 8 <= nWidth - 1; x += 8) {
+            __m128i a = load(pSrc + x);
+            __m128i b = load(pSrc + x + 1);
+            __m128i c = load(pSrc + x + nPitch);
+            __m128i d = load(pSrc + x + nPitch + 1);
+
+            __m128i lo = diagonalTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d));
+            __m128i hi = diagonalTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d));
+
+            store(pDst + x, packClamp(lo, hi, 65535));
+        }
+        for (; x < nWidth - 1; x++)
+            pDst[x] = (pSrc[x] + pSrc[x + 1] + pSrc[x + nPitch] + pSrc[x + nPitch + 1] + 2) >> 2;
+
+        pDst[nWidth - 1] = (pSrc[nWidth - 1] + pSrc[nWidth + nPitch - 1] + 1) >> 1;
+
+        pDst += nPitch;
+        pSrc += nPitch;
+    }
+
+    horizontalBilinearRow(pDst, pSrc, nWidth);
+}
+
+
+void mvtools_HorizontalWiener_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    int pixelMax = (1 << bitsPerSample) - 1;
+
+    for (int y = 0; y < nHeight; y++) {
+        uint16_t *pDst = (uint16_t *)pDst8;
+        const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+        pDst[0] = (pSrc[0] + pSrc[1] + 1) >> 1;
+        pDst[1] = (pSrc[1] + pSrc[2] + 1) >> 1;
+
+        int x = 2;
+        for (; x + 8 <= nWidth - 4; x += 8) {
+            __m128i a = load(pSrc + x - 2);
+            __m128i b = load(pSrc + x - 1);
+            __m128i c = load(pSrc + x);
+            __m128i d = load(pSrc + x + 1);
+            __m128i e = load(pSrc + x + 2);
+            __m128i f = load(pSrc + x + 3);
+
+            __m128i lo = wienerTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d), widenLo(e), widenLo(f));
+            __m128i hi = wienerTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d), widenHi(e), widenHi(f));
+
+            store(pDst + x, packClamp(lo, hi, pixelMax));
+        }
+        for (; x < nWidth - 4; x++) {
+            int value = (pSrc[x - 2] + (-pSrc[x - 1] + (pSrc[x] << 2) + (pSrc[x + 1] << 2) - pSrc[x + 2]) * 5 + pSrc[x + 3] + 16) >> 5;
+            pDst[x] = value < 0 ? 0 : (value > pixelMax ? pixelMax : value);
+        }
+
+        for (x = nWidth - 4; x < nWidth - 1; x++)
+            pDst[x] = (pSrc[x] + pSrc[x + 1] + 1) >> 1;
+
+        pDst[nWidth - 1] = pSrc[nWidth - 1];
+
+        pDst8 += nPitch;
+        pSrc8 += nPitch;
+    }
+}
+
+
+void mvtools_VerticalWiener_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    int pixelMax = (1 << bitsPerSample) - 1;
+
+    mvtools_Average2_u16_sse2(pDst8, pSrc8, pSrc8 + nPitch, nPitch, nWidth, 2);
+
+    uint16_t *pDst = (uint16_t *)(pDst8 + 2 * nPitch);
+    const uint16_t *pSrc = (const uint16_t *)(pSrc8 + 2 * nPitch);
+
+    intptr_t pitch = nPitch / sizeof(uint16_t);
+
+    for (int y = 2; y < nHeight - 4; y++) {
+        int x = 0;
+        for (; x + 8 <= nWidth; x += 8) {
+            __m128i a = load(pSrc + x - pitch * 2);
+            __m128i b = load(pSrc + x - pitch);
+            __m128i c = load(pSrc + x);
+            __m128i d = load(pSrc + x + pitch);
+            __m128i e = load(pSrc + x + pitch * 2);
+            __m128i f = load(pSrc + x + pitch * 3);
+
+            __m128i lo = wienerTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d), widenLo(e), widenLo(f));
+            __m128i hi = wienerTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d), widenHi(e), widenHi(f));
+
+            store(pDst + x, packClamp(lo, hi, pixelMax));
+        }
+        for (; x < nWidth; x++) {
+            int value = (pSrc[x - pitch * 2] + (-pSrc[x - pitch] + (pSrc[x] << 2) + (pSrc[x + pitch] << 2) - pSrc[x + pitch * 2]) * 5 + pSrc[x + pitch * 3] + 16) >> 5;
+            pDst[x] = value < 0 ? 0 : (value > pixelMax ? pixelMax : value);
+        }
+
+        pDst += pitch;
+        pSrc += pitch;
+    }
+
+    int y = nHeight - 4 > 2 ? nHeight - 4 : 2;
+
+    mvtools_Average2_u16_sse2(pDst8 + y * nPitch, pSrc8 + y * nPitch, pSrc8 + (y + 1) * nPitch, nPitch, nWidth, nHeight - 1 - y);
+
+    /* last row */
+    memcpy(pDst8 + (nHeight - 1) * nPitch, pSrc8 + (nHeight - 1) * nPitch, nWidth * sizeof(uint16_t));
+}
+
+
+void mvtools_HorizontalBicubic_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    int pixelMax = (1 << bitsPerSample) - 1;
+
+    for (int y = 0; y < nHeight; y++) {
+        uint16_t *pDst = (uint16_t *)pDst8;
+        const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+        pDst[0] = (pSrc[0] + pSrc[1] + 1) >> 1;
+
+        int x = 1;
+        for (; x + 8 <= nWidth - 3; x += 8) {
+            __m128i a = load(pSrc + x - 1);
+            __m128i b = load(pSrc + x);
+            __m128i c = load(pSrc + x + 1);
+            __m128i d = load(pSrc + x + 2);
+
+            __m128i lo = bicubicTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d));
+            __m128i hi = bicubicTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d));
+
+            store(pDst + x, packClamp(lo, hi, pixelMax));
+        }
+        for (; x < nWidth - 3; x++) {
+            int value = (-(pSrc[x - 1] + pSrc[x + 2]) + (pSrc[x] + pSrc[x + 1]) * 9 + 8) >> 4;
+            pDst[x] = value < 0 ? 0 : (value > pixelMax ? pixelMax : value);
+        }
+
+        for (x = nWidth - 3; x < nWidth - 1; x++)
+            pDst[x] = (pSrc[x] + pSrc[x + 1] + 1) >> 1;
+
+        pDst[nWidth - 1] = pSrc[nWidth - 1];
+
+        pDst8 += nPitch;
+        pSrc8 += nPitch;
+    }
+}
+
+
+void mvtools_VerticalBicubic_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nPitch, intptr_t nWidth, intptr_t nHeight, intptr_t bitsPerSample) {
+    int pixelMax = (1 << bitsPerSample) - 1;
+
+    mvtools_Average2_u16_sse2(pDst8, pSrc8, pSrc8 + nPitch, nPitch, nWidth, 1);
+
+    uint16_t *pDst = (uint16_t *)(pDst8 + nPitch);
+    const uint16_t *pSrc = (const uint16_t *)(pSrc8 + nPitch);
+
+    intptr_t pitch = nPitch / sizeof(uint16_t);
+
+    for (int y = 1; y < nHeight - 3; y++) {
+        int x = 0;
+        for (; x + 8 <= nWidth; x += 8) {
+            __m128i a = load(pSrc + x - pitch);
+            __m128i b = load(pSrc + x);
+            __m128i c = load(pSrc + x + pitch);
+            __m128i d = load(pSrc + x + pitch * 2);
+
+            __m128i lo = bicubicTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d));
+            __m128i hi = bicubicTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d));
+
+            store(pDst + x, packClamp(lo, hi, pixelMax));
+        }
+        for (; x < nWidth; x++) {
+            int value = (-pSrc[x - pitch] - pSrc[x + pitch * 2] + (pSrc[x] + pSrc[x + pitch]) * 9 + 8) >> 4;
+            pDst[x] = value < 0 ? 0 : (value > pixelMax ? pixelMax : value);
+        }
+
+        pDst += pitch;
+        pSrc += pitch;
+    }
+
+    int y = nHeight - 3 > 1 ? nHeight - 3 : 1;
+
+    mvtools_Average2_u16_sse2(pDst8 + y * nPitch, pSrc8 + y * nPitch, pSrc8 + (y + 1) * nPitch, nPitch, nWidth, nHeight - 1 - y);
+
+    /* last row */
+    memcpy(pDst8 + (nHeight - 1) * nPitch, pSrc8 + (nHeight - 1) * nPitch, nWidth * sizeof(uint16_t));
+}
+
+
+// The reducing functions only do the middle of each line, like their 8 bit counterparts.
+// nSrcPitch is in bytes. nWidthMMX is a multiple of 8 for the vertical functions,
+// and 1 + a multiple of 8 for the horizontal ones, which skip the first pixel.
+
+void mvtools_RB2BilinearFilteredVerticalLine_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nSrcPitch, intptr_t nWidthMMX) {
+    uint16_t *pDst = (uint16_t *)pDst8;
+    const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+    nSrcPitch /= sizeof(uint16_t);
+
+    for (int x = 0; x < nWidthMMX; x += 8) {
+        __m128i a = load(pSrc + x - nSrcPitch);
+        __m128i b = load(pSrc + x);
+        __m128i c = load(pSrc + x + nSrcPitch);
+        __m128i d = load(pSrc + x + nSrcPitch * 2);
+
+        __m128i lo = bilinearFilteredTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d));
+        __m128i hi = bilinearFilteredTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d));
+
+        store(pDst + x, packClamp(lo, hi, 65535));
+    }
+}
+
+
+void mvtools_RB2BilinearFilteredHorizontalInplaceLine_u16_sse2(uint8_t *pSrc8, intptr_t nWidthMMX) {
+    uint16_t *pSrc = (uint16_t *)pSrc8;
+
+    // Each pixel is written after the pixels it needs are read, so it's safe to work in place.
+    for (int x = 1; x < nWidthMMX; x += 8) {
+        const uint16_t *p = pSrc + x * 2 - 1;
+
+        __m128i lo = bilinearFilteredTaps(evenPixels(p), oddPixels(p), evenPixels(p + 2), oddPixels(p + 2));
+        p += 8;
+        __m128i hi = bilinearFilteredTaps(evenPixels(p), oddPixels(p), evenPixels(p + 2), oddPixels(p + 2));
+
+        store(pSrc + x, packClamp(lo, hi, 65535));
+    }
+}
+
+
+void mvtools_RB2QuadraticVerticalLine_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nSrcPitch, intptr_t nWidthMMX) {
+    uint16_t *pDst = (uint16_t *)pDst8;
+    const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+    nSrcPitch /= sizeof(uint16_t);
+
+    for (int x = 0; x < nWidthMMX; x += 8) {
+        __m128i a = load(pSrc + x - nSrcPitch * 2);
+        __m128i b = load(pSrc + x - nSrcPitch);
+        __m128i c = load(pSrc + x);
+        __m128i d = load(pSrc + x + nSrcPitch);
+        __m128i e = load(pSrc + x + nSrcPitch * 2);
+        __m128i f = load(pSrc + x + nSrcPitch * 3);
+
+        __m128i lo = quadraticTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d), widenLo(e), widenLo(f));
+        __m128i hi = quadraticTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d), widenHi(e), widenHi(f));
+
+        store(pDst + x, packClamp(lo, hi, 65535));
+    }
+}
+
+
+void mvtools_RB2QuadraticHorizontalInplaceLine_u16_sse2(uint8_t *pSrc8, intptr_t nWidthMMX) {
+    uint16_t *pSrc = (uint16_t *)pSrc8;
+
+    for (int x = 1; x < nWidthMMX; x += 8) {
+        const uint16_t *p = pSrc + x * 2 - 2;
+
+        __m128i lo = quadraticTaps(evenPixels(p), oddPixels(p), evenPixels(p + 2), oddPixels(p + 2), evenPixels(p + 4), oddPixels(p + 4));
+        p += 8;
+        __m128i hi = quadraticTaps(evenPixels(p), oddPixels(p), evenPixels(p + 2), oddPixels(p + 2), evenPixels(p + 4), oddPixels(p + 4));
+
+        store(pSrc + x, packClamp(lo, hi, 65535));
+    }
+}
+
+
+void mvtools_RB2CubicVerticalLine_u16_sse2(uint8_t *pDst8, const uint8_t *pSrc8, intptr_t nSrcPitch, intptr_t nWidthMMX) {
+    uint16_t *pDst = (uint16_t *)pDst8;
+    const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+    nSrcPitch /= sizeof(uint16_t);
+
+    for (int x = 0; x < nWidthMMX; x += 8) {
+        __m128i a = load(pSrc + x - nSrcPitch * 2);
+        __m128i b = load(pSrc + x - nSrcPitch);
+        __m128i c = load(pSrc + x);
+        __m128i d = load(pSrc + x + nSrcPitch);
+        __m128i e = load(pSrc + x + nSrcPitch * 2);
+        __m128i f = load(pSrc + x + nSrcPitch * 3);
+
+        __m128i lo = cubicTaps(widenLo(a), widenLo(b), widenLo(c), widenLo(d), widenLo(e), widenLo(f));
+        __m128i hi = cubicTaps(widenHi(a), widenHi(b), widenHi(c), widenHi(d), widenHi(e), widenHi(f));
+
+        store(pDst + x, packClamp(lo, hi, 65535));
+    }
+}
+
+
+void mvtools_RB2CubicHorizontalInplaceLine_u16_sse2(uint8_t *pSrc8, intptr_t nWidthMMX) {
+    uint16_t *pSrc = (uint16_t *)pSrc8;
+
+    for (int x = 1; x < nWidthMMX; x += 8) {
+        const uint16_t *p = pSrc + x * 2 - 2;
+
+        __m128i lo = cubicTaps(evenPixels(p), oddPixels(p), evenPixels(p + 2), oddPixels(p + 2), evenPixels(p + 4), oddPixels(p + 4));
+        p += 8;
+        __m128i hi = cubicTaps(evenPixels(p), oddPixels(p), evenPixels(p + 2), oddPixels(p + 2), evenPixels(p + 4), oddPixels(p + 4));
+
+        store(pSrc + x, packClamp(lo, hi, 65535));
+    }
+}
+
+#endif // MVTOOLS_X86
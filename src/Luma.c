@@ -15,20 +15,60 @@ unsigned int mvtools_luma_##width##x##height##_u##bits##_c(const uint8_t *pSrc8,
     return meanLuma;                                \
 }
 
+DEFINE_LUMA(2, 2, 8)
+DEFINE_LUMA(2, 4, 8)
+DEFINE_LUMA(4, 2, 8)
 DEFINE_LUMA(4, 4, 8)
+DEFINE_LUMA(4, 8, 8)
+DEFINE_LUMA(4, 16, 8)
+DEFINE_LUMA(8, 1, 8)
+DEFINE_LUMA(8, 2, 8)
 DEFINE_LUMA(8, 4, 8)
 DEFINE_LUMA(8, 8, 8)
+DEFINE_LUMA(8, 16, 8)
+DEFINE_LUMA(8, 32, 8)
+DEFINE_LUMA(16, 1, 8)
 DEFINE_LUMA(16, 2, 8)
+DEFINE_LUMA(16, 4, 8)
 DEFINE_LUMA(16, 8, 8)
 DEFINE_LUMA(16, 16, 8)
+DEFINE_LUMA(16, 32, 8)
+DEFINE_LUMA(16, 64, 8)
+DEFINE_LUMA(32, 4, 8)
+DEFINE_LUMA(32, 8, 8)
 DEFINE_LUMA(32, 16, 8)
 DEFINE_LUMA(32, 32, 8)
+DEFINE_LUMA(32, 64, 8)
+DEFINE_LUMA(64, 8, 8)
+DEFINE_LUMA(64, 16, 8)
+DEFINE_LUMA(64, 32, 8)
+DEFINE_LUMA(64, 64, 8)
 
+DEFINE_LUMA(2, 2, 16)
+DEFINE_LUMA(2, 4, 16)
+DEFINE_LUMA(4, 2, 16)
 DEFINE_LUMA(4, 4, 16)
+DEFINE_LUMA(4, 8, 16)
+DEFINE_LUMA(4, 16, 16)
+DEFINE_LUMA(8, 1, 16)
+DEFINE_LUMA(8, 2, 16)
 DEFINE_LUMA(8, 4, 16)
 DEFINE_LUMA(8, 8, 16)
+DEFINE_LUMA(8, 16, 16)
+DEFINE_LUMA(8, 32, 16)
+DEFINE_LUMA(16, 1, 16)
 DEFINE_LUMA(16, 2, 16)
+DEFINE_LUMA(16, 4, 16)
 DEFINE_LUMA(16, 8, 16)
 DEFINE_LUMA(16, 16, 16)
+DEFINE_LUMA(16, 32, 16)
+DEFINE_LUMA(16, 64, 16)
+DEFINE_LUMA(32, 4, 16)
+DEFINE_LUMA(32, 8, 16)
 DEFINE_LUMA(32, 16, 16)
 DEFINE_LUMA(32, 32, 16)
+DEFINE_LUMA(32, 64, 16)
+DEFINE_LUMA(64, 8, 16)
+DEFINE_LUMA(64, 16, 16)
+DEFINE_LUMA(64, 32, 16)
+DEFINE_LUMA(64, 64, 16)
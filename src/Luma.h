@@ -13,23 +13,63 @@ typedef unsigned int (*LUMAFunction)(const uint8_t *pSrc, intptr_t nSrcPitch);
 
 #define DECLARE_LUMA(width, height, bits, opt) unsigned int mvtools_luma_##width##x##height##_u##bits##_##opt(const uint8_t *pSrc, intptr_t nSrcPitch);
 
+DECLARE_LUMA(2, 2, 8, c)
+DECLARE_LUMA(2, 4, 8, c)
+DECLARE_LUMA(4, 2, 8, c)
 DECLARE_LUMA(4, 4, 8, c)
+DECLARE_LUMA(4, 8, 8, c)
+DECLARE_LUMA(4, 16, 8, c)
+DECLARE_LUMA(8, 1, 8, c)
+DECLARE_LUMA(8, 2, 8, c)
 DECLARE_LUMA(8, 4, 8, c)
 DECLARE_LUMA(8, 8, 8, c)
+DECLARE_LUMA(8, 16, 8, c)
+DECLARE_LUMA(8, 32, 8, c)
+DECLARE_LUMA(16, 1, 8, c)
 DECLARE_LUMA(16, 2, 8, c)
+DECLARE_LUMA(16, 4, 8, c)
 DECLARE_LUMA(16, 8, 8, c)
 DECLARE_LUMA(16, 16, 8, c)
+DECLARE_LUMA(16, 32, 8, c)
+DECLARE_LUMA(16, 64, 8, c)
+DECLARE_LUMA(32, 4, 8, c)
+DECLARE_LUMA(32, 8, 8, c)
 DECLARE_LUMA(32, 16, 8, c)
 DECLARE_LUMA(32, 32, 8, c)
+DECLARE_LUMA(32, 64, 8, c)
+DECLARE_LUMA(64, 8, 8, c)
+DECLARE_LUMA(64, 16, 8, c)
+DECLARE_LUMA(64, 32, 8, c)
+DECLARE_LUMA(64, 64, 8, c)
 
+DECLARE_LUMA(2, 2, 16, c)
+DECLARE_LUMA(2, 4, 16, c)
+DECLARE_LUMA(4, 2, 16, c)
 DECLARE_LUMA(4, 4, 16, c)
+DECLARE_LUMA(4, 8, 16, c)
+DECLARE_LUMA(4, 16, 16, c)
+DECLARE_LUMA(8, 1, 16, c)
+DECLARE_LUMA(8, 2, 16, c)
 DECLARE_LUMA(8, 4, 16, c)
 DECLARE_LUMA(8, 8, 16, c)
+DECLARE_LUMA(8, 16, 16, c)
+DECLARE_LUMA(8, 32, 16, c)
+DECLARE_LUMA(16, 1, 16, c)
 DECLARE_LUMA(16, 2, 16, c)
+DECLARE_LUMA(16, 4, 16, c)
 DECLARE_LUMA(16, 8, 16, c)
 DECLARE_LUMA(16, 16, 16, c)
+DECLARE_LUMA(16, 32, 16, c)
+DECLARE_LUMA(16, 64, 16, c)
+DECLARE_LUMA(32, 4, 16, c)
+DECLARE_LUMA(32, 8, 16, c)
 DECLARE_LUMA(32, 16, 16, c)
 DECLARE_LUMA(32, 32, 16, c)
+DECLARE_LUMA(32, 64, 16, c)
+DECLARE_LUMA(64, 8, 16, c)
+DECLARE_LUMA(64, 16, 16, c)
+DECLARE_LUMA(64, 32, 16, c)
+DECLARE_LUMA(64, 64, 16, c)
 
 #if defined(MVTOOLS_X86)
 DECLARE_LUMA(4, 4, 8, sse2)
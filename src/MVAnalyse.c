@@ -8,8 +8,20 @@
 #include "Bullshit.h"
 #include "CPU.h"
 #include "DCTFFTW.h"
+#include "Fakery.h"
+#include "GroupOfFramesCache.h"
 #include "GroupOfPlanes.h"
 #include "MVAnalysisData.h"
+#include "ObjectPool.h"
+#include "SearchContext.h"
+
+
+// As many as DegrainN can use.
+#define MAX_MULTI_RADIUS 12
+
+
+// The vector fields of all of AnalyseMulti's outputs, attached to the frames of its internal node.
+static const char prop_MVTools_vectorFields[] = "MVTools_vectorFields";
 
 
 typedef struct MVAnalyseData {
@@ -48,12 +60,16 @@ typedef struct MVAnalyseData {
     int badrange;    // range (radius) of wide search
     int meander;    //meander (alternate) scan blocks (even row left to right, odd row right to left
     int tryMany;    // try refine around many predictors
+    int adaptive;   // lower the search parameters of each level where the coarser one had little motion
+    int nThreads;   // threads searching each frame (wavefront)
 
     int dctmode;
 
     int nModeYUV;
 
     int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
     int nSuperHPad;
     int nSuperVPad;
     int nSuperPel;
@@ -67,6 +83,16 @@ typedef struct MVAnalyseData {
     int fields;
     int tff;
     int tffexists;
+
+    int tr; // AnalyseMulti only
+
+    VSNodeRef *temporal; // vectors providing a temporal predictor, or NULL
+    const VSVideoInfo *temporalvi;
+    MVAnalysisData temporalData;
+    int temporalScale; // -1 if they point the other way
+
+    SearchContextParameters contextParams;
+    ObjectPool *contexts;
 } MVAnalyseData;
 
 
@@ -79,6 +105,16 @@ static void VS_CC mvanalyseInit(VSMap *in, VSMap *out, void **instanceData, VSNo
 }
 
 
+// The temporal predictors of frame n come from frame n - 1 of vectors in the
+// same direction, or from the reference frame of vectors in the other
+// direction, always with the same delta. Returns -1 if there is no such frame.
+static int mvanalyseTemporalFrame(const MVAnalyseData *d, int n, int nref) {
+    int tn = d->temporalScale > 0 ? n - 1 : nref;
+
+    return (tn >= 0 && tn < d->temporalvi->numFrames) ? tn : -1;
+}
+
+
 static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, void **instanceData, void **frameData, VSFrameContext *frameCtx, VSCore *core, const VSAPI *vsapi) {
     (void)frameData;
 
@@ -113,11 +149,16 @@ static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, vo
                 vsapi->requestFrameFilter(n, d->node, frameCtx);
             }
         }
-    } else if (activationReason == arAllFramesReady) {
 
-        GroupOfPlanes vectorFields;
+        if (d->temporal) {
+            int tn = mvanalyseTemporalFrame(d, n, nref);
+            if (tn >= 0)
+                vsapi->requestFrameFilter(tn, d->temporal, frameCtx);
+        }
+    } else if (activationReason == arAllFramesReady) {
 
-        gopInit(&vectorFields, d->analysisData.nBlkSizeX, d->analysisData.nBlkSizeY, d->analysisData.nLvCount, d->analysisData.nPel, d->analysisData.nMotionFlags, d->analysisData.nCPUFlags, d->analysisData.nOverlapX, d->analysisData.nOverlapY, d->analysisData.nBlkX, d->analysisData.nBlkY, d->analysisData.xRatioUV, d->analysisData.yRatioUV, d->divideExtra, d->supervi->format->bitsPerSample);
+        SearchContext *sc = (SearchContext *)poolAcquire(d->contexts);
+        GroupOfPlanes *vectorFields = &sc->gop;
 
 
         const uint8_t *pSrc[3] = { NULL };
@@ -141,7 +182,7 @@ static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, vo
         int srctff = !!vsapi->propGetInt(srcprops, "_Field", 0, &err);
         if (err && d->fields && !d->tffexists) {
             vsapi->setFilterError("Analyse: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
-            gopDeinit(&vectorFields);
+            poolRelease(d->contexts, sc);
             vsapi->freeFrame(src);
             return NULL;
         }
@@ -156,9 +197,12 @@ static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, vo
         }
 
 
-        int vectors_size = gopGetArraySize(&vectorFields) * sizeof(int);
+        int vectors_size = gopGetArraySize(vectorFields) * sizeof(int);
         int *vectors = (int *)malloc(vectors_size);
 
+        int nLevels = d->analysisData.nLvCount;
+        int64_t *dctCacheStats = NULL; // lookups, then hits, of each level
+
 
         if (nref >= 0 && nref < d->vi->numFrames) {
             const VSFrameRef *ref = vsapi->getFrameFilter(nref, d->node, frameCtx);
@@ -167,7 +211,7 @@ static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, vo
             int reftff = !!vsapi->propGetInt(refprops, "_Field", 0, &err);
             if (err && d->fields && !d->tffexists) {
                 vsapi->setFilterError("Analyse: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
-                gopDeinit(&vectorFields);
+                poolRelease(d->contexts, sc);
                 vsapi->freeFrame(src);
                 vsapi->freeFrame(ref);
                 free(vectors);
@@ -190,43 +234,58 @@ static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, vo
             }
 
 
-            MVGroupOfFrames pSrcGOF, pRefGOF;
+            const MVAnalysisData *ad = &d->analysisData;
+
+            int64_t srcSerial = vsapi->propGetInt(srcprops, "Super_serial", 0, &err);
+            int64_t refSerial = vsapi->propGetInt(refprops, "Super_serial", 0, &err);
+
+            MVGroupOfFrames *srcGOF = gofcAcquire(pSrc, nSrcPitch, d->nSuperLevels, ad->nWidth, ad->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, ad->xRatioUV, ad->yRatioUV, ad->bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
+            MVGroupOfFrames *refGOF = gofcAcquire(pRef, nRefPitch, d->nSuperLevels, ad->nWidth, ad->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, ad->xRatioUV, ad->yRatioUV, ad->bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
 
-            mvgofInit(&pSrcGOF, d->nSuperLevels, d->analysisData.nWidth, d->analysisData.nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, d->analysisData.xRatioUV, d->analysisData.yRatioUV, d->supervi->format->bitsPerSample);
-            mvgofInit(&pRefGOF, d->nSuperLevels, d->analysisData.nWidth, d->analysisData.nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, d->analysisData.xRatioUV, d->analysisData.yRatioUV, d->supervi->format->bitsPerSample);
 
-            // cast away the const, because why not.
-            mvgofUpdate(&pSrcGOF, (uint8_t **)pSrc, nSrcPitch);
-            mvgofUpdate(&pRefGOF, (uint8_t **)pRef, nRefPitch);
+            const VSFrameRef *temporalFrame = NULL;
+            FakeGroupOfPlanes temporalFGOP;
+            const VECTOR *temporal = NULL;
 
+            int tn = d->temporal ? mvanalyseTemporalFrame(d, n, nref) : -1;
+            if (tn >= 0) {
+                temporalFrame = vsapi->getFrameFilter(tn, d->temporal, frameCtx);
 
-            DCTFFTW *DCTc = NULL;
-            if (d->dctmode != 0) {
-                DCTc = (DCTFFTW *)malloc(sizeof(DCTFFTW));
-                dctInit(DCTc, d->analysisData.nBlkSizeX, d->analysisData.nBlkSizeY, d->dctmode, d->supervi->format->bitsPerSample);
+                fgopInit(&temporalFGOP, &d->temporalData);
+                fgopUpdate(&temporalFGOP, (const int *)vsapi->propGetData(vsapi->getFramePropsRO(temporalFrame), prop_MVTools_vectors, 0, NULL));
+
+                if (fgopIsValid(&temporalFGOP))
+                    temporal = fgopGetPlane(&temporalFGOP, 0)->vectors;
             }
 
 
-            gopSearchMVs(&vectorFields, &pSrcGOF, &pRefGOF, d->searchType, d->nSearchParam, d->nPelSearch, d->nLambda, d->lsad, d->pnew, d->plevel, d->global, vectors, fieldShift, DCTc, d->pzero, d->pglobal, d->badSAD, d->badrange, d->meander, d->tryMany, d->searchTypeCoarse);
+            gopSearchMVs(vectorFields, srcGOF, refGOF, d->searchType, d->nSearchParam, d->nPelSearch, d->nLambda, d->lsad, d->pnew, d->plevel, d->global, vectors, fieldShift, sc->DCT, d->pzero, d->pglobal, d->badSAD, d->badrange, d->meander, d->tryMany, d->searchTypeCoarse, d->adaptive, NULL, 0, temporal, d->temporalScale);
+
+            if (d->dctmode >= 1 && d->dctmode <= 4) {
+                dctCacheStats = (int64_t *)calloc(nLevels * 2, sizeof(int64_t));
+                gopGetDCTCacheStats(vectorFields, dctCacheStats, dctCacheStats + nLevels);
+            }
+
+            if (temporalFrame) {
+                fgopDeinit(&temporalFGOP);
+                vsapi->freeFrame(temporalFrame);
+            }
 
             if (d->divideExtra) {
                 // make extra level with divided sublocks with median (not estimated) motion
-                gopExtraDivide(&vectorFields, vectors);
+                gopExtraDivide(vectorFields, vectors);
             }
 
-            gopDeinit(&vectorFields);
-            if (DCTc) {
-                dctDeinit(DCTc);
-                free(DCTc);
-            }
-            mvgofDeinit(&pSrcGOF);
-            mvgofDeinit(&pRefGOF);
+            gofcRelease(srcGOF);
+            gofcRelease(refGOF);
+
             vsapi->freeFrame(ref);
         } else { // too close to the beginning or end to do anything
-            gopWriteDefaultToArray(&vectorFields, vectors);
-            gopDeinit(&vectorFields);
+            gopWriteDefaultToArray(vectorFields, vectors);
         }
 
+        poolRelease(d->contexts, sc);
+
         VSFrameRef *dst = vsapi->copyFrame(src, core);
         VSMap *dstprops = vsapi->getFramePropsRW(dst);
 
@@ -244,6 +303,11 @@ static const VSFrameRef *VS_CC mvanalyseGetFrame(int n, int activationReason, vo
 
         free(vectors);
 
+        if (dctCacheStats) {
+            setDCTCacheStats(dstprops, dctCacheStats, dctCacheStats + nLevels, nLevels, vsapi);
+            free(dctCacheStats);
+        }
+
         // FIXME: Get rid of all mmx shit.
         mvtools_cpu_emms();
 
@@ -261,381 +325,754 @@ static void VS_CC mvanalyseFree(void *instanceData, VSCore *core, const VSAPI *v
 
     MVAnalyseData *d = (MVAnalyseData *)instanceData;
 
+    poolFree(d->contexts);
+    if (d->contextParams.wavefrontPool)
+        wfFreePool(d->contextParams.wavefrontPool);
     vsapi->freeNode(d->node);
+    vsapi->freeNode(d->temporal);
     free(d);
 }
 
 
-static void VS_CC mvanalyseCreate(const VSMap *in, VSMap *out, void *userData, VSCore *core, const VSAPI *vsapi) {
-    (void)userData;
+static void mvanalyseSetError(VSMap *out, const char *filter_name, const char *message, const VSAPI *vsapi) {
+    char error_msg[1024];
+    snprintf(error_msg, sizeof(error_msg), "%s: %s", filter_name, message);
+    vsapi->setError(out, error_msg);
+}
 
-    MVAnalyseData d;
-    MVAnalyseData *data;
 
+// Shared by Analyse and AnalyseMulti. Returns 0 after setting an error in out.
+static int mvanalyseParseArguments(MVAnalyseData *d, const VSMap *in, VSMap *out, const char *filter_name, int multi, VSCore *core, const VSAPI *vsapi) {
     int err;
 
-    d.analysisData.nBlkSizeX = int64ToIntS(vsapi->propGetInt(in, "blksize", 0, &err));
+    d->analysisData.nBlkSizeX = int64ToIntS(vsapi->propGetInt(in, "blksize", 0, &err));
     if (err)
-        d.analysisData.nBlkSizeX = 8;
+        d->analysisData.nBlkSizeX = 8;
 
-    d.analysisData.nBlkSizeY = int64ToIntS(vsapi->propGetInt(in, "blksizev", 0, &err));
+    d->analysisData.nBlkSizeY = int64ToIntS(vsapi->propGetInt(in, "blksizev", 0, &err));
     if (err)
-        d.analysisData.nBlkSizeY = d.analysisData.nBlkSizeX;
+        d->analysisData.nBlkSizeY = d->analysisData.nBlkSizeX;
 
-    d.levels = int64ToIntS(vsapi->propGetInt(in, "levels", 0, &err));
+    d->levels = int64ToIntS(vsapi->propGetInt(in, "levels", 0, &err));
 
-    d.searchType = (SearchType)int64ToIntS(vsapi->propGetInt(in, "search", 0, &err));
+    d->searchType = (SearchType)int64ToIntS(vsapi->propGetInt(in, "search", 0, &err));
     if (err)
-        d.searchType = SearchHex2;
+        d->searchType = SearchHex2;
 
-    d.searchTypeCoarse = (SearchType)int64ToIntS(vsapi->propGetInt(in, "search_coarse", 0, &err));
+    d->searchTypeCoarse = (SearchType)int64ToIntS(vsapi->propGetInt(in, "search_coarse", 0, &err));
     if (err)
-        d.searchTypeCoarse = SearchExhaustive;
+        d->searchTypeCoarse = SearchExhaustive;
 
-    d.searchparam = int64ToIntS(vsapi->propGetInt(in, "searchparam", 0, &err));
+    d->searchparam = int64ToIntS(vsapi->propGetInt(in, "searchparam", 0, &err));
     if (err)
-        d.searchparam = 2;
+        d->searchparam = 2;
 
-    d.nPelSearch = int64ToIntS(vsapi->propGetInt(in, "pelsearch", 0, &err));
+    d->nPelSearch = int64ToIntS(vsapi->propGetInt(in, "pelsearch", 0, &err));
 
-    d.analysisData.isBackward = !!vsapi->propGetInt(in, "isb", 0, &err);
-
-    d.chroma = !!vsapi->propGetInt(in, "chroma", 0, &err);
+    d->chroma = !!vsapi->propGetInt(in, "chroma", 0, &err);
     if (err)
-        d.chroma = 1;
+        d->chroma = 1;
 
-    d.analysisData.nDeltaFrame = int64ToIntS(vsapi->propGetInt(in, "delta", 0, &err));
-    if (err)
-        d.analysisData.nDeltaFrame = 1;
+    if (multi) {
+        d->tr = int64ToIntS(vsapi->propGetInt(in, "tr", 0, &err));
+        if (err)
+            d->tr = 1;
 
-    d.truemotion = !!vsapi->propGetInt(in, "truemotion", 0, &err);
+        d->analysisData.isBackward = 0;
+        d->analysisData.nDeltaFrame = 1;
+    } else {
+        d->tr = 0;
+
+        d->analysisData.isBackward = !!vsapi->propGetInt(in, "isb", 0, &err);
+
+        d->analysisData.nDeltaFrame = int64ToIntS(vsapi->propGetInt(in, "delta", 0, &err));
+        if (err)
+            d->analysisData.nDeltaFrame = 1;
+    }
+
+    d->truemotion = !!vsapi->propGetInt(in, "truemotion", 0, &err);
     if (err)
-        d.truemotion = 1;
+        d->truemotion = 1;
 
-    d.nLambda = int64ToIntS(vsapi->propGetInt(in, "lambda", 0, &err));
+    d->nLambda = int64ToIntS(vsapi->propGetInt(in, "lambda", 0, &err));
     if (err)
-        d.nLambda = d.truemotion ? (1000 * d.analysisData.nBlkSizeX * d.analysisData.nBlkSizeY / 64) : 0;
+        d->nLambda = d->truemotion ? (1000 * d->analysisData.nBlkSizeX * d->analysisData.nBlkSizeY / 64) : 0;
 
-    d.lsad = int64ToIntS(vsapi->propGetInt(in, "lsad", 0, &err));
+    d->lsad = int64ToIntS(vsapi->propGetInt(in, "lsad", 0, &err));
     if (err)
-        d.lsad = d.truemotion ? 1200 : 400;
+        d->lsad = d->truemotion ? 1200 : 400;
 
-    d.plevel = int64ToIntS(vsapi->propGetInt(in, "plevel", 0, &err));
+    d->plevel = int64ToIntS(vsapi->propGetInt(in, "plevel", 0, &err));
     if (err)
-        d.plevel = d.truemotion ? 1 : 0;
+        d->plevel = d->truemotion ? 1 : 0;
 
-    d.global = !!vsapi->propGetInt(in, "global", 0, &err);
+    d->global = !!vsapi->propGetInt(in, "global", 0, &err);
     if (err)
-        d.global = d.truemotion ? 1 : 0;
+        d->global = d->truemotion ? 1 : 0;
 
-    d.pnew = int64ToIntS(vsapi->propGetInt(in, "pnew", 0, &err));
+    d->pnew = int64ToIntS(vsapi->propGetInt(in, "pnew", 0, &err));
     if (err)
-        d.pnew = d.truemotion ? 50 : 0; // relative to 256
+        d->pnew = d->truemotion ? 50 : 0; // relative to 256
 
-    d.pzero = int64ToIntS(vsapi->propGetInt(in, "pzero", 0, &err));
+    d->pzero = int64ToIntS(vsapi->propGetInt(in, "pzero", 0, &err));
     if (err)
-        d.pzero = d.pnew;
+        d->pzero = d->pnew;
 
-    d.pglobal = int64ToIntS(vsapi->propGetInt(in, "pglobal", 0, &err));
+    d->pglobal = int64ToIntS(vsapi->propGetInt(in, "pglobal", 0, &err));
 
-    d.analysisData.nOverlapX = int64ToIntS(vsapi->propGetInt(in, "overlap", 0, &err));
+    d->analysisData.nOverlapX = int64ToIntS(vsapi->propGetInt(in, "overlap", 0, &err));
 
-    d.analysisData.nOverlapY = int64ToIntS(vsapi->propGetInt(in, "overlapv", 0, &err));
+    d->analysisData.nOverlapY = int64ToIntS(vsapi->propGetInt(in, "overlapv", 0, &err));
     if (err)
-        d.analysisData.nOverlapY = d.analysisData.nOverlapX;
+        d->analysisData.nOverlapY = d->analysisData.nOverlapX;
 
-    d.dctmode = int64ToIntS(vsapi->propGetInt(in, "dct", 0, &err));
+    d->dctmode = int64ToIntS(vsapi->propGetInt(in, "dct", 0, &err));
 
-    d.divideExtra = int64ToIntS(vsapi->propGetInt(in, "divide", 0, &err));
+    d->divideExtra = int64ToIntS(vsapi->propGetInt(in, "divide", 0, &err));
 
-    d.badSAD = int64ToIntS(vsapi->propGetInt(in, "badsad", 0, &err));
+    d->badSAD = int64ToIntS(vsapi->propGetInt(in, "badsad", 0, &err));
     if (err)
-        d.badSAD = 10000;
+        d->badSAD = 10000;
 
-    d.badrange = int64ToIntS(vsapi->propGetInt(in, "badrange", 0, &err));
+    d->badrange = int64ToIntS(vsapi->propGetInt(in, "badrange", 0, &err));
     if (err)
-        d.badrange = 24;
+        d->badrange = 24;
 
-    d.isse = !!vsapi->propGetInt(in, "isse", 0, &err);
+    d->isse = !!vsapi->propGetInt(in, "isse", 0, &err);
     if (err)
-        d.isse = 1;
+        d->isse = 1;
 
-    d.meander = !!vsapi->propGetInt(in, "meander", 0, &err);
+    d->meander = !!vsapi->propGetInt(in, "meander", 0, &err);
     if (err)
-        d.meander = 1;
+        d->meander = 1;
 
-    d.tryMany = !!vsapi->propGetInt(in, "trymany", 0, &err);
+    d->tryMany = !!vsapi->propGetInt(in, "trymany", 0, &err);
 
-    d.fields = !!vsapi->propGetInt(in, "fields", 0, &err);
+    d->adaptive = !!vsapi->propGetInt(in, "adaptive", 0, &err);
 
-    d.tff = !!vsapi->propGetInt(in, "tff", 0, &err);
-    d.tffexists = err;
+    d->nThreads = int64ToIntS(vsapi->propGetInt(in, "threads", 0, &err));
+    if (err)
+        d->nThreads = 1;
 
+    d->fields = !!vsapi->propGetInt(in, "fields", 0, &err);
 
-    if (d.searchType < 0 || d.searchType > 7) {
-        vsapi->setError(out, "Analyse: search must be between 0 and 7 (inclusive).");
-        return;
+    d->tff = !!vsapi->propGetInt(in, "tff", 0, &err);
+    d->tffexists = err;
+
+
+    if (d->searchType < 0 || d->searchType > 7) {
+        mvanalyseSetError(out, filter_name, "search must be between 0 and 7 (inclusive).", vsapi);
+        return 0;
     }
 
-    if (d.searchTypeCoarse < 0 || d.searchTypeCoarse > 7) {
-        vsapi->setError(out, "Analyse: search_coarse must be between 0 and 7 (inclusive).");
-        return;
+    if (d->searchTypeCoarse < 0 || d->searchTypeCoarse > 7) {
+        mvanalyseSetError(out, filter_name, "search_coarse must be between 0 and 7 (inclusive).", vsapi);
+        return 0;
     }
 
-    if (d.dctmode < 0 || d.dctmode > 10) {
-        vsapi->setError(out, "Analyse: dct must be between 0 and 10 (inclusive).");
-        return;
+    if (d->dctmode < 0 || d->dctmode > 10) {
+        mvanalyseSetError(out, filter_name, "dct must be between 0 and 10 (inclusive).", vsapi);
+        return 0;
     }
 
-    if (d.dctmode >= 5 &&
-        !((d.analysisData.nBlkSizeX == 4 && d.analysisData.nBlkSizeY == 4) ||
-          (d.analysisData.nBlkSizeX == 8 && d.analysisData.nBlkSizeY == 4) ||
-          (d.analysisData.nBlkSizeX == 8 && d.analysisData.nBlkSizeY == 8) ||
-          (d.analysisData.nBlkSizeX == 16 && d.analysisData.nBlkSizeY == 8) ||
-          (d.analysisData.nBlkSizeX == 16 && d.analysisData.nBlkSizeY == 16))) {
-        vsapi->setError(out, "Analyse: dct 5..10 can only work with 4x4, 8x4, 8x8, 16x8, and 16x16 blocks.");
-        return;
+    if (d->dctmode >= 5 && (d->analysisData.nBlkSizeX < 4 || d->analysisData.nBlkSizeY < 4)) {
+        mvanalyseSetError(out, filter_name, "dct 5..10 need blocks at least 4 pixels wide and 4 pixels tall.", vsapi);
+        return 0;
     }
 
-    if (d.divideExtra < 0 || d.divideExtra > 2) {
-        vsapi->setError(out, "Analyse: divide must be between 0 and 2 (inclusive).");
-        return;
+    if (d->divideExtra < 0 || d->divideExtra > 2) {
+        mvanalyseSetError(out, filter_name, "divide must be between 0 and 2 (inclusive).", vsapi);
+        return 0;
+    }
+
+    if (multi && (d->tr < 1 || d->tr > MAX_MULTI_RADIUS)) {
+        char error_msg[64];
+        snprintf(error_msg, sizeof(error_msg), "tr must be between 1 and %d (inclusive).", MAX_MULTI_RADIUS);
+        mvanalyseSetError(out, filter_name, error_msg, vsapi);
+        return 0;
     }
 
+    if (d->nThreads < 1) {
+        mvanalyseSetError(out, filter_name, "threads must be at least 1.", vsapi);
+        return 0;
+    }
 
-    if ((d.analysisData.nBlkSizeX != 4 || d.analysisData.nBlkSizeY != 4) &&
-        (d.analysisData.nBlkSizeX != 8 || d.analysisData.nBlkSizeY != 4) &&
-        (d.analysisData.nBlkSizeX != 8 || d.analysisData.nBlkSizeY != 8) &&
-        (d.analysisData.nBlkSizeX != 16 || d.analysisData.nBlkSizeY != 2) &&
-        (d.analysisData.nBlkSizeX != 16 || d.analysisData.nBlkSizeY != 8) &&
-        (d.analysisData.nBlkSizeX != 16 || d.analysisData.nBlkSizeY != 16) &&
-        (d.analysisData.nBlkSizeX != 32 || d.analysisData.nBlkSizeY != 32) &&
-        (d.analysisData.nBlkSizeX != 32 || d.analysisData.nBlkSizeY != 16)) {
+    // More threads than the core has would only wait for each other.
+    int coreThreads = vsapi->getCoreInfo(core)->numThreads;
+    if (d->nThreads > coreThreads)
+        d->nThreads = coreThreads > 1 ? coreThreads : 1;
 
-        vsapi->setError(out, "Analyse: the block size must be 4x4, 8x4, 8x8, 16x2, 16x8, 16x16, 32x16, or 32x32.");
-        return;
+    if (d->nThreads > 1 && d->meander) {
+        mvanalyseSetError(out, filter_name, "threads > 1 requires meander=False.", vsapi);
+        return 0;
     }
 
 
-    if (d.plevel < 0 || d.plevel > 2) {
-        vsapi->setError(out, "Analyse: plevel must be between 0 and 2 (inclusive).");
-        return;
+    if (d->plevel < 0 || d->plevel > 2) {
+        mvanalyseSetError(out, filter_name, "plevel must be between 0 and 2 (inclusive).", vsapi);
+        return 0;
     }
 
 
-    if (d.pnew < 0 || d.pnew > 256) {
-        vsapi->setError(out, "Analyse: pnew must be between 0 and 256 (inclusive).");
-        return;
+    if (d->pnew < 0 || d->pnew > 256) {
+        mvanalyseSetError(out, filter_name, "pnew must be between 0 and 256 (inclusive).", vsapi);
+        return 0;
     }
 
 
-    if (d.pzero < 0 || d.pzero > 256) {
-        vsapi->setError(out, "Analyse: pzero must be between 0 and 256 (inclusive).");
-        return;
+    if (d->pzero < 0 || d->pzero > 256) {
+        mvanalyseSetError(out, filter_name, "pzero must be between 0 and 256 (inclusive).", vsapi);
+        return 0;
     }
 
 
-    if (d.pglobal < 0 || d.pglobal > 256) {
-        vsapi->setError(out, "Analyse: pglobal must be between 0 and 256 (inclusive).");
-        return;
+    if (d->pglobal < 0 || d->pglobal > 256) {
+        mvanalyseSetError(out, filter_name, "pglobal must be between 0 and 256 (inclusive).", vsapi);
+        return 0;
     }
 
 
-    if (d.analysisData.nOverlapX < 0 || d.analysisData.nOverlapX > d.analysisData.nBlkSizeX / 2 ||
-        d.analysisData.nOverlapY < 0 || d.analysisData.nOverlapY > d.analysisData.nBlkSizeY / 2) {
-        vsapi->setError(out, "Analyse: overlap must be at most half of blksize, overlapv must be at most half of blksizev, and they both need to be at least 0.");
-        return;
+    if (d->analysisData.nOverlapX < 0 || d->analysisData.nOverlapX > d->analysisData.nBlkSizeX / 2 ||
+        d->analysisData.nOverlapY < 0 || d->analysisData.nOverlapY > d->analysisData.nBlkSizeY / 2) {
+        mvanalyseSetError(out, filter_name, "overlap must be at most half of blksize, overlapv must be at most half of blksizev, and they both need to be at least 0.", vsapi);
+        return 0;
     }
 
-    if (d.divideExtra && (d.analysisData.nBlkSizeX < 8 || d.analysisData.nBlkSizeY < 8)) {
-        vsapi->setError(out, "Analyse: blksize and blksizev must be at least 8 when divide=True.");
-        return;
+    if (d->divideExtra && (d->analysisData.nBlkSizeX < 8 || d->analysisData.nBlkSizeY < 8)) {
+        mvanalyseSetError(out, filter_name, "blksize and blksizev must be at least 8 when divide=True.", vsapi);
+        return 0;
     }
 
 
-    if (d.searchType == SearchNstep)
-        d.nSearchParam = (d.searchparam < 0) ? 0 : d.searchparam;
+    if (d->searchType == SearchNstep)
+        d->nSearchParam = (d->searchparam < 0) ? 0 : d->searchparam;
     else
-        d.nSearchParam = (d.searchparam < 1) ? 1 : d.searchparam;
+        d->nSearchParam = (d->searchparam < 1) ? 1 : d->searchparam;
 
 
-    d.node = vsapi->propGetNode(in, "super", 0, 0);
-    d.supervi = vsapi->getVideoInfo(d.node);
-    d.vi = d.supervi;
+    d->node = vsapi->propGetNode(in, "super", 0, 0);
+    d->supervi = vsapi->getVideoInfo(d->node);
+    d->vi = d->supervi;
 
-    if (!isConstantFormat(d.vi) || d.vi->format->bitsPerSample > 16 || d.vi->format->sampleType != stInteger || d.vi->format->subSamplingW > 1 || d.vi->format->subSamplingH > 1 || (d.vi->format->colorFamily != cmYUV && d.vi->format->colorFamily != cmGray)) {
-        vsapi->setError(out, "Analyse: Input clip must be GRAY, 420, 422, 440, or 444, up to 16 bits, with constant format and dimensions.");
-        vsapi->freeNode(d.node);
-        return;
+    if (!isConstantFormat(d->vi) || d->vi->format->bitsPerSample > 16 || d->vi->format->sampleType != stInteger || d->vi->format->subSamplingW > 1 || d->vi->format->subSamplingH > 1 || (d->vi->format->colorFamily != cmYUV && d->vi->format->colorFamily != cmGray)) {
+        mvanalyseSetError(out, filter_name, "Input clip must be GRAY, 420, 422, 440, or 444, up to 16 bits, with constant format and dimensions.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
-    if (d.vi->format->colorFamily == cmGray)
-        d.chroma = 0;
+    if (d->vi->format->colorFamily == cmGray)
+        d->chroma = 0;
 
-    d.nModeYUV = d.chroma ? YUVPLANES : YPLANE;
+    d->nModeYUV = d->chroma ? YUVPLANES : YPLANE;
 
 
-    d.analysisData.bitsPerSample = d.vi->format->bitsPerSample;
+    d->analysisData.bitsPerSample = d->vi->format->bitsPerSample;
 
-    int pixelMax = (1 << d.vi->format->bitsPerSample) - 1;
-    d.lsad = (int)((double)d.lsad * pixelMax / 255.0 + 0.5);
-    d.badSAD = (int)((double)d.badSAD * pixelMax / 255.0 + 0.5);
+    int pixelMax = (1 << d->vi->format->bitsPerSample) - 1;
+    d->lsad = (int)((double)d->lsad * pixelMax / 255.0 + 0.5);
+    d->badSAD = (int)((double)d->badSAD * pixelMax / 255.0 + 0.5);
 
-    d.lsad = d.lsad * (d.analysisData.nBlkSizeX * d.analysisData.nBlkSizeY) / 64;
-    d.badSAD = d.badSAD * (d.analysisData.nBlkSizeX * d.analysisData.nBlkSizeY) / 64;
+    d->lsad = d->lsad * (d->analysisData.nBlkSizeX * d->analysisData.nBlkSizeY) / 64;
+    d->badSAD = d->badSAD * (d->analysisData.nBlkSizeX * d->analysisData.nBlkSizeY) / 64;
 
 
-    d.analysisData.nMotionFlags = 0;
-    d.analysisData.nMotionFlags |= d.isse ? MOTION_USE_ISSE : 0;
-    d.analysisData.nMotionFlags |= d.analysisData.isBackward ? MOTION_IS_BACKWARD : 0;
-    d.analysisData.nMotionFlags |= d.chroma ? MOTION_USE_CHROMA_MOTION : 0;
+    d->analysisData.nMotionFlags = 0;
+    d->analysisData.nMotionFlags |= d->isse ? MOTION_USE_ISSE : 0;
+    d->analysisData.nMotionFlags |= d->analysisData.isBackward ? MOTION_IS_BACKWARD : 0;
+    d->analysisData.nMotionFlags |= d->chroma ? MOTION_USE_CHROMA_MOTION : 0;
 
 
-    if (d.isse) {
-        d.analysisData.nCPUFlags = cpu_detect();
+    if (d->isse) {
+        d->analysisData.nCPUFlags = cpu_detect();
     }
 
-    if (d.vi->format->bitsPerSample > 8)
-        d.isse = 0; // needed here because MVPlane can't have isse=1 with more than 8 bits
-
-    if (d.analysisData.nOverlapX % (1 << d.vi->format->subSamplingW) ||
-        d.analysisData.nOverlapY % (1 << d.vi->format->subSamplingH)) {
-        vsapi->setError(out, "Analyse: The requested overlap is incompatible with the super clip's subsampling.");
-        vsapi->freeNode(d.node);
-        return;
+    if (d->analysisData.nOverlapX % (1 << d->vi->format->subSamplingW) ||
+        d->analysisData.nOverlapY % (1 << d->vi->format->subSamplingH)) {
+        mvanalyseSetError(out, filter_name, "The requested overlap is incompatible with the super clip's subsampling.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
-    if (d.divideExtra && (d.analysisData.nOverlapX % (2 << d.vi->format->subSamplingW) ||
-                          d.analysisData.nOverlapY % (2 << d.vi->format->subSamplingH))) { // subsampling times 2
-        vsapi->setError(out, "Analyse: overlap and overlapv must be multiples of 2 or 4 when divide=True, depending on the super clip's subsampling.");
-        vsapi->freeNode(d.node);
-        return;
+    if (d->divideExtra && (d->analysisData.nOverlapX % (2 << d->vi->format->subSamplingW) ||
+                          d->analysisData.nOverlapY % (2 << d->vi->format->subSamplingH))) { // subsampling times 2
+        mvanalyseSetError(out, filter_name, "overlap and overlapv must be multiples of 2 or 4 when divide=True, depending on the super clip's subsampling.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
-    if (d.analysisData.nDeltaFrame <= 0 && (-d.analysisData.nDeltaFrame) >= d.vi->numFrames) {
-        vsapi->setError(out, "Analyse: delta points to frame past the input clip's end.");
-        vsapi->freeNode(d.node);
-        return;
+    if (d->analysisData.nDeltaFrame <= 0 && (-d->analysisData.nDeltaFrame) >= d->vi->numFrames) {
+        mvanalyseSetError(out, filter_name, "delta points to frame past the input clip's end.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
-    d.analysisData.yRatioUV = 1 << d.vi->format->subSamplingH;
-    d.analysisData.xRatioUV = 1 << d.vi->format->subSamplingW;
+    d->analysisData.yRatioUV = 1 << d->vi->format->subSamplingH;
+    d->analysisData.xRatioUV = 1 << d->vi->format->subSamplingW;
+
+    char blockSizeError[512] = { 0 };
+    adataCheckBlockSize(&d->analysisData, d->divideExtra, filter_name, blockSizeError, sizeof(blockSizeError));
+    if (blockSizeError[0]) {
+        vsapi->setError(out, blockSizeError);
+        vsapi->freeNode(d->node);
+        return 0;
+    }
 
 
 #define ERROR_SIZE 1024
-    char errorMsg[ERROR_SIZE] = "Analyse: failed to retrieve first frame from super clip. Error message: ";
+    char errorMsg[ERROR_SIZE];
+    snprintf(errorMsg, ERROR_SIZE, "%s: failed to retrieve first frame from super clip. Error message: ", filter_name);
     size_t errorLen = strlen(errorMsg);
-    const VSFrameRef *evil = vsapi->getFrame(0, d.node, errorMsg + errorLen, ERROR_SIZE - errorLen);
+    const VSFrameRef *evil = vsapi->getFrame(0, d->node, errorMsg + errorLen, ERROR_SIZE - errorLen);
 #undef ERROR_SIZE
     if (!evil) {
         vsapi->setError(out, errorMsg);
-        vsapi->freeNode(d.node);
-        return;
+        vsapi->freeNode(d->node);
+        return 0;
     }
     const VSMap *props = vsapi->getFramePropsRO(evil);
     int evil_err[6];
     int nHeight = int64ToIntS(vsapi->propGetInt(props, "Super_height", 0, &evil_err[0]));
-    d.nSuperHPad = int64ToIntS(vsapi->propGetInt(props, "Super_hpad", 0, &evil_err[1]));
-    d.nSuperVPad = int64ToIntS(vsapi->propGetInt(props, "Super_vpad", 0, &evil_err[2]));
-    d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
-    d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
-    d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d->nSuperHPad = int64ToIntS(vsapi->propGetInt(props, "Super_hpad", 0, &evil_err[1]));
+    d->nSuperVPad = int64ToIntS(vsapi->propGetInt(props, "Super_vpad", 0, &evil_err[2]));
+    d->nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
+    d->nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
+    d->nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d->nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d->nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
     for (int i = 0; i < 6; i++)
         if (evil_err[i]) {
-            vsapi->setError(out, "Analyse: required properties not found in first frame of super clip. Maybe clip didn't come from mv.Super? Was the first frame trimmed away?");
-            vsapi->freeNode(d.node);
-            return;
+            mvanalyseSetError(out, filter_name, "required properties not found in first frame of super clip. Maybe clip didn't come from mv.Super? Was the first frame trimmed away?", vsapi);
+            vsapi->freeNode(d->node);
+            return 0;
         }
 
     // check sanity
-    if (nHeight <= 0 || d.nSuperHPad < 0 || d.nSuperHPad >= d.vi->width / 2 ||
-        d.nSuperVPad < 0 || d.nSuperPel < 1 || d.nSuperPel > 4 ||
-        d.nSuperModeYUV < 0 || d.nSuperModeYUV > YUVPLANES || d.nSuperLevels < 1) {
-        vsapi->setError(out, "Analyse: parameters from super clip appear to be wrong.");
-        vsapi->freeNode(d.node);
-        return;
+    if (nHeight <= 0 || d->nSuperHPad < 0 || d->nSuperHPad >= d->vi->width / 2 ||
+        d->nSuperVPad < 0 || d->nSuperPel < 1 || d->nSuperPel > 4 ||
+        d->nSuperModeYUV < 0 || d->nSuperModeYUV > YUVPLANES || d->nSuperLevels < 1) {
+        mvanalyseSetError(out, filter_name, "parameters from super clip appear to be wrong.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
-    if ((d.nModeYUV & d.nSuperModeYUV) != d.nModeYUV) { //x
-        vsapi->setError(out, "Analyse: super clip does not contain needed colour data.");
-        vsapi->freeNode(d.node);
-        return;
+    if ((d->nModeYUV & d->nSuperModeYUV) != d->nModeYUV) { //x
+        mvanalyseSetError(out, filter_name, "super clip does not contain needed colour data.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
 
     // fill in missing fields
-    d.analysisData.nWidth = d.vi->width - d.nSuperHPad * 2; //x
+    d->analysisData.nWidth = d->vi->width - d->nSuperHPad * 2; //x
 
-    d.analysisData.nHeight = nHeight; //x
+    d->analysisData.nHeight = nHeight; //x
 
-    d.analysisData.nPel = d.nSuperPel; //x
+    d->analysisData.nPel = d->nSuperPel; //x
 
-    d.analysisData.nHPadding = d.nSuperHPad; //v2.0    //x
-    d.analysisData.nVPadding = d.nSuperVPad;
+    d->analysisData.nHPadding = d->nSuperHPad; //v2.0    //x
+    d->analysisData.nVPadding = d->nSuperVPad;
 
 
-    int nBlkX = (d.analysisData.nWidth - d.analysisData.nOverlapX) / (d.analysisData.nBlkSizeX - d.analysisData.nOverlapX); //x
+    int nBlkX = (d->analysisData.nWidth - d->analysisData.nOverlapX) / (d->analysisData.nBlkSizeX - d->analysisData.nOverlapX); //x
 
-    int nBlkY = (d.analysisData.nHeight - d.analysisData.nOverlapY) / (d.analysisData.nBlkSizeY - d.analysisData.nOverlapY);
+    int nBlkY = (d->analysisData.nHeight - d->analysisData.nOverlapY) / (d->analysisData.nBlkSizeY - d->analysisData.nOverlapY);
 
-    d.analysisData.nBlkX = nBlkX;
-    d.analysisData.nBlkY = nBlkY;
+    d->analysisData.nBlkX = nBlkX;
+    d->analysisData.nBlkY = nBlkY;
 
-    int nWidth_B = (d.analysisData.nBlkSizeX - d.analysisData.nOverlapX) * nBlkX + d.analysisData.nOverlapX; // covered by blocks
-    int nHeight_B = (d.analysisData.nBlkSizeY - d.analysisData.nOverlapY) * nBlkY + d.analysisData.nOverlapY;
+    int nWidth_B = (d->analysisData.nBlkSizeX - d->analysisData.nOverlapX) * nBlkX + d->analysisData.nOverlapX; // covered by blocks
+    int nHeight_B = (d->analysisData.nBlkSizeY - d->analysisData.nOverlapY) * nBlkY + d->analysisData.nOverlapY;
 
     // calculate valid levels
     int nLevelsMax = 0;
-    while (((nWidth_B >> nLevelsMax) - d.analysisData.nOverlapX) / (d.analysisData.nBlkSizeX - d.analysisData.nOverlapX) > 0 &&
-           ((nHeight_B >> nLevelsMax) - d.analysisData.nOverlapY) / (d.analysisData.nBlkSizeY - d.analysisData.nOverlapY) > 0) // at last one block
+    while (((nWidth_B >> nLevelsMax) - d->analysisData.nOverlapX) / (d->analysisData.nBlkSizeX - d->analysisData.nOverlapX) > 0 &&
+           ((nHeight_B >> nLevelsMax) - d->analysisData.nOverlapY) / (d->analysisData.nBlkSizeY - d->analysisData.nOverlapY) > 0) // at last one block
     {
         nLevelsMax++;
     }
 
-    d.analysisData.nLvCount = d.levels > 0 ? d.levels : nLevelsMax + d.levels;
+    d->analysisData.nLvCount = d->levels > 0 ? d->levels : nLevelsMax + d->levels;
 
-    if (d.analysisData.nLvCount < 1 || d.analysisData.nLvCount > nLevelsMax) {
-        vsapi->setError(out, "Analyse: invalid number of levels.");
-        vsapi->freeNode(d.node);
-        return;
+    if (d->analysisData.nLvCount < 1 || d->analysisData.nLvCount > nLevelsMax) {
+        mvanalyseSetError(out, filter_name, "invalid number of levels.", vsapi);
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
-    if (d.analysisData.nLvCount > d.nSuperLevels) { //x
+    if (d->analysisData.nLvCount > d->nSuperLevels) { //x
 #define ERROR_SIZE 512
         char error_msg[ERROR_SIZE + 1] = { 0 };
-        snprintf(error_msg, ERROR_SIZE, "Analyse: super clip has %d levels. Analyse needs %d levels.", d.nSuperLevels, d.analysisData.nLvCount);
+        snprintf(error_msg, ERROR_SIZE, "%s: super clip has %d levels. %s needs %d levels.", filter_name, d->nSuperLevels, filter_name, d->analysisData.nLvCount);
 #undef ERROR_SIZE
         vsapi->setError(out, error_msg);
-        vsapi->freeNode(d.node);
-        return;
+        vsapi->freeNode(d->node);
+        return 0;
     }
 
 
-    if (d.nPelSearch <= 0)
-        d.nPelSearch = d.analysisData.nPel; // not below value of 0 at finest level //x
+    if (d->nPelSearch <= 0)
+        d->nPelSearch = d->analysisData.nPel; // not below value of 0 at finest level //x
 
 
-    if (d.divideExtra) { //v1.8.1
-        memcpy(&d.analysisDataDivided, &d.analysisData, sizeof(d.analysisData));
-        d.analysisDataDivided.nBlkX = d.analysisData.nBlkX * 2;
-        d.analysisDataDivided.nBlkY = d.analysisData.nBlkY * 2;
-        d.analysisDataDivided.nBlkSizeX = d.analysisData.nBlkSizeX / 2;
-        d.analysisDataDivided.nBlkSizeY = d.analysisData.nBlkSizeY / 2;
-        d.analysisDataDivided.nOverlapX = d.analysisData.nOverlapX / 2;
-        d.analysisDataDivided.nOverlapY = d.analysisData.nOverlapY / 2;
-        d.analysisDataDivided.nLvCount = d.analysisData.nLvCount + 1;
+    if (d->divideExtra) { //v1.8.1
+        memcpy(&d->analysisDataDivided, &d->analysisData, sizeof(d->analysisData));
+        d->analysisDataDivided.nBlkX = d->analysisData.nBlkX * 2;
+        d->analysisDataDivided.nBlkY = d->analysisData.nBlkY * 2;
+        d->analysisDataDivided.nBlkSizeX = d->analysisData.nBlkSizeX / 2;
+        d->analysisDataDivided.nBlkSizeY = d->analysisData.nBlkSizeY / 2;
+        d->analysisDataDivided.nOverlapX = d->analysisData.nOverlapX / 2;
+        d->analysisDataDivided.nOverlapY = d->analysisData.nOverlapY / 2;
+        d->analysisDataDivided.nLvCount = d->analysisData.nLvCount + 1;
     }
 
 
+    d->contextParams.divideExtra = d->divideExtra;
+    d->contextParams.dctmode = d->dctmode;
+    d->contextParams.nThreads = d->nThreads;
+
+
+    d->temporal = multi ? NULL : vsapi->propGetNode(in, "temporal", 0, &err);
+    d->temporalvi = NULL;
+    d->temporalScale = 1;
+    if (d->temporal) {
+#define ERROR_SIZE 512
+        char error[ERROR_SIZE + 1] = { 0 };
+
+        adataFromVectorClip(&d->temporalData, d->temporal, filter_name, "temporal", vsapi, error, ERROR_SIZE);
+#undef ERROR_SIZE
+
+        const MVAnalysisData *ad = &d->analysisData;
+        const MVAnalysisData *td = &d->temporalData;
+
+        if (!error[0]) {
+            if (td->nBlkX != ad->nBlkX || td->nBlkY != ad->nBlkY ||
+                td->nBlkSizeX != ad->nBlkSizeX || td->nBlkSizeY != ad->nBlkSizeY ||
+                td->nOverlapX != ad->nOverlapX || td->nOverlapY != ad->nOverlapY ||
+                td->nPel != ad->nPel)
+                snprintf(error, sizeof(error), "%s: temporal must have the same blocks and pel as the vectors being searched, without divide.", filter_name);
+            // Its SADs are compared with those of the search.
+            else if (td->bitsPerSample != ad->bitsPerSample || (td->nMotionFlags & MOTION_USE_CHROMA_MOTION) != (ad->nMotionFlags & MOTION_USE_CHROMA_MOTION))
+                snprintf(error, sizeof(error), "%s: temporal must have the same bit depth and chroma as the vectors being searched.", filter_name);
+            else if (td->nDeltaFrame != ad->nDeltaFrame)
+                snprintf(error, sizeof(error), "%s: temporal must have the same delta as the vectors being searched.", filter_name);
+            else if (td->isBackward != ad->isBackward && ad->nDeltaFrame <= 0)
+                snprintf(error, sizeof(error), "%s: temporal must have the same isb when delta is not positive.", filter_name);
+        }
+
+        if (error[0]) {
+            vsapi->setError(out, error);
+            vsapi->freeNode(d->temporal);
+            vsapi->freeNode(d->node);
+            return 0;
+        }
+
+        d->temporalvi = vsapi->getVideoInfo(d->temporal);
+        d->temporalScale = td->isBackward == ad->isBackward ? 1 : -1;
+    }
+
+    return 1;
+}
+
+
+static void VS_CC mvanalyseCreate(const VSMap *in, VSMap *out, void *userData, VSCore *core, const VSAPI *vsapi) {
+    (void)userData;
+
+    MVAnalyseData d;
+    MVAnalyseData *data;
+
+    if (!mvanalyseParseArguments(&d, in, out, "Analyse", 0, core, vsapi))
+        return;
+
     data = (MVAnalyseData *)malloc(sizeof(d));
     *data = d;
 
+    data->contextParams.analysisData = &data->analysisData;
+    data->contextParams.wavefrontPool = data->nThreads > 1 ? wfCreatePool(data->nThreads) : NULL;
+    data->contexts = poolCreate(scPoolCreate, scPoolDestroy, &data->contextParams);
+
     vsapi->createFilter(in, out, "Analyse", mvanalyseInit, mvanalyseGetFrame, mvanalyseFree, fmParallel, 0, data, core);
 }
 
 
+// AnalyseMulti searches all the vector fields of a frame in one request, in an
+// internal node whose frames carry them in prop_MVTools_vectorFields, in the
+// order of its outputs. Each output is a small filter taking one of them.
+//
+// The source frame's descriptor is acquired once for all the fields. The
+// first field searched, which always has delta 1, provides the coarse levels
+// of the others: if the motion is constant, the vectors towards frame
+// n - delta are delta times those towards frame n - 1, and the vectors
+// towards n + delta are their opposite. Only the two finest levels of the
+// other fields are searched.
+static const VSFrameRef *VS_CC mvanalysemultiGetFrame(int n, int activationReason, void **instanceData, void **frameData, VSFrameContext *frameCtx, VSCore *core, const VSAPI *vsapi) {
+    (void)frameData;
+
+    MVAnalyseData *d = (MVAnalyseData *)*instanceData;
+
+    if (activationReason == arInitial) {
+        for (int i = VSMAX(n - d->tr, 0); i <= VSMIN(n + d->tr, d->vi->numFrames - 1); i++)
+            vsapi->requestFrameFilter(i, d->node, frameCtx);
+    } else if (activationReason == arAllFramesReady) {
+        const VSFrameRef *src = vsapi->getFrameFilter(n, d->node, frameCtx);
+        const VSMap *srcprops = vsapi->getFramePropsRO(src);
+        int err;
+
+        int srctff = !!vsapi->propGetInt(srcprops, "_Field", 0, &err);
+        if (err && d->fields && !d->tffexists) {
+            vsapi->setFilterError("AnalyseMulti: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
+            vsapi->freeFrame(src);
+            return NULL;
+        }
+
+        // if tff was passed, it overrides _Field.
+        if (d->tffexists)
+            srctff = d->tff && (n % 2 == 0);
+
+        const uint8_t *pSrc[3] = { NULL };
+        int nSrcPitch[3] = { 0 };
+
+        for (int plane = 0; plane < d->supervi->format->numPlanes; plane++) {
+            pSrc[plane] = vsapi->getReadPtr(src, plane);
+            nSrcPitch[plane] = vsapi->getStride(src, plane);
+        }
+
+        const MVAnalysisData *ad = &d->analysisData;
+
+        int64_t srcSerial = vsapi->propGetInt(srcprops, "Super_serial", 0, &err);
+
+        SearchContext *sc = (SearchContext *)poolAcquire(d->contexts);
+        GroupOfPlanes *vectorFields = &sc->gop;
+
+        int field_size = gopGetArraySize(vectorFields);
+        int *vectors = (int *)malloc(field_size * d->tr * 2 * sizeof(int));
+
+        // Lookups, then hits, of each level, added up over all the vector fields.
+        int nLevels = ad->nLvCount;
+        int64_t *dctCacheStats = NULL;
+        if (d->dctmode >= 1 && d->dctmode <= 4)
+            dctCacheStats = (int64_t *)calloc(nLevels * 2, sizeof(int64_t));
+
+        MVGroupOfFrames *srcGOF = NULL;
+
+        const int *seed = NULL;
+        int seedDirection = 0;
+
+        for (int delta = 1; delta <= d->tr; delta++) {
+            for (int isb = 0; isb < 2; isb++) {
+                int *fieldVectors = vectors + field_size * ((delta - 1) * 2 + !isb);
+                int nref = isb ? n + delta : n - delta;
+
+                if (nref < 0 || nref >= d->vi->numFrames) { // too close to the beginning or end to do anything
+                    gopWriteDefaultToArray(vectorFields, fieldVectors);
+                    continue;
+                }
+
+                const VSFrameRef *ref = vsapi->getFrameFilter(nref, d->node, frameCtx);
+                const VSMap *refprops = vsapi->getFramePropsRO(ref);
+
+                int reftff = !!vsapi->propGetInt(refprops, "_Field", 0, &err);
+                if (err && d->fields && !d->tffexists) {
+                    vsapi->setFilterError("AnalyseMulti: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
+                    gofcRelease(srcGOF);
+                    poolRelease(d->contexts, sc);
+                    vsapi->freeFrame(src);
+                    vsapi->freeFrame(ref);
+                    free(vectors);
+                    free(dctCacheStats);
+                    return NULL;
+                }
+
+                // if tff was passed, it overrides _Field.
+                if (d->tffexists)
+                    reftff = d->tff && (nref % 2 == 0);
+
+                int fieldShift = 0;
+                if (d->fields && ad->nPel > 1 && (delta % 2)) {
+                    fieldShift = (srctff && !reftff) ? ad->nPel / 2 : ((reftff && !srctff) ? -(ad->nPel / 2) : 0);
+                    // vertical shift of fields for fieldbased video at finest level pel2
+                }
+
+                const uint8_t *pRef[3] = { NULL };
+                int nRefPitch[3] = { 0 };
+
+                for (int plane = 0; plane < d->supervi->format->numPlanes; plane++) {
+                    pRef[plane] = vsapi->getReadPtr(ref, plane);
+                    nRefPitch[plane] = vsapi->getStride(ref, plane);
+                }
+
+                int64_t refSerial = vsapi->propGetInt(refprops, "Super_serial", 0, &err);
+
+                if (!srcGOF)
+                    srcGOF = gofcAcquire(pSrc, nSrcPitch, d->nSuperLevels, ad->nWidth, ad->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, ad->xRatioUV, ad->yRatioUV, ad->bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
+                MVGroupOfFrames *refGOF = gofcAcquire(pRef, nRefPitch, d->nSuperLevels, ad->nWidth, ad->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, ad->xRatioUV, ad->yRatioUV, ad->bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
+
+                int direction = isb ? -1 : 1;
+
+                gopSearchMVs(vectorFields, srcGOF, refGOF, d->searchType, d->nSearchParam, d->nPelSearch, d->nLambda, d->lsad, d->pnew, d->plevel, d->global, fieldVectors, fieldShift, sc->DCT, d->pzero, d->pglobal, d->badSAD, d->badrange, d->meander, d->tryMany, d->searchTypeCoarse, d->adaptive, seed, direction * seedDirection * delta, NULL, 0);
+
+                if (dctCacheStats)
+                    gopGetDCTCacheStats(vectorFields, dctCacheStats, dctCacheStats + nLevels);
+
+                if (!seed) {
+                    seed = fieldVectors;
+                    seedDirection = direction;
+                }
+
+                // Only the finest level is divided, so the seed stays usable.
+                if (d->divideExtra)
+                    gopExtraDivide(vectorFields, fieldVectors);
+
+                gofcRelease(refGOF);
+
+                vsapi->freeFrame(ref);
+            }
+        }
+
+        gofcRelease(srcGOF);
+
+        poolRelease(d->contexts, sc);
+
+        VSFrameRef *dst = vsapi->copyFrame(src, core);
+        VSMap *dstprops = vsapi->getFramePropsRW(dst);
+
+        for (int i = 0; i < d->tr * 2; i++)
+            vsapi->propSetData(dstprops,
+                               prop_MVTools_vectorFields,
+                               (const char *)(vectors + field_size * i),
+                               field_size * sizeof(int),
+                               paAppend);
+
+        free(vectors);
+
+        if (dctCacheStats) {
+            setDCTCacheStats(dstprops, dctCacheStats, dctCacheStats + nLevels, nLevels, vsapi);
+            free(dctCacheStats);
+        }
+
+        // FIXME: Get rid of all mmx shit.
+        mvtools_cpu_emms();
+
+        vsapi->freeFrame(src);
+
+        return dst;
+    }
+
+    return 0;
+}
+
+
+typedef struct MVAnalyseMultiOutputData {
+    VSNodeRef *node; // AnalyseMulti's internal node
+    const VSVideoInfo *vi;
+
+    MVAnalysisData analysisData;
+
+    int field; // index in prop_MVTools_vectorFields
+} MVAnalyseMultiOutputData;
+
+
+static void VS_CC mvanalysemultioutputInit(VSMap *in, VSMap *out, void **instanceData, VSNode *node, VSCore *core, const VSAPI *vsapi) {
+    (void)in;
+    (void)out;
+    (void)core;
+    MVAnalyseMultiOutputData *d = (MVAnalyseMultiOutputData *)*instanceData;
+    vsapi->setVideoInfo(d->vi, 1, node);
+}
+
+
+static const VSFrameRef *VS_CC mvanalysemultioutputGetFrame(int n, int activationReason, void **instanceData, void **frameData, VSFrameContext *frameCtx, VSCore *core, const VSAPI *vsapi) {
+    (void)frameData;
+
+    MVAnalyseMultiOutputData *d = (MVAnalyseMultiOutputData *)*instanceData;
+
+    if (activationReason == arInitial) {
+        vsapi->requestFrameFilter(n, d->node, frameCtx);
+    } else if (activationReason == arAllFramesReady) {
+        const VSFrameRef *src = vsapi->getFrameFilter(n, d->node, frameCtx);
+        const VSMap *srcprops = vsapi->getFramePropsRO(src);
+
+        const char *vectors = vsapi->propGetData(srcprops, prop_MVTools_vectorFields, d->field, NULL);
+        int vectors_size = vsapi->propGetDataSize(srcprops, prop_MVTools_vectorFields, d->field, NULL);
+
+        VSFrameRef *dst = vsapi->copyFrame(src, core);
+        VSMap *dstprops = vsapi->getFramePropsRW(dst);
+
+        vsapi->propSetData(dstprops,
+                           prop_MVTools_MVAnalysisData,
+                           (const char *)&d->analysisData,
+                           sizeof(MVAnalysisData),
+                           paReplace);
+
+        vsapi->propSetData(dstprops,
+                           prop_MVTools_vectors,
+                           vectors,
+                           vectors_size,
+                           paReplace);
+
+        vsapi->propDeleteKey(dstprops, prop_MVTools_vectorFields);
+
+        vsapi->freeFrame(src);
+
+        return dst;
+    }
+
+    return 0;
+}
+
+
+static void VS_CC mvanalysemultioutputFree(void *instanceData, VSCore *core, const VSAPI *vsapi) {
+    (void)core;
+
+    MVAnalyseMultiOutputData *d = (MVAnalyseMultiOutputData *)instanceData;
+
+    vsapi->freeNode(d->node);
+    free(d);
+}
+
+
+static void VS_CC mvanalysemultiCreate(const VSMap *in, VSMap *out, void *userData, VSCore *core, const VSAPI *vsapi) {
+    (void)userData;
+
+    MVAnalyseData d;
+    MVAnalyseData *data;
+
+    if (!mvanalyseParseArguments(&d, in, out, "AnalyseMulti", 1, core, vsapi))
+        return;
+
+    data = (MVAnalyseData *)malloc(sizeof(d));
+    *data = d;
+
+    data->contextParams.analysisData = &data->analysisData;
+    data->contextParams.wavefrontPool = data->nThreads > 1 ? wfCreatePool(data->nThreads) : NULL;
+    data->contexts = poolCreate(scPoolCreate, scPoolDestroy, &data->contextParams);
+
+    VSMap *internal = vsapi->createMap();
+    vsapi->createFilter(in, internal, "AnalyseMulti", mvanalyseInit, mvanalysemultiGetFrame, mvanalyseFree, fmParallel, 0, data, core);
+    VSNodeRef *node = vsapi->propGetNode(internal, "clip", 0, NULL);
+    vsapi->freeMap(internal);
+
+    // Backward and forward vectors alternate, with increasing deltas, like Degrain's arguments.
+    for (int i = 0; i < d.tr * 2; i++) {
+        MVAnalyseMultiOutputData *outputData = (MVAnalyseMultiOutputData *)malloc(sizeof(MVAnalyseMultiOutputData));
+
+        outputData->node = vsapi->cloneNodeRef(node);
+        outputData->vi = vsapi->getVideoInfo(node);
+        outputData->analysisData = d.divideExtra ? d.analysisDataDivided : d.analysisData;
+        outputData->analysisData.isBackward = !(i % 2);
+        outputData->analysisData.nDeltaFrame = i / 2 + 1;
+        if (outputData->analysisData.isBackward)
+            outputData->analysisData.nMotionFlags |= MOTION_IS_BACKWARD;
+        outputData->field = i;
+
+        vsapi->createFilter(in, out, "AnalyseMulti", mvanalysemultioutputInit, mvanalysemultioutputGetFrame, mvanalysemultioutputFree, fmParallel, 0, outputData, core);
+    }
+
+    vsapi->freeNode(node);
+}
+
+
 void mvanalyseRegister(VSRegisterFunction registerFunc, VSPlugin *plugin) {
     registerFunc("Analyse",
                  "super:clip;"
@@ -667,6 +1104,43 @@ void mvanalyseRegister(VSRegisterFunction registerFunc, VSPlugin *plugin) {
                  "fields:int:opt;"
                  "tff:int:opt;"
                  "search_coarse:int:opt;"
-                 "dct:int:opt;",
+                 "dct:int:opt;"
+                 "threads:int:opt;"
+                 "adaptive:int:opt;"
+                 "temporal:clip:opt;",
                  mvanalyseCreate, 0, plugin);
+
+    registerFunc("AnalyseMulti",
+                 "super:clip;"
+                 "tr:int:opt;"
+                 "blksize:int:opt;"
+                 "blksizev:int:opt;"
+                 "levels:int:opt;"
+                 "search:int:opt;"
+                 "searchparam:int:opt;"
+                 "pelsearch:int:opt;"
+                 "lambda:int:opt;"
+                 "chroma:int:opt;"
+                 "truemotion:int:opt;"
+                 "lsad:int:opt;"
+                 "plevel:int:opt;"
+                 "global:int:opt;"
+                 "pnew:int:opt;"
+                 "pzero:int:opt;"
+                 "pglobal:int:opt;"
+                 "overlap:int:opt;"
+                 "overlapv:int:opt;"
+                 "divide:int:opt;"
+                 "badsad:int:opt;"
+                 "badrange:int:opt;"
+                 "isse:int:opt;"
+                 "meander:int:opt;"
+                 "trymany:int:opt;"
+                 "fields:int:opt;"
+                 "tff:int:opt;"
+                 "search_coarse:int:opt;"
+                 "dct:int:opt;"
+                 "threads:int:opt;"
+                 "adaptive:int:opt;",
+                 mvanalysemultiCreate, 0, plugin);
 }
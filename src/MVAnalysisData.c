@@ -96,3 +96,57 @@ void adataCheckSimilarity(const MVAnalysisData *ad1, const MVAnalysisData *ad2,
     if (ad1->bitsPerSample != ad2->bitsPerSample)
         snprintf(error, error_size, "%s: %s and %s have different bit depths.", filter_name1, filter_name2, vector_name);
 }
+
+
+int findBlockSize(int width, int height) {
+    // In the order of BlockSize.
+    static const int sizes[BlockSizeCount][2] = {
+        { 2, 2 }, { 2, 4 }, { 4, 2 }, { 4, 4 }, { 4, 8 }, { 4, 16 }, { 8, 1 },
+        { 8, 2 }, { 8, 4 }, { 8, 8 }, { 8, 16 }, { 8, 32 }, { 16, 1 }, { 16, 2 },
+        { 16, 4 }, { 16, 8 }, { 16, 16 }, { 16, 32 }, { 16, 64 }, { 32, 4 }, { 32, 8 },
+        { 32, 16 }, { 32, 32 }, { 32, 64 }, { 64, 8 }, { 64, 16 }, { 64, 32 }, { 64, 64 },
+    };
+
+    for (int i = 0; i < BlockSizeCount; i++)
+        if (sizes[i][0] == width && sizes[i][1] == height)
+            return i;
+
+    return -1;
+}
+
+
+void adataCheckBlockSize(const MVAnalysisData *ad, int divide, const char *filter_name, char *error, size_t error_size) {
+    if (error_size) {
+        if (error[0])
+            return;
+        error[0] = '\0';
+    }
+
+    if (findBlockSize(ad->nBlkSizeX, ad->nBlkSizeY) < 0) {
+        snprintf(error, error_size, "%s: the block size must be 2x2, 2x4, 4x2, 4x4, 4x8, 4x16, 8x1, 8x2, 8x4, 8x8, 8x16, 8x32, 16x1, 16x2, 16x4, 16x8, 16x16, 16x32, 16x64, 32x4, 32x8, 32x16, 32x32, 32x64, 64x8, 64x16, 64x32, or 64x64.", filter_name);
+        return;
+    }
+
+    // divide makes blocks half as big in both directions.
+    for (int shift = 0; shift <= (divide ? 1 : 0); shift++) {
+        int width = (ad->nBlkSizeX >> shift) / ad->xRatioUV;
+        int height = (ad->nBlkSizeY >> shift) / ad->yRatioUV;
+
+        if (findBlockSize(width, height) < 0) {
+            snprintf(error, error_size, "%s: the chroma blocks would be %dx%d%s, which is not a supported block size.", filter_name, width, height, shift ? " after divide" : "");
+            return;
+        }
+    }
+}
+
+
+void setDCTCacheStats(VSMap *props, const int64_t *lookups, const int64_t *hits, int levels, const VSAPI *vsapi) {
+    // The frame may come with those of another filter.
+    vsapi->propDeleteKey(props, prop_MVTools_dctCacheLookups);
+    vsapi->propDeleteKey(props, prop_MVTools_dctCacheHits);
+
+    for (int i = 0; i < levels; i++) {
+        vsapi->propSetInt(props, prop_MVTools_dctCacheLookups, lookups[i], paAppend);
+        vsapi->propSetInt(props, prop_MVTools_dctCacheHits, hits[i], paAppend);
+    }
+}
@@ -36,6 +36,11 @@ extern "C" {
 static const char prop_MVTools_MVAnalysisData[] = "MVTools_MVAnalysisData";
 static const char prop_MVTools_vectors[] = "MVTools_vectors";
 
+// One element per level, the finest first, when the dct mode caches the
+// transforms of the reference blocks.
+static const char prop_MVTools_dctCacheLookups[] = "MVTools_dctCacheLookups";
+static const char prop_MVTools_dctCacheHits[] = "MVTools_dctCacheHits";
+
 
 typedef struct VECTOR {
     int x;
@@ -60,6 +65,41 @@ typedef enum SearchType {
 } SearchType;
 
 
+// The block sizes with functions in every filter using the vectors. The
+// filters keep their functions in arrays indexed by these.
+typedef enum BlockSize {
+    Block2x2,
+    Block2x4,
+    Block4x2,
+    Block4x4,
+    Block4x8,
+    Block4x16,
+    Block8x1,
+    Block8x2,
+    Block8x4,
+    Block8x8,
+    Block8x16,
+    Block8x32,
+    Block16x1,
+    Block16x2,
+    Block16x4,
+    Block16x8,
+    Block16x16,
+    Block16x32,
+    Block16x64,
+    Block32x4,
+    Block32x8,
+    Block32x16,
+    Block32x32,
+    Block32x64,
+    Block64x8,
+    Block64x16,
+    Block64x32,
+    Block64x64,
+    BlockSizeCount
+} BlockSize;
+
+
 #define MOTION_USE_ISSE             0x00000001
 #define MOTION_IS_BACKWARD          0x00000002
 #define MOTION_SMALLEST_PLANE       0x00000004
@@ -139,6 +179,17 @@ void adataFromVectorClip(struct MVAnalysisData *ad, VSNodeRef *clip, const char
 
 void adataCheckSimilarity(const MVAnalysisData *ad1, const MVAnalysisData *ad2, const char *filter_name1, const char *filter_name2, const char *vector_name, char *error, size_t error_size);
 
+// Returns the BlockSize of width x height, or -1 if the filters have no
+// functions for it.
+int findBlockSize(int width, int height);
+
+// Checks that the blocks described by ad, their chroma blocks, and those
+// made by divide, have sizes the filters have functions for.
+void adataCheckBlockSize(const MVAnalysisData *ad, int divide, const char *filter_name, char *error, size_t error_size);
+
+// lookups and hits have one element per level, like the properties.
+void setDCTCacheStats(VSMap *props, const int64_t *lookups, const int64_t *hits, int levels, const VSAPI *vsapi);
+
 
 //#define MOTION_DELTA_FRAME_BUFFER 5
 
@@ -28,8 +28,11 @@
 #include "Bullshit.h"
 #include "CopyCode.h"
 #include "CommonFunctions.h"
+#include "GroupOfFramesCache.h"
 #include "MaskFun.h"
 #include "MVAnalysisData.h"
+#include "ObjectPool.h"
+#include "ScratchArena.h"
 #include "SimpleResize.h"
 
 
@@ -58,6 +61,8 @@ typedef struct MVBlockFPSData {
     int nSuperPel;
     int nSuperModeYUV;
     int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
 
     int nWidthUV;
     int nHeightUV;
@@ -78,6 +83,9 @@ typedef struct MVBlockFPSData {
     int64_t fa, fb;
 
     COPYFunction BLITLUMA;
+
+    size_t scratchSize;
+    ObjectPool *scratch;
 } MVBlockFPSData;
 
 
@@ -358,20 +366,22 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
         int isUsableF = 0;
         int isUsableB = 0;
 
+        // The fgops point into the vector frames' properties, so they are kept until fgopDeinit.
+        const VSFrameRef *mvF = NULL;
+        const VSFrameRef *mvB = NULL;
+
         if (nleft < d->oldvi->numFrames && nright < d->oldvi->numFrames) {
             // forward from current to next
-            const VSFrameRef *mvF = vsapi->getFrameFilter(nright, d->mvfw, frameCtx);
+            mvF = vsapi->getFrameFilter(nright, d->mvfw, frameCtx);
             const VSMap *mvprops = vsapi->getFramePropsRO(mvF);
             fgopUpdate(&fgopF, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
             isUsableF = fgopIsUsable(&fgopF, d->thscd1, d->thscd2);
-            vsapi->freeFrame(mvF);
 
             // backward from next to current
-            const VSFrameRef *mvB = vsapi->getFrameFilter(nleft, d->mvbw, frameCtx);
+            mvB = vsapi->getFrameFilter(nleft, d->mvbw, frameCtx);
             mvprops = vsapi->getFramePropsRO(mvB);
             fgopUpdate(&fgopB, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
             isUsableB = fgopIsUsable(&fgopB, d->thscd1, d->thscd2);
-            vsapi->freeFrame(mvB);
         }
 
         const int nWidth = d->mvbw_data.nWidth;
@@ -432,29 +442,29 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
                 nSrcPitches[i] = vsapi->getStride(src, i);
             }
 
-            MVGroupOfFrames pRefBGOF, pRefFGOF;
-
-            mvgofInit(&pRefBGOF, nSuperLevels, nWidth, nHeight, nSuperPel, nSuperHPad, nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, d->supervi->format->bitsPerSample);
-            mvgofInit(&pRefFGOF, nSuperLevels, nWidth, nHeight, nSuperPel, nSuperHPad, nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, d->supervi->format->bitsPerSample);
+            int err;
+            int64_t refSerial = vsapi->propGetInt(vsapi->getFramePropsRO(ref), "Super_serial", 0, &err);
+            int64_t srcSerial = vsapi->propGetInt(vsapi->getFramePropsRO(src), "Super_serial", 0, &err);
 
-            mvgofUpdate(&pRefBGOF, (uint8_t **)pRef, nRefPitches);
-            mvgofUpdate(&pRefFGOF, (uint8_t **)pSrc, nSrcPitches);
+            MVGroupOfFrames *pRefBGOF = gofcAcquire(pRef, nRefPitches, nSuperLevels, nWidth, nHeight, nSuperPel, nSuperHPad, nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, d->supervi->format->bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
+            MVGroupOfFrames *pRefFGOF = gofcAcquire(pSrc, nSrcPitches, nSuperLevels, nWidth, nHeight, nSuperPel, nSuperHPad, nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, d->supervi->format->bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
 
-            MVPlane **pPlanesB = pRefBGOF.frames[0]->planes;
-            MVPlane **pPlanesF = pRefFGOF.frames[0]->planes;
+            MVPlane **pPlanesB = pRefBGOF->frames[0]->planes;
+            MVPlane **pPlanesF = pRefFGOF->frames[0]->planes;
 
+            ScratchArena *arena = (ScratchArena *)poolAcquire(d->scratch);
 
-            uint8_t *MaskFullYB = (uint8_t *)malloc(nHeightP * nPitchY);
-            uint8_t *MaskFullYF = (uint8_t *)malloc(nHeightP * nPitchY);
-            uint8_t *MaskOccY = (uint8_t *)malloc(nHeightP * nPitchY);
+            uint8_t *MaskFullYB = (uint8_t *)arenaAlloc(arena, nHeightP * nPitchY);
+            uint8_t *MaskFullYF = (uint8_t *)arenaAlloc(arena, nHeightP * nPitchY);
+            uint8_t *MaskOccY = (uint8_t *)arenaAlloc(arena, nHeightP * nPitchY);
 
             uint8_t *MaskFullUVB = NULL;
             uint8_t *MaskFullUVF = NULL;
             uint8_t *MaskOccUV = NULL;
             if (nSuperModeYUV & UVPLANES) {
-                MaskFullUVB = (uint8_t *)malloc(nHeightPUV * nPitchUV);
-                MaskFullUVF = (uint8_t *)malloc(nHeightPUV * nPitchUV);
-                MaskOccUV = (uint8_t *)malloc(nHeightPUV * nPitchUV);
+                MaskFullUVB = (uint8_t *)arenaAlloc(arena, nHeightPUV * nPitchUV);
+                MaskFullUVF = (uint8_t *)arenaAlloc(arena, nHeightPUV * nPitchUV);
+                MaskOccUV = (uint8_t *)arenaAlloc(arena, nHeightPUV * nPitchUV);
             }
 
 
@@ -470,21 +480,25 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
             int maxoffset = nPitchY * (nHeightP - nBlkSizeY) - nBlkSizeX;
 
             if (mode == 3 || mode == 4 || mode == 5) {
-                smallMaskB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                smallMaskF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                smallMaskO = (uint8_t *)malloc(nBlkXP * nBlkYP);
+                smallMaskB = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
+                smallMaskF = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
+                smallMaskO = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
 
                 // make forward shifted images by projection to build occlusion mask
                 for (int i = 0; i < blocks; i++) {
-                    const FakeBlockData *blockF = fgopGetBlock(&fgopF, 0, i);
-                    int offset = blockF->x - ((blockF->vector.x * time256) >> 8) / nPel + (blockF->y - ((blockF->vector.y * time256) >> 8) / nPel) * nPitchY;
+                    const VECTOR *vectorF = fgopGetVector(&fgopF, 0, i);
+                    int xF = fgopGetBlockX(&fgopF, 0, i);
+                    int yF = fgopGetBlockY(&fgopF, 0, i);
+                    int offset = xF - ((vectorF->x * time256) >> 8) / nPel + (yF - ((vectorF->y * time256) >> 8) / nPel) * nPitchY;
                     if (offset >= 0 && offset < maxoffset)
                         d->BLITLUMA(MaskFullYF + offset, nPitchY, OnesBlock, nBlkSizeX); // fill by ones
                 }
                 //  same mask for backward
                 for (int i = 0; i < blocks; i++) {
-                    const FakeBlockData *blockB = fgopGetBlock(&fgopB, 0, i);
-                    int offset = blockB->x - ((blockB->vector.x * (256 - time256)) >> 8) / nPel + (blockB->y - ((blockB->vector.y * (256 - time256)) >> 8) / nPel) * nPitchY;
+                    const VECTOR *vectorB = fgopGetVector(&fgopB, 0, i);
+                    int xB = fgopGetBlockX(&fgopB, 0, i);
+                    int yB = fgopGetBlockY(&fgopB, 0, i);
+                    int offset = xB - ((vectorB->x * (256 - time256)) >> 8) / nPel + (yB - ((vectorB->y * (256 - time256)) >> 8) / nPel) * nPitchY;
                     if (offset >= 0 && offset < maxoffset)
                         d->BLITLUMA(MaskFullYB + offset, nPitchY, OnesBlock, nBlkSizeX); // fill by ones
                 }
@@ -493,18 +507,18 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
                 MakeSmallMask(MaskFullYF, nPitchY, smallMaskF, nBlkXP, nBlkYP, nBlkSizeX, nBlkSizeY, thres);
                 InflateMask(smallMaskF, nBlkXP, nBlkYP);
                 // upsize small mask to full frame size
-                simpleResize(upsizer, MaskFullYF, nPitchY, smallMaskF, nBlkXP);
+                simpleResize_uint8_t(upsizer, MaskFullYF, nPitchY, smallMaskF, nBlkXP);
                 // now we have forward fullframe blured occlusion mask in maskF arrays
 
                 // make small binary mask from  occlusion  regions
                 MakeSmallMask(MaskFullYB, nPitchY, smallMaskB, nBlkXP, nBlkYP, nBlkSizeX, nBlkSizeY, thres);
                 InflateMask(smallMaskB, nBlkXP, nBlkYP);
                 // upsize small mask to full frame size
-                simpleResize(upsizer, MaskFullYB, nPitchY, smallMaskB, nBlkXP);
+                simpleResize_uint8_t(upsizer, MaskFullYB, nPitchY, smallMaskB, nBlkXP);
 
                 if (nSuperModeYUV & UVPLANES) {
-                    simpleResize(upsizerUV, MaskFullUVF, nPitchUV, smallMaskF, nBlkXP);
-                    simpleResize(upsizerUV, MaskFullUVB, nPitchUV, smallMaskB, nBlkXP);
+                    simpleResize_uint8_t(upsizerUV, MaskFullUVF, nPitchUV, smallMaskF, nBlkXP);
+                    simpleResize_uint8_t(upsizerUV, MaskFullUVB, nPitchUV, smallMaskB, nBlkXP);
                 }
             }
 
@@ -513,9 +527,9 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
                 MultMasks(smallMaskF, smallMaskB, smallMaskO, nBlkXP, nBlkYP);
                 InflateMask(smallMaskO, nBlkXP, nBlkYP);
                 // upsize small mask to full frame size
-                simpleResize(upsizer, MaskOccY, nPitchY, smallMaskO, nBlkXP);
+                simpleResize_uint8_t(upsizer, MaskOccY, nPitchY, smallMaskO, nBlkXP);
                 if (nSuperModeYUV & UVPLANES)
-                    simpleResize(upsizerUV, MaskOccUV, nPitchUV, smallMaskO, nBlkXP);
+                    simpleResize_uint8_t(upsizerUV, MaskOccUV, nPitchUV, smallMaskO, nBlkXP);
             }
 
             // pointers
@@ -538,14 +552,18 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
 
             // fetch image blocks
             for (int i = 0; i < blocks; i++) {
-                const FakeBlockData *blockB = fgopGetBlock(&fgopB, 0, i);
-                const FakeBlockData *blockF = fgopGetBlock(&fgopF, 0, i);
+                const VECTOR *vectorB = fgopGetVector(&fgopB, 0, i);
+                const VECTOR *vectorF = fgopGetVector(&fgopF, 0, i);
+                int xB = fgopGetBlockX(&fgopB, 0, i);
+                int yB = fgopGetBlockY(&fgopB, 0, i);
+                int xF = fgopGetBlockX(&fgopF, 0, i);
+                int yF = fgopGetBlockY(&fgopF, 0, i);
 
                 // luma
                 ResultBlock(pDst[0], nDstPitches[0],
-                            mvpGetPointer(pPlanesB[0], blockB->x * nPel + ((blockB->vector.x * (256 - time256)) >> 8), blockB->y * nPel + ((blockB->vector.y * (256 - time256)) >> 8)),
+                            mvpGetPointer(pPlanesB[0], xB * nPel + ((vectorB->x * (256 - time256)) >> 8), yB * nPel + ((vectorB->y * (256 - time256)) >> 8)),
                             pPlanesB[0]->nPitch,
-                            mvpGetPointer(pPlanesF[0], blockF->x * nPel + ((blockF->vector.x * time256) >> 8), blockF->y * nPel + ((blockF->vector.y * time256) >> 8)),
+                            mvpGetPointer(pPlanesF[0], xF * nPel + ((vectorF->x * time256) >> 8), yF * nPel + ((vectorF->y * time256) >> 8)),
                             pPlanesF[0]->nPitch,
                             pRef[0], nRefPitches[0],
                             pSrc[0], nSrcPitches[0],
@@ -555,9 +573,9 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
                 if (nSuperModeYUV & UVPLANES) {
                     // chroma u
                     ResultBlock(pDst[1], nDstPitches[1],
-                                mvpGetPointer(pPlanesB[1], (blockB->x * nPel + ((blockB->vector.x * (256 - time256)) >> 8)) / xRatioUV, (blockB->y * nPel + ((blockB->vector.y * (256 - time256)) >> 8)) / yRatioUV),
+                                mvpGetPointer(pPlanesB[1], (xB * nPel + ((vectorB->x * (256 - time256)) >> 8)) / xRatioUV, (yB * nPel + ((vectorB->y * (256 - time256)) >> 8)) / yRatioUV),
                                 pPlanesB[1]->nPitch,
-                                mvpGetPointer(pPlanesF[1], (blockF->x * nPel + ((blockF->vector.x * time256) >> 8)) / xRatioUV, (blockF->y * nPel + ((blockF->vector.y * time256) >> 8)) / yRatioUV),
+                                mvpGetPointer(pPlanesF[1], (xF * nPel + ((vectorF->x * time256) >> 8)) / xRatioUV, (yF * nPel + ((vectorF->y * time256) >> 8)) / yRatioUV),
                                 pPlanesF[1]->nPitch,
                                 pRef[1], nRefPitches[1],
                                 pSrc[1], nSrcPitches[1],
@@ -566,9 +584,9 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
                                 nBlkSizeX / xRatioUV, nBlkSizeY / yRatioUV, time256, mode, bitsPerSample);
                     // chroma v
                     ResultBlock(pDst[2], nDstPitches[2],
-                                mvpGetPointer(pPlanesB[2], (blockB->x * nPel + ((blockB->vector.x * (256 - time256)) >> 8)) / xRatioUV, (blockB->y * nPel + ((blockB->vector.y * (256 - time256)) >> 8)) / yRatioUV),
+                                mvpGetPointer(pPlanesB[2], (xB * nPel + ((vectorB->x * (256 - time256)) >> 8)) / xRatioUV, (yB * nPel + ((vectorB->y * (256 - time256)) >> 8)) / yRatioUV),
                                 pPlanesB[2]->nPitch,
-                                mvpGetPointer(pPlanesF[2], (blockF->x * nPel + ((blockF->vector.x * time256) >> 8)) / xRatioUV, (blockF->y * nPel + ((blockF->vector.y * time256) >> 8)) / yRatioUV),
+                                mvpGetPointer(pPlanesF[2], (xF * nPel + ((vectorF->x * time256) >> 8)) / xRatioUV, (yF * nPel + ((vectorF->y * time256) >> 8)) / yRatioUV),
                                 pPlanesF[2]->nPitch,
                                 pRef[2], nRefPitches[2],
                                 pSrc[2], nSrcPitches[2],
@@ -632,34 +650,26 @@ static const VSFrameRef *VS_CC mvblockfpsGetFrame(int n, int activationReason, v
                 Blend(pDst[2], pSrc[2], pRef[2], nHeightUV - (nBlkSizeY / yRatioUV) * nBlkY, nWidthUV, nDstPitches[2], nSrcPitches[2], nRefPitches[2], time256, bitsPerSample);
             }
 
+            arenaReset(arena);
+            poolRelease(d->scratch, arena);
 
-            free(MaskFullYB);
-            free(MaskFullYF);
-            free(MaskOccY);
-            if (nSuperModeYUV & UVPLANES) {
-                free(MaskFullUVB);
-                free(MaskFullUVF);
-                free(MaskOccUV);
-            }
-            if (smallMaskB) {
-                free(smallMaskB);
-                free(smallMaskF);
-                free(smallMaskO);
-            }
-
-            mvgofDeinit(&pRefBGOF);
-            mvgofDeinit(&pRefFGOF);
+            gofcRelease(pRefBGOF);
+            gofcRelease(pRefFGOF);
 
             vsapi->freeFrame(src);
             vsapi->freeFrame(ref);
 
             fgopDeinit(&fgopF);
             fgopDeinit(&fgopB);
+            vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvB);
 
             return dst;
         } else { // poor estimation
             fgopDeinit(&fgopF);
             fgopDeinit(&fgopB);
+            vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvB);
 
             const VSFrameRef *src = vsapi->getFrameFilter(VSMIN(nleft, d->oldvi->numFrames - 1), d->node, frameCtx);
 
@@ -713,6 +723,8 @@ static void VS_CC mvblockfpsFree(void *instanceData, VSCore *core, const VSAPI *
 
     free(d->OnesBlock);
 
+    poolFree(d->scratch);
+
     vsapi->freeNode(d->super);
     vsapi->freeNode(d->mvfw);
     vsapi->freeNode(d->mvbw);
@@ -743,30 +755,39 @@ static void selectFunctions(MVBlockFPSData *d) {
     const int nBlkSizeX = d->mvbw_data.nBlkSizeX;
     const int nBlkSizeY = d->mvbw_data.nBlkSizeY;
 
-    COPYFunction copys[33][33];
+    COPYFunction copys[BlockSizeCount];
 
     // The copy functions are only used with 8 bit masks.
-    copys[2][2] = mvtools_copy_2x2_u8_c;
-    copys[2][4] = mvtools_copy_2x4_u8_c;
-    copys[4][2] = mvtools_copy_4x2_u8_c;
-    copys[4][4] = mvtools_copy_4x4_u8_c;
-    copys[4][8] = mvtools_copy_4x8_u8_c;
-    copys[8][1] = mvtools_copy_8x1_u8_c;
-    copys[8][2] = mvtools_copy_8x2_u8_c;
-    copys[8][4] = mvtools_copy_8x4_u8_c;
-    copys[8][8] = mvtools_copy_8x8_u8_c;
-    copys[8][16] = mvtools_copy_8x16_u8_c;
-    copys[16][1] = mvtools_copy_16x1_u8_c;
-    copys[16][2] = mvtools_copy_16x2_u8_c;
-    copys[16][4] = mvtools_copy_16x4_u8_c;
-    copys[16][8] = mvtools_copy_16x8_u8_c;
-    copys[16][16] = mvtools_copy_16x16_u8_c;
-    copys[16][32] = mvtools_copy_16x32_u8_c;
-    copys[32][8] = mvtools_copy_32x8_u8_c;
-    copys[32][16] = mvtools_copy_32x16_u8_c;
-    copys[32][32] = mvtools_copy_32x32_u8_c;
-
-    d->BLITLUMA = copys[nBlkSizeX][nBlkSizeY];
+    copys[Block2x2] = mvtools_copy_2x2_u8_c;
+    copys[Block2x4] = mvtools_copy_2x4_u8_c;
+    copys[Block4x2] = mvtools_copy_4x2_u8_c;
+    copys[Block4x4] = mvtools_copy_4x4_u8_c;
+    copys[Block4x8] = mvtools_copy_4x8_u8_c;
+    copys[Block4x16] = mvtools_copy_4x16_u8_c;
+    copys[Block8x1] = mvtools_copy_8x1_u8_c;
+    copys[Block8x2] = mvtools_copy_8x2_u8_c;
+    copys[Block8x4] = mvtools_copy_8x4_u8_c;
+    copys[Block8x8] = mvtools_copy_8x8_u8_c;
+    copys[Block8x16] = mvtools_copy_8x16_u8_c;
+    copys[Block8x32] = mvtools_copy_8x32_u8_c;
+    copys[Block16x1] = mvtools_copy_16x1_u8_c;
+    copys[Block16x2] = mvtools_copy_16x2_u8_c;
+    copys[Block16x4] = mvtools_copy_16x4_u8_c;
+    copys[Block16x8] = mvtools_copy_16x8_u8_c;
+    copys[Block16x16] = mvtools_copy_16x16_u8_c;
+    copys[Block16x32] = mvtools_copy_16x32_u8_c;
+    copys[Block16x64] = mvtools_copy_16x64_u8_c;
+    copys[Block32x4] = mvtools_copy_32x4_u8_c;
+    copys[Block32x8] = mvtools_copy_32x8_u8_c;
+    copys[Block32x16] = mvtools_copy_32x16_u8_c;
+    copys[Block32x32] = mvtools_copy_32x32_u8_c;
+    copys[Block32x64] = mvtools_copy_32x64_u8_c;
+    copys[Block64x8] = mvtools_copy_64x8_u8_c;
+    copys[Block64x16] = mvtools_copy_64x16_u8_c;
+    copys[Block64x32] = mvtools_copy_64x32_u8_c;
+    copys[Block64x64] = mvtools_copy_64x64_u8_c;
+
+    d->BLITLUMA = copys[findBlockSize(nBlkSizeX, nBlkSizeY)];
 }
 
 
@@ -834,6 +855,8 @@ static void VS_CC mvblockfpsCreate(const VSMap *in, VSMap *out, void *userData,
     d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
     d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
     d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
     for (int i = 0; i < 6; i++)
@@ -967,9 +990,6 @@ static void VS_CC mvblockfpsCreate(const VSMap *in, VSMap *out, void *userData,
         return;
     }
 
-    if (d.vi.format->bitsPerSample > 8)
-        d.isse = 0;
-
 
     d.nBlkXP = (d.mvbw_data.nBlkX * (d.mvbw_data.nBlkSizeX - d.mvbw_data.nOverlapX) + d.mvbw_data.nOverlapX < d.mvbw_data.nWidth) ? d.mvbw_data.nBlkX + 1 : d.mvbw_data.nBlkX;
     d.nBlkYP = (d.mvbw_data.nBlkY * (d.mvbw_data.nBlkSizeY - d.mvbw_data.nOverlapY) + d.mvbw_data.nOverlapY < d.mvbw_data.nHeight) ? d.mvbw_data.nBlkY + 1 : d.mvbw_data.nBlkY;
@@ -989,16 +1009,23 @@ static void VS_CC mvblockfpsCreate(const VSMap *in, VSMap *out, void *userData,
     memset(d.OnesBlock, 255, d.mvbw_data.nBlkSizeX * d.mvbw_data.nBlkSizeY);
 
 
-    simpleInit(&d.upsizer, d.nWidthP, d.nHeightP, d.nBlkXP, d.nBlkYP);
+    simpleInit(&d.upsizer, d.nWidthP, d.nHeightP, d.nBlkXP, d.nBlkYP, d.isse);
     if (d.nSuperModeYUV & UVPLANES)
-        simpleInit(&d.upsizerUV, d.nWidthPUV, d.nHeightPUV, d.nBlkXP, d.nBlkYP);
+        simpleInit(&d.upsizerUV, d.nWidthPUV, d.nHeightPUV, d.nBlkXP, d.nBlkYP, d.isse);
 
     selectFunctions(&d);
 
+    // The masks made by mvblockfpsGetFrame.
+    d.scratchSize = 3 * arenaBufferSize(d.nHeightP * d.nPitchY) + 3 * arenaBufferSize(d.nBlkXP * d.nBlkYP);
+    if (d.nSuperModeYUV & UVPLANES)
+        d.scratchSize += 3 * arenaBufferSize(d.nHeightPUV * d.nPitchUV);
+
 
     data = (MVBlockFPSData *)malloc(sizeof(d));
     *data = d;
 
+    data->scratch = poolCreate(arenaPoolCreate, arenaPoolDestroy, &data->scratchSize);
+
     vsapi->createFilter(in, out, "BlockFPS", mvblockfpsInit, mvblockfpsGetFrame, mvblockfpsFree, fmParallel, 0, data, core);
 
     // AssumeFPS sets the _DurationNum and _DurationDen properties.
@@ -23,6 +23,7 @@
 
 #include "CopyCode.h"
 #include "Fakery.h"
+#include "GroupOfFramesCache.h"
 #include "Overlap.h"
 #include "MaskFun.h"
 #include "MVAnalysisData.h"
@@ -52,6 +53,8 @@ typedef struct MVCompensateData {
     int nSuperPel;
     int nSuperModeYUV;
     int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
 
     int dstTempPitch;
     int dstTempPitchUV;
@@ -124,7 +127,6 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
         fgopInit(&fgop, &d->vectors_data);
         const VSMap *mvprops = vsapi->getFramePropsRO(mvn);
         fgopUpdate(&fgop, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
-        vsapi->freeFrame(mvn);
 
         int off, nref;
         if (d->vectors_data.nDeltaFrame > 0) {
@@ -179,17 +181,16 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
                 nRefPitches[i] = vsapi->getStride(ref, i);
             }
 
-            MVGroupOfFrames pRefGOF, pSrcGOF;
-
-            mvgofInit(&pRefGOF, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, bitsPerSample);
-            mvgofInit(&pSrcGOF, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, bitsPerSample);
+            int serialErr;
+            int64_t refSerial = vsapi->propGetInt(vsapi->getFramePropsRO(ref), "Super_serial", 0, &serialErr);
+            int64_t srcSerial = vsapi->propGetInt(vsapi->getFramePropsRO(src), "Super_serial", 0, &serialErr);
 
-            mvgofUpdate(&pRefGOF, (uint8_t **)pRef, nRefPitches);
-            mvgofUpdate(&pSrcGOF, (uint8_t **)pSrc, nSrcPitches);
+            MVGroupOfFrames *pRefGOF = gofcAcquire(pRef, nRefPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
+            MVGroupOfFrames *pSrcGOF = gofcAcquire(pSrc, nSrcPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, nSuperModeYUV, isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
 
 
-            MVPlane **pPlanes = pRefGOF.frames[0]->planes;
-            MVPlane **pSrcPlanes = pSrcGOF.frames[0]->planes;
+            MVPlane **pPlanes = pRefGOF->frames[0]->planes;
+            MVPlane **pSrcPlanes = pSrcGOF->frames[0]->planes;
 
             for (int plane = 0; plane < d->supervi->format->numPlanes; plane++) {
                 pDstCur[plane] = pDst[plane];
@@ -204,8 +205,9 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
                 if (err && !d->tffexists) {
                     vsapi->setFilterError("Compensate: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
                     fgopDeinit(&fgop);
-                    mvgofDeinit(&pRefGOF);
-                    mvgofDeinit(&pSrcGOF);
+                    vsapi->freeFrame(mvn);
+                    gofcRelease(pRefGOF);
+                    gofcRelease(pSrcGOF);
                     vsapi->freeFrame(src);
                     vsapi->freeFrame(dst);
                     vsapi->freeFrame(ref);
@@ -220,8 +222,9 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
                 if (err && !d->tffexists) {
                     vsapi->setFilterError("Compensate: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
                     fgopDeinit(&fgop);
-                    mvgofDeinit(&pRefGOF);
-                    mvgofDeinit(&pSrcGOF);
+                    vsapi->freeFrame(mvn);
+                    gofcRelease(pRefGOF);
+                    gofcRelease(pSrcGOF);
                     vsapi->freeFrame(src);
                     vsapi->freeFrame(dst);
                     vsapi->freeFrame(ref);
@@ -240,10 +243,10 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
                     int xx = 0;
                     for (int bx = 0; bx < nBlkX; bx++) {
                         int i = by * nBlkX + bx;
-                        const FakeBlockData *block = fgopGetBlock(&fgop, 0, i);
-                        blx = block->x * nPel + block->vector.x;
-                        bly = block->y * nPel + block->vector.y + fieldShift;
-                        if (block->vector.sad < thSAD) {
+                        const VECTOR *vector = fgopGetVector(&fgop, 0, i);
+                        blx = fgopGetBlockX(&fgop, 0, i) * nPel + vector->x;
+                        bly = fgopGetBlockY(&fgop, 0, i) * nPel + vector->y + fieldShift;
+                        if (vector->sad < thSAD) {
                             // luma
                             d->BLITLUMA(pDstCur[0] + xx, nDstPitches[0], mvpGetPointer(pPlanes[0], blx, bly), pPlanes[0]->nPitch);
                             // chroma u
@@ -312,12 +315,12 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
                             winOverUV = overGetWindow(OverWinsUV, wby + wbx);
 
                         int i = by * nBlkX + bx;
-                        const FakeBlockData *block = fgopGetBlock(&fgop, 0, i);
+                        const VECTOR *vector = fgopGetVector(&fgop, 0, i);
 
-                        blx = block->x * nPel + block->vector.x;
-                        bly = block->y * nPel + block->vector.y + fieldShift;
+                        blx = fgopGetBlockX(&fgop, 0, i) * nPel + vector->x;
+                        bly = fgopGetBlockY(&fgop, 0, i) * nPel + vector->y + fieldShift;
 
-                        if (block->vector.sad < thSAD) {
+                        if (vector->sad < thSAD) {
                             // luma
                             d->OVERSLUMA(pDstTemp + xx * 2, dstTempPitch, mvpGetPointer(pPlanes[0], blx, bly), pPlanes[0]->nPitch, winOver, nBlkSizeX);
                             // chroma u
@@ -417,8 +420,8 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
                               (nWidth >> xSubUV) * bytesPerSample, (nHeight - nHeight_B) >> ySubUV);
             }
 
-            mvgofDeinit(&pRefGOF);
-            mvgofDeinit(&pSrcGOF);
+            gofcRelease(pRefGOF);
+            gofcRelease(pSrcGOF);
 
             vsapi->freeFrame(ref);
         } else { // balls.IsUsable()
@@ -448,6 +451,7 @@ static const VSFrameRef *VS_CC mvcompensateGetFrame(int n, int activationReason,
         }
 
         fgopDeinit(&fgop);
+        vsapi->freeFrame(mvn);
 
         vsapi->freeFrame(src);
 
@@ -485,156 +489,255 @@ static void selectFunctions(MVCompensateData *d) {
     const int nBlkSizeX = d->vectors_data.nBlkSizeX;
     const int nBlkSizeY = d->vectors_data.nBlkSizeY;
 
-    OverlapsFunction overs[33][33];
-    COPYFunction copys[33][33];
+    OverlapsFunction overs[BlockSizeCount];
+    COPYFunction copys[BlockSizeCount];
 
     if (d->vi->format->bitsPerSample == 8) {
-        overs[2][2] = mvtools_overlaps_2x2_uint16_t_uint8_t_c;
-        copys[2][2] = mvtools_copy_2x2_u8_c;
+        overs[Block2x2] = mvtools_overlaps_2x2_uint16_t_uint8_t_c;
+        copys[Block2x2] = mvtools_copy_2x2_u8_c;
+
+        overs[Block2x4] = mvtools_overlaps_2x4_uint16_t_uint8_t_c;
+        copys[Block2x4] = mvtools_copy_2x4_u8_c;
+
+        overs[Block4x2] = mvtools_overlaps_4x2_uint16_t_uint8_t_c;
+        copys[Block4x2] = mvtools_copy_4x2_u8_c;
+
+        overs[Block4x4] = mvtools_overlaps_4x4_uint16_t_uint8_t_c;
+        copys[Block4x4] = mvtools_copy_4x4_u8_c;
+
+        overs[Block4x8] = mvtools_overlaps_4x8_uint16_t_uint8_t_c;
+        copys[Block4x8] = mvtools_copy_4x8_u8_c;
 
-        overs[2][4] = mvtools_overlaps_2x4_uint16_t_uint8_t_c;
-        copys[2][4] = mvtools_copy_2x4_u8_c;
+        overs[Block4x16] = mvtools_overlaps_4x16_uint16_t_uint8_t_c;
+        copys[Block4x16] = mvtools_copy_4x16_u8_c;
 
-        overs[4][2] = mvtools_overlaps_4x2_uint16_t_uint8_t_c;
-        copys[4][2] = mvtools_copy_4x2_u8_c;
+        overs[Block8x1] = mvtools_overlaps_8x1_uint16_t_uint8_t_c;
+        copys[Block8x1] = mvtools_copy_8x1_u8_c;
 
-        overs[4][4] = mvtools_overlaps_4x4_uint16_t_uint8_t_c;
-        copys[4][4] = mvtools_copy_4x4_u8_c;
+        overs[Block8x2] = mvtools_overlaps_8x2_uint16_t_uint8_t_c;
+        copys[Block8x2] = mvtools_copy_8x2_u8_c;
 
-        overs[4][8] = mvtools_overlaps_4x8_uint16_t_uint8_t_c;
-        copys[4][8] = mvtools_copy_4x8_u8_c;
+        overs[Block8x4] = mvtools_overlaps_8x4_uint16_t_uint8_t_c;
+        copys[Block8x4] = mvtools_copy_8x4_u8_c;
 
-        overs[8][1] = mvtools_overlaps_8x1_uint16_t_uint8_t_c;
-        copys[8][1] = mvtools_copy_8x1_u8_c;
+        overs[Block8x8] = mvtools_overlaps_8x8_uint16_t_uint8_t_c;
+        copys[Block8x8] = mvtools_copy_8x8_u8_c;
 
-        overs[8][2] = mvtools_overlaps_8x2_uint16_t_uint8_t_c;
-        copys[8][2] = mvtools_copy_8x2_u8_c;
+        overs[Block8x16] = mvtools_overlaps_8x16_uint16_t_uint8_t_c;
+        copys[Block8x16] = mvtools_copy_8x16_u8_c;
 
-        overs[8][4] = mvtools_overlaps_8x4_uint16_t_uint8_t_c;
-        copys[8][4] = mvtools_copy_8x4_u8_c;
+        overs[Block8x32] = mvtools_overlaps_8x32_uint16_t_uint8_t_c;
+        copys[Block8x32] = mvtools_copy_8x32_u8_c;
 
-        overs[8][8] = mvtools_overlaps_8x8_uint16_t_uint8_t_c;
-        copys[8][8] = mvtools_copy_8x8_u8_c;
+        overs[Block16x1] = mvtools_overlaps_16x1_uint16_t_uint8_t_c;
+        copys[Block16x1] = mvtools_copy_16x1_u8_c;
 
-        overs[8][16] = mvtools_overlaps_8x16_uint16_t_uint8_t_c;
-        copys[8][16] = mvtools_copy_8x16_u8_c;
+        overs[Block16x2] = mvtools_overlaps_16x2_uint16_t_uint8_t_c;
+        copys[Block16x2] = mvtools_copy_16x2_u8_c;
 
-        overs[16][1] = mvtools_overlaps_16x1_uint16_t_uint8_t_c;
-        copys[16][1] = mvtools_copy_16x1_u8_c;
+        overs[Block16x4] = mvtools_overlaps_16x4_uint16_t_uint8_t_c;
+        copys[Block16x4] = mvtools_copy_16x4_u8_c;
 
-        overs[16][2] = mvtools_overlaps_16x2_uint16_t_uint8_t_c;
-        copys[16][2] = mvtools_copy_16x2_u8_c;
+        overs[Block16x8] = mvtools_overlaps_16x8_uint16_t_uint8_t_c;
+        copys[Block16x8] = mvtools_copy_16x8_u8_c;
 
-        overs[16][4] = mvtools_overlaps_16x4_uint16_t_uint8_t_c;
-        copys[16][4] = mvtools_copy_16x4_u8_c;
+        overs[Block16x16] = mvtools_overlaps_16x16_uint16_t_uint8_t_c;
+        copys[Block16x16] = mvtools_copy_16x16_u8_c;
 
-        overs[16][8] = mvtools_overlaps_16x8_uint16_t_uint8_t_c;
-        copys[16][8] = mvtools_copy_16x8_u8_c;
+        overs[Block16x32] = mvtools_overlaps_16x32_uint16_t_uint8_t_c;
+        copys[Block16x32] = mvtools_copy_16x32_u8_c;
 
-        overs[16][16] = mvtools_overlaps_16x16_uint16_t_uint8_t_c;
-        copys[16][16] = mvtools_copy_16x16_u8_c;
+        overs[Block16x64] = mvtools_overlaps_16x64_uint16_t_uint8_t_c;
+        copys[Block16x64] = mvtools_copy_16x64_u8_c;
 
-        overs[16][32] = mvtools_overlaps_16x32_uint16_t_uint8_t_c;
-        copys[16][32] = mvtools_copy_16x32_u8_c;
+        overs[Block32x4] = mvtools_overlaps_32x4_uint16_t_uint8_t_c;
+        copys[Block32x4] = mvtools_copy_32x4_u8_c;
 
-        overs[32][8] = mvtools_overlaps_32x8_uint16_t_uint8_t_c;
-        copys[32][8] = mvtools_copy_32x8_u8_c;
+        overs[Block32x8] = mvtools_overlaps_32x8_uint16_t_uint8_t_c;
+        copys[Block32x8] = mvtools_copy_32x8_u8_c;
 
-        overs[32][16] = mvtools_overlaps_32x16_uint16_t_uint8_t_c;
-        copys[32][16] = mvtools_copy_32x16_u8_c;
+        overs[Block32x16] = mvtools_overlaps_32x16_uint16_t_uint8_t_c;
+        copys[Block32x16] = mvtools_copy_32x16_u8_c;
 
-        overs[32][32] = mvtools_overlaps_32x32_uint16_t_uint8_t_c;
-        copys[32][32] = mvtools_copy_32x32_u8_c;
+        overs[Block32x32] = mvtools_overlaps_32x32_uint16_t_uint8_t_c;
+        copys[Block32x32] = mvtools_copy_32x32_u8_c;
+
+        overs[Block32x64] = mvtools_overlaps_32x64_uint16_t_uint8_t_c;
+        copys[Block32x64] = mvtools_copy_32x64_u8_c;
+
+        overs[Block64x8] = mvtools_overlaps_64x8_uint16_t_uint8_t_c;
+        copys[Block64x8] = mvtools_copy_64x8_u8_c;
+
+        overs[Block64x16] = mvtools_overlaps_64x16_uint16_t_uint8_t_c;
+        copys[Block64x16] = mvtools_copy_64x16_u8_c;
+
+        overs[Block64x32] = mvtools_overlaps_64x32_uint16_t_uint8_t_c;
+        copys[Block64x32] = mvtools_copy_64x32_u8_c;
+
+        overs[Block64x64] = mvtools_overlaps_64x64_uint16_t_uint8_t_c;
+        copys[Block64x64] = mvtools_copy_64x64_u8_c;
 
         d->ToPixels = ToPixels_uint16_t_uint8_t;
 
         if (d->isse) {
 #if defined(MVTOOLS_X86)
-            overs[4][2] = mvtools_overlaps_4x2_sse2;
-            overs[4][4] = mvtools_overlaps_4x4_sse2;
-            overs[4][8] = mvtools_overlaps_4x8_sse2;
-            overs[8][1] = mvtools_overlaps_8x1_sse2;
-            overs[8][2] = mvtools_overlaps_8x2_sse2;
-            overs[8][4] = mvtools_overlaps_8x4_sse2;
-            overs[8][8] = mvtools_overlaps_8x8_sse2;
-            overs[8][16] = mvtools_overlaps_8x16_sse2;
-            overs[16][1] = mvtools_overlaps_16x1_sse2;
-            overs[16][2] = mvtools_overlaps_16x2_sse2;
-            overs[16][4] = mvtools_overlaps_16x4_sse2;
-            overs[16][8] = mvtools_overlaps_16x8_sse2;
-            overs[16][16] = mvtools_overlaps_16x16_sse2;
-            overs[16][32] = mvtools_overlaps_16x32_sse2;
-            overs[32][8] = mvtools_overlaps_32x8_sse2;
-            overs[32][16] = mvtools_overlaps_32x16_sse2;
-            overs[32][32] = mvtools_overlaps_32x32_sse2;
+            overs[Block4x2] = mvtools_overlaps_4x2_sse2;
+            overs[Block4x4] = mvtools_overlaps_4x4_sse2;
+            overs[Block4x8] = mvtools_overlaps_4x8_sse2;
+            overs[Block8x1] = mvtools_overlaps_8x1_sse2;
+            overs[Block8x2] = mvtools_overlaps_8x2_sse2;
+            overs[Block8x4] = mvtools_overlaps_8x4_sse2;
+            overs[Block8x8] = mvtools_overlaps_8x8_sse2;
+            overs[Block8x16] = mvtools_overlaps_8x16_sse2;
+            overs[Block16x1] = mvtools_overlaps_16x1_sse2;
+            overs[Block16x2] = mvtools_overlaps_16x2_sse2;
+            overs[Block16x4] = mvtools_overlaps_16x4_sse2;
+            overs[Block16x8] = mvtools_overlaps_16x8_sse2;
+            overs[Block16x16] = mvtools_overlaps_16x16_sse2;
+            overs[Block16x32] = mvtools_overlaps_16x32_sse2;
+            overs[Block32x8] = mvtools_overlaps_32x8_sse2;
+            overs[Block32x16] = mvtools_overlaps_32x16_sse2;
+            overs[Block32x32] = mvtools_overlaps_32x32_sse2;
+            overs[Block4x16] = mvtools_overlaps_4x16_uint16_t_uint8_t_sse2;
+            overs[Block8x32] = mvtools_overlaps_8x32_uint16_t_uint8_t_sse2;
+            overs[Block16x64] = mvtools_overlaps_16x64_uint16_t_uint8_t_sse2;
+            overs[Block32x4] = mvtools_overlaps_32x4_uint16_t_uint8_t_sse2;
+            overs[Block32x64] = mvtools_overlaps_32x64_uint16_t_uint8_t_sse2;
+            overs[Block64x8] = mvtools_overlaps_64x8_uint16_t_uint8_t_sse2;
+            overs[Block64x16] = mvtools_overlaps_64x16_uint16_t_uint8_t_sse2;
+            overs[Block64x32] = mvtools_overlaps_64x32_uint16_t_uint8_t_sse2;
+            overs[Block64x64] = mvtools_overlaps_64x64_uint16_t_uint8_t_sse2;
 #endif
         }
     } else {
-        overs[2][2] = mvtools_overlaps_2x2_uint32_t_uint16_t_c;
-        copys[2][2] = mvtools_copy_2x2_u16_c;
+        overs[Block2x2] = mvtools_overlaps_2x2_uint32_t_uint16_t_c;
+        copys[Block2x2] = mvtools_copy_2x2_u16_c;
+
+        overs[Block2x4] = mvtools_overlaps_2x4_uint32_t_uint16_t_c;
+        copys[Block2x4] = mvtools_copy_2x4_u16_c;
+
+        overs[Block4x2] = mvtools_overlaps_4x2_uint32_t_uint16_t_c;
+        copys[Block4x2] = mvtools_copy_4x2_u16_c;
 
-        overs[2][4] = mvtools_overlaps_2x4_uint32_t_uint16_t_c;
-        copys[2][4] = mvtools_copy_2x4_u16_c;
+        overs[Block4x4] = mvtools_overlaps_4x4_uint32_t_uint16_t_c;
+        copys[Block4x4] = mvtools_copy_4x4_u16_c;
 
-        overs[4][2] = mvtools_overlaps_4x2_uint32_t_uint16_t_c;
-        copys[4][2] = mvtools_copy_4x2_u16_c;
+        overs[Block4x8] = mvtools_overlaps_4x8_uint32_t_uint16_t_c;
+        copys[Block4x8] = mvtools_copy_4x8_u16_c;
 
-        overs[4][4] = mvtools_overlaps_4x4_uint32_t_uint16_t_c;
-        copys[4][4] = mvtools_copy_4x4_u16_c;
+        overs[Block4x16] = mvtools_overlaps_4x16_uint32_t_uint16_t_c;
+        copys[Block4x16] = mvtools_copy_4x16_u16_c;
 
-        overs[4][8] = mvtools_overlaps_4x8_uint32_t_uint16_t_c;
-        copys[4][8] = mvtools_copy_4x8_u16_c;
+        overs[Block8x1] = mvtools_overlaps_8x1_uint32_t_uint16_t_c;
+        copys[Block8x1] = mvtools_copy_8x1_u16_c;
 
-        overs[8][1] = mvtools_overlaps_8x1_uint32_t_uint16_t_c;
-        copys[8][1] = mvtools_copy_8x1_u16_c;
+        overs[Block8x2] = mvtools_overlaps_8x2_uint32_t_uint16_t_c;
+        copys[Block8x2] = mvtools_copy_8x2_u16_c;
 
-        overs[8][2] = mvtools_overlaps_8x2_uint32_t_uint16_t_c;
-        copys[8][2] = mvtools_copy_8x2_u16_c;
+        overs[Block8x4] = mvtools_overlaps_8x4_uint32_t_uint16_t_c;
+        copys[Block8x4] = mvtools_copy_8x4_u16_c;
 
-        overs[8][4] = mvtools_overlaps_8x4_uint32_t_uint16_t_c;
-        copys[8][4] = mvtools_copy_8x4_u16_c;
+        overs[Block8x8] = mvtools_overlaps_8x8_uint32_t_uint16_t_c;
+        copys[Block8x8] = mvtools_copy_8x8_u16_c;
 
-        overs[8][8] = mvtools_overlaps_8x8_uint32_t_uint16_t_c;
-        copys[8][8] = mvtools_copy_8x8_u16_c;
+        overs[Block8x16] = mvtools_overlaps_8x16_uint32_t_uint16_t_c;
+        copys[Block8x16] = mvtools_copy_8x16_u16_c;
 
-        overs[8][16] = mvtools_overlaps_8x16_uint32_t_uint16_t_c;
-        copys[8][16] = mvtools_copy_8x16_u16_c;
+        overs[Block8x32] = mvtools_overlaps_8x32_uint32_t_uint16_t_c;
+        copys[Block8x32] = mvtools_copy_8x32_u16_c;
 
-        overs[16][1] = mvtools_overlaps_16x1_uint32_t_uint16_t_c;
-        copys[16][1] = mvtools_copy_16x1_u16_c;
+        overs[Block16x1] = mvtools_overlaps_16x1_uint32_t_uint16_t_c;
+        copys[Block16x1] = mvtools_copy_16x1_u16_c;
 
-        overs[16][2] = mvtools_overlaps_16x2_uint32_t_uint16_t_c;
-        copys[16][2] = mvtools_copy_16x2_u16_c;
+        overs[Block16x2] = mvtools_overlaps_16x2_uint32_t_uint16_t_c;
+        copys[Block16x2] = mvtools_copy_16x2_u16_c;
 
-        overs[16][4] = mvtools_overlaps_16x4_uint32_t_uint16_t_c;
-        copys[16][4] = mvtools_copy_16x4_u16_c;
+        overs[Block16x4] = mvtools_overlaps_16x4_uint32_t_uint16_t_c;
+        copys[Block16x4] = mvtools_copy_16x4_u16_c;
 
-        overs[16][8] = mvtools_overlaps_16x8_uint32_t_uint16_t_c;
-        copys[16][8] = mvtools_copy_16x8_u16_c;
+        overs[Block16x8] = mvtools_overlaps_16x8_uint32_t_uint16_t_c;
+        copys[Block16x8] = mvtools_copy_16x8_u16_c;
 
-        overs[16][16] = mvtools_overlaps_16x16_uint32_t_uint16_t_c;
-        copys[16][16] = mvtools_copy_16x16_u16_c;
+        overs[Block16x16] = mvtools_overlaps_16x16_uint32_t_uint16_t_c;
+        copys[Block16x16] = mvtools_copy_16x16_u16_c;
 
-        overs[16][32] = mvtools_overlaps_16x32_uint32_t_uint16_t_c;
-        copys[16][32] = mvtools_copy_16x32_u16_c;
+        overs[Block16x32] = mvtools_overlaps_16x32_uint32_t_uint16_t_c;
+        copys[Block16x32] = mvtools_copy_16x32_u16_c;
 
-        overs[32][8] = mvtools_overlaps_32x8_uint32_t_uint16_t_c;
-        copys[32][8] = mvtools_copy_32x8_u16_c;
+        overs[Block16x64] = mvtools_overlaps_16x64_uint32_t_uint16_t_c;
+        copys[Block16x64] = mvtools_copy_16x64_u16_c;
 
-        overs[32][16] = mvtools_overlaps_32x16_uint32_t_uint16_t_c;
-        copys[32][16] = mvtools_copy_32x16_u16_c;
+        overs[Block32x4] = mvtools_overlaps_32x4_uint32_t_uint16_t_c;
+        copys[Block32x4] = mvtools_copy_32x4_u16_c;
 
-        overs[32][32] = mvtools_overlaps_32x32_uint32_t_uint16_t_c;
-        copys[32][32] = mvtools_copy_32x32_u16_c;
+        overs[Block32x8] = mvtools_overlaps_32x8_uint32_t_uint16_t_c;
+        copys[Block32x8] = mvtools_copy_32x8_u16_c;
+
+        overs[Block32x16] = mvtools_overlaps_32x16_uint32_t_uint16_t_c;
+        copys[Block32x16] = mvtools_copy_32x16_u16_c;
+
+        overs[Block32x32] = mvtools_overlaps_32x32_uint32_t_uint16_t_c;
+        copys[Block32x32] = mvtools_copy_32x32_u16_c;
+
+        overs[Block32x64] = mvtools_overlaps_32x64_uint32_t_uint16_t_c;
+        copys[Block32x64] = mvtools_copy_32x64_u16_c;
+
+        overs[Block64x8] = mvtools_overlaps_64x8_uint32_t_uint16_t_c;
+        copys[Block64x8] = mvtools_copy_64x8_u16_c;
+
+        overs[Block64x16] = mvtools_overlaps_64x16_uint32_t_uint16_t_c;
+        copys[Block64x16] = mvtools_copy_64x16_u16_c;
+
+        overs[Block64x32] = mvtools_overlaps_64x32_uint32_t_uint16_t_c;
+        copys[Block64x32] = mvtools_copy_64x32_u16_c;
+
+        overs[Block64x64] = mvtools_overlaps_64x64_uint32_t_uint16_t_c;
+        copys[Block64x64] = mvtools_copy_64x64_u16_c;
 
         d->ToPixels = ToPixels_uint32_t_uint16_t;
+
+        if (d->isse) {
+#if defined(MVTOOLS_X86)
+            overs[Block4x2] = mvtools_overlaps_4x2_uint32_t_uint16_t_sse2;
+            overs[Block4x4] = mvtools_overlaps_4x4_uint32_t_uint16_t_sse2;
+            overs[Block4x8] = mvtools_overlaps_4x8_uint32_t_uint16_t_sse2;
+            overs[Block4x16] = mvtools_overlaps_4x16_uint32_t_uint16_t_sse2;
+            overs[Block8x1] = mvtools_overlaps_8x1_uint32_t_uint16_t_sse2;
+            overs[Block8x2] = mvtools_overlaps_8x2_uint32_t_uint16_t_sse2;
+            overs[Block8x4] = mvtools_overlaps_8x4_uint32_t_uint16_t_sse2;
+            overs[Block8x8] = mvtools_overlaps_8x8_uint32_t_uint16_t_sse2;
+            overs[Block8x16] = mvtools_overlaps_8x16_uint32_t_uint16_t_sse2;
+            overs[Block8x32] = mvtools_overlaps_8x32_uint32_t_uint16_t_sse2;
+            overs[Block16x1] = mvtools_overlaps_16x1_uint32_t_uint16_t_sse2;
+            overs[Block16x2] = mvtools_overlaps_16x2_uint32_t_uint16_t_sse2;
+            overs[Block16x4] = mvtools_overlaps_16x4_uint32_t_uint16_t_sse2;
+            overs[Block16x8] = mvtools_overlaps_16x8_uint32_t_uint16_t_sse2;
+            overs[Block16x16] = mvtools_overlaps_16x16_uint32_t_uint16_t_sse2;
+            overs[Block16x32] = mvtools_overlaps_16x32_uint32_t_uint16_t_sse2;
+            overs[Block16x64] = mvtools_overlaps_16x64_uint32_t_uint16_t_sse2;
+            overs[Block32x4] = mvtools_overlaps_32x4_uint32_t_uint16_t_sse2;
+            overs[Block32x8] = mvtools_overlaps_32x8_uint32_t_uint16_t_sse2;
+            overs[Block32x16] = mvtools_overlaps_32x16_uint32_t_uint16_t_sse2;
+            overs[Block32x32] = mvtools_overlaps_32x32_uint32_t_uint16_t_sse2;
+            overs[Block32x64] = mvtools_overlaps_32x64_uint32_t_uint16_t_sse2;
+            overs[Block64x8] = mvtools_overlaps_64x8_uint32_t_uint16_t_sse2;
+            overs[Block64x16] = mvtools_overlaps_64x16_uint32_t_uint16_t_sse2;
+            overs[Block64x32] = mvtools_overlaps_64x32_uint32_t_uint16_t_sse2;
+            overs[Block64x64] = mvtools_overlaps_64x64_uint32_t_uint16_t_sse2;
+
+            d->ToPixels = ToPixels_uint32_t_uint16_t_sse2;
+#endif
+        }
     }
 
-    d->OVERSLUMA = overs[nBlkSizeX][nBlkSizeY];
-    d->BLITLUMA = copys[nBlkSizeX][nBlkSizeY];
+    const int size = findBlockSize(nBlkSizeX, nBlkSizeY);
+    const int chromaSize = findBlockSize(nBlkSizeX / xRatioUV, nBlkSizeY / yRatioUV);
+
+    d->OVERSLUMA = overs[size];
+    d->BLITLUMA = copys[size];
 
-    d->OVERSCHROMA = overs[nBlkSizeX / xRatioUV][nBlkSizeY / yRatioUV];
-    d->BLITCHROMA = copys[nBlkSizeX / xRatioUV][nBlkSizeY / yRatioUV];
+    d->OVERSCHROMA = overs[chromaSize];
+    d->BLITCHROMA = copys[chromaSize];
 }
 
 
@@ -692,6 +795,8 @@ static void VS_CC mvcompensateCreate(const VSMap *in, VSMap *out, void *userData
     d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
     d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
     d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
     for (int i = 0; i < 6; i++)
@@ -760,9 +865,6 @@ static void VS_CC mvcompensateCreate(const VSMap *in, VSMap *out, void *userData
         return;
     }
 
-    if (d.vi->format->bitsPerSample > 8)
-        d.isse = 0;
-
     if (d.vectors_data.nOverlapX || d.vectors_data.nOverlapY) {
         d.OverWins = (OverlapWindows *)malloc(sizeof(OverlapWindows));
         overInit(d.OverWins, d.vectors_data.nBlkSizeX, d.vectors_data.nBlkSizeY, d.vectors_data.nOverlapX, d.vectors_data.nOverlapY);
@@ -24,6 +24,7 @@
 
 #include "Bullshit.h"
 #include "Fakery.h"
+#include "GroupOfFramesCache.h"
 #include "MVAnalysisData.h"
 #include "MVDegrains.h"
 #include "MVFrame.h"
@@ -35,7 +36,9 @@ struct MVDegrainData {
     const VSVideoInfo *vi;
 
     VSNodeRef *super;
-    VSNodeRef *vectors[6];
+    VSNodeRef *vectors[MAX_DEGRAIN_RADIUS * 2];
+
+    int radius;
 
     int thSAD[3];
     int YUVplanes;
@@ -44,18 +47,20 @@ struct MVDegrainData {
     int nSCD2;
     int isse;
 
-    MVAnalysisData vectors_data[6];
+    MVAnalysisData vectors_data[MAX_DEGRAIN_RADIUS * 2];
 
     int nSuperHPad;
     int nSuperVPad;
     int nSuperPel;
     int nSuperModeYUV;
     int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
 
     int dstTempPitch;
 
-    OverlapsFunction OVERS[3];
     DenoiseFunction DEGRAIN[3];
+    DenoiseOverlapFunction DEGRAINOVERLAP[3];
     LimitFunction LimitChanges;
     ToPixelsFunction ToPixels;
 
@@ -86,54 +91,21 @@ static void VS_CC mvdegrainInit(VSMap *in, VSMap *out, void **instanceData, VSNo
 }
 
 
-template <int radius>
 static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, void **instanceData, void **frameData, VSFrameContext *frameCtx, VSCore *core, const VSAPI *vsapi) {
     (void)frameData;
 
     MVDegrainData *d = (MVDegrainData *)*instanceData;
 
-    if (activationReason == arInitial) {
-        if (radius > 2)
-            vsapi->requestFrameFilter(n, d->vectors[Forward3], frameCtx);
-        if (radius > 1)
-            vsapi->requestFrameFilter(n, d->vectors[Forward2], frameCtx);
-        vsapi->requestFrameFilter(n, d->vectors[Forward1], frameCtx);
-        vsapi->requestFrameFilter(n, d->vectors[Backward1], frameCtx);
-        if (radius > 1)
-            vsapi->requestFrameFilter(n, d->vectors[Backward2], frameCtx);
-        if (radius > 2)
-            vsapi->requestFrameFilter(n, d->vectors[Backward3], frameCtx);
-
-        if (radius > 2) {
-            int offF3 = -1 * d->vectors_data[Forward3].nDeltaFrame;
-            if (n + offF3 >= 0)
-                vsapi->requestFrameFilter(n + offF3, d->super, frameCtx);
-        }
-
-        if (radius > 1) {
-            int offF2 = -1 * d->vectors_data[Forward2].nDeltaFrame;
-            if (n + offF2 >= 0)
-                vsapi->requestFrameFilter(n + offF2, d->super, frameCtx);
-        }
-
-        int offF = -1 * d->vectors_data[Forward1].nDeltaFrame;
-        if (n + offF >= 0)
-            vsapi->requestFrameFilter(n + offF, d->super, frameCtx);
+    const int nRefs = d->radius * 2;
 
-        int offB = d->vectors_data[Backward1].nDeltaFrame;
-        if (n + offB < d->vi->numFrames)
-            vsapi->requestFrameFilter(n + offB, d->super, frameCtx);
-
-        if (radius > 1) {
-            int offB2 = d->vectors_data[Backward2].nDeltaFrame;
-            if (n + offB2 < d->vi->numFrames)
-                vsapi->requestFrameFilter(n + offB2, d->super, frameCtx);
-        }
+    if (activationReason == arInitial) {
+        for (int r = 0; r < nRefs; r++)
+            vsapi->requestFrameFilter(n, d->vectors[r], frameCtx);
 
-        if (radius > 2) {
-            int offB3 = d->vectors_data[Backward3].nDeltaFrame;
-            if (n + offB3 < d->vi->numFrames)
-                vsapi->requestFrameFilter(n + offB3, d->super, frameCtx);
+        for (int r = 0; r < nRefs; r++) {
+            int offset = d->vectors_data[r].nDeltaFrame * (d->vectors_data[r].isBackward ? 1 : -1);
+            if (n + offset >= 0 && n + offset < d->vi->numFrames)
+                vsapi->requestFrameFilter(n + offset, d->super, frameCtx);
         }
 
         vsapi->requestFrameFilter(n, d->node, frameCtx);
@@ -148,23 +120,23 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
         uint8_t *pDstCur[3] = { 0 };
         const uint8_t *pSrcCur[3] = { NULL };
         const uint8_t *pSrc[3] = { NULL };
-        const uint8_t *pRefs[radius * 2][3] = { { NULL } };
+        const uint8_t *pRefs[MAX_DEGRAIN_RADIUS * 2][3] = { { NULL } };
         int nDstPitches[3] = { 0 };
         int nSrcPitches[3] = { 0 };
-        int nRefPitches[radius * 2][3] = { { 0 } };
-        int isUsable[radius * 2];
+        int nRefPitches[MAX_DEGRAIN_RADIUS * 2][3] = { { 0 } };
+        int isUsable[MAX_DEGRAIN_RADIUS * 2];
         int nLogPel = (d->vectors_data[0].nPel == 4) ? 2 : (d->vectors_data[0].nPel == 2) ? 1 : 0;
 
-        FakeGroupOfPlanes fgops[radius * 2];
-        const VSFrameRef *refFrames[radius * 2] = { 0 };
+        FakeGroupOfPlanes fgops[MAX_DEGRAIN_RADIUS * 2];
+        const VSFrameRef *vectorFrames[MAX_DEGRAIN_RADIUS * 2] = { 0 };
+        const VSFrameRef *refFrames[MAX_DEGRAIN_RADIUS * 2] = { 0 };
 
-        for (int r = 0; r < radius * 2; r++) {
-            const VSFrameRef *frame = vsapi->getFrameFilter(n, d->vectors[r], frameCtx);
+        for (int r = 0; r < nRefs; r++) {
+            vectorFrames[r] = vsapi->getFrameFilter(n, d->vectors[r], frameCtx);
             fgopInit(&fgops[r], &d->vectors_data[r]);
-            const VSMap *mvprops = vsapi->getFramePropsRO(frame);
+            const VSMap *mvprops = vsapi->getFramePropsRO(vectorFrames[r]);
             fgopUpdate(&fgops[r], (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
             isUsable[r] = fgopIsUsable(&fgops[r], d->nSCD1, d->nSCD2);
-            vsapi->freeFrame(frame);
 
             if (isUsable[r]) {
                 int offset = d->vectors_data[r].nDeltaFrame * (d->vectors_data[r].isBackward ? 1 : -1);
@@ -179,7 +151,7 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
             pSrc[i] = vsapi->getReadPtr(src, i);
             nSrcPitches[i] = vsapi->getStride(src, i);
 
-            for (int r = 0; r < radius * 2; r++)
+            for (int r = 0; r < nRefs; r++)
                 if (isUsable[r]) {
                     pRefs[r][i] = vsapi->getReadPtr(refFrames[r], i);
                     nRefPitches[r][i] = vsapi->getStride(refFrames[r], i);
@@ -206,26 +178,22 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
         const int *nLimit = d->nLimit;
 
 
-        MVGroupOfFrames pRefGOF[radius * 2];
-        for (int r = 0; r < radius * 2; r++)
-            mvgofInit(&pRefGOF[r], d->nSuperLevels, nWidth[0], nHeight[0], d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, isse, xRatioUV, yRatioUV, bitsPerSample);
-
-
         OverlapWindows *OverWins[3] = { d->OverWins[0], d->OverWins[1], d->OverWins[2] };
+        // Only one row of blocks is accumulated at a time, so this stays in cache.
         uint8_t *DstTemp = NULL;
-        int tmpBlockPitch = nBlkSizeX[0] * bytesPerSample;
-        uint8_t *tmpBlock = NULL;
-        if (nOverlapX[0] > 0 || nOverlapY[0] > 0) {
-            DstTemp = new uint8_t[dstTempPitch * nHeight[0]];
-            tmpBlock = new uint8_t[tmpBlockPitch * nBlkSizeY[0]];
-        }
+        if (nOverlapX[0] > 0 || nOverlapY[0] > 0)
+            DstTemp = new uint8_t[dstTempPitch * nBlkSizeY[0]];
 
-        MVPlane **pPlanes[radius * 2] = { NULL };
+        MVGroupOfFrames *pRefGOF[MAX_DEGRAIN_RADIUS * 2] = { NULL };
+        MVPlane **pPlanes[MAX_DEGRAIN_RADIUS * 2] = { NULL };
 
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < nRefs; r++)
             if (isUsable[r]) {
-                mvgofUpdate(&pRefGOF[r], (uint8_t **)pRefs[r], nRefPitches[r]);
-                pPlanes[r] = pRefGOF[r].frames[0]->planes;
+                int err;
+                int64_t serial = vsapi->propGetInt(vsapi->getFramePropsRO(refFrames[r]), "Super_serial", 0, &err);
+
+                pRefGOF[r] = gofcAcquire(pRefs[r], nRefPitches[r], d->nSuperLevels, nWidth[0], nHeight[0], d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, serial);
+                pPlanes[r] = pRefGOF[r]->frames[0]->planes;
             }
 
 
@@ -249,19 +217,19 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
                     for (int bx = 0; bx < nBlkX; bx++) {
                         int i = by * nBlkX + bx;
 
-                        const uint8_t *pointers[radius * 2]; // Moved by the degrain function.
-                        int strides[radius * 2];
+                        const uint8_t *pointers[MAX_DEGRAIN_RADIUS * 2]; // Moved by the degrain function.
+                        int strides[MAX_DEGRAIN_RADIUS * 2];
 
-                        int WSrc, WRefs[radius * 2];
+                        int WSrc, WRefs[MAX_DEGRAIN_RADIUS * 2];
 
-                        for (int r = 0; r < radius * 2; r++)
+                        for (int r = 0; r < nRefs; r++)
                             useBlock(pointers[r], strides[r], WRefs[r], isUsable[r], &fgops[r], i, pPlanes[r], pSrcCur, xx, nSrcPitches, nLogPel, plane, xSubUV, ySubUV, thSAD);
 
-                        normaliseWeights<radius>(WSrc, WRefs);
+                        normaliseWeights(WSrc, WRefs, nRefs);
 
                         d->DEGRAIN[plane](pDstCur[plane] + xx, nDstPitches[plane], pSrcCur[plane] + xx, nSrcPitches[plane],
                                           pointers, strides,
-                                          WSrc, WRefs);
+                                          WSrc, WRefs, nRefs);
 
                         xx += nBlkSizeX[plane] * bytesPerSample;
 
@@ -279,8 +247,11 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
                                   nWidth[plane] * bytesPerSample, nHeight[plane] - nHeight_B[plane]);
                 }
             } else { // overlap
-                uint8_t *pDstTemp = DstTemp;
-                memset(pDstTemp, 0, dstTempPitch * nHeight_B[0]);
+                // The rows shared with the next row of blocks are carried over to the top of DstTemp,
+                // and the rest are converted to pixels as soon as they are complete.
+                const int nStepY = nBlkSizeY[plane] - nOverlapY[plane];
+
+                memset(DstTemp, 0, dstTempPitch * nBlkSizeY[plane]);
 
                 for (int by = 0; by < nBlkY; by++) {
                     int wby = ((by + nBlkY - 3) / (nBlkY - 2)) * 3;
@@ -292,28 +263,37 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
 
                         int i = by * nBlkX + bx;
 
-                        const uint8_t *pointers[radius * 2]; // Moved by the degrain function.
-                        int strides[radius * 2];
+                        const uint8_t *pointers[MAX_DEGRAIN_RADIUS * 2]; // Moved by the degrain function.
+                        int strides[MAX_DEGRAIN_RADIUS * 2];
 
-                        int WSrc, WRefs[radius * 2];
+                        int WSrc, WRefs[MAX_DEGRAIN_RADIUS * 2];
 
-                        for (int r = 0; r < radius * 2; r++)
+                        for (int r = 0; r < nRefs; r++)
                             useBlock(pointers[r], strides[r], WRefs[r], isUsable[r], &fgops[r], i, pPlanes[r], pSrcCur, xx, nSrcPitches, nLogPel, plane, xSubUV, ySubUV, thSAD);
 
-                        normaliseWeights<radius>(WSrc, WRefs);
+                        normaliseWeights(WSrc, WRefs, nRefs);
 
-                        d->DEGRAIN[plane](tmpBlock, tmpBlockPitch, pSrcCur[plane] + xx, nSrcPitches[plane],
-                                          pointers, strides,
-                                          WSrc, WRefs);
-                        d->OVERS[plane](pDstTemp + xx * 2, dstTempPitch, tmpBlock, tmpBlockPitch, winOver, nBlkSizeX[plane]);
+                        d->DEGRAINOVERLAP[plane](DstTemp + xx * 2, dstTempPitch, pSrcCur[plane] + xx, nSrcPitches[plane],
+                                                 pointers, strides,
+                                                 WSrc, WRefs, nRefs,
+                                                 winOver, nBlkSizeX[plane]);
 
                         xx += (nBlkSizeX[plane] - nOverlapX[plane]) * bytesPerSample;
                     }
-                    pSrcCur[plane] += (nBlkSizeY[plane] - nOverlapY[plane]) * nSrcPitches[plane];
-                    pDstTemp += (nBlkSizeY[plane] - nOverlapY[plane]) * dstTempPitch;
-                }
 
-                d->ToPixels(pDst[plane], nDstPitches[plane], DstTemp, dstTempPitch, nWidth_B[plane], nHeight_B[plane], bitsPerSample);
+                    if (by == nBlkY - 1) {
+                        d->ToPixels(pDstCur[plane], nDstPitches[plane], DstTemp, dstTempPitch, nWidth_B[plane], nBlkSizeY[plane], bitsPerSample);
+                    } else {
+                        d->ToPixels(pDstCur[plane], nDstPitches[plane], DstTemp, dstTempPitch, nWidth_B[plane], nStepY, bitsPerSample);
+
+                        // nOverlapY is at most half of nBlkSizeY, so these don't overlap.
+                        memcpy(DstTemp, DstTemp + nStepY * dstTempPitch, nOverlapY[plane] * dstTempPitch);
+                        memset(DstTemp + nOverlapY[plane] * dstTempPitch, 0, nStepY * dstTempPitch);
+                    }
+
+                    pSrcCur[plane] += nStepY * nSrcPitches[plane];
+                    pDstCur[plane] += nStepY * nDstPitches[plane];
+                }
 
                 if (nWidth_B[0] < nWidth[0])
                     vs_bitblt(pDst[plane] + nWidth_B[plane] * bytesPerSample, nDstPitches[plane],
@@ -334,19 +314,17 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
         }
 
 
-        if (tmpBlock)
-            delete[] tmpBlock;
-
         if (DstTemp)
             delete[] DstTemp;
 
-        for (int r = 0; r < radius * 2; r++) {
-            mvgofDeinit(&pRefGOF[r]);
+        for (int r = 0; r < nRefs; r++) {
+            gofcRelease(pRefGOF[r]);
 
             if (refFrames[r])
                 vsapi->freeFrame(refFrames[r]);
 
             fgopDeinit(&fgops[r]);
+            vsapi->freeFrame(vectorFrames[r]);
         }
 
         vsapi->freeFrame(src);
@@ -358,7 +336,6 @@ static const VSFrameRef *VS_CC mvdegrainGetFrame(int n, int activationReason, vo
 }
 
 
-template <int radius>
 static void VS_CC mvdegrainFree(void *instanceData, VSCore *core, const VSAPI *vsapi) {
     (void)core;
 
@@ -372,7 +349,7 @@ static void VS_CC mvdegrainFree(void *instanceData, VSCore *core, const VSAPI *v
             free(d->OverWins[1]);
         }
     }
-    for (int r = 0; r < radius * 2; r++)
+    for (int r = 0; r < d->radius * 2; r++)
         vsapi->freeNode(d->vectors[r]);
 
     vsapi->freeNode(d->super);
@@ -382,73 +359,99 @@ static void VS_CC mvdegrainFree(void *instanceData, VSCore *core, const VSAPI *v
 }
 
 
-template <int radius>
 static void selectFunctions(MVDegrainData *d) {
     const int xRatioUV = d->vectors_data[0].xRatioUV;
     const int yRatioUV = d->vectors_data[0].yRatioUV;
     const int nBlkSizeX = d->vectors_data[0].nBlkSizeX;
     const int nBlkSizeY = d->vectors_data[0].nBlkSizeY;
 
-    OverlapsFunction overs[33][33];
-    DenoiseFunction degs[33][33];
+    DenoiseFunction degs[BlockSizeCount];
+    DenoiseOverlapFunction degovers[BlockSizeCount];
 
     if (d->vi->format->bitsPerSample == 8) {
-        overs[2][2] = mvtools_overlaps_2x2_uint16_t_uint8_t_c;
-        degs[2][2] = Degrain_C<radius, 2, 2, uint8_t>;
+        degs[Block2x2] = Degrain_C<2, 2, uint8_t>;
+        degovers[Block2x2] = DegrainOverlap_C<2, 2, uint8_t, uint16_t>;
+
+        degs[Block2x4] = Degrain_C<2, 4, uint8_t>;
+        degovers[Block2x4] = DegrainOverlap_C<2, 4, uint8_t, uint16_t>;
+
+        degs[Block4x2] = Degrain_C<4, 2, uint8_t>;
+        degovers[Block4x2] = DegrainOverlap_C<4, 2, uint8_t, uint16_t>;
+
+        degs[Block4x4] = Degrain_C<4, 4, uint8_t>;
+        degovers[Block4x4] = DegrainOverlap_C<4, 4, uint8_t, uint16_t>;
+
+        degs[Block4x8] = Degrain_C<4, 8, uint8_t>;
+        degovers[Block4x8] = DegrainOverlap_C<4, 8, uint8_t, uint16_t>;
 
-        overs[2][4] = mvtools_overlaps_2x4_uint16_t_uint8_t_c;
-        degs[2][4] = Degrain_C<radius, 2, 4, uint8_t>;
+        degs[Block4x16] = Degrain_C<4, 16, uint8_t>;
+        degovers[Block4x16] = DegrainOverlap_C<4, 16, uint8_t, uint16_t>;
 
-        overs[4][2] = mvtools_overlaps_4x2_uint16_t_uint8_t_c;
-        degs[4][2] = Degrain_C<radius, 4, 2, uint8_t>;
+        degs[Block8x1] = Degrain_C<8, 1, uint8_t>;
+        degovers[Block8x1] = DegrainOverlap_C<8, 1, uint8_t, uint16_t>;
 
-        overs[4][4] = mvtools_overlaps_4x4_uint16_t_uint8_t_c;
-        degs[4][4] = Degrain_C<radius, 4, 4, uint8_t>;
+        degs[Block8x2] = Degrain_C<8, 2, uint8_t>;
+        degovers[Block8x2] = DegrainOverlap_C<8, 2, uint8_t, uint16_t>;
 
-        overs[4][8] = mvtools_overlaps_4x8_uint16_t_uint8_t_c;
-        degs[4][8] = Degrain_C<radius, 4, 8, uint8_t>;
+        degs[Block8x4] = Degrain_C<8, 4, uint8_t>;
+        degovers[Block8x4] = DegrainOverlap_C<8, 4, uint8_t, uint16_t>;
 
-        overs[8][1] = mvtools_overlaps_8x1_uint16_t_uint8_t_c;
-        degs[8][1] = Degrain_C<radius, 8, 1, uint8_t>;
+        degs[Block8x8] = Degrain_C<8, 8, uint8_t>;
+        degovers[Block8x8] = DegrainOverlap_C<8, 8, uint8_t, uint16_t>;
 
-        overs[8][2] = mvtools_overlaps_8x2_uint16_t_uint8_t_c;
-        degs[8][2] = Degrain_C<radius, 8, 2, uint8_t>;
+        degs[Block8x16] = Degrain_C<8, 16, uint8_t>;
+        degovers[Block8x16] = DegrainOverlap_C<8, 16, uint8_t, uint16_t>;
 
-        overs[8][4] = mvtools_overlaps_8x4_uint16_t_uint8_t_c;
-        degs[8][4] = Degrain_C<radius, 8, 4, uint8_t>;
+        degs[Block8x32] = Degrain_C<8, 32, uint8_t>;
+        degovers[Block8x32] = DegrainOverlap_C<8, 32, uint8_t, uint16_t>;
 
-        overs[8][8] = mvtools_overlaps_8x8_uint16_t_uint8_t_c;
-        degs[8][8] = Degrain_C<radius, 8, 8, uint8_t>;
+        degs[Block16x1] = Degrain_C<16, 1, uint8_t>;
+        degovers[Block16x1] = DegrainOverlap_C<16, 1, uint8_t, uint16_t>;
 
-        overs[8][16] = mvtools_overlaps_8x16_uint16_t_uint8_t_c;
-        degs[8][16] = Degrain_C<radius, 8, 16, uint8_t>;
+        degs[Block16x2] = Degrain_C<16, 2, uint8_t>;
+        degovers[Block16x2] = DegrainOverlap_C<16, 2, uint8_t, uint16_t>;
 
-        overs[16][1] = mvtools_overlaps_16x1_uint16_t_uint8_t_c;
-        degs[16][1] = Degrain_C<radius, 16, 1, uint8_t>;
+        degs[Block16x4] = Degrain_C<16, 4, uint8_t>;
+        degovers[Block16x4] = DegrainOverlap_C<16, 4, uint8_t, uint16_t>;
 
-        overs[16][2] = mvtools_overlaps_16x2_uint16_t_uint8_t_c;
-        degs[16][2] = Degrain_C<radius, 16, 2, uint8_t>;
+        degs[Block16x8] = Degrain_C<16, 8, uint8_t>;
+        degovers[Block16x8] = DegrainOverlap_C<16, 8, uint8_t, uint16_t>;
 
-        overs[16][4] = mvtools_overlaps_16x4_uint16_t_uint8_t_c;
-        degs[16][4] = Degrain_C<radius, 16, 4, uint8_t>;
+        degs[Block16x16] = Degrain_C<16, 16, uint8_t>;
+        degovers[Block16x16] = DegrainOverlap_C<16, 16, uint8_t, uint16_t>;
 
-        overs[16][8] = mvtools_overlaps_16x8_uint16_t_uint8_t_c;
-        degs[16][8] = Degrain_C<radius, 16, 8, uint8_t>;
+        degs[Block16x32] = Degrain_C<16, 32, uint8_t>;
+        degovers[Block16x32] = DegrainOverlap_C<16, 32, uint8_t, uint16_t>;
 
-        overs[16][16] = mvtools_overlaps_16x16_uint16_t_uint8_t_c;
-        degs[16][16] = Degrain_C<radius, 16, 16, uint8_t>;
+        degs[Block16x64] = Degrain_C<16, 64, uint8_t>;
+        degovers[Block16x64] = DegrainOverlap_C<16, 64, uint8_t, uint16_t>;
 
-        overs[16][32] = mvtools_overlaps_16x32_uint16_t_uint8_t_c;
-        degs[16][32] = Degrain_C<radius, 16, 32, uint8_t>;
+        degs[Block32x4] = Degrain_C<32, 4, uint8_t>;
+        degovers[Block32x4] = DegrainOverlap_C<32, 4, uint8_t, uint16_t>;
 
-        overs[32][8] = mvtools_overlaps_32x8_uint16_t_uint8_t_c;
-        degs[32][8] = Degrain_C<radius, 32, 8, uint8_t>;
+        degs[Block32x8] = Degrain_C<32, 8, uint8_t>;
+        degovers[Block32x8] = DegrainOverlap_C<32, 8, uint8_t, uint16_t>;
 
-        overs[32][16] = mvtools_overlaps_32x16_uint16_t_uint8_t_c;
-        degs[32][16] = Degrain_C<radius, 32, 16, uint8_t>;
+        degs[Block32x16] = Degrain_C<32, 16, uint8_t>;
+        degovers[Block32x16] = DegrainOverlap_C<32, 16, uint8_t, uint16_t>;
 
-        overs[32][32] = mvtools_overlaps_32x32_uint16_t_uint8_t_c;
-        degs[32][32] = Degrain_C<radius, 32, 32, uint8_t>;
+        degs[Block32x32] = Degrain_C<32, 32, uint8_t>;
+        degovers[Block32x32] = DegrainOverlap_C<32, 32, uint8_t, uint16_t>;
+
+        degs[Block32x64] = Degrain_C<32, 64, uint8_t>;
+        degovers[Block32x64] = DegrainOverlap_C<32, 64, uint8_t, uint16_t>;
+
+        degs[Block64x8] = Degrain_C<64, 8, uint8_t>;
+        degovers[Block64x8] = DegrainOverlap_C<64, 8, uint8_t, uint16_t>;
+
+        degs[Block64x16] = Degrain_C<64, 16, uint8_t>;
+        degovers[Block64x16] = DegrainOverlap_C<64, 16, uint8_t, uint16_t>;
+
+        degs[Block64x32] = Degrain_C<64, 32, uint8_t>;
+        degovers[Block64x32] = DegrainOverlap_C<64, 32, uint8_t, uint16_t>;
+
+        degs[Block64x64] = Degrain_C<64, 64, uint8_t>;
+        degovers[Block64x64] = DegrainOverlap_C<64, 64, uint8_t, uint16_t>;
 
         d->LimitChanges = LimitChanges_C<uint8_t>;
 
@@ -456,143 +459,302 @@ static void selectFunctions(MVDegrainData *d) {
 
         if (d->isse) {
 #if defined(MVTOOLS_X86)
-            overs[4][2] = mvtools_overlaps_4x2_sse2;
-            degs[4][2] = Degrain_sse2<radius, 4, 2>;
+            degs[Block4x2] = Degrain_sse2<4, 2>;
+            degovers[Block4x2] = DegrainOverlap_sse2<4, 2>;
+
+            degs[Block4x4] = Degrain_sse2<4, 4>;
+            degovers[Block4x4] = DegrainOverlap_sse2<4, 4>;
+
+            degs[Block4x8] = Degrain_sse2<4, 8>;
+            degovers[Block4x8] = DegrainOverlap_sse2<4, 8>;
+
+            degs[Block4x16] = Degrain_sse2<4, 16>;
+            degovers[Block4x16] = DegrainOverlap_sse2<4, 16>;
+
+            degs[Block8x1] = Degrain_sse2<8, 1>;
+            degovers[Block8x1] = DegrainOverlap_sse2<8, 1>;
+
+            degs[Block8x2] = Degrain_sse2<8, 2>;
+            degovers[Block8x2] = DegrainOverlap_sse2<8, 2>;
+
+            degs[Block8x4] = Degrain_sse2<8, 4>;
+            degovers[Block8x4] = DegrainOverlap_sse2<8, 4>;
+
+            degs[Block8x8] = Degrain_sse2<8, 8>;
+            degovers[Block8x8] = DegrainOverlap_sse2<8, 8>;
+
+            degs[Block8x16] = Degrain_sse2<8, 16>;
+            degovers[Block8x16] = DegrainOverlap_sse2<8, 16>;
+
+            degs[Block8x32] = Degrain_sse2<8, 32>;
+            degovers[Block8x32] = DegrainOverlap_sse2<8, 32>;
 
-            overs[4][4] = mvtools_overlaps_4x4_sse2;
-            degs[4][4] = Degrain_sse2<radius, 4, 4>;
+            degs[Block16x1] = Degrain_sse2<16, 1>;
+            degovers[Block16x1] = DegrainOverlap_sse2<16, 1>;
 
-            overs[4][8] = mvtools_overlaps_4x8_sse2;
-            degs[4][8] = Degrain_sse2<radius, 4, 8>;
+            degs[Block16x2] = Degrain_sse2<16, 2>;
+            degovers[Block16x2] = DegrainOverlap_sse2<16, 2>;
 
-            overs[8][1] = mvtools_overlaps_8x1_sse2;
-            degs[8][1] = Degrain_sse2<radius, 8, 1>;
+            degs[Block16x4] = Degrain_sse2<16, 4>;
+            degovers[Block16x4] = DegrainOverlap_sse2<16, 4>;
 
-            overs[8][2] = mvtools_overlaps_8x2_sse2;
-            degs[8][2] = Degrain_sse2<radius, 8, 2>;
+            degs[Block16x8] = Degrain_sse2<16, 8>;
+            degovers[Block16x8] = DegrainOverlap_sse2<16, 8>;
 
-            overs[8][4] = mvtools_overlaps_8x4_sse2;
-            degs[8][4] = Degrain_sse2<radius, 8, 4>;
+            degs[Block16x16] = Degrain_sse2<16, 16>;
+            degovers[Block16x16] = DegrainOverlap_sse2<16, 16>;
 
-            overs[8][8] = mvtools_overlaps_8x8_sse2;
-            degs[8][8] = Degrain_sse2<radius, 8, 8>;
+            degs[Block16x32] = Degrain_sse2<16, 32>;
+            degovers[Block16x32] = DegrainOverlap_sse2<16, 32>;
 
-            overs[8][16] = mvtools_overlaps_8x16_sse2;
-            degs[8][16] = Degrain_sse2<radius, 8, 16>;
+            degs[Block16x64] = Degrain_sse2<16, 64>;
+            degovers[Block16x64] = DegrainOverlap_sse2<16, 64>;
 
-            overs[16][1] = mvtools_overlaps_16x1_sse2;
-            degs[16][1] = Degrain_sse2<radius, 16, 1>;
+            degs[Block32x4] = Degrain_sse2<32, 4>;
+            degovers[Block32x4] = DegrainOverlap_sse2<32, 4>;
 
-            overs[16][2] = mvtools_overlaps_16x2_sse2;
-            degs[16][2] = Degrain_sse2<radius, 16, 2>;
+            degs[Block32x8] = Degrain_sse2<32, 8>;
+            degovers[Block32x8] = DegrainOverlap_sse2<32, 8>;
 
-            overs[16][4] = mvtools_overlaps_16x4_sse2;
-            degs[16][4] = Degrain_sse2<radius, 16, 4>;
+            degs[Block32x16] = Degrain_sse2<32, 16>;
+            degovers[Block32x16] = DegrainOverlap_sse2<32, 16>;
 
-            overs[16][8] = mvtools_overlaps_16x8_sse2;
-            degs[16][8] = Degrain_sse2<radius, 16, 8>;
+            degs[Block32x32] = Degrain_sse2<32, 32>;
+            degovers[Block32x32] = DegrainOverlap_sse2<32, 32>;
 
-            overs[16][16] = mvtools_overlaps_16x16_sse2;
-            degs[16][16] = Degrain_sse2<radius, 16, 16>;
+            degs[Block32x64] = Degrain_sse2<32, 64>;
+            degovers[Block32x64] = DegrainOverlap_sse2<32, 64>;
 
-            overs[16][32] = mvtools_overlaps_16x32_sse2;
-            degs[16][32] = Degrain_sse2<radius, 16, 32>;
+            degs[Block64x8] = Degrain_sse2<64, 8>;
+            degovers[Block64x8] = DegrainOverlap_sse2<64, 8>;
 
-            overs[32][8] = mvtools_overlaps_32x8_sse2;
-            degs[32][8] = Degrain_sse2<radius, 32, 8>;
+            degs[Block64x16] = Degrain_sse2<64, 16>;
+            degovers[Block64x16] = DegrainOverlap_sse2<64, 16>;
 
-            overs[32][16] = mvtools_overlaps_32x16_sse2;
-            degs[32][16] = Degrain_sse2<radius, 32, 16>;
+            degs[Block64x32] = Degrain_sse2<64, 32>;
+            degovers[Block64x32] = DegrainOverlap_sse2<64, 32>;
 
-            overs[32][32] = mvtools_overlaps_32x32_sse2;
-            degs[32][32] = Degrain_sse2<radius, 32, 32>;
+            degs[Block64x64] = Degrain_sse2<64, 64>;
+            degovers[Block64x64] = DegrainOverlap_sse2<64, 64>;
 
             d->LimitChanges = mvtools_LimitChanges_sse2;
 #endif
         }
     } else {
-        overs[2][2] = mvtools_overlaps_2x2_uint32_t_uint16_t_c;
-        degs[2][2] = Degrain_C<radius, 2, 2, uint16_t>;
+        degs[Block2x2] = Degrain_C<2, 2, uint16_t>;
+        degovers[Block2x2] = DegrainOverlap_C<2, 2, uint16_t, uint32_t>;
 
-        overs[2][4] = mvtools_overlaps_2x4_uint32_t_uint16_t_c;
-        degs[2][4] = Degrain_C<radius, 2, 4, uint16_t>;
+        degs[Block2x4] = Degrain_C<2, 4, uint16_t>;
+        degovers[Block2x4] = DegrainOverlap_C<2, 4, uint16_t, uint32_t>;
 
-        overs[4][2] = mvtools_overlaps_4x2_uint32_t_uint16_t_c;
-        degs[4][2] = Degrain_C<radius, 4, 2, uint16_t>;
+        degs[Block4x2] = Degrain_C<4, 2, uint16_t>;
+        degovers[Block4x2] = DegrainOverlap_C<4, 2, uint16_t, uint32_t>;
 
-        overs[4][4] = mvtools_overlaps_4x4_uint32_t_uint16_t_c;
-        degs[4][4] = Degrain_C<radius, 4, 4, uint16_t>;
+        degs[Block4x4] = Degrain_C<4, 4, uint16_t>;
+        degovers[Block4x4] = DegrainOverlap_C<4, 4, uint16_t, uint32_t>;
 
-        overs[4][8] = mvtools_overlaps_4x8_uint32_t_uint16_t_c;
-        degs[4][8] = Degrain_C<radius, 4, 8, uint16_t>;
+        degs[Block4x8] = Degrain_C<4, 8, uint16_t>;
+        degovers[Block4x8] = DegrainOverlap_C<4, 8, uint16_t, uint32_t>;
 
-        overs[8][1] = mvtools_overlaps_8x1_uint32_t_uint16_t_c;
-        degs[8][1] = Degrain_C<radius, 8, 1, uint16_t>;
+        degs[Block4x16] = Degrain_C<4, 16, uint16_t>;
+        degovers[Block4x16] = DegrainOverlap_C<4, 16, uint16_t, uint32_t>;
 
-        overs[8][2] = mvtools_overlaps_8x2_uint32_t_uint16_t_c;
-        degs[8][2] = Degrain_C<radius, 8, 2, uint16_t>;
+        degs[Block8x1] = Degrain_C<8, 1, uint16_t>;
+        degovers[Block8x1] = DegrainOverlap_C<8, 1, uint16_t, uint32_t>;
 
-        overs[8][4] = mvtools_overlaps_8x4_uint32_t_uint16_t_c;
-        degs[8][4] = Degrain_C<radius, 8, 4, uint16_t>;
+        degs[Block8x2] = Degrain_C<8, 2, uint16_t>;
+        degovers[Block8x2] = DegrainOverlap_C<8, 2, uint16_t, uint32_t>;
 
-        overs[8][8] = mvtools_overlaps_8x8_uint32_t_uint16_t_c;
-        degs[8][8] = Degrain_C<radius, 8, 8, uint16_t>;
+        degs[Block8x4] = Degrain_C<8, 4, uint16_t>;
+        degovers[Block8x4] = DegrainOverlap_C<8, 4, uint16_t, uint32_t>;
 
-        overs[8][16] = mvtools_overlaps_8x16_uint32_t_uint16_t_c;
-        degs[8][16] = Degrain_C<radius, 8, 16, uint16_t>;
+        degs[Block8x8] = Degrain_C<8, 8, uint16_t>;
+        degovers[Block8x8] = DegrainOverlap_C<8, 8, uint16_t, uint32_t>;
 
-        overs[16][1] = mvtools_overlaps_16x1_uint32_t_uint16_t_c;
-        degs[16][1] = Degrain_C<radius, 16, 1, uint16_t>;
+        degs[Block8x16] = Degrain_C<8, 16, uint16_t>;
+        degovers[Block8x16] = DegrainOverlap_C<8, 16, uint16_t, uint32_t>;
 
-        overs[16][2] = mvtools_overlaps_16x2_uint32_t_uint16_t_c;
-        degs[16][2] = Degrain_C<radius, 16, 2, uint16_t>;
+        degs[Block8x32] = Degrain_C<8, 32, uint16_t>;
+        degovers[Block8x32] = DegrainOverlap_C<8, 32, uint16_t, uint32_t>;
 
-        overs[16][4] = mvtools_overlaps_16x4_uint32_t_uint16_t_c;
-        degs[16][4] = Degrain_C<radius, 16, 4, uint16_t>;
+        degs[Block16x1] = Degrain_C<16, 1, uint16_t>;
+        degovers[Block16x1] = DegrainOverlap_C<16, 1, uint16_t, uint32_t>;
 
-        overs[16][8] = mvtools_overlaps_16x8_uint32_t_uint16_t_c;
-        degs[16][8] = Degrain_C<radius, 16, 8, uint16_t>;
+        degs[Block16x2] = Degrain_C<16, 2, uint16_t>;
+        degovers[Block16x2] = DegrainOverlap_C<16, 2, uint16_t, uint32_t>;
 
-        overs[16][16] = mvtools_overlaps_16x16_uint32_t_uint16_t_c;
-        degs[16][16] = Degrain_C<radius, 16, 16, uint16_t>;
+        degs[Block16x4] = Degrain_C<16, 4, uint16_t>;
+        degovers[Block16x4] = DegrainOverlap_C<16, 4, uint16_t, uint32_t>;
 
-        overs[16][32] = mvtools_overlaps_16x32_uint32_t_uint16_t_c;
-        degs[16][32] = Degrain_C<radius, 16, 32, uint16_t>;
+        degs[Block16x8] = Degrain_C<16, 8, uint16_t>;
+        degovers[Block16x8] = DegrainOverlap_C<16, 8, uint16_t, uint32_t>;
 
-        overs[32][8] = mvtools_overlaps_32x8_uint32_t_uint16_t_c;
-        degs[32][8] = Degrain_C<radius, 32, 8, uint16_t>;
+        degs[Block16x16] = Degrain_C<16, 16, uint16_t>;
+        degovers[Block16x16] = DegrainOverlap_C<16, 16, uint16_t, uint32_t>;
 
-        overs[32][16] = mvtools_overlaps_32x16_uint32_t_uint16_t_c;
-        degs[32][16] = Degrain_C<radius, 32, 16, uint16_t>;
+        degs[Block16x32] = Degrain_C<16, 32, uint16_t>;
+        degovers[Block16x32] = DegrainOverlap_C<16, 32, uint16_t, uint32_t>;
 
-        overs[32][32] = mvtools_overlaps_32x32_uint32_t_uint16_t_c;
-        degs[32][32] = Degrain_C<radius, 32, 32, uint16_t>;
+        degs[Block16x64] = Degrain_C<16, 64, uint16_t>;
+        degovers[Block16x64] = DegrainOverlap_C<16, 64, uint16_t, uint32_t>;
+
+        degs[Block32x4] = Degrain_C<32, 4, uint16_t>;
+        degovers[Block32x4] = DegrainOverlap_C<32, 4, uint16_t, uint32_t>;
+
+        degs[Block32x8] = Degrain_C<32, 8, uint16_t>;
+        degovers[Block32x8] = DegrainOverlap_C<32, 8, uint16_t, uint32_t>;
+
+        degs[Block32x16] = Degrain_C<32, 16, uint16_t>;
+        degovers[Block32x16] = DegrainOverlap_C<32, 16, uint16_t, uint32_t>;
+
+        degs[Block32x32] = Degrain_C<32, 32, uint16_t>;
+        degovers[Block32x32] = DegrainOverlap_C<32, 32, uint16_t, uint32_t>;
+
+        degs[Block32x64] = Degrain_C<32, 64, uint16_t>;
+        degovers[Block32x64] = DegrainOverlap_C<32, 64, uint16_t, uint32_t>;
+
+        degs[Block64x8] = Degrain_C<64, 8, uint16_t>;
+        degovers[Block64x8] = DegrainOverlap_C<64, 8, uint16_t, uint32_t>;
+
+        degs[Block64x16] = Degrain_C<64, 16, uint16_t>;
+        degovers[Block64x16] = DegrainOverlap_C<64, 16, uint16_t, uint32_t>;
+
+        degs[Block64x32] = Degrain_C<64, 32, uint16_t>;
+        degovers[Block64x32] = DegrainOverlap_C<64, 32, uint16_t, uint32_t>;
+
+        degs[Block64x64] = Degrain_C<64, 64, uint16_t>;
+        degovers[Block64x64] = DegrainOverlap_C<64, 64, uint16_t, uint32_t>;
 
         d->LimitChanges = LimitChanges_C<uint16_t>;
 
         d->ToPixels = ToPixels_uint32_t_uint16_t;
+
+        if (d->isse) {
+#if defined(MVTOOLS_X86)
+            degs[Block4x2] = Degrain_u16_sse2<4, 2>;
+            degovers[Block4x2] = DegrainOverlap_u16_sse2<4, 2>;
+
+            degs[Block4x4] = Degrain_u16_sse2<4, 4>;
+            degovers[Block4x4] = DegrainOverlap_u16_sse2<4, 4>;
+
+            degs[Block4x8] = Degrain_u16_sse2<4, 8>;
+            degovers[Block4x8] = DegrainOverlap_u16_sse2<4, 8>;
+
+            degs[Block4x16] = Degrain_u16_sse2<4, 16>;
+            degovers[Block4x16] = DegrainOverlap_u16_sse2<4, 16>;
+
+            degs[Block8x1] = Degrain_u16_sse2<8, 1>;
+            degovers[Block8x1] = DegrainOverlap_u16_sse2<8, 1>;
+
+            degs[Block8x2] = Degrain_u16_sse2<8, 2>;
+            degovers[Block8x2] = DegrainOverlap_u16_sse2<8, 2>;
+
+            degs[Block8x4] = Degrain_u16_sse2<8, 4>;
+            degovers[Block8x4] = DegrainOverlap_u16_sse2<8, 4>;
+
+            degs[Block8x8] = Degrain_u16_sse2<8, 8>;
+            degovers[Block8x8] = DegrainOverlap_u16_sse2<8, 8>;
+
+            degs[Block8x16] = Degrain_u16_sse2<8, 16>;
+            degovers[Block8x16] = DegrainOverlap_u16_sse2<8, 16>;
+
+            degs[Block8x32] = Degrain_u16_sse2<8, 32>;
+            degovers[Block8x32] = DegrainOverlap_u16_sse2<8, 32>;
+
+            degs[Block16x1] = Degrain_u16_sse2<16, 1>;
+            degovers[Block16x1] = DegrainOverlap_u16_sse2<16, 1>;
+
+            degs[Block16x2] = Degrain_u16_sse2<16, 2>;
+            degovers[Block16x2] = DegrainOverlap_u16_sse2<16, 2>;
+
+            degs[Block16x4] = Degrain_u16_sse2<16, 4>;
+            degovers[Block16x4] = DegrainOverlap_u16_sse2<16, 4>;
+
+            degs[Block16x8] = Degrain_u16_sse2<16, 8>;
+            degovers[Block16x8] = DegrainOverlap_u16_sse2<16, 8>;
+
+            degs[Block16x16] = Degrain_u16_sse2<16, 16>;
+            degovers[Block16x16] = DegrainOverlap_u16_sse2<16, 16>;
+
+            degs[Block16x32] = Degrain_u16_sse2<16, 32>;
+            degovers[Block16x32] = DegrainOverlap_u16_sse2<16, 32>;
+
+            degs[Block16x64] = Degrain_u16_sse2<16, 64>;
+            degovers[Block16x64] = DegrainOverlap_u16_sse2<16, 64>;
+
+            degs[Block32x4] = Degrain_u16_sse2<32, 4>;
+            degovers[Block32x4] = DegrainOverlap_u16_sse2<32, 4>;
+
+            degs[Block32x8] = Degrain_u16_sse2<32, 8>;
+            degovers[Block32x8] = DegrainOverlap_u16_sse2<32, 8>;
+
+            degs[Block32x16] = Degrain_u16_sse2<32, 16>;
+            degovers[Block32x16] = DegrainOverlap_u16_sse2<32, 16>;
+
+            degs[Block32x32] = Degrain_u16_sse2<32, 32>;
+            degovers[Block32x32] = DegrainOverlap_u16_sse2<32, 32>;
+
+            degs[Block32x64] = Degrain_u16_sse2<32, 64>;
+            degovers[Block32x64] = DegrainOverlap_u16_sse2<32, 64>;
+
+            degs[Block64x8] = Degrain_u16_sse2<64, 8>;
+            degovers[Block64x8] = DegrainOverlap_u16_sse2<64, 8>;
+
+            degs[Block64x16] = Degrain_u16_sse2<64, 16>;
+            degovers[Block64x16] = DegrainOverlap_u16_sse2<64, 16>;
+
+            degs[Block64x32] = Degrain_u16_sse2<64, 32>;
+            degovers[Block64x32] = DegrainOverlap_u16_sse2<64, 32>;
+
+            degs[Block64x64] = Degrain_u16_sse2<64, 64>;
+            degovers[Block64x64] = DegrainOverlap_u16_sse2<64, 64>;
+
+            d->LimitChanges = LimitChanges_u16_sse2;
+
+            d->ToPixels = ToPixels_uint32_t_uint16_t_sse2;
+#endif
+        }
     }
 
-    d->OVERS[0] = overs[nBlkSizeX][nBlkSizeY];
-    d->DEGRAIN[0] = degs[nBlkSizeX][nBlkSizeY];
+    const int size = findBlockSize(nBlkSizeX, nBlkSizeY);
+    const int chromaSize = findBlockSize(nBlkSizeX / xRatioUV, nBlkSizeY / yRatioUV);
 
-    d->OVERS[1] = d->OVERS[2] = overs[nBlkSizeX / xRatioUV][nBlkSizeY / yRatioUV];
-    d->DEGRAIN[1] = d->DEGRAIN[2] = degs[nBlkSizeX / xRatioUV][nBlkSizeY / yRatioUV];
+    d->DEGRAIN[0] = degs[size];
+    d->DEGRAINOVERLAP[0] = degovers[size];
+
+    d->DEGRAIN[1] = d->DEGRAIN[2] = degs[chromaSize];
+    d->DEGRAINOVERLAP[1] = d->DEGRAINOVERLAP[2] = degovers[chromaSize];
 }
 
 
+// radius is 0 for DegrainN, which takes the vector clips as arrays.
 template <int radius>
 static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, VSCore *core, const VSAPI *vsapi) {
     (void)userData;
 
     std::string filter = "Degrain";
-    filter.append(std::to_string(radius));
+    filter.append(radius ? std::to_string(radius) : "N");
 
     MVDegrainData d;
     MVDegrainData *data;
 
     int err;
 
+    d.radius = radius;
+    if (!radius) {
+        d.radius = vsapi->propNumElements(in, "mvbw");
+
+        if (d.radius != vsapi->propNumElements(in, "mvfw")) {
+            vsapi->setError(out, (filter + ": mvbw and mvfw must contain the same number of clips.").c_str());
+            return;
+        }
+
+        if (d.radius < 1 || d.radius > MAX_DEGRAIN_RADIUS) {
+            vsapi->setError(out, (filter + ": mvbw and mvfw must contain between 1 and " + std::to_string(MAX_DEGRAIN_RADIUS) + " clips.").c_str());
+            return;
+        }
+    }
+
     d.thSAD[0] = int64ToIntS(vsapi->propGetInt(in, "thsad", 0, &err));
     if (err)
         d.thSAD[0] = 400;
@@ -644,6 +806,8 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
     d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
     d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
     d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
     for (int i = 0; i < 6; i++)
@@ -658,25 +822,38 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
 
     char error[ERROR_SIZE + 1] = { 0 };
 
-    const char *vector_names[] = { "mvbw", "mvfw", "mvbw2", "mvfw2", "mvbw3", "mvfw3" };
+    // mvbw, mvfw, mvbw2, mvfw2, etc, in the same order as VectorOrder.
+    // DegrainN's are mvbw[0], mvfw[0], mvbw[1], etc.
+    std::string vector_names[MAX_DEGRAIN_RADIUS * 2];
+
+    for (int r = 0; r < d.radius * 2; r++) {
+        vector_names[r] = r % 2 ? "mvfw" : "mvbw";
+
+        if (radius) {
+            if (r >= 2)
+                vector_names[r].append(std::to_string(r / 2 + 1));
 
-    for (int r = 0; r < radius * 2; r++) {
-        d.vectors[r] = vsapi->propGetNode(in, vector_names[r], 0, NULL);
+            d.vectors[r] = vsapi->propGetNode(in, vector_names[r].c_str(), 0, NULL);
+        } else {
+            d.vectors[r] = vsapi->propGetNode(in, vector_names[r].c_str(), r / 2, NULL);
 
-        adataFromVectorClip(&d.vectors_data[r], d.vectors[r], filter.c_str(), vector_names[r], vsapi, error, ERROR_SIZE);
+            vector_names[r].append("[" + std::to_string(r / 2) + "]");
+        }
+
+        adataFromVectorClip(&d.vectors_data[r], d.vectors[r], filter.c_str(), vector_names[r].c_str(), vsapi, error, ERROR_SIZE);
     }
 
     int nSCD1_old = d.nSCD1;
     scaleThSCD(&d.nSCD1, &d.nSCD2, &d.vectors_data[0], filter.c_str(), error, ERROR_SIZE);
 
-    for (int r = 1; r < radius * 2; r++)
-        adataCheckSimilarity(&d.vectors_data[0], &d.vectors_data[r], filter.c_str(), vector_names[0], vector_names[r], error, ERROR_SIZE);
+    for (int r = 1; r < d.radius * 2; r++)
+        adataCheckSimilarity(&d.vectors_data[0], &d.vectors_data[r], filter.c_str(), vector_names[0].c_str(), vector_names[r].c_str(), error, ERROR_SIZE);
 
     if (error[0]) {
         vsapi->setError(out, error);
 
         vsapi->freeNode(d.super);
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < d.radius * 2; r++)
             vsapi->freeNode(d.vectors[r]);
 
         return;
@@ -686,31 +863,14 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
     error[0] = '\0';
 
     // Make sure the motion vector clips are correct.
-    if (!d.vectors_data[Backward1].isBackward)
-        snprintf(error, ERROR_SIZE, "%s", "mvbw must be generated with isb=True.");
-    if (d.vectors_data[Forward1].isBackward)
-        snprintf(error, ERROR_SIZE, "%s", "mvfw must be generated with isb=False.");
-    if (radius > 1) {
-        if (!d.vectors_data[Backward2].isBackward)
-            snprintf(error, ERROR_SIZE, "%s", "mvbw2 must be generated with isb=True.");
-        if (d.vectors_data[Forward2].isBackward)
-            snprintf(error, ERROR_SIZE, "%s", "mvfw2 must be generated with isb=False.");
-
-        if (d.vectors_data[Backward2].nDeltaFrame <= d.vectors_data[Backward1].nDeltaFrame)
-            snprintf(error, ERROR_SIZE, "%s", "mvbw2 must have greater delta than mvbw.");
-        if (d.vectors_data[Forward2].nDeltaFrame <= d.vectors_data[Forward1].nDeltaFrame)
-            snprintf(error, ERROR_SIZE, "%s", "mvfw2 must have greater delta than mvfw.");
-    }
-    if (radius > 2) {
-        if (!d.vectors_data[Backward3].isBackward)
-            snprintf(error, ERROR_SIZE, "%s", "mvbw3 must be generated with isb=True.");
-        if (d.vectors_data[Forward3].isBackward)
-            snprintf(error, ERROR_SIZE, "%s", "mvfw3 must be generated with isb=False.");
-
-        if (d.vectors_data[Backward3].nDeltaFrame <= d.vectors_data[Backward2].nDeltaFrame)
-            snprintf(error, ERROR_SIZE, "%s", "mvbw3 must have greater delta than mvbw2.");
-        if (d.vectors_data[Forward3].nDeltaFrame <= d.vectors_data[Forward2].nDeltaFrame)
-            snprintf(error, ERROR_SIZE, "%s", "mvfw3 must have greater delta than mvfw2.");
+    for (int r = 0; r < d.radius * 2; r++) {
+        int isBackward = r % 2 == Backward1;
+
+        if (!!d.vectors_data[r].isBackward != isBackward)
+            snprintf(error, ERROR_SIZE, "%s must be generated with isb=%s.", vector_names[r].c_str(), isBackward ? "True" : "False");
+
+        if (r >= 2 && d.vectors_data[r].nDeltaFrame <= d.vectors_data[r - 2].nDeltaFrame)
+            snprintf(error, ERROR_SIZE, "%s must have greater delta than %s.", vector_names[r].c_str(), vector_names[r - 2].c_str());
     }
 
 #undef ERROR_SIZE
@@ -719,7 +879,7 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
         vsapi->setError(out, (filter + ": " + error).c_str());
         vsapi->freeNode(d.super);
 
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < d.radius * 2; r++)
             vsapi->freeNode(d.vectors[r]);
 
         return;
@@ -741,7 +901,7 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.node);
 
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < d.radius * 2; r++)
             vsapi->freeNode(d.vectors[r]);
 
         return;
@@ -752,15 +912,12 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.node);
 
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < d.radius * 2; r++)
             vsapi->freeNode(d.vectors[r]);
 
         return;
     }
 
-    if (d.vi->format->bitsPerSample > 8)
-        d.isse = 0;
-
     int pixelMax = (1 << d.vi->format->bitsPerSample) - 1;
 
     d.nLimit[0] = int64ToIntS(vsapi->propGetInt(in, "limit", 0, &err));
@@ -777,7 +934,7 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.node);
 
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < d.radius * 2; r++)
             vsapi->freeNode(d.vectors[r]);
 
         return;
@@ -789,7 +946,7 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.node);
 
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < d.radius * 2; r++)
             vsapi->freeNode(d.vectors[r]);
 
         return;
@@ -841,13 +998,13 @@ static void VS_CC mvdegrainCreate(const VSMap *in, VSMap *out, void *userData, V
         }
     }
 
-    selectFunctions<radius>(&d);
+    selectFunctions(&d);
 
 
     data = (MVDegrainData *)malloc(sizeof(d));
     *data = d;
 
-    vsapi->createFilter(in, out, filter.c_str(), mvdegrainInit, mvdegrainGetFrame<radius>, mvdegrainFree<radius>, fmParallel, 0, data, core);
+    vsapi->createFilter(in, out, filter.c_str(), mvdegrainInit, mvdegrainGetFrame, mvdegrainFree, fmParallel, 0, data, core);
 }
 
 
@@ -900,4 +1057,18 @@ extern "C" void mvdegrainsRegister(VSRegisterFunction registerFunc, VSPlugin *pl
                  "thscd2:int:opt;"
                  "isse:int:opt;",
                  mvdegrainCreate<3>, 0, plugin);
+    registerFunc("DegrainN",
+                 "clip:clip;"
+                 "super:clip;"
+                 "mvbw:clip[];"
+                 "mvfw:clip[];"
+                 "thsad:int:opt;"
+                 "thsadc:int:opt;"
+                 "plane:int:opt;"
+                 "limit:int:opt;"
+                 "limitc:int:opt;"
+                 "thscd1:int:opt;"
+                 "thscd2:int:opt;"
+                 "isse:int:opt;",
+                 mvdegrainCreate<0>, 0, plugin);
 }
@@ -7,6 +7,10 @@
 #include "Fakery.h"
 #include "MVFrame.h"
 
+#define MAX_DEGRAIN_RADIUS 12
+
+
+// Backward and forward vectors alternate, with increasing deltas, up to MAX_DEGRAIN_RADIUS * 2.
 enum VectorOrder {
     Backward1 = 0,
     Forward1,
@@ -17,13 +21,17 @@ enum VectorOrder {
 };
 
 
-typedef void (*DenoiseFunction)(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **_pRefs, const int *nRefPitches, int WSrc, const int *WRefs);
+typedef void (*DenoiseFunction)(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **_pRefs, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs);
+
+// Degrains a block and adds it to the overlap buffer, weighted by the window,
+// so the result never goes through an intermediate block.
+typedef void (*DenoiseOverlapFunction)(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **_pRefs, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs, const int16_t *pWin, int nWinPitch);
 
 
 // XXX Moves the pointers passed in pRefs. This is okay because they are not
 // used after this function is done with them.
-template <int radius, int blockWidth, int blockHeight, typename PixelType>
-void Degrain_C(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, const uint8_t **pRefs8, const int *nRefPitches, int WSrc, const int *WRefs) {
+template <int blockWidth, int blockHeight, typename PixelType>
+void Degrain_C(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, const uint8_t **pRefs8, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs) {
     for (int y = 0; y < blockHeight; y++) {
         for (int x = 0; x < blockWidth; x++) {
             const PixelType *pSrc = (const PixelType *)pSrc8;
@@ -31,7 +39,7 @@ void Degrain_C(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitc
 
             int sum = 128 + pSrc[x] * WSrc;
 
-            for (int r = 0; r < radius * 2; r++) {
+            for (int r = 0; r < nRefs; r++) {
                 const PixelType *pRef = (const PixelType *)pRefs8[r];
                 sum += pRef[x] * WRefs[r];
             }
@@ -41,7 +49,37 @@ void Degrain_C(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitc
 
         pDst8 += nDstPitch;
         pSrc8 += nSrcPitch;
-        for (int r = 0; r < radius * 2; r++)
+        for (int r = 0; r < nRefs; r++)
+            pRefs8[r] += nRefPitches[r];
+    }
+}
+
+
+// XXX Moves the pointers passed in pRefs. This is okay because they are not
+// used after this function is done with them.
+template <int blockWidth, int blockHeight, typename PixelType, typename PixelType2>
+void DegrainOverlap_C(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, const uint8_t **pRefs8, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs, const int16_t *pWin, int nWinPitch) {
+    for (int y = 0; y < blockHeight; y++) {
+        for (int x = 0; x < blockWidth; x++) {
+            const PixelType *pSrc = (const PixelType *)pSrc8;
+            PixelType2 *pDst = (PixelType2 *)pDst8;
+
+            int sum = 128 + pSrc[x] * WSrc;
+
+            for (int r = 0; r < nRefs; r++) {
+                const PixelType *pRef = (const PixelType *)pRefs8[r];
+                sum += pRef[x] * WRefs[r];
+            }
+
+            // Same rounding as Degrain_C followed by the overlaps function.
+            PixelType pixel = sum >> 8;
+            pDst[x] += (pixel * pWin[x]) >> 6;
+        }
+
+        pDst8 += nDstPitch;
+        pSrc8 += nSrcPitch;
+        pWin += nWinPitch;
+        for (int r = 0; r < nRefs; r++)
             pRefs8[r] += nRefPitches[r];
     }
 }
@@ -51,120 +89,252 @@ void Degrain_C(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitc
 
 #include <emmintrin.h>
 
+// Weighted average of 8 (or 4) 8 bit pixels, as 16 bit integers.
+template <int blockWidth>
+static inline __m128i degrainPixels_sse2(const uint8_t *pSrc, const uint8_t * const *pRefs, int x, __m128i wsrc, const __m128i *wrefs, int nRefs) {
+    __m128i zero = _mm_setzero_si128();
+
+    // pDst[x] = (pSrc[x]*WSrc + pRefs[0][x]*WRefs[0] + ... + pRefs[nRefs-1][x]*WRefs[nRefs-1] + 128)>>8;
+    // The weights add up to 256, so the sums fit in 16 bits.
+
+    __m128i src;
+    if (blockWidth == 4)
+        src = _mm_cvtsi32_si128(*(const int *)pSrc);
+    else
+        src = _mm_loadl_epi64((const __m128i *)(pSrc + x));
+
+    __m128i accum = _mm_add_epi16(_mm_set1_epi16(128), _mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), wsrc));
+
+    for (int r = 0; r < nRefs; r++) {
+        __m128i ref;
+        if (blockWidth == 4)
+            ref = _mm_cvtsi32_si128(*(const int *)pRefs[r]);
+        else
+            ref = _mm_loadl_epi64((const __m128i *)(pRefs[r] + x));
+
+        accum = _mm_add_epi16(accum, _mm_mullo_epi16(_mm_unpacklo_epi8(ref, zero), wrefs[r]));
+    }
+
+    return _mm_srli_epi16(accum, 8);
+}
+
+
 // XXX Moves the pointers passed in pRefs. This is okay because they are not
 // used after this function is done with them.
-template <int radius, int blockWidth, int blockHeight>
-void Degrain_sse2(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **pRefs, const int *nRefPitches, int WSrc, const int *WRefs) {
+template <int blockWidth, int blockHeight>
+void Degrain_sse2(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **pRefs, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs) {
     __m128i zero = _mm_setzero_si128();
     __m128i wsrc = _mm_set1_epi16(WSrc);
-    __m128i wrefs[6];
-    wrefs[0] = _mm_set1_epi16(WRefs[0]);
-    wrefs[1] = _mm_set1_epi16(WRefs[1]);
-    if (radius > 1) {
-        wrefs[2] = _mm_set1_epi16(WRefs[2]);
-        wrefs[3] = _mm_set1_epi16(WRefs[3]);
-    }
-    if (radius > 2) {
-        wrefs[4] = _mm_set1_epi16(WRefs[4]);
-        wrefs[5] = _mm_set1_epi16(WRefs[5]);
+    __m128i wrefs[MAX_DEGRAIN_RADIUS * 2];
+    for (int r = 0; r < nRefs; r++)
+        wrefs[r] = _mm_set1_epi16(WRefs[r]);
+
+    for (int y = 0; y < blockHeight; y++) {
+        for (int x = 0; x < blockWidth; x += 8) {
+            __m128i accum = _mm_packus_epi16(degrainPixels_sse2<blockWidth>(pSrc, pRefs, x, wsrc, wrefs, nRefs), zero);
+
+            if (blockWidth == 4)
+                *(int *)pDst = _mm_cvtsi128_si32(accum);
+            else
+                _mm_storel_epi64((__m128i *)(pDst + x), accum);
+        }
+        pDst += nDstPitch;
+        pSrc += nSrcPitch;
+        for (int r = 0; r < nRefs; r++)
+            pRefs[r] += nRefPitches[r];
     }
+}
+
 
-    __m128i src, refs[6];
+// XXX Moves the pointers passed in pRefs. This is okay because they are not
+// used after this function is done with them.
+template <int blockWidth, int blockHeight>
+void DegrainOverlap_sse2(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **pRefs, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs, const int16_t *pWin, int nWinPitch) {
+    __m128i wsrc = _mm_set1_epi16(WSrc);
+    __m128i wrefs[MAX_DEGRAIN_RADIUS * 2];
+    for (int r = 0; r < nRefs; r++)
+        wrefs[r] = _mm_set1_epi16(WRefs[r]);
 
     for (int y = 0; y < blockHeight; y++) {
         for (int x = 0; x < blockWidth; x += 8) {
-            // pDst[x] = (pRefF[x]*WRefF + pSrc[x]*WSrc + pRefB[x]*WRefB + pRefF2[x]*WRefF2 + pRefB2[x]*WRefB2 + pRefF3[x]*WRefF3 + pRefB3[x]*WRefB3 + 128)>>8;
+            __m128i pixels = degrainPixels_sse2<blockWidth>(pSrc, pRefs, x, wsrc, wrefs, nRefs);
 
+            // pWin from 0 to 2048, so (pixel * window) >> 6 is computed in 32 bits.
+            __m128i win, dst;
             if (blockWidth == 4) {
-                src = _mm_cvtsi32_si128(*(const int *)pSrc);
-                refs[0] = _mm_cvtsi32_si128(*(const int *)pRefs[0]);
-                refs[1] = _mm_cvtsi32_si128(*(const int *)pRefs[1]);
-                if (radius > 1) {
-                    refs[2] = _mm_cvtsi32_si128(*(const int *)pRefs[2]);
-                    refs[3] = _mm_cvtsi32_si128(*(const int *)pRefs[3]);
-                }
-                if (radius > 2) {
-                    refs[4] = _mm_cvtsi32_si128(*(const int *)pRefs[4]);
-                    refs[5] = _mm_cvtsi32_si128(*(const int *)pRefs[5]);
-                }
+                win = _mm_loadl_epi64((const __m128i *)pWin);
+                dst = _mm_loadl_epi64((const __m128i *)pDst);
             } else {
-                src = _mm_loadl_epi64((const __m128i *)(pSrc + x));
-                refs[0] = _mm_loadl_epi64((const __m128i *)(pRefs[0] + x));
-                refs[1] = _mm_loadl_epi64((const __m128i *)(pRefs[1] + x));
-                if (radius > 1) {
-                    refs[2] = _mm_loadl_epi64((const __m128i *)(pRefs[2] + x));
-                    refs[3] = _mm_loadl_epi64((const __m128i *)(pRefs[3] + x));
-                }
-                if (radius > 2) {
-                    refs[4] = _mm_loadl_epi64((const __m128i *)(pRefs[4] + x));
-                    refs[5] = _mm_loadl_epi64((const __m128i *)(pRefs[5] + x));
-                }
+                win = _mm_loadu_si128((const __m128i *)(pWin + x));
+                dst = _mm_loadu_si128((const __m128i *)(pDst + x * 2));
             }
 
-            src = _mm_unpacklo_epi8(src, zero);
-            refs[0] = _mm_unpacklo_epi8(refs[0], zero);
-            refs[1] = _mm_unpacklo_epi8(refs[1], zero);
-            if (radius > 1) {
-                refs[2] = _mm_unpacklo_epi8(refs[2], zero);
-                refs[3] = _mm_unpacklo_epi8(refs[3], zero);
-            }
-            if (radius > 2) {
-                refs[4] = _mm_unpacklo_epi8(refs[4], zero);
-                refs[5] = _mm_unpacklo_epi8(refs[5], zero);
-            }
+            __m128i lo = _mm_mullo_epi16(pixels, win);
+            __m128i hi = _mm_mulhi_epi16(pixels, win);
 
-            src = _mm_mullo_epi16(src, wsrc);
-            refs[0] = _mm_mullo_epi16(refs[0], wrefs[0]);
-            refs[1] = _mm_mullo_epi16(refs[1], wrefs[1]);
-            if (radius > 1) {
-                refs[2] = _mm_mullo_epi16(refs[2], wrefs[2]);
-                refs[3] = _mm_mullo_epi16(refs[3], wrefs[3]);
-            }
-            if (radius > 2) {
-                refs[4] = _mm_mullo_epi16(refs[4], wrefs[4]);
-                refs[5] = _mm_mullo_epi16(refs[5], wrefs[5]);
-            }
+            __m128i overlap = _mm_packs_epi32(_mm_srli_epi32(_mm_unpacklo_epi16(lo, hi), 6),
+                                              _mm_srli_epi32(_mm_unpackhi_epi16(lo, hi), 6));
+            dst = _mm_adds_epu16(dst, overlap);
+
+            if (blockWidth == 4)
+                _mm_storel_epi64((__m128i *)pDst, dst);
+            else
+                _mm_storeu_si128((__m128i *)(pDst + x * 2), dst);
+        }
+        pDst += nDstPitch;
+        pSrc += nSrcPitch;
+        pWin += nWinPitch;
+        for (int r = 0; r < nRefs; r++)
+            pRefs[r] += nRefPitches[r];
+    }
+}
 
-            __m128i accum = _mm_set1_epi16(128);
 
-            accum = _mm_add_epi16(accum, src);
-            accum = _mm_add_epi16(accum, refs[0]);
-            accum = _mm_add_epi16(accum, refs[1]);
-            if (radius > 1) {
-                accum = _mm_add_epi16(accum, refs[2]);
-                accum = _mm_add_epi16(accum, refs[3]);
-            }
-            if (radius > 2) {
-                accum = _mm_add_epi16(accum, refs[4]);
-                accum = _mm_add_epi16(accum, refs[5]);
-            }
+// Weighted average of 8 (or 4) 16 bit pixels.
+template <int blockWidth>
+static inline __m128i degrainPixels_u16_sse2(const uint8_t *pSrc, const uint8_t * const *pRefs, int x, __m128i wsrc, const __m128i *wrefs, int nRefs) {
+    // The weights add up to 256, so the results fit in 16 bits.
+    // packs_epi32 is signed, hence the bias.
+    __m128i bias = _mm_set1_epi32(32768);
+    __m128i rounder = _mm_set1_epi32(128);
+
+    __m128i src;
+    if (blockWidth == 4)
+        src = _mm_loadl_epi64((const __m128i *)pSrc);
+    else
+        src = _mm_loadu_si128((const __m128i *)(pSrc + x));
+
+    // 32 bit products of the 16 bit pixels and weights.
+    __m128i lo = _mm_mullo_epi16(src, wsrc);
+    __m128i hi = _mm_mulhi_epu16(src, wsrc);
+
+    __m128i accumLo = _mm_add_epi32(rounder, _mm_unpacklo_epi16(lo, hi));
+    __m128i accumHi = _mm_add_epi32(rounder, _mm_unpackhi_epi16(lo, hi));
+
+    for (int r = 0; r < nRefs; r++) {
+        __m128i ref;
+        if (blockWidth == 4)
+            ref = _mm_loadl_epi64((const __m128i *)pRefs[r]);
+        else
+            ref = _mm_loadu_si128((const __m128i *)(pRefs[r] + x));
+
+        lo = _mm_mullo_epi16(ref, wrefs[r]);
+        hi = _mm_mulhi_epu16(ref, wrefs[r]);
+
+        accumLo = _mm_add_epi32(accumLo, _mm_unpacklo_epi16(lo, hi));
+        accumHi = _mm_add_epi32(accumHi, _mm_unpackhi_epi16(lo, hi));
+    }
+
+    accumLo = _mm_sub_epi32(_mm_srli_epi32(accumLo, 8), bias);
+    accumHi = _mm_sub_epi32(_mm_srli_epi32(accumHi, 8), bias);
 
-            accum = _mm_srli_epi16(accum, 8);
-            accum = _mm_packus_epi16(accum, zero);
+    return _mm_xor_si128(_mm_packs_epi32(accumLo, accumHi), _mm_set1_epi16(-32768));
+}
+
+
+// XXX Moves the pointers passed in pRefs. This is okay because they are not
+// used after this function is done with them.
+template <int blockWidth, int blockHeight>
+void Degrain_u16_sse2(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **pRefs, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs) {
+    __m128i wsrc = _mm_set1_epi16(WSrc);
+    __m128i wrefs[MAX_DEGRAIN_RADIUS * 2];
+    for (int r = 0; r < nRefs; r++)
+        wrefs[r] = _mm_set1_epi16(WRefs[r]);
+
+    for (int y = 0; y < blockHeight; y++) {
+        for (int x = 0; x < blockWidth * 2; x += 16) {
+            __m128i result = degrainPixels_u16_sse2<blockWidth>(pSrc, pRefs, x, wsrc, wrefs, nRefs);
 
             if (blockWidth == 4)
-                *(int *)pDst = _mm_cvtsi128_si32(accum);
+                _mm_storel_epi64((__m128i *)pDst, result);
             else
-                _mm_storel_epi64((__m128i *)(pDst + x), accum);
+                _mm_storeu_si128((__m128i *)(pDst + x), result);
         }
         pDst += nDstPitch;
         pSrc += nSrcPitch;
-        pRefs[0] += nRefPitches[0];
-        pRefs[1] += nRefPitches[1];
-        if (radius > 1) {
-            pRefs[2] += nRefPitches[2];
-            pRefs[3] += nRefPitches[3];
-        }
-        if (radius > 2) {
-            pRefs[4] += nRefPitches[4];
-            pRefs[5] += nRefPitches[5];
+        for (int r = 0; r < nRefs; r++)
+            pRefs[r] += nRefPitches[r];
+    }
+}
+
+
+// XXX Moves the pointers passed in pRefs. This is okay because they are not
+// used after this function is done with them.
+template <int blockWidth, int blockHeight>
+void DegrainOverlap_u16_sse2(uint8_t *pDst, int nDstPitch, const uint8_t *pSrc, int nSrcPitch, const uint8_t **pRefs, const int *nRefPitches, int WSrc, const int *WRefs, int nRefs, const int16_t *pWin, int nWinPitch) {
+    __m128i wsrc = _mm_set1_epi16(WSrc);
+    __m128i wrefs[MAX_DEGRAIN_RADIUS * 2];
+    for (int r = 0; r < nRefs; r++)
+        wrefs[r] = _mm_set1_epi16(WRefs[r]);
+
+    for (int y = 0; y < blockHeight; y++) {
+        for (int x = 0; x < blockWidth * 2; x += 16) {
+            __m128i pixels = degrainPixels_u16_sse2<blockWidth>(pSrc, pRefs, x, wsrc, wrefs, nRefs);
+
+            // pWin from 0 to 2048, so the products fit in 32 bits.
+            __m128i win;
+            if (blockWidth == 4)
+                win = _mm_loadl_epi64((const __m128i *)pWin);
+            else
+                win = _mm_loadu_si128((const __m128i *)(pWin + x / 2));
+
+            __m128i lo = _mm_mullo_epi16(pixels, win);
+            __m128i hi = _mm_mulhi_epu16(pixels, win);
+
+            uint8_t *dstp = pDst + x * 2;
+
+            __m128i dst = _mm_loadu_si128((const __m128i *)dstp);
+            dst = _mm_add_epi32(dst, _mm_srli_epi32(_mm_unpacklo_epi16(lo, hi), 6));
+            _mm_storeu_si128((__m128i *)dstp, dst);
+
+            if (blockWidth > 4) {
+                dst = _mm_loadu_si128((const __m128i *)(dstp + 16));
+                dst = _mm_add_epi32(dst, _mm_srli_epi32(_mm_unpackhi_epi16(lo, hi), 6));
+                _mm_storeu_si128((__m128i *)(dstp + 16), dst);
+            }
         }
+        pDst += nDstPitch;
+        pSrc += nSrcPitch;
+        pWin += nWinPitch;
+        for (int r = 0; r < nRefs; r++)
+            pRefs[r] += nRefPitches[r];
     }
 }
 
 
 extern "C" void mvtools_LimitChanges_sse2(uint8_t *pDst, intptr_t nDstPitch, const uint8_t *pSrc, intptr_t nSrcPitch, intptr_t nWidth, intptr_t nHeight, intptr_t nLimit);
 
+
+static void LimitChanges_u16_sse2(uint8_t *pDst8, intptr_t nDstPitch, const uint8_t *pSrc8, intptr_t nSrcPitch, intptr_t nWidth, intptr_t nHeight, intptr_t nLimit) {
+    __m128i limit = _mm_set1_epi16(nLimit);
+
+    for (int h = 0; h < nHeight; h++) {
+        uint16_t *pDst = (uint16_t *)pDst8;
+        const uint16_t *pSrc = (const uint16_t *)pSrc8;
+
+        int i = 0;
+        for (; i + 8 <= nWidth; i += 8) {
+            __m128i dst = _mm_loadu_si128((const __m128i *)(pDst + i));
+            __m128i src = _mm_loadu_si128((const __m128i *)(pSrc + i));
+
+            // Saturating is fine: a bound below 0 or above 65535 doesn't limit anything.
+            __m128i lower = _mm_subs_epu16(src, limit);
+            __m128i upper = _mm_adds_epu16(src, limit);
+
+            // Unsigned max and min, which SSE2 doesn't have.
+            dst = _mm_add_epi16(lower, _mm_subs_epu16(dst, lower));
+            dst = _mm_sub_epi16(dst, _mm_subs_epu16(dst, upper));
+
+            _mm_storeu_si128((__m128i *)(pDst + i), dst);
+        }
+        for (; i < nWidth; i++)
+            pDst[i] = (uint16_t)VSMIN(VSMAX(pDst[i], (pSrc[i] - nLimit)), (pSrc[i] + nLimit));
+
+        pDst8 += nDstPitch;
+        pSrc8 += nSrcPitch;
+    }
+}
+
 #endif // MVTOOLS_X86
 
 
@@ -196,12 +366,12 @@ inline int DegrainWeight(int64_t thSAD, int64_t blockSAD) {
 
 inline void useBlock(const uint8_t *&p, int &np, int &WRef, bool isUsable, const FakeGroupOfPlanes *fgop, int i, MVPlane * const *pPlane, const uint8_t **pSrcCur, int xx, const int *nSrcPitch, int nLogPel, int plane, int xSubUV, int ySubUV, const int *thSAD) {
     if (isUsable) {
-        const FakeBlockData *block = fgopGetBlock(fgop, 0, i);
-        int blx = (block->x << nLogPel) + block->vector.x;
-        int bly = (block->y << nLogPel) + block->vector.y;
+        const VECTOR *vector = fgopGetVector(fgop, 0, i);
+        int blx = (fgopGetBlockX(fgop, 0, i) << nLogPel) + vector->x;
+        int bly = (fgopGetBlockY(fgop, 0, i) << nLogPel) + vector->y;
         p = mvpGetPointer(pPlane[plane], plane ? blx >> xSubUV : blx, plane ? bly >> ySubUV : bly);
         np = pPlane[plane]->nPitch;
-        int blockSAD = block->vector.sad;
+        int blockSAD = vector->sad;
         WRef = DegrainWeight(thSAD[plane], blockSAD);
     } else {
         p = pSrcCur[plane] + xx;
@@ -211,15 +381,14 @@ inline void useBlock(const uint8_t *&p, int &np, int &WRef, bool isUsable, const
 }
 
 
-template <int radius>
-static inline void normaliseWeights(int &WSrc, int *WRefs) {
+static inline void normaliseWeights(int &WSrc, int *WRefs, int nRefs) {
     // normalise weights to 256
     WSrc = 256;
     int WSum = WSrc + 1;
-    for (int r = 0; r < radius * 2; r++)
+    for (int r = 0; r < nRefs; r++)
         WSum += WRefs[r];
 
-    for (int r = 0; r < radius * 2; r++) {
+    for (int r = 0; r < nRefs; r++) {
         WRefs[r] = WRefs[r] * 256 / WSum;
         WSrc -= WRefs[r];
     }
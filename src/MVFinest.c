@@ -20,6 +20,7 @@
 #include <VapourSynth.h>
 #include <VSHelper.h>
 
+#include "GroupOfFramesCache.h"
 #include "MaskFun.h"
 
 
@@ -36,6 +37,8 @@ typedef struct MVFinestData {
     int nSuperPel;
     int nSuperModeYUV;
     int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
     int nPel;
     int xRatioUV;
     int yRatioUV;
@@ -63,8 +66,8 @@ static const VSFrameRef *VS_CC mvfinestGetFrame(int n, int activationReason, voi
         VSFrameRef *dst = vsapi->newVideoFrame(d->vi.format, d->vi.width, d->vi.height, ref, core);
 
         uint8_t *pDst[3];
-        const uint8_t *pRef[3];
-        int nDstPitches[3], nRefPitches[3];
+        const uint8_t *pRef[3] = { NULL };
+        int nDstPitches[3], nRefPitches[3] = { 0 };
 
         for (int i = 0; i < d->vi.format->numPlanes; i++) {
             pDst[i] = vsapi->getWritePtr(dst, i);
@@ -80,12 +83,12 @@ static const VSFrameRef *VS_CC mvfinestGetFrame(int n, int activationReason, voi
             for (int i = 0; i < d->vi.format->numPlanes; i++)
                 vs_bitblt(pDst[i], nDstPitches[i], pRef[i], nRefPitches[i], d->vi.width * bytesPerSample, d->vi.height);
         } else {
-            MVGroupOfFrames pRefGOF = { 0 };
-            mvgofInit(&pRefGOF, d->nSuperLevels, d->nWidth, d->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, d->xRatioUV, d->yRatioUV, bitsPerSample);
+            int err;
+            int64_t serial = vsapi->propGetInt(vsapi->getFramePropsRO(ref), "Super_serial", 0, &err);
 
-            mvgofUpdate(&pRefGOF, (uint8_t **)pRef, nRefPitches);
+            MVGroupOfFrames *pRefGOF = gofcAcquire(pRef, nRefPitches, d->nSuperLevels, d->nWidth, d->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, d->xRatioUV, d->yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, serial);
 
-            MVPlane **pPlanes = pRefGOF.frames[0]->planes;
+            MVPlane **pPlanes = pRefGOF->frames[0]->planes;
 
 
             // merge refined planes to big single plane
@@ -123,7 +126,7 @@ static const VSFrameRef *VS_CC mvfinestGetFrame(int n, int activationReason, voi
                 }
             }
 
-            mvgofDeinit(&pRefGOF);
+            gofcRelease(pRefGOF);
         }
 
         vsapi->freeFrame(ref);
@@ -167,9 +170,6 @@ static void VS_CC mvfinestCreate(const VSMap *in, VSMap *out, void *userData, VS
         return;
     }
 
-    if (d.vi.format->bitsPerSample > 8)
-        d.isse = 0;
-
 #define ERROR_SIZE 1024
     char errorMsg[ERROR_SIZE] = "Finest: failed to retrieve first frame from super clip. Error message: ";
     size_t errorLen = strlen(errorMsg);
@@ -188,6 +188,8 @@ static void VS_CC mvfinestCreate(const VSMap *in, VSMap *out, void *userData, VS
     d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
     d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
     d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
     for (int i = 0; i < 6; i++)
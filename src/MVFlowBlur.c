@@ -26,9 +26,13 @@
 #include <VSHelper.h>
 
 #include "Bullshit.h"
+#include "CommonFunctions.h"
 #include "Fakery.h"
+#include "GroupOfFramesCache.h"
 #include "MaskFun.h"
 #include "MVAnalysisData.h"
+#include "ObjectPool.h"
+#include "ScratchArena.h"
 #include "SimpleResize.h"
 
 
@@ -36,7 +40,6 @@ typedef struct MVFlowBlurData {
     VSNodeRef *node;
     const VSVideoInfo *vi;
 
-    VSNodeRef *finest;
     VSNodeRef *super;
     VSNodeRef *mvbw;
     VSNodeRef *mvfw;
@@ -51,11 +54,15 @@ typedef struct MVFlowBlurData {
     MVAnalysisData mvfw_data;
 
     int nSuperHPad;
+    int nSuperVPad;
+    int nSuperPel;
+    int nSuperModeYUV;
+    int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
 
     int nWidthUV;
     int nHeightUV;
-    int nVPaddingUV;
-    int nHPaddingUV;
     int VPitchY;
     int VPitchUV;
 
@@ -63,6 +70,9 @@ typedef struct MVFlowBlurData {
 
     SimpleResize upsizer;
     SimpleResize upsizerUV;
+
+    size_t scratchSize;
+    ObjectPool *scratch;
 } MVFlowBlurData;
 
 
@@ -76,145 +86,58 @@ static void VS_CC mvflowblurInit(VSMap *in, VSMap *out, void **instanceData, VSN
 
 
 #define RealFlowBlur(PixelType) \
-static void RealFlowBlur_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *pref8, int ref_pitch, \
-                         uint8_t *VXFullB, uint8_t *VXFullF, uint8_t *VYFullB, uint8_t *VYFullF, \
+static void RealFlowBlur_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *const *pref, int ref_pitch, \
+                         const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, \
                          int VPitch, int width, int height, int blur256, int prec, int nPel) { \
-    const PixelType *pref = (const PixelType *)pref8; \
+    const PixelType *pref0 = (const PixelType *)pref[0]; \
     PixelType *pdst = (PixelType *)pdst8; \
+    const int nLogPel = ilog2(nPel); \
  \
     ref_pitch /= sizeof(PixelType); \
     dst_pitch /= sizeof(PixelType); \
  \
     /* very slow, but precise motion blur */ \
-    if (nPel == 1) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int bluredsum = pref[w]; \
-                int vxF0 = ((VXFullF[w] - 128) * blur256); \
-                int vyF0 = ((VYFullF[w] - 128) * blur256); \
-                int mF = (VSMAX(abs(vxF0), abs(vyF0)) / prec) >> 8; \
-                if (mF > 0) { \
-                    vxF0 /= mF; \
-                    vyF0 /= mF; \
-                    int vxF = vxF0; \
-                    int vyF = vyF0; \
-                    for (int i = 0; i < mF; i++) { \
-                        int dstF = pref[(vyF >> 8) * ref_pitch + (vxF >> 8) + w]; \
-                        bluredsum += dstF; \
-                        vxF += vxF0; \
-                        vyF += vyF0; \
-                    } \
-                } \
-                int vxB0 = ((VXFullB[w] - 128) * blur256); \
-                int vyB0 = ((VYFullB[w] - 128) * blur256); \
-                int mB = (VSMAX(abs(vxB0), abs(vyB0)) / prec) >> 8; \
-                if (mB > 0) { \
-                    vxB0 /= mB; \
-                    vyB0 /= mB; \
-                    int vxB = vxB0; \
-                    int vyB = vyB0; \
-                    for (int i = 0; i < mB; i++) { \
-                        int dstB = pref[(vyB >> 8) * ref_pitch + (vxB >> 8) + w]; \
-                        bluredsum += dstB; \
-                        vxB += vxB0; \
-                        vyB += vyB0; \
-                    } \
+    for (int h = 0; h < height; h++) { \
+        for (int w = 0; w < width; w++) { \
+            int bluredsum = pref0[w]; \
+            int vxF0 = VXFullF[w] * blur256; \
+            int vyF0 = VYFullF[w] * blur256; \
+            int mF = (VSMAX(abs(vxF0), abs(vyF0)) / prec) >> 8; \
+            if (mF > 0) { \
+                vxF0 /= mF; \
+                vyF0 /= mF; \
+                int vxF = vxF0; \
+                int vyF = vyF0; \
+                for (int i = 0; i < mF; i++) { \
+                    int dstF = SUBPEL_SAMPLE(PixelType, pref, ref_pitch, (w << nLogPel) + (vxF >> 8), (h << nLogPel) + (vyF >> 8), nLogPel); \
+                    bluredsum += dstF; \
+                    vxF += vxF0; \
+                    vyF += vyF0; \
                 } \
-                pdst[w] = bluredsum / (mF + mB + 1); \
             } \
-            pdst += dst_pitch; \
-            pref += ref_pitch; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-        } \
-    } else if (nPel == 2) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int bluredsum = pref[w << 1]; \
-                int vxF0 = ((VXFullF[w] - 128) * blur256); \
-                int vyF0 = ((VYFullF[w] - 128) * blur256); \
-                int mF = (VSMAX(abs(vxF0), abs(vyF0)) / prec) >> 8; \
-                if (mF > 0) { \
-                    vxF0 /= mF; \
-                    vyF0 /= mF; \
-                    int vxF = vxF0; \
-                    int vyF = vyF0; \
-                    for (int i = 0; i < mF; i++) { \
-                        int dstF = pref[(vyF >> 8) * ref_pitch + (vxF >> 8) + (w << 1)]; \
-                        bluredsum += dstF; \
-                        vxF += vxF0; \
-                        vyF += vyF0; \
-                    } \
-                } \
-                int vxB0 = ((VXFullB[w] - 128) * blur256); \
-                int vyB0 = ((VYFullB[w] - 128) * blur256); \
-                int mB = (VSMAX(abs(vxB0), abs(vyB0)) / prec) >> 8; \
-                if (mB > 0) { \
-                    vxB0 /= mB; \
-                    vyB0 /= mB; \
-                    int vxB = vxB0; \
-                    int vyB = vyB0; \
-                    for (int i = 0; i < mB; i++) { \
-                        int dstB = pref[(vyB >> 8) * ref_pitch + (vxB >> 8) + (w << 1)]; \
-                        bluredsum += dstB; \
-                        vxB += vxB0; \
-                        vyB += vyB0; \
-                    } \
-                } \
-                pdst[w] = bluredsum / (mF + mB + 1); \
-            } \
-            pdst += dst_pitch; \
-            pref += (ref_pitch << 1); \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-        } \
-    } else if (nPel == 4) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int bluredsum = pref[w << 2]; \
-                int vxF0 = ((VXFullF[w] - 128) * blur256); \
-                int vyF0 = ((VYFullF[w] - 128) * blur256); \
-                int mF = (VSMAX(abs(vxF0), abs(vyF0)) / prec) >> 8; \
-                if (mF > 0) { \
-                    vxF0 /= mF; \
-                    vyF0 /= mF; \
-                    int vxF = vxF0; \
-                    int vyF = vyF0; \
-                    for (int i = 0; i < mF; i++) { \
-                        int dstF = pref[(vyF >> 8) * ref_pitch + (vxF >> 8) + (w << 2)]; \
-                        bluredsum += dstF; \
-                        vxF += vxF0; \
-                        vyF += vyF0; \
-                    } \
+            int vxB0 = VXFullB[w] * blur256; \
+            int vyB0 = VYFullB[w] * blur256; \
+            int mB = (VSMAX(abs(vxB0), abs(vyB0)) / prec) >> 8; \
+            if (mB > 0) { \
+                vxB0 /= mB; \
+                vyB0 /= mB; \
+                int vxB = vxB0; \
+                int vyB = vyB0; \
+                for (int i = 0; i < mB; i++) { \
+                    int dstB = SUBPEL_SAMPLE(PixelType, pref, ref_pitch, (w << nLogPel) + (vxB >> 8), (h << nLogPel) + (vyB >> 8), nLogPel); \
+                    bluredsum += dstB; \
+                    vxB += vxB0; \
+                    vyB += vyB0; \
                 } \
-                int vxB0 = ((VXFullB[w] - 128) * blur256); \
-                int vyB0 = ((VYFullB[w] - 128) * blur256); \
-                int mB = (VSMAX(abs(vxB0), abs(vyB0)) / prec) >> 8; \
-                if (mB > 0) { \
-                    vxB0 /= mB; \
-                    vyB0 /= mB; \
-                    int vxB = vxB0; \
-                    int vyB = vyB0; \
-                    for (int i = 0; i < mB; i++) { \
-                        int dstB = pref[(vyB >> 8) * ref_pitch + (vxB >> 8) + (w << 2)]; \
-                        bluredsum += dstB; \
-                        vxB += vxB0; \
-                        vyB += vyB0; \
-                    } \
-                } \
-                pdst[w] = bluredsum / (mF + mB + 1); \
             } \
-            pdst += dst_pitch; \
-            pref += (ref_pitch << 2); \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
+            pdst[w] = bluredsum / (mF + mB + 1); \
         } \
+        pdst += dst_pitch; \
+        pref0 += ref_pitch; \
+        VXFullB += VPitch; \
+        VYFullB += VPitch; \
+        VXFullF += VPitch; \
+        VYFullF += VPitch; \
     } \
 }
 
@@ -222,8 +145,8 @@ RealFlowBlur(uint8_t)
 RealFlowBlur(uint16_t)
 
 
-static void FlowBlur(uint8_t *pdst, int dst_pitch, const uint8_t *pref, int ref_pitch,
-                     uint8_t *VXFullB, uint8_t *VXFullF, uint8_t *VYFullB, uint8_t *VYFullF,
+static void FlowBlur(uint8_t *pdst, int dst_pitch, const uint8_t *const *pref, int ref_pitch,
+                     const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF,
                      int VPitch, int width, int height, int blur256, int prec, int nPel, int bitsPerSample) {
     if (bitsPerSample == 8)
         RealFlowBlur_uint8_t(pdst, dst_pitch, pref, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, VPitch, width, height, blur256, prec, nPel);
@@ -245,13 +168,13 @@ static const VSFrameRef *VS_CC mvflowblurGetFrame(int n, int activationReason, v
             vsapi->requestFrameFilter(n + off, d->mvfw, frameCtx);
         }
 
-        vsapi->requestFrameFilter(n, d->finest, frameCtx);
+        vsapi->requestFrameFilter(n, d->super, frameCtx);
         vsapi->requestFrameFilter(n, d->node, frameCtx);
     } else if (activationReason == arAllFramesReady) {
         uint8_t *pDst[3];
-        const uint8_t *pRef[3];
+        const uint8_t *pRef[3] = { NULL };
         int nDstPitches[3];
-        int nRefPitches[3];
+        int nRefPitches[3] = { 0 };
 
         FakeGroupOfPlanes fgopF, fgopB;
 
@@ -263,23 +186,24 @@ static const VSFrameRef *VS_CC mvflowblurGetFrame(int n, int activationReason, v
 
         int off = d->mvbw_data.nDeltaFrame; // integer offset of reference frame
 
+        // The fgops point into the vector frames' properties, so they are kept until fgopDeinit.
+        const VSFrameRef *mvF = NULL, *mvB = NULL;
+
         if (n - off >= 0 && n + off < d->vi->numFrames) {
-            const VSFrameRef *mvF = vsapi->getFrameFilter(n + off, d->mvfw, frameCtx);
+            mvF = vsapi->getFrameFilter(n + off, d->mvfw, frameCtx);
             const VSMap *mvprops = vsapi->getFramePropsRO(mvF);
             fgopUpdate(&fgopF, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
             isUsableF = fgopIsUsable(&fgopF, d->thscd1, d->thscd2);
-            vsapi->freeFrame(mvF);
 
-            const VSFrameRef *mvB = vsapi->getFrameFilter(n - off, d->mvbw, frameCtx);
+            mvB = vsapi->getFrameFilter(n - off, d->mvbw, frameCtx);
             mvprops = vsapi->getFramePropsRO(mvB);
             fgopUpdate(&fgopB, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
             isUsableB = fgopIsUsable(&fgopB, d->thscd1, d->thscd2);
-            vsapi->freeFrame(mvB);
         }
 
 
         if (isUsableB && isUsableF) {
-            const VSFrameRef *ref = vsapi->getFrameFilter(n, d->finest, frameCtx); //  ref for  compensation
+            const VSFrameRef *ref = vsapi->getFrameFilter(n, d->super, frameCtx); //  ref for  compensation
             VSFrameRef *dst = vsapi->newVideoFrame(d->vi->format, d->vi->width, d->vi->height, ref, core);
 
             for (int i = 0; i < d->vi->format->numPlanes; i++) {
@@ -297,10 +221,6 @@ static const VSFrameRef *VS_CC mvflowblurGetFrame(int n, int activationReason, v
             const int yRatioUV = d->mvbw_data.yRatioUV;
             const int nBlkX = d->mvbw_data.nBlkX;
             const int nBlkY = d->mvbw_data.nBlkY;
-            const int nVPadding = d->mvbw_data.nVPadding;
-            const int nHPadding = d->mvbw_data.nHPadding;
-            const int nVPaddingUV = d->nVPaddingUV;
-            const int nHPaddingUV = d->nHPaddingUV;
             const int nPel = d->mvbw_data.nPel;
             const int blur256 = d->blur256;
             const int prec = d->prec;
@@ -308,25 +228,32 @@ static const VSFrameRef *VS_CC mvflowblurGetFrame(int n, int activationReason, v
             const int VPitchUV = d->VPitchUV;
 
             int bitsPerSample = d->vi->format->bitsPerSample;
-            int bytesPerSample = d->vi->format->bytesPerSample;
 
-            int nOffsetY = nRefPitches[0] * nVPadding * nPel + nHPadding * bytesPerSample * nPel;
-            int nOffsetUV = nRefPitches[1] * nVPaddingUV * nPel + nHPaddingUV * bytesPerSample * nPel;
+            int err;
+            int64_t serial = vsapi->propGetInt(vsapi->getFramePropsRO(ref), "Super_serial", 0, &err);
+
+            MVGroupOfFrames *pRefGOF = gofcAcquire(pRef, nRefPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, serial);
+
+            // The subplanes are sampled directly, so the super clip doesn't need to go through Finest.
+            MVPlane **pPlanes = pRefGOF->frames[0]->planes;
+            const uint8_t *pRefSubplanes[3][16];
+
+            for (int i = 0; i < 3; i++)
+                if (pPlanes[i])
+                    mvpGetSubplanePointers(pPlanes[i], pRefSubplanes[i]);
 
+            ScratchArena *arena = (ScratchArena *)poolAcquire(d->scratch);
 
-            uint8_t *VXFullYB = (uint8_t *)malloc(nHeight * VPitchY);
-            uint8_t *VYFullYB = (uint8_t *)malloc(nHeight * VPitchY);
-            uint8_t *VXFullYF = (uint8_t *)malloc(nHeight * VPitchY);
-            uint8_t *VYFullYF = (uint8_t *)malloc(nHeight * VPitchY);
-            uint8_t *VXSmallYB = (uint8_t *)malloc(nBlkX * nBlkY);
-            uint8_t *VYSmallYB = (uint8_t *)malloc(nBlkX * nBlkY);
-            uint8_t *VXSmallYF = (uint8_t *)malloc(nBlkX * nBlkY);
-            uint8_t *VYSmallYF = (uint8_t *)malloc(nBlkX * nBlkY);
+            int16_t *VXFullYB = (int16_t *)arenaAlloc(arena, nHeight * VPitchY * sizeof(int16_t));
+            int16_t *VYFullYB = (int16_t *)arenaAlloc(arena, nHeight * VPitchY * sizeof(int16_t));
+            int16_t *VXFullYF = (int16_t *)arenaAlloc(arena, nHeight * VPitchY * sizeof(int16_t));
+            int16_t *VYFullYF = (int16_t *)arenaAlloc(arena, nHeight * VPitchY * sizeof(int16_t));
+            int16_t *VXSmallYB = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
+            int16_t *VYSmallYB = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
+            int16_t *VXSmallYF = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
+            int16_t *VYSmallYF = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
 
             // make  vector vx and vy small masks
-            // 1. ATTENTION: vectors are assumed SHORT (|vx|, |vy| < 127) !
-            // 2. they will be zeroed if not
-            // 3. added 128 to all values
             MakeVectorSmallMasks(&fgopB, nBlkX, nBlkY, VXSmallYB, nBlkX, VYSmallYB, nBlkX);
             MakeVectorSmallMasks(&fgopF, nBlkX, nBlkY, VXSmallYF, nBlkX, VYSmallYF, nBlkX);
 
@@ -335,30 +262,25 @@ static const VSFrameRef *VS_CC mvflowblurGetFrame(int n, int activationReason, v
             // upsize (bilinear interpolate) vector masks to fullframe size
 
 
-            simpleResize(&d->upsizer, VXFullYB, VPitchY, VXSmallYB, nBlkX);
-            simpleResize(&d->upsizer, VYFullYB, VPitchY, VYSmallYB, nBlkX);
-            simpleResize(&d->upsizer, VXFullYF, VPitchY, VXSmallYF, nBlkX);
-            simpleResize(&d->upsizer, VYFullYF, VPitchY, VYSmallYF, nBlkX);
+            simpleResizeVectors(&d->upsizer, VXFullYB, VYFullYB, VPitchY, VXSmallYB, VYSmallYB, nBlkX);
+            simpleResizeVectors(&d->upsizer, VXFullYF, VYFullYF, VPitchY, VXSmallYF, VYSmallYF, nBlkX);
 
-            FlowBlur(pDst[0], nDstPitches[0], pRef[0] + nOffsetY, nRefPitches[0],
+            FlowBlur(pDst[0], nDstPitches[0], pRefSubplanes[0], pPlanes[0]->nPitch,
                      VXFullYB, VXFullYF, VYFullYB, VYFullYF, VPitchY,
                      nWidth, nHeight, blur256, prec, nPel, bitsPerSample);
 
             if (d->vi->format->colorFamily != cmGray) {
-                uint8_t *VXFullUVB = (uint8_t *)malloc(nHeightUV * VPitchUV);
-                uint8_t *VYFullUVB = (uint8_t *)malloc(nHeightUV * VPitchUV);
+                int16_t *VXFullUVB = (int16_t *)arenaAlloc(arena, nHeightUV * VPitchUV * sizeof(int16_t));
+                int16_t *VYFullUVB = (int16_t *)arenaAlloc(arena, nHeightUV * VPitchUV * sizeof(int16_t));
 
-                uint8_t *VXFullUVF = (uint8_t *)malloc(nHeightUV * VPitchUV);
-                uint8_t *VYFullUVF = (uint8_t *)malloc(nHeightUV * VPitchUV);
+                int16_t *VXFullUVF = (int16_t *)arenaAlloc(arena, nHeightUV * VPitchUV * sizeof(int16_t));
+                int16_t *VYFullUVF = (int16_t *)arenaAlloc(arena, nHeightUV * VPitchUV * sizeof(int16_t));
 
-                uint8_t *VXSmallUVB = (uint8_t *)malloc(nBlkX * nBlkY);
-                uint8_t *VYSmallUVB = (uint8_t *)malloc(nBlkX * nBlkY);
+                int16_t *VXSmallUVB = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
+                int16_t *VYSmallUVB = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
 
-                uint8_t *VXSmallUVF = (uint8_t *)malloc(nBlkX * nBlkY);
-                uint8_t *VYSmallUVF = (uint8_t *)malloc(nBlkX * nBlkY);
-
-                uint8_t *MaskFullUVB = (uint8_t *)malloc(nHeightUV * VPitchUV);
-                uint8_t *MaskFullUVF = (uint8_t *)malloc(nHeightUV * VPitchUV);
+                int16_t *VXSmallUVF = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
+                int16_t *VYSmallUVF = (int16_t *)arenaAlloc(arena, nBlkX * nBlkY * sizeof(int16_t));
 
                 VectorSmallMaskYToHalfUV(VXSmallYB, nBlkX, nBlkY, VXSmallUVB, xRatioUV);
                 VectorSmallMaskYToHalfUV(VYSmallYB, nBlkX, nBlkY, VYSmallUVB, yRatioUV);
@@ -366,50 +288,37 @@ static const VSFrameRef *VS_CC mvflowblurGetFrame(int n, int activationReason, v
                 VectorSmallMaskYToHalfUV(VXSmallYF, nBlkX, nBlkY, VXSmallUVF, xRatioUV);
                 VectorSmallMaskYToHalfUV(VYSmallYF, nBlkX, nBlkY, VYSmallUVF, yRatioUV);
 
-                simpleResize(&d->upsizerUV, VXFullUVB, VPitchUV, VXSmallUVB, nBlkX);
-                simpleResize(&d->upsizerUV, VYFullUVB, VPitchUV, VYSmallUVB, nBlkX);
+                simpleResizeVectors(&d->upsizerUV, VXFullUVB, VYFullUVB, VPitchUV, VXSmallUVB, VYSmallUVB, nBlkX);
 
-                simpleResize(&d->upsizerUV, VXFullUVF, VPitchUV, VXSmallUVF, nBlkX);
-                simpleResize(&d->upsizerUV, VYFullUVF, VPitchUV, VYSmallUVF, nBlkX);
+                simpleResizeVectors(&d->upsizerUV, VXFullUVF, VYFullUVF, VPitchUV, VXSmallUVF, VYSmallUVF, nBlkX);
 
 
-                FlowBlur(pDst[1], nDstPitches[1], pRef[1] + nOffsetUV, nRefPitches[1],
+                FlowBlur(pDst[1], nDstPitches[1], pRefSubplanes[1], pPlanes[1]->nPitch,
                          VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, VPitchUV,
                          nWidthUV, nHeightUV, blur256, prec, nPel, bitsPerSample);
-                FlowBlur(pDst[2], nDstPitches[2], pRef[2] + nOffsetUV, nRefPitches[2],
+                FlowBlur(pDst[2], nDstPitches[2], pRefSubplanes[2], pPlanes[2]->nPitch,
                          VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, VPitchUV,
                          nWidthUV, nHeightUV, blur256, prec, nPel, bitsPerSample);
-
-                free(VXFullUVB);
-                free(VYFullUVB);
-                free(VXSmallUVB);
-                free(VYSmallUVB);
-                free(VXFullUVF);
-                free(VYFullUVF);
-                free(VXSmallUVF);
-                free(VYSmallUVF);
-                free(MaskFullUVB);
-                free(MaskFullUVF);
             }
 
-            free(VXFullYB);
-            free(VYFullYB);
-            free(VXSmallYB);
-            free(VYSmallYB);
-            free(VXFullYF);
-            free(VYFullYF);
-            free(VXSmallYF);
-            free(VYSmallYF);
+            arenaReset(arena);
+            poolRelease(d->scratch, arena);
+
+            gofcRelease(pRefGOF);
 
             vsapi->freeFrame(ref);
 
             fgopDeinit(&fgopF);
             fgopDeinit(&fgopB);
+            vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvB);
 
             return dst;
         } else { // not usable
             fgopDeinit(&fgopF);
             fgopDeinit(&fgopB);
+            vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvB);
 
             return vsapi->getFrameFilter(n, d->node, frameCtx);
         }
@@ -428,7 +337,8 @@ static void VS_CC mvflowblurFree(void *instanceData, VSCore *core, const VSAPI *
     if (d->vi->format->colorFamily != cmGray)
         simpleDeinit(&d->upsizerUV);
 
-    vsapi->freeNode(d->finest);
+    poolFree(d->scratch);
+
     vsapi->freeNode(d->super);
     vsapi->freeNode(d->mvfw);
     vsapi->freeNode(d->mvbw);
@@ -492,12 +402,18 @@ static void VS_CC mvflowblurCreate(const VSMap *in, VSMap *out, void *userData,
         return;
     }
     const VSMap *props = vsapi->getFramePropsRO(evil);
-    int evil_err[2];
+    int evil_err[6];
     int nHeightS = int64ToIntS(vsapi->propGetInt(props, "Super_height", 0, &evil_err[0]));
     d.nSuperHPad = int64ToIntS(vsapi->propGetInt(props, "Super_hpad", 0, &evil_err[1]));
+    d.nSuperVPad = int64ToIntS(vsapi->propGetInt(props, "Super_vpad", 0, &evil_err[2]));
+    d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
+    d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
+    d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
-    for (int i = 0; i < 2; i++)
+    for (int i = 0; i < 6; i++)
         if (evil_err[i]) {
             vsapi->setError(out, "FlowBlur: required properties not found in first frame of super clip. Maybe clip didn't come from mv.Super? Was the first frame trimmed away?");
             vsapi->freeNode(d.super);
@@ -552,55 +468,6 @@ static void VS_CC mvflowblurCreate(const VSMap *in, VSMap *out, void *userData,
     }
 
 
-    if (d.mvbw_data.nPel == 1)
-        d.finest = vsapi->cloneNodeRef(d.super); // v2.0.9.1
-    else {
-        VSPlugin *mvtoolsPlugin = vsapi->getPluginById("com.nodame.mvtools", core);
-        VSPlugin *stdPlugin = vsapi->getPluginById("com.vapoursynth.std", core);
-
-        VSMap *args = vsapi->createMap();
-        vsapi->propSetNode(args, "super", d.super, paReplace);
-        vsapi->propSetInt(args, "isse", d.isse, paReplace);
-        VSMap *ret = vsapi->invoke(mvtoolsPlugin, "Finest", args);
-        if (vsapi->getError(ret)) {
-#define ERROR_SIZE 512
-            char error_msg[ERROR_SIZE + 1] = { 0 };
-            snprintf(error_msg, ERROR_SIZE, "FlowBlur: %s", vsapi->getError(ret));
-#undef ERROR_SIZE
-            vsapi->setError(out, error_msg);
-
-            vsapi->freeNode(d.super);
-            vsapi->freeNode(d.mvfw);
-            vsapi->freeNode(d.mvbw);
-            vsapi->freeMap(args);
-            vsapi->freeMap(ret);
-            return;
-        }
-        d.finest = vsapi->propGetNode(ret, "clip", 0, NULL);
-        vsapi->freeMap(ret);
-
-        vsapi->clearMap(args);
-        vsapi->propSetNode(args, "clip", d.finest, paReplace);
-        vsapi->freeNode(d.finest);
-        ret = vsapi->invoke(stdPlugin, "Cache", args);
-        vsapi->freeMap(args);
-        if (vsapi->getError(ret)) {
-#define ERROR_SIZE 512
-            char error_msg[ERROR_SIZE + 1] = { 0 };
-            snprintf(error_msg, ERROR_SIZE, "FlowBlur: %s", vsapi->getError(ret));
-#undef ERROR_SIZE
-            vsapi->setError(out, error_msg);
-
-            vsapi->freeNode(d.super);
-            vsapi->freeNode(d.mvfw);
-            vsapi->freeNode(d.mvbw);
-            vsapi->freeMap(ret);
-            return;
-        }
-        d.finest = vsapi->propGetNode(ret, "clip", 0, NULL);
-        vsapi->freeMap(ret);
-    }
-
     d.node = vsapi->propGetNode(in, "clip", 0, 0);
     d.vi = vsapi->getVideoInfo(d.node);
 
@@ -609,7 +476,6 @@ static void VS_CC mvflowblurCreate(const VSMap *in, VSMap *out, void *userData,
 
     if (d.mvbw_data.nHeight != nHeightS || d.mvbw_data.nWidth != nSuperWidth - d.nSuperHPad * 2) {
         vsapi->setError(out, "FlowBlur: wrong source or super clip frame size.");
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
@@ -620,34 +486,54 @@ static void VS_CC mvflowblurCreate(const VSMap *in, VSMap *out, void *userData,
     if (!isConstantFormat(d.vi) || d.vi->format->bitsPerSample > 16 || d.vi->format->sampleType != stInteger || d.vi->format->subSamplingW > 1 || d.vi->format->subSamplingH > 1 || (d.vi->format->colorFamily != cmYUV && d.vi->format->colorFamily != cmGray)) {
         vsapi->setError(out, "FlowBlur: input clip must be GRAY, 420, 422, 440, or 444, up to 16 bits, with constant dimensions.");
         vsapi->freeNode(d.super);
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
         vsapi->freeNode(d.node);
         return;
     }
 
-    if (d.vi->format->bitsPerSample > 8)
-        d.isse = 0;
+    if (d.nSuperPel != d.mvbw_data.nPel) {
+        vsapi->setError(out, "FlowBlur: super clip and motion vector clips must have the same pel.");
+        vsapi->freeNode(d.super);
+        vsapi->freeNode(d.mvfw);
+        vsapi->freeNode(d.mvbw);
+        vsapi->freeNode(d.node);
+        return;
+    }
+
+    if (d.vi->format->colorFamily != cmGray && !(d.nSuperModeYUV & UVPLANES)) {
+        vsapi->setError(out, "FlowBlur: super clip must be created with chroma=True, unless the input clip is GRAY.");
+        vsapi->freeNode(d.super);
+        vsapi->freeNode(d.mvfw);
+        vsapi->freeNode(d.mvbw);
+        vsapi->freeNode(d.node);
+        return;
+    }
 
 
     d.nHeightUV = d.mvbw_data.nHeight / d.mvbw_data.yRatioUV;
     d.nWidthUV = d.mvbw_data.nWidth / d.mvbw_data.xRatioUV;
-    d.nHPaddingUV = d.mvbw_data.nHPadding / d.mvbw_data.xRatioUV;
-    //d.nVPaddingUV = d.mvbw_data.nHPadding / d.mvbw_data.yRatioUV; // original looks wrong
-    d.nVPaddingUV = d.mvbw_data.nVPadding / d.mvbw_data.yRatioUV;
 
     d.VPitchY = d.mvbw_data.nWidth;
     d.VPitchUV = d.nWidthUV;
 
-    simpleInit(&d.upsizer, d.mvbw_data.nWidth, d.mvbw_data.nHeight, d.mvbw_data.nBlkX, d.mvbw_data.nBlkY);
+    simpleInit(&d.upsizer, d.mvbw_data.nWidth, d.mvbw_data.nHeight, d.mvbw_data.nBlkX, d.mvbw_data.nBlkY, d.isse);
     if (d.vi->format->colorFamily != cmGray)
-        simpleInit(&d.upsizerUV, d.nWidthUV, d.nHeightUV, d.mvbw_data.nBlkX, d.mvbw_data.nBlkY);
+        simpleInit(&d.upsizerUV, d.nWidthUV, d.nHeightUV, d.mvbw_data.nBlkX, d.mvbw_data.nBlkY, d.isse);
+
+    // The vectors made by mvflowblurGetFrame.
+    d.scratchSize = 4 * arenaBufferSize(d.mvbw_data.nHeight * d.VPitchY * sizeof(int16_t)) +
+                    4 * arenaBufferSize(d.mvbw_data.nBlkX * d.mvbw_data.nBlkY * sizeof(int16_t));
+    if (d.vi->format->colorFamily != cmGray)
+        d.scratchSize += 4 * arenaBufferSize(d.nHeightUV * d.VPitchUV * sizeof(int16_t)) +
+                         4 * arenaBufferSize(d.mvbw_data.nBlkX * d.mvbw_data.nBlkY * sizeof(int16_t));
 
 
     data = (MVFlowBlurData *)malloc(sizeof(d));
     *data = d;
 
+    data->scratch = poolCreate(arenaPoolCreate, arenaPoolDestroy, &data->scratchSize);
+
     vsapi->createFilter(in, out, "FlowBlur", mvflowblurInit, mvflowblurGetFrame, mvflowblurFree, fmParallel, 0, data, core);
 }
 
@@ -28,7 +28,10 @@
 #include "Bullshit.h"
 #include "MVAnalysisData.h"
 #include "CommonFunctions.h"
+#include "GroupOfFramesCache.h"
 #include "MaskFun.h"
+#include "ObjectPool.h"
+#include "ScratchArena.h"
 #include "SimpleResize.h"
 
 #include "MVFlowFPSHelper.h"
@@ -39,7 +42,6 @@ typedef struct MVFlowFPSData {
     VSVideoInfo vi;
     const VSVideoInfo *oldvi;
 
-    VSNodeRef *finest;
     VSNodeRef *super;
     VSNodeRef *mvbw;
     VSNodeRef *mvfw;
@@ -55,11 +57,15 @@ typedef struct MVFlowFPSData {
     MVAnalysisData mvfw_data;
 
     int nSuperHPad;
+    int nSuperVPad;
+    int nSuperPel;
+    int nSuperModeYUV;
+    int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
 
     int nWidthUV;
     int nHeightUV;
-    int nVPaddingUV;
-    int nHPaddingUV;
     int VPitchY;
     int VPitchUV;
     int nWidthP;
@@ -69,10 +75,17 @@ typedef struct MVFlowFPSData {
     int nBlkXP;
     int nBlkYP;
 
+    FlowInterFunction FlowInter;
+    FlowInterFunction FlowInterSimple;
+    FlowInterExtraFunction FlowInterExtra;
+
     SimpleResize upsizer;
     SimpleResize upsizerUV;
 
     int64_t fa, fb;
+
+    size_t scratchSize;
+    ObjectPool *scratch;
 } MVFlowFPSData;
 
 
@@ -116,8 +129,8 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
             if (d->maskmode == 2)
                 vsapi->requestFrameFilter(nright, d->mvbw, frameCtx); // requests nleft + off, nleft + off + off
 
-            vsapi->requestFrameFilter(nleft, d->finest, frameCtx);
-            vsapi->requestFrameFilter(nright, d->finest, frameCtx);
+            vsapi->requestFrameFilter(nleft, d->super, frameCtx);
+            vsapi->requestFrameFilter(nright, d->super, frameCtx);
         }
 
         vsapi->requestFrameFilter(VSMIN(nleft, d->oldvi->numFrames - 1), d->node, frameCtx);
@@ -151,7 +164,8 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
         int isUsableF = 0;
         int isUsableB = 0;
 
-        const VSFrameRef *mvF = NULL, *mvB = NULL;
+        // The fgops point into the vector frames' properties, so they are kept until fgopDeinit.
+        const VSFrameRef *mvF = NULL, *mvB = NULL, *mvFF = NULL, *mvBB = NULL;
 
         if (nleft < d->oldvi->numFrames && nright < d->oldvi->numFrames) {
             // forward from current to next
@@ -175,7 +189,6 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
         const int nHeightPUV = d->nHeightPUV;
         const int maskmode = d->maskmode;
         const int blend = d->blend;
-        const double ml = d->ml;
         const int xRatioUV = d->mvbw_data.xRatioUV;
         const int yRatioUV = d->mvbw_data.yRatioUV;
         const int nBlkX = d->mvbw_data.nBlkX;
@@ -184,10 +197,6 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
         const int nBlkSizeY = d->mvbw_data.nBlkSizeY;
         const int nOverlapX = d->mvbw_data.nOverlapX;
         const int nOverlapY = d->mvbw_data.nOverlapY;
-        const int nVPadding = d->mvbw_data.nVPadding;
-        const int nHPadding = d->mvbw_data.nHPadding;
-        const int nVPaddingUV = d->nVPaddingUV;
-        const int nHPaddingUV = d->nHPaddingUV;
         const int nPel = d->mvbw_data.nPel;
         const int VPitchY = d->VPitchY;
         const int VPitchUV = d->VPitchUV;
@@ -197,7 +206,6 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
         const SimpleResize *upsizerUV = &d->upsizerUV;
 
         int bitsPerSample = d->vi.format->bitsPerSample;
-        int bytesPerSample = d->vi.format->bytesPerSample;
 
         if (isUsableB && isUsableF) {
             uint8_t *pDst[3] = { NULL };
@@ -205,29 +213,34 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
             const uint8_t *pSrc[3] = { NULL };
             int nDstPitches[3] = { 0 };
             int nRefPitches[3] = { 0 };
+            int nSrcPitches[3] = { 0 };
 
             // Put this before any allocations so we don't have to free much in case of error.
             const VSMap *props = vsapi->getFramePropsRO(mvB);
-            int err[8] = { 0 };
-            const uint8_t *VXFullYB = (const uint8_t *)vsapi->propGetData(props, prop_VXFullY, 0, &err[0]);
-            const uint8_t *VYFullYB = (const uint8_t *)vsapi->propGetData(props, prop_VYFullY, 0, &err[1]);
-            const uint8_t *VXFullUVB = NULL;
-            const uint8_t *VYFullUVB = NULL;
+            int err[12] = { 0 };
+            const int16_t *VXFullYB = (const int16_t *)vsapi->propGetData(props, prop_VXFullY, 0, &err[0]);
+            const int16_t *VYFullYB = (const int16_t *)vsapi->propGetData(props, prop_VYFullY, 0, &err[1]);
+            const int16_t *VXFullUVB = NULL;
+            const int16_t *VYFullUVB = NULL;
             if (d->vi.format->colorFamily != cmGray) {
-                VXFullUVB = (const uint8_t *)vsapi->propGetData(props, prop_VXFullUV, 0, &err[2]);
-                VYFullUVB = (const uint8_t *)vsapi->propGetData(props, prop_VYFullUV, 0, &err[3]);
+                VXFullUVB = (const int16_t *)vsapi->propGetData(props, prop_VXFullUV, 0, &err[2]);
+                VYFullUVB = (const int16_t *)vsapi->propGetData(props, prop_VYFullUV, 0, &err[3]);
             }
+            const uint8_t *OcclusionXB = (const uint8_t *)vsapi->propGetData(props, prop_OcclusionX, 0, &err[8]);
+            const uint8_t *OcclusionYB = (const uint8_t *)vsapi->propGetData(props, prop_OcclusionY, 0, &err[9]);
 
             props = vsapi->getFramePropsRO(mvF);
-            const uint8_t *VXFullYF = (const uint8_t *)vsapi->propGetData(props, prop_VXFullY, 0, &err[4]);
-            const uint8_t *VYFullYF = (const uint8_t *)vsapi->propGetData(props, prop_VYFullY, 0, &err[5]);
-            const uint8_t *VXFullUVF = NULL;
-            const uint8_t *VYFullUVF = NULL;
+            const int16_t *VXFullYF = (const int16_t *)vsapi->propGetData(props, prop_VXFullY, 0, &err[4]);
+            const int16_t *VYFullYF = (const int16_t *)vsapi->propGetData(props, prop_VYFullY, 0, &err[5]);
+            const int16_t *VXFullUVF = NULL;
+            const int16_t *VYFullUVF = NULL;
             if (d->vi.format->colorFamily != cmGray) {
-                VXFullUVF = (const uint8_t *)vsapi->propGetData(props, prop_VXFullUV, 0, &err[6]);
-                VYFullUVF = (const uint8_t *)vsapi->propGetData(props, prop_VYFullUV, 0, &err[7]);
+                VXFullUVF = (const int16_t *)vsapi->propGetData(props, prop_VXFullUV, 0, &err[6]);
+                VYFullUVF = (const int16_t *)vsapi->propGetData(props, prop_VYFullUV, 0, &err[7]);
             }
-            for (int i = 0; i < 8; i++) {
+            const uint8_t *OcclusionXF = (const uint8_t *)vsapi->propGetData(props, prop_OcclusionX, 0, &err[10]);
+            const uint8_t *OcclusionYF = (const uint8_t *)vsapi->propGetData(props, prop_OcclusionY, 0, &err[11]);
+            for (int i = 0; i < 12; i++) {
                 if (err[i]) {
                     vsapi->freeFrame(mvB);
                     vsapi->freeFrame(mvF);
@@ -242,8 +255,8 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
             }
 
             // If both are usable, that means both nleft and nright are less than oldvi->numFrames. Thus there is no need to check nleft and nright here.
-            const VSFrameRef *src = vsapi->getFrameFilter(nleft, d->finest, frameCtx);
-            const VSFrameRef *ref = vsapi->getFrameFilter(nright, d->finest, frameCtx); //  right frame for  compensation
+            const VSFrameRef *src = vsapi->getFrameFilter(nleft, d->super, frameCtx);
+            const VSFrameRef *ref = vsapi->getFrameFilter(nright, d->super, frameCtx); //  right frame for  compensation
             VSFrameRef *dst = vsapi->newVideoFrame(d->vi.format, d->vi.width, d->vi.height, src, core);
 
             for (int i = 0; i < d->vi.format->numPlanes; i++) {
@@ -252,73 +265,28 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
                 pSrc[i] = vsapi->getReadPtr(src, i);
                 nDstPitches[i] = vsapi->getStride(dst, i);
                 nRefPitches[i] = vsapi->getStride(ref, i);
+                nSrcPitches[i] = vsapi->getStride(src, i);
             }
 
-            uint8_t *VXFullYBB = NULL;
-            uint8_t *VXFullUVBB = NULL;
-            uint8_t *VYFullYBB = NULL;
-            uint8_t *VYFullUVBB = NULL;
-            uint8_t *VXSmallYBB = NULL;
-            uint8_t *VYSmallYBB = NULL;
-            uint8_t *VXSmallUVBB = NULL;
-            uint8_t *VYSmallUVBB = NULL;
-            uint8_t *VXFullYFF = NULL;
-            uint8_t *VXFullUVFF = NULL;
-            uint8_t *VYFullYFF = NULL;
-            uint8_t *VYFullUVFF = NULL;
-            uint8_t *VXSmallYFF = NULL;
-            uint8_t *VYSmallYFF = NULL;
-            uint8_t *VXSmallUVFF = NULL;
-            uint8_t *VYSmallUVFF = NULL;
+            ScratchArena *arena = (ScratchArena *)poolAcquire(d->scratch);
 
             uint8_t *MaskFullUVB = NULL;
             uint8_t *MaskFullUVF = NULL;
 
-            if (maskmode == 2) {
-                VXFullYBB = (uint8_t *)malloc(nHeightP * VPitchY);
-                VYFullYBB = (uint8_t *)malloc(nHeightP * VPitchY);
-
-                VXFullYFF = (uint8_t *)malloc(nHeightP * VPitchY);
-                VYFullYFF = (uint8_t *)malloc(nHeightP * VPitchY);
-
-                VXSmallYBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                VYSmallYBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-
-                VXSmallYFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                VYSmallYFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            }
-
-            uint8_t *MaskSmallB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *MaskFullYB = (uint8_t *)malloc(nHeightP * VPitchY);
+            uint8_t *MaskSmallB = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
+            uint8_t *MaskFullYB = (uint8_t *)arenaAlloc(arena, nHeightP * VPitchY);
 
-            uint8_t *MaskSmallF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *MaskFullYF = (uint8_t *)malloc(nHeightP * VPitchY);
+            uint8_t *MaskSmallF = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
+            uint8_t *MaskFullYF = (uint8_t *)arenaAlloc(arena, nHeightP * VPitchY);
 
             if (d->vi.format->colorFamily != cmGray) {
-                if (maskmode == 2) {
-                    VXFullUVBB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    VYFullUVBB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    VXFullUVFF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    VYFullUVFF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    VXSmallUVBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                    VYSmallUVBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                    VXSmallUVFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                    VYSmallUVFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                }
-
-                MaskFullUVB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                MaskFullUVF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
+                MaskFullUVB = (uint8_t *)arenaAlloc(arena, nHeightPUV * VPitchUV);
+                MaskFullUVF = (uint8_t *)arenaAlloc(arena, nHeightPUV * VPitchUV);
             }
 
-            int *LUTVB = (int *)malloc(256 * sizeof(int));
-            int *LUTVF = (int *)malloc(256 * sizeof(int));
-
-            Create_LUTV(time256, LUTVB, LUTVF); // lookup table
-
             // analyse vectors field to detect occlusion
-            //        double occNormB = (256-time256)/(256*ml);
-            //        MakeVectorOcclusionMask(mvClipB, nBlkX, nBlkY, occNormB, 1.0, nPel, MaskSmallB, nBlkXP);
-            MakeVectorOcclusionMaskTime(&fgopB, nBlkX, nBlkY, ml, 1.0, nPel, MaskSmallB, nBlkXP, (256 - time256), nBlkSizeX - nOverlapX, nBlkSizeY - nOverlapY);
+            // The helper did the part that doesn't depend on the time.
+            SpreadVectorOcclusionStrengths(&fgopB, nBlkX, nBlkY, OcclusionXB, OcclusionYB, MaskSmallB, nBlkXP, (256 - time256), nBlkSizeX - nOverlapX, nBlkSizeY - nOverlapY);
             if (nBlkXP > nBlkX) // fill right
                 for (int j = 0; j < nBlkY; j++)
                     MaskSmallB[j * nBlkXP + nBlkX] = MaskSmallB[j * nBlkXP + nBlkX - 1];
@@ -326,14 +294,12 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
                 for (int i = 0; i < nBlkXP; i++)
                     MaskSmallB[nBlkXP * nBlkY + i] = MaskSmallB[nBlkXP * (nBlkY - 1) + i];
 
-            simpleResize(upsizer, MaskFullYB, VPitchY, MaskSmallB, nBlkXP);
+            simpleResize_uint8_t(upsizer, MaskFullYB, VPitchY, MaskSmallB, nBlkXP);
             if (d->vi.format->colorFamily != cmGray)
-                simpleResize(upsizerUV, MaskFullUVB, VPitchUV, MaskSmallB, nBlkXP);
+                simpleResize_uint8_t(upsizerUV, MaskFullUVB, VPitchUV, MaskSmallB, nBlkXP);
 
             // analyse vectors field to detect occlusion
-            //        double occNormF = time256/(256*ml);
-            //        MakeVectorOcclusionMask(mvClipF, nBlkX, nBlkY, occNormF, 1.0, nPel, MaskSmallF, nBlkXP);
-            MakeVectorOcclusionMaskTime(&fgopF, nBlkX, nBlkY, ml, 1.0, nPel, MaskSmallF, nBlkXP, time256, nBlkSizeX - nOverlapX, nBlkSizeY - nOverlapY);
+            SpreadVectorOcclusionStrengths(&fgopF, nBlkX, nBlkY, OcclusionXF, OcclusionYF, MaskSmallF, nBlkXP, time256, nBlkSizeX - nOverlapX, nBlkSizeY - nOverlapY);
             if (nBlkXP > nBlkX) // fill right
                 for (int j = 0; j < nBlkY; j++)
                     MaskSmallF[j * nBlkXP + nBlkX] = MaskSmallF[j * nBlkXP + nBlkX - 1];
@@ -341,140 +307,122 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
                 for (int i = 0; i < nBlkXP; i++)
                     MaskSmallF[nBlkXP * nBlkY + i] = MaskSmallF[nBlkXP * (nBlkY - 1) + i];
 
-            simpleResize(upsizer, MaskFullYF, VPitchY, MaskSmallF, nBlkXP);
+            simpleResize_uint8_t(upsizer, MaskFullYF, VPitchY, MaskSmallF, nBlkXP);
             if (d->vi.format->colorFamily != cmGray)
-                simpleResize(upsizerUV, MaskFullUVF, VPitchUV, MaskSmallF, nBlkXP);
+                simpleResize_uint8_t(upsizerUV, MaskFullUVF, VPitchUV, MaskSmallF, nBlkXP);
+
+            const int16_t *VXFullYBB = NULL;
+            const int16_t *VYFullYBB = NULL;
+            const int16_t *VXFullUVBB = NULL;
+            const int16_t *VYFullUVBB = NULL;
+            const int16_t *VXFullYFF = NULL;
+            const int16_t *VYFullYFF = NULL;
+            const int16_t *VXFullUVFF = NULL;
+            const int16_t *VYFullUVFF = NULL;
 
             if (maskmode == 2) { // These motion vectors should only be needed with maskmode 2. Why was the Avisynth plugin requesting them for all mask modes?
                 // Get motion info from more frames for occlusion areas
 
                 // forward from previous to current
-                const VSFrameRef *mvFF = vsapi->getFrameFilter(nleft, d->mvfw, frameCtx);
+                mvFF = vsapi->getFrameFilter(nleft, d->mvfw, frameCtx);
                 const VSMap *mvprops = vsapi->getFramePropsRO(mvFF);
                 fgopUpdate(&fgopF, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
                 isUsableF = fgopIsUsable(&fgopF, d->thscd1, d->thscd2);
-                vsapi->freeFrame(mvFF);
 
                 // backward from next next to next
-                const VSFrameRef *mvBB = vsapi->getFrameFilter(nright, d->mvbw, frameCtx);
+                mvBB = vsapi->getFrameFilter(nright, d->mvbw, frameCtx);
                 mvprops = vsapi->getFramePropsRO(mvBB);
                 fgopUpdate(&fgopB, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
                 isUsableB = fgopIsUsable(&fgopB, d->thscd1, d->thscd2);
-                vsapi->freeFrame(mvBB);
-            }
 
-            int nOffsetY = nRefPitches[0] * nVPadding * nPel + nHPadding * bytesPerSample * nPel;
-            int nOffsetUV = nRefPitches[1] * nVPaddingUV * nPel + nHPaddingUV * bytesPerSample * nPel;
-
-            if (maskmode == 2 && isUsableB && isUsableF) { // slow method with extra frames
-                // get vector mask from extra frames
-                MakeVectorSmallMasks(&fgopB, nBlkX, nBlkY, VXSmallYBB, nBlkXP, VYSmallYBB, nBlkXP);
-                MakeVectorSmallMasks(&fgopF, nBlkX, nBlkY, VXSmallYFF, nBlkXP, VYSmallYFF, nBlkXP);
-                if (nBlkXP > nBlkX) { // fill right
-                    for (int j = 0; j < nBlkY; j++) {
-                        VXSmallYBB[j * nBlkXP + nBlkX] = VSMIN(VXSmallYBB[j * nBlkXP + nBlkX - 1], 128);
-                        VYSmallYBB[j * nBlkXP + nBlkX] = VYSmallYBB[j * nBlkXP + nBlkX - 1];
-                        VXSmallYFF[j * nBlkXP + nBlkX] = VSMIN(VXSmallYFF[j * nBlkXP + nBlkX - 1], 128);
-                        VYSmallYFF[j * nBlkXP + nBlkX] = VYSmallYFF[j * nBlkXP + nBlkX - 1];
+                // The helper already upsized these vectors, when it made the frames mvB and mvF of other intervals.
+                if (isUsableB && isUsableF) {
+                    props = vsapi->getFramePropsRO(mvBB);
+                    VXFullYBB = (const int16_t *)vsapi->propGetData(props, prop_VXFullY, 0, &err[0]);
+                    VYFullYBB = (const int16_t *)vsapi->propGetData(props, prop_VYFullY, 0, &err[1]);
+                    if (d->vi.format->colorFamily != cmGray) {
+                        VXFullUVBB = (const int16_t *)vsapi->propGetData(props, prop_VXFullUV, 0, &err[2]);
+                        VYFullUVBB = (const int16_t *)vsapi->propGetData(props, prop_VYFullUV, 0, &err[3]);
                     }
-                }
-                if (nBlkYP > nBlkY) { // fill bottom
-                    for (int i = 0; i < nBlkXP; i++) {
-                        VXSmallYBB[nBlkXP * nBlkY + i] = VXSmallYBB[nBlkXP * (nBlkY - 1) + i];
-                        VYSmallYBB[nBlkXP * nBlkY + i] = VSMIN(VYSmallYBB[nBlkXP * (nBlkY - 1) + i], 128);
-                        VXSmallYFF[nBlkXP * nBlkY + i] = VXSmallYFF[nBlkXP * (nBlkY - 1) + i];
-                        VYSmallYFF[nBlkXP * nBlkY + i] = VSMIN(VYSmallYFF[nBlkXP * (nBlkY - 1) + i], 128);
+
+                    props = vsapi->getFramePropsRO(mvFF);
+                    VXFullYFF = (const int16_t *)vsapi->propGetData(props, prop_VXFullY, 0, &err[4]);
+                    VYFullYFF = (const int16_t *)vsapi->propGetData(props, prop_VYFullY, 0, &err[5]);
+                    if (d->vi.format->colorFamily != cmGray) {
+                        VXFullUVFF = (const int16_t *)vsapi->propGetData(props, prop_VXFullUV, 0, &err[6]);
+                        VYFullUVFF = (const int16_t *)vsapi->propGetData(props, prop_VYFullUV, 0, &err[7]);
                     }
+
+                    // Shouldn't happen, because the helper uses the same thresholds.
+                    for (int i = 0; i < 8; i++)
+                        if (err[i])
+                            isUsableB = 0;
                 }
+            }
 
-                simpleResize(upsizer, VXFullYBB, VPitchY, VXSmallYBB, nBlkXP);
-                simpleResize(upsizer, VYFullYBB, VPitchY, VYSmallYBB, nBlkXP);
+            int serialErr;
+            int64_t srcSerial = vsapi->propGetInt(vsapi->getFramePropsRO(src), "Super_serial", 0, &serialErr);
+            int64_t refSerial = vsapi->propGetInt(vsapi->getFramePropsRO(ref), "Super_serial", 0, &serialErr);
 
-                simpleResize(upsizer, VXFullYFF, VPitchY, VXSmallYFF, nBlkXP);
-                simpleResize(upsizer, VYFullYFF, VPitchY, VYSmallYFF, nBlkXP);
+            MVGroupOfFrames *pSrcGOF = gofcAcquire(pSrc, nSrcPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
+            MVGroupOfFrames *pRefGOF = gofcAcquire(pRef, nRefPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
 
-                FlowInterExtra(pDst[0], nDstPitches[0], pRef[0] + nOffsetY, pSrc[0] + nOffsetY, nRefPitches[0],
-                               VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
-                               nWidth, nHeight, time256, nPel, LUTVB, LUTVF, VXFullYBB, VXFullYFF, VYFullYBB, VYFullYFF, bitsPerSample);
+            // The subplanes are sampled directly, so the super clip doesn't need to go through Finest.
+            MVPlane **pSrcPlanes = pSrcGOF->frames[0]->planes;
+            MVPlane **pRefPlanes = pRefGOF->frames[0]->planes;
+            const uint8_t *pSrcSubplanes[3][16];
+            const uint8_t *pRefSubplanes[3][16];
+
+            for (int i = 0; i < 3; i++) {
+                if (pSrcPlanes[i]) {
+                    mvpGetSubplanePointers(pSrcPlanes[i], pSrcSubplanes[i]);
+                    mvpGetSubplanePointers(pRefPlanes[i], pRefSubplanes[i]);
+                }
+            }
+
+            if (maskmode == 2 && isUsableB && isUsableF) { // slow method with extra frames
+                d->FlowInterExtra(pDst[0], nDstPitches[0], pRefSubplanes[0], pSrcSubplanes[0], pRefPlanes[0]->nPitch,
+                                  VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
+                                  nWidth, nHeight, time256, nPel, VXFullYBB, VXFullYFF, VYFullYBB, VYFullYFF);
                 if (d->vi.format->colorFamily != cmGray) {
-                    VectorSmallMaskYToHalfUV(VXSmallYBB, nBlkXP, nBlkYP, VXSmallUVBB, xRatioUV);
-                    VectorSmallMaskYToHalfUV(VYSmallYBB, nBlkXP, nBlkYP, VYSmallUVBB, yRatioUV);
-                    VectorSmallMaskYToHalfUV(VXSmallYFF, nBlkXP, nBlkYP, VXSmallUVFF, xRatioUV);
-                    VectorSmallMaskYToHalfUV(VYSmallYFF, nBlkXP, nBlkYP, VYSmallUVFF, yRatioUV);
-
-                    simpleResize(upsizerUV, VXFullUVBB, VPitchUV, VXSmallUVBB, nBlkXP);
-                    simpleResize(upsizerUV, VYFullUVBB, VPitchUV, VYSmallUVBB, nBlkXP);
-
-                    simpleResize(upsizerUV, VXFullUVFF, VPitchUV, VXSmallUVFF, nBlkXP);
-                    simpleResize(upsizerUV, VYFullUVFF, VPitchUV, VYSmallUVFF, nBlkXP);
-
-                    FlowInterExtra(pDst[1], nDstPitches[1], pRef[1] + nOffsetUV, pSrc[1] + nOffsetUV, nRefPitches[1],
-                                   VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                                   nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF, bitsPerSample);
-                    FlowInterExtra(pDst[2], nDstPitches[2], pRef[2] + nOffsetUV, pSrc[2] + nOffsetUV, nRefPitches[2],
-                                   VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                                   nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF, bitsPerSample);
+                    d->FlowInterExtra(pDst[1], nDstPitches[1], pRefSubplanes[1], pSrcSubplanes[1], pRefPlanes[1]->nPitch,
+                                      VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                      nWidthUV, nHeightUV, time256, nPel, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF);
+                    d->FlowInterExtra(pDst[2], nDstPitches[2], pRefSubplanes[2], pSrcSubplanes[2], pRefPlanes[2]->nPitch,
+                                      VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                      nWidthUV, nHeightUV, time256, nPel, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF);
                 }
             } else if (maskmode == 1) { // old method without extra frames
-                FlowInter(pDst[0], nDstPitches[0], pRef[0] + nOffsetY, pSrc[0] + nOffsetY, nRefPitches[0],
-                          VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
-                          nWidth, nHeight, time256, nPel, LUTVB, LUTVF, bitsPerSample);
+                d->FlowInter(pDst[0], nDstPitches[0], pRefSubplanes[0], pSrcSubplanes[0], pRefPlanes[0]->nPitch,
+                             VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
+                             nWidth, nHeight, time256, nPel);
                 if (d->vi.format->colorFamily != cmGray) {
-                    FlowInter(pDst[1], nDstPitches[1], pRef[1] + nOffsetUV, pSrc[1] + nOffsetUV, nRefPitches[1],
-                              VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                              nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, bitsPerSample);
-                    FlowInter(pDst[2], nDstPitches[2], pRef[2] + nOffsetUV, pSrc[2] + nOffsetUV, nRefPitches[2],
-                              VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                              nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, bitsPerSample);
+                    d->FlowInter(pDst[1], nDstPitches[1], pRefSubplanes[1], pSrcSubplanes[1], pRefPlanes[1]->nPitch,
+                                 VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                 nWidthUV, nHeightUV, time256, nPel);
+                    d->FlowInter(pDst[2], nDstPitches[2], pRefSubplanes[2], pSrcSubplanes[2], pRefPlanes[2]->nPitch,
+                                 VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                 nWidthUV, nHeightUV, time256, nPel);
                 }
             } else { // mode=0, faster simple method
-                FlowInterSimple(pDst[0], nDstPitches[0], pRef[0] + nOffsetY, pSrc[0] + nOffsetY, nRefPitches[0],
-                                VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
-                                nWidth, nHeight, time256, nPel, LUTVB, LUTVF, bitsPerSample);
+                d->FlowInterSimple(pDst[0], nDstPitches[0], pRefSubplanes[0], pSrcSubplanes[0], pRefPlanes[0]->nPitch,
+                                   VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
+                                   nWidth, nHeight, time256, nPel);
                 if (d->vi.format->colorFamily != cmGray) {
-                    FlowInterSimple(pDst[1], nDstPitches[1], pRef[1] + nOffsetUV, pSrc[1] + nOffsetUV, nRefPitches[1],
-                                    VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                                    nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, bitsPerSample);
-                    FlowInterSimple(pDst[2], nDstPitches[2], pRef[2] + nOffsetUV, pSrc[2] + nOffsetUV, nRefPitches[2],
-                                    VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                                    nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, bitsPerSample);
+                    d->FlowInterSimple(pDst[1], nDstPitches[1], pRefSubplanes[1], pSrcSubplanes[1], pRefPlanes[1]->nPitch,
+                                       VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                       nWidthUV, nHeightUV, time256, nPel);
+                    d->FlowInterSimple(pDst[2], nDstPitches[2], pRefSubplanes[2], pSrcSubplanes[2], pRefPlanes[2]->nPitch,
+                                       VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                       nWidthUV, nHeightUV, time256, nPel);
                 }
             }
 
-            if (maskmode == 2) {
-                free(VXFullYBB);
-                free(VYFullYBB);
-                free(VXSmallYBB);
-                free(VYSmallYBB);
-                free(VXFullYFF);
-                free(VYFullYFF);
-                free(VXSmallYFF);
-                free(VYSmallYFF);
-            }
+            arenaReset(arena);
+            poolRelease(d->scratch, arena);
 
-            free(MaskSmallB);
-            free(MaskFullYB);
-            free(MaskSmallF);
-            free(MaskFullYF);
-
-            if (d->vi.format->colorFamily != cmGray) {
-                if (maskmode == 2) {
-                    free(VXFullUVBB);
-                    free(VYFullUVBB);
-                    free(VXSmallUVBB);
-                    free(VYSmallUVBB);
-                    free(VXFullUVFF);
-                    free(VYFullUVFF);
-                    free(VXSmallUVFF);
-                    free(VYSmallUVFF);
-                }
-
-                free(MaskFullUVB);
-                free(MaskFullUVF);
-            }
-
-            free(LUTVB);
-            free(LUTVF);
+            gofcRelease(pSrcGOF);
+            gofcRelease(pRefGOF);
 
             vsapi->freeFrame(src);
             vsapi->freeFrame(ref);
@@ -484,6 +432,8 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
 
             vsapi->freeFrame(mvB);
             vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvBB);
+            vsapi->freeFrame(mvFF);
 
             return dst;
         } else { // poor estimation
@@ -492,6 +442,8 @@ static const VSFrameRef *VS_CC mvflowfpsGetFrame(int n, int activationReason, vo
 
             vsapi->freeFrame(mvB);
             vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvBB);
+            vsapi->freeFrame(mvFF);
 
             const VSFrameRef *src = vsapi->getFrameFilter(VSMIN(nleft, d->oldvi->numFrames - 1), d->node, frameCtx);
 
@@ -545,7 +497,8 @@ static void VS_CC mvflowfpsFree(void *instanceData, VSCore *core, const VSAPI *v
 
     simpleDeinit(&d->upsizer);
 
-    vsapi->freeNode(d->finest);
+    poolFree(d->scratch);
+
     vsapi->freeNode(d->super);
     vsapi->freeNode(d->mvfw);
     vsapi->freeNode(d->mvbw);
@@ -637,12 +590,18 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
         return;
     }
     const VSMap *props = vsapi->getFramePropsRO(evil);
-    int evil_err[2];
+    int evil_err[6];
     int nHeightS = int64ToIntS(vsapi->propGetInt(props, "Super_height", 0, &evil_err[0]));
     d.nSuperHPad = int64ToIntS(vsapi->propGetInt(props, "Super_hpad", 0, &evil_err[1]));
+    d.nSuperVPad = int64ToIntS(vsapi->propGetInt(props, "Super_vpad", 0, &evil_err[2]));
+    d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
+    d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
+    d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
-    for (int i = 0; i < 2; i++)
+    for (int i = 0; i < 6; i++)
         if (evil_err[i]) {
             vsapi->setError(out, "FlowFPS: required properties not found in first frame of super clip. Maybe clip didn't come from mv.Super? Was the first frame trimmed away?");
             vsapi->freeNode(d.super);
@@ -699,55 +658,6 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
     }
 
 
-    if (d.mvbw_data.nPel == 1)
-        d.finest = vsapi->cloneNodeRef(d.super); // v2.0.9.1
-    else {
-        VSPlugin *mvtoolsPlugin = vsapi->getPluginById("com.nodame.mvtools", core);
-        VSPlugin *stdPlugin = vsapi->getPluginById("com.vapoursynth.std", core);
-
-        VSMap *args = vsapi->createMap();
-        vsapi->propSetNode(args, "super", d.super, paReplace);
-        vsapi->propSetInt(args, "isse", d.isse, paReplace);
-        VSMap *ret = vsapi->invoke(mvtoolsPlugin, "Finest", args);
-        if (vsapi->getError(ret)) {
-#define ERROR_SIZE 512
-            char error_msg[ERROR_SIZE + 1] = { 0 };
-            snprintf(error_msg, ERROR_SIZE, "FlowFPS: %s", vsapi->getError(ret));
-#undef ERROR_SIZE
-            vsapi->setError(out, error_msg);
-
-            vsapi->freeNode(d.super);
-            vsapi->freeNode(d.mvfw);
-            vsapi->freeNode(d.mvbw);
-            vsapi->freeMap(args);
-            vsapi->freeMap(ret);
-            return;
-        }
-        d.finest = vsapi->propGetNode(ret, "clip", 0, NULL);
-        vsapi->freeMap(ret);
-
-        vsapi->clearMap(args);
-        vsapi->propSetNode(args, "clip", d.finest, paReplace);
-        vsapi->freeNode(d.finest);
-        ret = vsapi->invoke(stdPlugin, "Cache", args);
-        vsapi->freeMap(args);
-        if (vsapi->getError(ret)) {
-#define ERROR_SIZE 512
-            char error_msg[ERROR_SIZE + 1] = { 0 };
-            snprintf(error_msg, ERROR_SIZE, "FlowFPS: %s", vsapi->getError(ret));
-#undef ERROR_SIZE
-            vsapi->setError(out, error_msg);
-
-            vsapi->freeNode(d.super);
-            vsapi->freeNode(d.mvfw);
-            vsapi->freeNode(d.mvbw);
-            vsapi->freeMap(ret);
-            return;
-        }
-        d.finest = vsapi->propGetNode(ret, "clip", 0, NULL);
-        vsapi->freeMap(ret);
-    }
-
     d.node = vsapi->propGetNode(in, "clip", 0, 0);
     d.oldvi = vsapi->getVideoInfo(d.node);
     d.vi = *d.oldvi;
@@ -755,7 +665,6 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
 
     if (d.vi.fpsNum == 0 || d.vi.fpsDen == 0) {
         vsapi->setError(out, "FlowFPS: The input clip must have a frame rate. Invoke AssumeFPS if necessary.");
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
@@ -789,7 +698,6 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
 
     if (d.mvbw_data.nWidth != d.vi.width || d.mvbw_data.nHeight != d.vi.height) {
         vsapi->setError(out, "FlowFPS: inconsistent source and vector frame size.");
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
@@ -803,7 +711,6 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
 
     if (d.mvbw_data.nHeight != nHeightS || d.mvbw_data.nWidth != nSuperWidth - d.nSuperHPad * 2) {
         vsapi->setError(out, "FlowFPS: wrong source or super clip frame size.");
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
@@ -813,7 +720,6 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
 
     if (!((d.mvbw_data.nWidth + d.mvbw_data.nHPadding * 2) == supervi->width && (d.mvbw_data.nHeight + d.mvbw_data.nVPadding * 2) <= supervi->height)) {
         vsapi->setError(out, "FlowFPS: inconsistent clips frame size! Incomprehensible error messages are the best, right?");
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
@@ -824,15 +730,29 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
     if (!isConstantFormat(&d.vi) || d.vi.format->bitsPerSample > 16 || d.vi.format->sampleType != stInteger || d.vi.format->subSamplingW > 1 || d.vi.format->subSamplingH > 1 || (d.vi.format->colorFamily != cmYUV && d.vi.format->colorFamily != cmGray)) {
         vsapi->setError(out, "FlowFPS: input clip must be GRAY, 420, 422, 440, or 444, up to 16 bits, with constant dimensions.");
         vsapi->freeNode(d.super);
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
         vsapi->freeNode(d.node);
         return;
     }
 
-    if (d.vi.format->bitsPerSample > 8)
-        d.isse = 0;
+    if (d.nSuperPel != d.mvbw_data.nPel) {
+        vsapi->setError(out, "FlowFPS: super clip and motion vector clips must have the same pel.");
+        vsapi->freeNode(d.super);
+        vsapi->freeNode(d.mvfw);
+        vsapi->freeNode(d.mvbw);
+        vsapi->freeNode(d.node);
+        return;
+    }
+
+    if (d.vi.format->colorFamily != cmGray && !(d.nSuperModeYUV & UVPLANES)) {
+        vsapi->setError(out, "FlowFPS: super clip must be created with chroma=True, unless the input clip is GRAY.");
+        vsapi->freeNode(d.super);
+        vsapi->freeNode(d.mvfw);
+        vsapi->freeNode(d.mvbw);
+        vsapi->freeNode(d.node);
+        return;
+    }
 
 
     d.nBlkXP = (d.mvbw_data.nBlkX * (d.mvbw_data.nBlkSizeX - d.mvbw_data.nOverlapX) + d.mvbw_data.nOverlapX < d.mvbw_data.nWidth) ? d.mvbw_data.nBlkX + 1 : d.mvbw_data.nBlkX;
@@ -845,15 +765,19 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
     d.nHeightUV = d.mvbw_data.nHeight / d.mvbw_data.yRatioUV;
     d.nWidthUV = d.mvbw_data.nWidth / d.mvbw_data.xRatioUV;
 
-    d.nHPaddingUV = d.mvbw_data.nHPadding / d.mvbw_data.xRatioUV;
-    d.nVPaddingUV = d.mvbw_data.nVPadding / d.mvbw_data.yRatioUV;
-
     d.VPitchY = (d.nWidthP + 15) & (~15);
     d.VPitchUV = (d.nWidthPUV + 15) & (~15);
 
-    simpleInit(&d.upsizer, d.nWidthP, d.nHeightP, d.nBlkXP, d.nBlkYP);
+    selectFlowInterFunctions(&d.FlowInter, &d.FlowInterSimple, &d.FlowInterExtra, d.vi.format->bitsPerSample, d.isse);
+
+    simpleInit(&d.upsizer, d.nWidthP, d.nHeightP, d.nBlkXP, d.nBlkYP, d.isse);
     if (d.vi.format->colorFamily != cmGray)
-        simpleInit(&d.upsizerUV, d.nWidthPUV, d.nHeightPUV, d.nBlkXP, d.nBlkYP);
+        simpleInit(&d.upsizerUV, d.nWidthPUV, d.nHeightPUV, d.nBlkXP, d.nBlkYP, d.isse);
+
+    // The masks made by mvflowfpsGetFrame.
+    d.scratchSize = 2 * arenaBufferSize(d.nBlkXP * d.nBlkYP) + 2 * arenaBufferSize(d.nHeightP * d.VPitchY);
+    if (d.vi.format->colorFamily != cmGray)
+        d.scratchSize += 2 * arenaBufferSize(d.nHeightPUV * d.VPitchUV);
 
 
     MVFlowFPSHelperData *hb = (MVFlowFPSHelperData *)malloc(sizeof(MVFlowFPSHelperData));
@@ -869,6 +793,7 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
     hb->supervi = hf->supervi = vsapi->getVideoInfo(d.super);
     hb->thscd1 = hf->thscd1 = d.thscd1;
     hb->thscd2 = hf->thscd2 = d.thscd2;
+    hb->ml = hf->ml = d.ml;
     hb->nHeightP = hf->nHeightP = d.nHeightP;
     hb->nHeightPUV = hf->nHeightPUV = d.nHeightPUV;
     hb->VPitchY = hf->VPitchY = d.VPitchY;
@@ -878,6 +803,17 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
     hb->upsizer = hf->upsizer = d.upsizer;
     hb->upsizerUV = hf->upsizerUV = d.upsizerUV;
 
+    // The buffers used by mvflowfpshelperGetFrame.
+    hb->scratchSize = 2 * arenaBufferSize(d.nHeightP * d.VPitchY * sizeof(int16_t)) +
+                      2 * arenaBufferSize(d.nBlkXP * d.nBlkYP * sizeof(int16_t)) +
+                      2 * arenaBufferSize(d.mvbw_data.nBlkX * d.mvbw_data.nBlkY);
+    if (d.vi.format->colorFamily != cmGray)
+        hb->scratchSize += 2 * arenaBufferSize(d.nHeightPUV * d.VPitchUV * sizeof(int16_t)) +
+                           2 * arenaBufferSize(d.nBlkXP * d.nBlkYP * sizeof(int16_t));
+    hf->scratchSize = hb->scratchSize;
+    hb->scratch = poolCreate(arenaPoolCreate, arenaPoolDestroy, &hb->scratchSize);
+    hf->scratch = poolCreate(arenaPoolCreate, arenaPoolDestroy, &hf->scratchSize);
+
     vsapi->createFilter(in, out, "FlowFPSHelper", mvflowfpshelperInit, mvflowfpshelperGetFrame, mvflowfpshelperFree, fmParallel, 0, hb, core);
 
     VSPlugin *std_plugin = vsapi->getPluginById("com.vapoursynth.std", core);
@@ -906,6 +842,8 @@ static void VS_CC mvflowfpsCreate(const VSMap *in, VSMap *out, void *userData, V
     data = (MVFlowFPSData *)malloc(sizeof(d));
     *data = d;
 
+    data->scratch = poolCreate(arenaPoolCreate, arenaPoolDestroy, &data->scratchSize);
+
     vsapi->createFilter(in, out, "FlowFPS", mvflowfpsInit, mvflowfpsGetFrame, mvflowfpsFree, fmParallel, 0, data, core);
 
     // AssumeFPS sets the _DurationNum and _DurationDen properties.
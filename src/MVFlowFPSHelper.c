@@ -3,6 +3,8 @@
 #include <VSHelper.h>
 
 #include "MaskFun.h"
+#include "ObjectPool.h"
+#include "ScratchArena.h"
 #include "SimpleResize.h"
 
 #include "MVFlowFPSHelper.h"
@@ -38,7 +40,6 @@ const VSFrameRef *VS_CC mvflowfpshelperGetFrame(int n, int activationReason, voi
 
         if (isUsable) {
             VSFrameRef *dst = vsapi->copyFrame(src, core);
-            vsapi->freeFrame(src);
 
             VSMap *props = vsapi->getFramePropsRW(dst);
 
@@ -58,67 +59,65 @@ const VSFrameRef *VS_CC mvflowfpshelperGetFrame(int n, int activationReason, voi
             int full_size_y = nHeightP * VPitchY;
             int small_size = nBlkXP * nBlkYP;
 
-            uint8_t *VXFullY = (uint8_t *)malloc(full_size_y);
-            uint8_t *VYFullY = (uint8_t *)malloc(full_size_y);
-            uint8_t *VXSmallY = (uint8_t *)malloc(small_size);
-            uint8_t *VYSmallY = (uint8_t *)malloc(small_size);
+            // propSetData makes copies.
+            ScratchArena *arena = (ScratchArena *)poolAcquire(d->scratch);
+
+            int16_t *VXFullY = (int16_t *)arenaAlloc(arena, full_size_y * sizeof(int16_t));
+            int16_t *VYFullY = (int16_t *)arenaAlloc(arena, full_size_y * sizeof(int16_t));
+            int16_t *VXSmallY = (int16_t *)arenaAlloc(arena, small_size * sizeof(int16_t));
+            int16_t *VYSmallY = (int16_t *)arenaAlloc(arena, small_size * sizeof(int16_t));
 
             // make  vector vx and vy small masks
-            // 1. ATTENTION: vectors are assumed SHORT (|vx|, |vy| < 127) !
-            // 2. they will be zeroed if not
-            // 3. added 128 to all values
             MakeVectorSmallMasks(&fgop, nBlkX, nBlkY, VXSmallY, nBlkXP, VYSmallY, nBlkXP);
             if (nBlkXP > nBlkX) { // fill right
                 for (int j = 0; j < nBlkY; j++) {
-                    VXSmallY[j * nBlkXP + nBlkX] = VSMIN(VXSmallY[j * nBlkXP + nBlkX - 1], 128);
+                    VXSmallY[j * nBlkXP + nBlkX] = VSMIN(VXSmallY[j * nBlkXP + nBlkX - 1], 0);
                     VYSmallY[j * nBlkXP + nBlkX] = VYSmallY[j * nBlkXP + nBlkX - 1];
                 }
             }
             if (nBlkYP > nBlkY) { // fill bottom
                 for (int i = 0; i < nBlkXP; i++) {
                     VXSmallY[nBlkXP * nBlkY + i] = VXSmallY[nBlkXP * (nBlkY - 1) + i];
-                    VYSmallY[nBlkXP * nBlkY + i] = VSMIN(VYSmallY[nBlkXP * (nBlkY - 1) + i], 128);
+                    VYSmallY[nBlkXP * nBlkY + i] = VSMIN(VYSmallY[nBlkXP * (nBlkY - 1) + i], 0);
                 }
             }
 
-            simpleResize(upsizer, VXFullY, VPitchY, VXSmallY, nBlkXP);
-            simpleResize(upsizer, VYFullY, VPitchY, VYSmallY, nBlkXP);
-
-            vsapi->propSetData(props, prop_VXFullY, (const char *)VXFullY, full_size_y, paReplace);
-            vsapi->propSetData(props, prop_VYFullY, (const char *)VYFullY, full_size_y, paReplace);
+            simpleResizeVectors(upsizer, VXFullY, VYFullY, VPitchY, VXSmallY, VYSmallY, nBlkXP);
 
-            free(VXFullY);
-            free(VYFullY);
+            vsapi->propSetData(props, prop_VXFullY, (const char *)VXFullY, full_size_y * sizeof(int16_t), paReplace);
+            vsapi->propSetData(props, prop_VYFullY, (const char *)VYFullY, full_size_y * sizeof(int16_t), paReplace);
 
             if (d->supervi->format->colorFamily != cmGray) {
                 int full_size_uv = nHeightPUV * VPitchUV;
 
-                uint8_t *VXFullUV = (uint8_t *)malloc(full_size_uv);
-                uint8_t *VYFullUV = (uint8_t *)malloc(full_size_uv);
-                uint8_t *VXSmallUV = (uint8_t *)malloc(small_size);
-                uint8_t *VYSmallUV = (uint8_t *)malloc(small_size);
+                int16_t *VXFullUV = (int16_t *)arenaAlloc(arena, full_size_uv * sizeof(int16_t));
+                int16_t *VYFullUV = (int16_t *)arenaAlloc(arena, full_size_uv * sizeof(int16_t));
+                int16_t *VXSmallUV = (int16_t *)arenaAlloc(arena, small_size * sizeof(int16_t));
+                int16_t *VYSmallUV = (int16_t *)arenaAlloc(arena, small_size * sizeof(int16_t));
 
                 VectorSmallMaskYToHalfUV(VXSmallY, nBlkXP, nBlkYP, VXSmallUV, xRatioUV);
                 VectorSmallMaskYToHalfUV(VYSmallY, nBlkXP, nBlkYP, VYSmallUV, yRatioUV);
 
-                simpleResize(upsizerUV, VXFullUV, VPitchUV, VXSmallUV, nBlkXP);
-                simpleResize(upsizerUV, VYFullUV, VPitchUV, VYSmallUV, nBlkXP);
+                simpleResizeVectors(upsizerUV, VXFullUV, VYFullUV, VPitchUV, VXSmallUV, VYSmallUV, nBlkXP);
 
-                free(VXSmallUV);
-                free(VYSmallUV);
+                vsapi->propSetData(props, prop_VXFullUV, (const char *)VXFullUV, full_size_uv * sizeof(int16_t), paReplace);
+                vsapi->propSetData(props, prop_VYFullUV, (const char *)VYFullUV, full_size_uv * sizeof(int16_t), paReplace);
+            }
 
-                vsapi->propSetData(props, prop_VXFullUV, (const char *)VXFullUV, full_size_uv, paReplace);
-                vsapi->propSetData(props, prop_VYFullUV, (const char *)VYFullUV, full_size_uv, paReplace);
+            // The time-independent part of the occlusion masks.
+            uint8_t *occX = (uint8_t *)arenaAlloc(arena, nBlkX * nBlkY);
+            uint8_t *occY = (uint8_t *)arenaAlloc(arena, nBlkX * nBlkY);
 
-                free(VXFullUV);
-                free(VYFullUV);
-            }
+            MakeVectorOcclusionStrengths(&fgop, nBlkX, nBlkY, d->ml, 1.0, d->vectors_data.nPel, occX, occY);
 
-            free(VXSmallY);
-            free(VYSmallY);
+            vsapi->propSetData(props, prop_OcclusionX, (const char *)occX, nBlkX * nBlkY, paReplace);
+            vsapi->propSetData(props, prop_OcclusionY, (const char *)occY, nBlkX * nBlkY, paReplace);
 
+            arenaReset(arena);
+            poolRelease(d->scratch, arena);
 
             fgopDeinit(&fgop);
+            vsapi->freeFrame(src);
 
             return dst;
         } else { // poor estimation
@@ -137,6 +136,7 @@ void VS_CC mvflowfpshelperFree(void *instanceData, VSCore *core, const VSAPI *vs
 
     MVFlowFPSHelperData *d = (MVFlowFPSHelperData *)instanceData;
 
+    poolFree(d->scratch);
     vsapi->freeNode(d->vectors);
 
     free(d);
@@ -8,6 +8,7 @@ extern "C" {
 #include <VapourSynth.h>
 
 #include "MVAnalysisData.h"
+#include "ObjectPool.h"
 #include "SimpleResize.h"
 
 typedef struct MVFlowFPSHelperData {
@@ -17,6 +18,7 @@ typedef struct MVFlowFPSHelperData {
     const VSVideoInfo *supervi;
 
     int thscd1, thscd2;
+    double ml;
 
     MVAnalysisData vectors_data;
 
@@ -29,6 +31,9 @@ typedef struct MVFlowFPSHelperData {
 
     SimpleResize upsizer;
     SimpleResize upsizerUV;
+
+    size_t scratchSize;
+    ObjectPool *scratch;
 } MVFlowFPSHelperData;
 
 
@@ -36,6 +41,9 @@ static const char prop_VXFullY[] = "VXFullY";
 static const char prop_VYFullY[] = "VYFullY";
 static const char prop_VXFullUV[] = "VXFullUV";
 static const char prop_VYFullUV[] = "VYFullUV";
+// From MakeVectorOcclusionStrengths.
+static const char prop_OcclusionX[] = "OcclusionX";
+static const char prop_OcclusionY[] = "OcclusionY";
 
 
 void VS_CC mvflowfpshelperInit(VSMap *in, VSMap *out, void **instanceData, VSNode *node, VSCore *core, const VSAPI *vsapi);
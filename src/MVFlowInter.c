@@ -27,8 +27,11 @@
 
 #include "Bullshit.h"
 #include "Fakery.h"
+#include "GroupOfFramesCache.h"
 #include "MaskFun.h"
 #include "MVAnalysisData.h"
+#include "ObjectPool.h"
+#include "ScratchArena.h"
 #include "SimpleResize.h"
 
 
@@ -36,7 +39,6 @@ typedef struct MVFlowInterData {
     VSNodeRef *node;
     const VSVideoInfo *vi;
 
-    VSNodeRef *finest;
     VSNodeRef *super;
     VSNodeRef *mvbw;
     VSNodeRef *mvfw;
@@ -52,6 +54,12 @@ typedef struct MVFlowInterData {
     MVAnalysisData mvfw_data;
 
     int nSuperHPad;
+    int nSuperVPad;
+    int nSuperPel;
+    int nSuperModeYUV;
+    int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
 
     int nBlkXP;
     int nBlkYP;
@@ -61,18 +69,20 @@ typedef struct MVFlowInterData {
     int nHeightPUV;
     int nWidthUV;
     int nHeightUV;
-    int nVPaddingUV;
-    int nHPaddingUV;
     int VPitchY;
     int VPitchUV;
 
     int time256;
 
-    int *LUTVB;
-    int *LUTVF;
+
+    FlowInterFunction FlowInter;
+    FlowInterExtraFunction FlowInterExtra;
 
     SimpleResize upsizer;
     SimpleResize upsizerUV;
+
+    size_t scratchSize;
+    ObjectPool *scratch;
 } MVFlowInterData;
 
 
@@ -100,18 +110,18 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
             vsapi->requestFrameFilter(n, d->mvbw, frameCtx);
             vsapi->requestFrameFilter(n + off, d->mvbw, frameCtx);
 
-            vsapi->requestFrameFilter(n, d->finest, frameCtx);
-            vsapi->requestFrameFilter(n + off, d->finest, frameCtx);
+            vsapi->requestFrameFilter(n, d->super, frameCtx);
+            vsapi->requestFrameFilter(n + off, d->super, frameCtx);
         }
 
         vsapi->requestFrameFilter(n, d->node, frameCtx);
         vsapi->requestFrameFilter(VSMIN(n + off, d->vi->numFrames - 1), d->node, frameCtx);
     } else if (activationReason == arAllFramesReady) {
         uint8_t *pDst[3];
-        const uint8_t *pRef[3], *pSrc[3];
+        const uint8_t *pRef[3] = { NULL }, *pSrc[3] = { NULL };
         int nDstPitches[3];
-        int nRefPitches[3];
-        int nSrcPitches[3];
+        int nRefPitches[3] = { 0 };
+        int nSrcPitches[3] = { 0 };
 
         FakeGroupOfPlanes fgopF, fgopB;
 
@@ -123,17 +133,18 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
 
         int off = d->mvbw_data.nDeltaFrame; // integer offset of reference frame
 
+        // The fgops point into the vector frames' properties, so they are kept until fgopDeinit.
+        const VSFrameRef *mvF = NULL, *mvB = NULL, *mvFF = NULL, *mvBB = NULL;
+
         if (n + off < d->vi->numFrames) {
-            const VSFrameRef *mvF = vsapi->getFrameFilter(n + off, d->mvfw, frameCtx);
+            mvF = vsapi->getFrameFilter(n + off, d->mvfw, frameCtx);
             const VSMap *mvprops = vsapi->getFramePropsRO(mvF);
             fgopUpdate(&fgopF, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
-            vsapi->freeFrame(mvF);
             isUsableF = fgopIsUsable(&fgopF, d->thscd1, d->thscd2);
 
-            const VSFrameRef *mvB = vsapi->getFrameFilter(n, d->mvbw, frameCtx);
+            mvB = vsapi->getFrameFilter(n, d->mvbw, frameCtx);
             mvprops = vsapi->getFramePropsRO(mvB);
             fgopUpdate(&fgopB, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
-            vsapi->freeFrame(mvB);
             isUsableB = fgopIsUsable(&fgopB, d->thscd1, d->thscd2);
         }
 
@@ -145,11 +156,10 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
         const int blend = d->blend;
 
         int bitsPerSample = d->vi->format->bitsPerSample;
-        int bytesPerSample = d->vi->format->bytesPerSample;
 
         if (isUsableB && isUsableF) {
-            const VSFrameRef *src = vsapi->getFrameFilter(n, d->finest, frameCtx);
-            const VSFrameRef *ref = vsapi->getFrameFilter(n + off, d->finest, frameCtx); //  ref for  compensation
+            const VSFrameRef *src = vsapi->getFrameFilter(n, d->super, frameCtx);
+            const VSFrameRef *ref = vsapi->getFrameFilter(n + off, d->super, frameCtx); //  ref for  compensation
             VSFrameRef *dst = vsapi->newVideoFrame(d->vi->format, d->vi->width, d->vi->height, src, core);
 
             for (int i = 0; i < d->vi->format->numPlanes; i++) {
@@ -170,10 +180,6 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
             const int nBlkSizeY = d->mvbw_data.nBlkSizeY;
             const int nOverlapX = d->mvbw_data.nOverlapX;
             const int nOverlapY = d->mvbw_data.nOverlapY;
-            const int nVPadding = d->mvbw_data.nVPadding;
-            const int nHPadding = d->mvbw_data.nHPadding;
-            const int nVPaddingUV = d->nVPaddingUV;
-            const int nHPaddingUV = d->nHPaddingUV;
             const int nPel = d->mvbw_data.nPel;
             const int VPitchY = d->VPitchY;
             const int VPitchUV = d->VPitchUV;
@@ -183,49 +189,62 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
             const int nBlkYP = d->nBlkYP;
             SimpleResize *upsizer = &d->upsizer;
             SimpleResize *upsizerUV = &d->upsizerUV;
-            const int *LUTVB = d->LUTVB;
-            const int *LUTVF = d->LUTVF;
-
-            int nOffsetY = nRefPitches[0] * nVPadding * nPel + nHPadding * bytesPerSample * nPel;
-            int nOffsetUV = nRefPitches[1] * nVPaddingUV * nPel + nHPaddingUV * bytesPerSample * nPel;
-
-
-            uint8_t *VXFullYB = (uint8_t *)malloc(nHeightP * VPitchY);
-            uint8_t *VYFullYB = (uint8_t *)malloc(nHeightP * VPitchY);
-            uint8_t *VXFullYF = (uint8_t *)malloc(nHeightP * VPitchY);
-            uint8_t *VYFullYF = (uint8_t *)malloc(nHeightP * VPitchY);
-            uint8_t *VXSmallYB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *VYSmallYB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *VXSmallYF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *VYSmallYF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *MaskSmallB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *MaskFullYB = (uint8_t *)malloc(nHeightP * VPitchY);
-            uint8_t *MaskSmallF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-            uint8_t *MaskFullYF = (uint8_t *)malloc(nHeightP * VPitchY);
-            uint8_t *VXFullUVB = NULL;
-            uint8_t *VYFullUVB = NULL;
-            uint8_t *VXFullUVF = NULL;
-            uint8_t *VYFullUVF = NULL;
-            uint8_t *VXSmallUVB = NULL;
-            uint8_t *VYSmallUVB = NULL;
-            uint8_t *VXSmallUVF = NULL;
-            uint8_t *VYSmallUVF = NULL;
+
+            int err;
+            int64_t srcSerial = vsapi->propGetInt(vsapi->getFramePropsRO(src), "Super_serial", 0, &err);
+            int64_t refSerial = vsapi->propGetInt(vsapi->getFramePropsRO(ref), "Super_serial", 0, &err);
+
+            MVGroupOfFrames *pSrcGOF = gofcAcquire(pSrc, nSrcPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
+            MVGroupOfFrames *pRefGOF = gofcAcquire(pRef, nRefPitches, d->nSuperLevels, nWidth, nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, xRatioUV, yRatioUV, bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
+
+            // The subplanes are sampled directly, so the super clip doesn't need to go through Finest.
+            MVPlane **pSrcPlanes = pSrcGOF->frames[0]->planes;
+            MVPlane **pRefPlanes = pRefGOF->frames[0]->planes;
+            const uint8_t *pSrcSubplanes[3][16];
+            const uint8_t *pRefSubplanes[3][16];
+
+            for (int i = 0; i < 3; i++) {
+                if (pSrcPlanes[i]) {
+                    mvpGetSubplanePointers(pSrcPlanes[i], pSrcSubplanes[i]);
+                    mvpGetSubplanePointers(pRefPlanes[i], pRefSubplanes[i]);
+                }
+            }
+
+            ScratchArena *arena = (ScratchArena *)poolAcquire(d->scratch);
+
+            int16_t *VXFullYB = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+            int16_t *VYFullYB = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+            int16_t *VXFullYF = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+            int16_t *VYFullYF = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+            int16_t *VXSmallYB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+            int16_t *VYSmallYB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+            int16_t *VXSmallYF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+            int16_t *VYSmallYF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+            uint8_t *MaskSmallB = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
+            uint8_t *MaskFullYB = (uint8_t *)arenaAlloc(arena, nHeightP * VPitchY);
+            uint8_t *MaskSmallF = (uint8_t *)arenaAlloc(arena, nBlkXP * nBlkYP);
+            uint8_t *MaskFullYF = (uint8_t *)arenaAlloc(arena, nHeightP * VPitchY);
+            int16_t *VXFullUVB = NULL;
+            int16_t *VYFullUVB = NULL;
+            int16_t *VXFullUVF = NULL;
+            int16_t *VYFullUVF = NULL;
+            int16_t *VXSmallUVB = NULL;
+            int16_t *VYSmallUVB = NULL;
+            int16_t *VXSmallUVF = NULL;
+            int16_t *VYSmallUVF = NULL;
             uint8_t *MaskFullUVB = NULL;
             uint8_t *MaskFullUVF = NULL;
 
 
             // make  vector vx and vy small masks
-            // 1. ATTENTION: vectors are assumed SHORT (|vx|, |vy| < 127) !
-            // 2. they will be zeroed if not
-            // 3. added 128 to all values
             MakeVectorSmallMasks(&fgopB, nBlkX, nBlkY, VXSmallYB, nBlkXP, VYSmallYB, nBlkXP);
             MakeVectorSmallMasks(&fgopF, nBlkX, nBlkY, VXSmallYF, nBlkXP, VYSmallYF, nBlkXP);
             if (nBlkXP > nBlkX) // fill right
             {
                 for (int j = 0; j < nBlkY; j++) {
-                    VXSmallYB[j * nBlkXP + nBlkX] = VSMIN(VXSmallYB[j * nBlkXP + nBlkX - 1], 128);
+                    VXSmallYB[j * nBlkXP + nBlkX] = VSMIN(VXSmallYB[j * nBlkXP + nBlkX - 1], 0);
                     VYSmallYB[j * nBlkXP + nBlkX] = VYSmallYB[j * nBlkXP + nBlkX - 1];
-                    VXSmallYF[j * nBlkXP + nBlkX] = VSMIN(VXSmallYF[j * nBlkXP + nBlkX - 1], 128);
+                    VXSmallYF[j * nBlkXP + nBlkX] = VSMIN(VXSmallYF[j * nBlkXP + nBlkX - 1], 0);
                     VYSmallYF[j * nBlkXP + nBlkX] = VYSmallYF[j * nBlkXP + nBlkX - 1];
                 }
             }
@@ -233,9 +252,9 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
             {
                 for (int i = 0; i < nBlkXP; i++) {
                     VXSmallYB[nBlkXP * nBlkY + i] = VXSmallYB[nBlkXP * (nBlkY - 1) + i];
-                    VYSmallYB[nBlkXP * nBlkY + i] = VSMIN(VYSmallYB[nBlkXP * (nBlkY - 1) + i], 128);
+                    VYSmallYB[nBlkXP * nBlkY + i] = VSMIN(VYSmallYB[nBlkXP * (nBlkY - 1) + i], 0);
                     VXSmallYF[nBlkXP * nBlkY + i] = VXSmallYF[nBlkXP * (nBlkY - 1) + i];
-                    VYSmallYF[nBlkXP * nBlkY + i] = VSMIN(VYSmallYF[nBlkXP * (nBlkY - 1) + i], 128);
+                    VYSmallYF[nBlkXP * nBlkY + i] = VSMIN(VYSmallYF[nBlkXP * (nBlkY - 1) + i], 0);
                 }
             }
             // analyse vectors field to detect occlusion
@@ -260,63 +279,57 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
             // upsize (bilinear interpolate) vector masks to fullframe size
 
 
-            simpleResize(upsizer, VXFullYB, VPitchY, VXSmallYB, nBlkXP);
-            simpleResize(upsizer, VYFullYB, VPitchY, VYSmallYB, nBlkXP);
-            simpleResize(upsizer, VXFullYF, VPitchY, VXSmallYF, nBlkXP);
-            simpleResize(upsizer, VYFullYF, VPitchY, VYSmallYF, nBlkXP);
-            simpleResize(upsizer, MaskFullYB, VPitchY, MaskSmallB, nBlkXP);
-            simpleResize(upsizer, MaskFullYF, VPitchY, MaskSmallF, nBlkXP);
+            simpleResizeVectors(upsizer, VXFullYB, VYFullYB, VPitchY, VXSmallYB, VYSmallYB, nBlkXP);
+            simpleResizeVectors(upsizer, VXFullYF, VYFullYF, VPitchY, VXSmallYF, VYSmallYF, nBlkXP);
+            simpleResize_uint8_t(upsizer, MaskFullYB, VPitchY, MaskSmallB, nBlkXP);
+            simpleResize_uint8_t(upsizer, MaskFullYF, VPitchY, MaskSmallF, nBlkXP);
 
             if (d->vi->format->colorFamily != cmGray) {
-                VXFullUVB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                VYFullUVB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                VXFullUVF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                VYFullUVF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                VXSmallUVB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                VYSmallUVB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                VXSmallUVF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                VYSmallUVF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                MaskFullUVB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                MaskFullUVF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
+                VXFullUVB = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                VYFullUVB = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                VXFullUVF = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                VYFullUVF = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                VXSmallUVB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                VYSmallUVB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                VXSmallUVF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                VYSmallUVF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                MaskFullUVB = (uint8_t *)arenaAlloc(arena, nHeightPUV * VPitchUV);
+                MaskFullUVF = (uint8_t *)arenaAlloc(arena, nHeightPUV * VPitchUV);
 
                 VectorSmallMaskYToHalfUV(VXSmallYB, nBlkXP, nBlkYP, VXSmallUVB, xRatioUV);
                 VectorSmallMaskYToHalfUV(VYSmallYB, nBlkXP, nBlkYP, VYSmallUVB, yRatioUV);
                 VectorSmallMaskYToHalfUV(VXSmallYF, nBlkXP, nBlkYP, VXSmallUVF, xRatioUV);
                 VectorSmallMaskYToHalfUV(VYSmallYF, nBlkXP, nBlkYP, VYSmallUVF, yRatioUV);
 
-                simpleResize(upsizerUV, VXFullUVB, VPitchUV, VXSmallUVB, nBlkXP);
-                simpleResize(upsizerUV, VYFullUVB, VPitchUV, VYSmallUVB, nBlkXP);
-                simpleResize(upsizerUV, VXFullUVF, VPitchUV, VXSmallUVF, nBlkXP);
-                simpleResize(upsizerUV, VYFullUVF, VPitchUV, VYSmallUVF, nBlkXP);
-                simpleResize(upsizerUV, MaskFullUVB, VPitchUV, MaskSmallB, nBlkXP);
-                simpleResize(upsizerUV, MaskFullUVF, VPitchUV, MaskSmallF, nBlkXP);
+                simpleResizeVectors(upsizerUV, VXFullUVB, VYFullUVB, VPitchUV, VXSmallUVB, VYSmallUVB, nBlkXP);
+                simpleResizeVectors(upsizerUV, VXFullUVF, VYFullUVF, VPitchUV, VXSmallUVF, VYSmallUVF, nBlkXP);
+                simpleResize_uint8_t(upsizerUV, MaskFullUVB, VPitchUV, MaskSmallB, nBlkXP);
+                simpleResize_uint8_t(upsizerUV, MaskFullUVF, VPitchUV, MaskSmallF, nBlkXP);
             }
 
 
             {
-                const VSFrameRef *mvFF = vsapi->getFrameFilter(n, d->mvfw, frameCtx);
+                mvFF = vsapi->getFrameFilter(n, d->mvfw, frameCtx);
                 const VSMap *mvprops = vsapi->getFramePropsRO(mvFF);
                 fgopUpdate(&fgopF, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
                 isUsableF = fgopIsUsable(&fgopF, d->thscd1, d->thscd2);
-                vsapi->freeFrame(mvFF);
 
-                const VSFrameRef *mvBB = vsapi->getFrameFilter(n + off, d->mvbw, frameCtx);
+                mvBB = vsapi->getFrameFilter(n + off, d->mvbw, frameCtx);
                 mvprops = vsapi->getFramePropsRO(mvBB);
                 fgopUpdate(&fgopB, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
                 isUsableB = fgopIsUsable(&fgopB, d->thscd1, d->thscd2);
-                vsapi->freeFrame(mvBB);
             }
 
 
             if (isUsableF && isUsableB) {
-                uint8_t *VXFullYBB = (uint8_t *)malloc(nHeightP * VPitchY);
-                uint8_t *VYFullYBB = (uint8_t *)malloc(nHeightP * VPitchY);
-                uint8_t *VXFullYFF = (uint8_t *)malloc(nHeightP * VPitchY);
-                uint8_t *VYFullYFF = (uint8_t *)malloc(nHeightP * VPitchY);
-                uint8_t *VXSmallYBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                uint8_t *VYSmallYBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                uint8_t *VXSmallYFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                uint8_t *VYSmallYFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
+                int16_t *VXFullYBB = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+                int16_t *VYFullYBB = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+                int16_t *VXFullYFF = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+                int16_t *VYFullYFF = (int16_t *)arenaAlloc(arena, nHeightP * VPitchY * sizeof(int16_t));
+                int16_t *VXSmallYBB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                int16_t *VYSmallYBB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                int16_t *VXSmallYFF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                int16_t *VYSmallYFF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
 
                 // get vector mask from extra frames
                 MakeVectorSmallMasks(&fgopB, nBlkX, nBlkY, VXSmallYBB, nBlkXP, VYSmallYBB, nBlkXP);
@@ -324,9 +337,9 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
                 if (nBlkXP > nBlkX) // fill right
                 {
                     for (int j = 0; j < nBlkY; j++) {
-                        VXSmallYBB[j * nBlkXP + nBlkX] = VSMIN(VXSmallYBB[j * nBlkXP + nBlkX - 1], 128);
+                        VXSmallYBB[j * nBlkXP + nBlkX] = VSMIN(VXSmallYBB[j * nBlkXP + nBlkX - 1], 0);
                         VYSmallYBB[j * nBlkXP + nBlkX] = VYSmallYBB[j * nBlkXP + nBlkX - 1];
-                        VXSmallYFF[j * nBlkXP + nBlkX] = VSMIN(VXSmallYFF[j * nBlkXP + nBlkX - 1], 128);
+                        VXSmallYFF[j * nBlkXP + nBlkX] = VSMIN(VXSmallYFF[j * nBlkXP + nBlkX - 1], 0);
                         VYSmallYFF[j * nBlkXP + nBlkX] = VYSmallYFF[j * nBlkXP + nBlkX - 1];
                     }
                 }
@@ -334,113 +347,74 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
                 {
                     for (int i = 0; i < nBlkXP; i++) {
                         VXSmallYBB[nBlkXP * nBlkY + i] = VXSmallYBB[nBlkXP * (nBlkY - 1) + i];
-                        VYSmallYBB[nBlkXP * nBlkY + i] = VSMIN(VYSmallYBB[nBlkXP * (nBlkY - 1) + i], 128);
+                        VYSmallYBB[nBlkXP * nBlkY + i] = VSMIN(VYSmallYBB[nBlkXP * (nBlkY - 1) + i], 0);
                         VXSmallYFF[nBlkXP * nBlkY + i] = VXSmallYFF[nBlkXP * (nBlkY - 1) + i];
-                        VYSmallYFF[nBlkXP * nBlkY + i] = VSMIN(VYSmallYFF[nBlkXP * (nBlkY - 1) + i], 128);
+                        VYSmallYFF[nBlkXP * nBlkY + i] = VSMIN(VYSmallYFF[nBlkXP * (nBlkY - 1) + i], 0);
                     }
                 }
 
                 // upsize vectors to full frame
-                simpleResize(upsizer, VXFullYBB, VPitchY, VXSmallYBB, nBlkXP);
-                simpleResize(upsizer, VYFullYBB, VPitchY, VYSmallYBB, nBlkXP);
-                simpleResize(upsizer, VXFullYFF, VPitchY, VXSmallYFF, nBlkXP);
-                simpleResize(upsizer, VYFullYFF, VPitchY, VYSmallYFF, nBlkXP);
+                simpleResizeVectors(upsizer, VXFullYBB, VYFullYBB, VPitchY, VXSmallYBB, VYSmallYBB, nBlkXP);
+                simpleResizeVectors(upsizer, VXFullYFF, VYFullYFF, VPitchY, VXSmallYFF, VYSmallYFF, nBlkXP);
 
-                FlowInterExtra(pDst[0], nDstPitches[0], pRef[0] + nOffsetY, pSrc[0] + nOffsetY, nRefPitches[0],
-                               VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
-                               nWidth, nHeight, time256, nPel, LUTVB, LUTVF, VXFullYBB, VXFullYFF, VYFullYBB, VYFullYFF, bitsPerSample);
+                d->FlowInterExtra(pDst[0], nDstPitches[0], pRefSubplanes[0], pSrcSubplanes[0], pRefPlanes[0]->nPitch,
+                                  VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
+                                  nWidth, nHeight, time256, nPel, VXFullYBB, VXFullYFF, VYFullYBB, VYFullYFF);
 
                 if (d->vi->format->colorFamily != cmGray) {
-                    uint8_t *VXFullUVFF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    uint8_t *VXFullUVBB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    uint8_t *VYFullUVBB = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    uint8_t *VYFullUVFF = (uint8_t *)malloc(nHeightPUV * VPitchUV);
-                    uint8_t *VXSmallUVBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                    uint8_t *VYSmallUVBB = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                    uint8_t *VXSmallUVFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
-                    uint8_t *VYSmallUVFF = (uint8_t *)malloc(nBlkXP * nBlkYP);
+                    int16_t *VXFullUVFF = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                    int16_t *VXFullUVBB = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                    int16_t *VYFullUVBB = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                    int16_t *VYFullUVFF = (int16_t *)arenaAlloc(arena, nHeightPUV * VPitchUV * sizeof(int16_t));
+                    int16_t *VXSmallUVBB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                    int16_t *VYSmallUVBB = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                    int16_t *VXSmallUVFF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
+                    int16_t *VYSmallUVFF = (int16_t *)arenaAlloc(arena, nBlkXP * nBlkYP * sizeof(int16_t));
 
                     VectorSmallMaskYToHalfUV(VXSmallYBB, nBlkXP, nBlkYP, VXSmallUVBB, xRatioUV);
                     VectorSmallMaskYToHalfUV(VYSmallYBB, nBlkXP, nBlkYP, VYSmallUVBB, yRatioUV);
                     VectorSmallMaskYToHalfUV(VXSmallYFF, nBlkXP, nBlkYP, VXSmallUVFF, xRatioUV);
                     VectorSmallMaskYToHalfUV(VYSmallYFF, nBlkXP, nBlkYP, VYSmallUVFF, yRatioUV);
 
-                    simpleResize(upsizerUV, VXFullUVBB, VPitchUV, VXSmallUVBB, nBlkXP);
-                    simpleResize(upsizerUV, VYFullUVBB, VPitchUV, VYSmallUVBB, nBlkXP);
-                    simpleResize(upsizerUV, VXFullUVFF, VPitchUV, VXSmallUVFF, nBlkXP);
-                    simpleResize(upsizerUV, VYFullUVFF, VPitchUV, VYSmallUVFF, nBlkXP);
-
-                    FlowInterExtra(pDst[1], nDstPitches[1], pRef[1] + nOffsetUV, pSrc[1] + nOffsetUV, nRefPitches[1],
-                                   VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                                   nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF, bitsPerSample);
-                    FlowInterExtra(pDst[2], nDstPitches[2], pRef[2] + nOffsetUV, pSrc[2] + nOffsetUV, nRefPitches[2],
-                                   VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                                   nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF, bitsPerSample);
-
-                    free(VXFullUVBB);
-                    free(VYFullUVBB);
-                    free(VXSmallUVBB);
-                    free(VYSmallUVBB);
-                    free(VXFullUVFF);
-                    free(VYFullUVFF);
-                    free(VXSmallUVFF);
-                    free(VYSmallUVFF);
-                }
+                    simpleResizeVectors(upsizerUV, VXFullUVBB, VYFullUVBB, VPitchUV, VXSmallUVBB, VYSmallUVBB, nBlkXP);
+                    simpleResizeVectors(upsizerUV, VXFullUVFF, VYFullUVFF, VPitchUV, VXSmallUVFF, VYSmallUVFF, nBlkXP);
 
-                free(VXFullYBB);
-                free(VYFullYBB);
-                free(VXSmallYBB);
-                free(VYSmallYBB);
-                free(VXFullYFF);
-                free(VYFullYFF);
-                free(VXSmallYFF);
-                free(VYSmallYFF);
+                    d->FlowInterExtra(pDst[1], nDstPitches[1], pRefSubplanes[1], pSrcSubplanes[1], pRefPlanes[1]->nPitch,
+                                      VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                      nWidthUV, nHeightUV, time256, nPel, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF);
+                    d->FlowInterExtra(pDst[2], nDstPitches[2], pRefSubplanes[2], pSrcSubplanes[2], pRefPlanes[2]->nPitch,
+                                      VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                      nWidthUV, nHeightUV, time256, nPel, VXFullUVBB, VXFullUVFF, VYFullUVBB, VYFullUVFF);
+                }
             } else { // bad extra frames, use old method without extra frames
-                FlowInter(pDst[0], nDstPitches[0], pRef[0] + nOffsetY, pSrc[0] + nOffsetY, nRefPitches[0],
-                          VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
-                          nWidth, nHeight, time256, nPel, LUTVB, LUTVF, bitsPerSample);
+                d->FlowInter(pDst[0], nDstPitches[0], pRefSubplanes[0], pSrcSubplanes[0], pRefPlanes[0]->nPitch,
+                             VXFullYB, VXFullYF, VYFullYB, VYFullYF, MaskFullYB, MaskFullYF, VPitchY,
+                             nWidth, nHeight, time256, nPel);
                 if (d->vi->format->colorFamily != cmGray) {
-                    FlowInter(pDst[1], nDstPitches[1], pRef[1] + nOffsetUV, pSrc[1] + nOffsetUV, nRefPitches[1],
-                              VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                              nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, bitsPerSample);
-                    FlowInter(pDst[2], nDstPitches[2], pRef[2] + nOffsetUV, pSrc[2] + nOffsetUV, nRefPitches[2],
-                              VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
-                              nWidthUV, nHeightUV, time256, nPel, LUTVB, LUTVF, bitsPerSample);
+                    d->FlowInter(pDst[1], nDstPitches[1], pRefSubplanes[1], pSrcSubplanes[1], pRefPlanes[1]->nPitch,
+                                 VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                 nWidthUV, nHeightUV, time256, nPel);
+                    d->FlowInter(pDst[2], nDstPitches[2], pRefSubplanes[2], pSrcSubplanes[2], pRefPlanes[2]->nPitch,
+                                 VXFullUVB, VXFullUVF, VYFullUVB, VYFullUVF, MaskFullUVB, MaskFullUVF, VPitchUV,
+                                 nWidthUV, nHeightUV, time256, nPel);
                 }
             }
 
+            arenaReset(arena);
+            poolRelease(d->scratch, arena);
 
-            free(VXFullYB);
-            free(VYFullYB);
-            free(VXSmallYB);
-            free(VYSmallYB);
-            free(VXFullYF);
-            free(VYFullYF);
-            free(VXSmallYF);
-            free(VYSmallYF);
-            free(MaskSmallB);
-            free(MaskFullYB);
-            free(MaskSmallF);
-            free(MaskFullYF);
-
-            if (d->vi->format->colorFamily != cmGray) {
-                free(VXFullUVB);
-                free(VYFullUVB);
-                free(VXSmallUVB);
-                free(VYSmallUVB);
-                free(VXFullUVF);
-                free(VYFullUVF);
-                free(VXSmallUVF);
-                free(VYSmallUVF);
-                free(MaskFullUVB);
-                free(MaskFullUVF);
-            }
+            gofcRelease(pSrcGOF);
+            gofcRelease(pRefGOF);
 
             vsapi->freeFrame(src);
             vsapi->freeFrame(ref);
 
             fgopDeinit(&fgopF);
             fgopDeinit(&fgopB);
+            vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvB);
+            vsapi->freeFrame(mvFF);
+            vsapi->freeFrame(mvBB);
 
             return dst;
         } else { // not usable
@@ -448,6 +422,10 @@ static const VSFrameRef *VS_CC mvflowinterGetFrame(int n, int activationReason,
 
             fgopDeinit(&fgopF);
             fgopDeinit(&fgopB);
+            vsapi->freeFrame(mvF);
+            vsapi->freeFrame(mvB);
+            vsapi->freeFrame(mvFF);
+            vsapi->freeFrame(mvBB);
 
             const VSFrameRef *src = vsapi->getFrameFilter(n, d->node, frameCtx);
 
@@ -496,10 +474,8 @@ static void VS_CC mvflowinterFree(void *instanceData, VSCore *core, const VSAPI
     if (d->vi->format->colorFamily != cmGray)
         simpleDeinit(&d->upsizerUV);
 
-    free(d->LUTVB);
-    free(d->LUTVF);
+    poolFree(d->scratch);
 
-    vsapi->freeNode(d->finest);
     vsapi->freeNode(d->super);
     vsapi->freeNode(d->mvfw);
     vsapi->freeNode(d->mvbw);
@@ -567,12 +543,18 @@ static void VS_CC mvflowinterCreate(const VSMap *in, VSMap *out, void *userData,
         return;
     }
     const VSMap *props = vsapi->getFramePropsRO(evil);
-    int evil_err[2];
+    int evil_err[6];
     int nHeightS = int64ToIntS(vsapi->propGetInt(props, "Super_height", 0, &evil_err[0]));
     d.nSuperHPad = int64ToIntS(vsapi->propGetInt(props, "Super_hpad", 0, &evil_err[1]));
+    d.nSuperVPad = int64ToIntS(vsapi->propGetInt(props, "Super_vpad", 0, &evil_err[2]));
+    d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
+    d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
+    d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
-    for (int i = 0; i < 2; i++)
+    for (int i = 0; i < 6; i++)
         if (evil_err[i]) {
             vsapi->setError(out, "FlowInter: required properties not found in first frame of super clip. Maybe clip didn't come from mv.Super? Was the first frame trimmed away?");
             vsapi->freeNode(d.super);
@@ -625,55 +607,6 @@ static void VS_CC mvflowinterCreate(const VSMap *in, VSMap *out, void *userData,
         return;
     }
 
-    if (d.mvbw_data.nPel == 1)
-        d.finest = vsapi->cloneNodeRef(d.super); // v2.0.9.1
-    else {
-        VSPlugin *mvtoolsPlugin = vsapi->getPluginById("com.nodame.mvtools", core);
-        VSPlugin *stdPlugin = vsapi->getPluginById("com.vapoursynth.std", core);
-
-        VSMap *args = vsapi->createMap();
-        vsapi->propSetNode(args, "super", d.super, paReplace);
-        vsapi->propSetInt(args, "isse", d.isse, paReplace);
-        VSMap *ret = vsapi->invoke(mvtoolsPlugin, "Finest", args);
-        if (vsapi->getError(ret)) {
-#define ERROR_SIZE 512
-            char error_msg[ERROR_SIZE + 1] = { 0 };
-            snprintf(error_msg, ERROR_SIZE, "FlowInter: %s", vsapi->getError(ret));
-#undef ERROR_SIZE
-            vsapi->setError(out, error_msg);
-
-            vsapi->freeNode(d.super);
-            vsapi->freeNode(d.mvfw);
-            vsapi->freeNode(d.mvbw);
-            vsapi->freeMap(args);
-            vsapi->freeMap(ret);
-            return;
-        }
-        d.finest = vsapi->propGetNode(ret, "clip", 0, NULL);
-        vsapi->freeMap(ret);
-
-        vsapi->clearMap(args);
-        vsapi->propSetNode(args, "clip", d.finest, paReplace);
-        vsapi->freeNode(d.finest);
-        ret = vsapi->invoke(stdPlugin, "Cache", args);
-        vsapi->freeMap(args);
-        if (vsapi->getError(ret)) {
-#define ERROR_SIZE 512
-            char error_msg[ERROR_SIZE + 1] = { 0 };
-            snprintf(error_msg, ERROR_SIZE, "FlowInter: %s", vsapi->getError(ret));
-#undef ERROR_SIZE
-            vsapi->setError(out, error_msg);
-
-            vsapi->freeNode(d.super);
-            vsapi->freeNode(d.mvfw);
-            vsapi->freeNode(d.mvbw);
-            vsapi->freeMap(ret);
-            return;
-        }
-        d.finest = vsapi->propGetNode(ret, "clip", 0, NULL);
-        vsapi->freeMap(ret);
-    }
-
     d.node = vsapi->propGetNode(in, "clip", 0, 0);
     d.vi = vsapi->getVideoInfo(d.node);
 
@@ -682,7 +615,6 @@ static void VS_CC mvflowinterCreate(const VSMap *in, VSMap *out, void *userData,
 
     if (d.mvbw_data.nHeight != nHeightS || d.mvbw_data.nWidth != nSuperWidth - d.nSuperHPad * 2) {
         vsapi->setError(out, "FlowInter: wrong source or super clip frame size.");
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.super);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
@@ -693,15 +625,29 @@ static void VS_CC mvflowinterCreate(const VSMap *in, VSMap *out, void *userData,
     if (!isConstantFormat(d.vi) || d.vi->format->bitsPerSample > 16 || d.vi->format->sampleType != stInteger || d.vi->format->subSamplingW > 1 || d.vi->format->subSamplingH > 1 || (d.vi->format->colorFamily != cmYUV && d.vi->format->colorFamily != cmGray)) {
         vsapi->setError(out, "FlowInter: input clip must be GRAY, 420, 422, 440, or 444, up to 16 bits, with constant dimensions.");
         vsapi->freeNode(d.super);
-        vsapi->freeNode(d.finest);
         vsapi->freeNode(d.mvfw);
         vsapi->freeNode(d.mvbw);
         vsapi->freeNode(d.node);
         return;
     }
 
-    if (d.vi->format->bitsPerSample > 8)
-        d.isse = 0;
+    if (d.nSuperPel != d.mvbw_data.nPel) {
+        vsapi->setError(out, "FlowInter: super clip and motion vector clips must have the same pel.");
+        vsapi->freeNode(d.super);
+        vsapi->freeNode(d.mvfw);
+        vsapi->freeNode(d.mvbw);
+        vsapi->freeNode(d.node);
+        return;
+    }
+
+    if (d.vi->format->colorFamily != cmGray && !(d.nSuperModeYUV & UVPLANES)) {
+        vsapi->setError(out, "FlowInter: super clip must be created with chroma=True, unless the input clip is GRAY.");
+        vsapi->freeNode(d.super);
+        vsapi->freeNode(d.mvfw);
+        vsapi->freeNode(d.mvbw);
+        vsapi->freeNode(d.node);
+        return;
+    }
 
 
     d.nBlkXP = (d.mvbw_data.nBlkX * (d.mvbw_data.nBlkSizeX - d.mvbw_data.nOverlapX) + d.mvbw_data.nOverlapX < d.mvbw_data.nWidth) ? d.mvbw_data.nBlkX + 1 : d.mvbw_data.nBlkX;
@@ -714,26 +660,33 @@ static void VS_CC mvflowinterCreate(const VSMap *in, VSMap *out, void *userData,
     d.nHeightUV = d.mvbw_data.nHeight / d.mvbw_data.yRatioUV;
     d.nWidthUV = d.mvbw_data.nWidth / d.mvbw_data.xRatioUV;
 
-    d.nHPaddingUV = d.mvbw_data.nHPadding / d.mvbw_data.xRatioUV;
-    d.nVPaddingUV = d.mvbw_data.nVPadding / d.mvbw_data.yRatioUV;
-
     d.VPitchY = (d.nWidthP + 15) & (~15);
     d.VPitchUV = (d.nWidthPUV + 15) & (~15);
 
 
-    simpleInit(&d.upsizer, d.nWidthP, d.nHeightP, d.nBlkXP, d.nBlkYP);
+    simpleInit(&d.upsizer, d.nWidthP, d.nHeightP, d.nBlkXP, d.nBlkYP, d.isse);
     if (d.vi->format->colorFamily != cmGray)
-        simpleInit(&d.upsizerUV, d.nWidthPUV, d.nHeightPUV, d.nBlkXP, d.nBlkYP);
+        simpleInit(&d.upsizerUV, d.nWidthPUV, d.nHeightPUV, d.nBlkXP, d.nBlkYP, d.isse);
+
+    // The vectors and masks made by mvflowinterGetFrame, for both directions and the extra frames.
+    d.scratchSize = 8 * arenaBufferSize(d.nHeightP * d.VPitchY * sizeof(int16_t)) +
+                    8 * arenaBufferSize(d.nBlkXP * d.nBlkYP * sizeof(int16_t)) +
+                    2 * arenaBufferSize(d.nHeightP * d.VPitchY) +
+                    2 * arenaBufferSize(d.nBlkXP * d.nBlkYP);
+    if (d.vi->format->colorFamily != cmGray)
+        d.scratchSize += 8 * arenaBufferSize(d.nHeightPUV * d.VPitchUV * sizeof(int16_t)) +
+                         8 * arenaBufferSize(d.nBlkXP * d.nBlkYP * sizeof(int16_t)) +
+                         2 * arenaBufferSize(d.nHeightPUV * d.VPitchUV);
 
 
-    d.LUTVB = (int *)malloc(256 * sizeof(int));
-    d.LUTVF = (int *)malloc(256 * sizeof(int));
-    Create_LUTV(d.time256, d.LUTVB, d.LUTVF);
+    selectFlowInterFunctions(&d.FlowInter, NULL, &d.FlowInterExtra, d.vi->format->bitsPerSample, d.isse);
 
 
     data = (MVFlowInterData *)malloc(sizeof(d));
     *data = d;
 
+    data->scratch = poolCreate(arenaPoolCreate, arenaPoolDestroy, &data->scratchSize);
+
     vsapi->createFilter(in, out, "FlowInter", mvflowinterInit, mvflowinterGetFrame, mvflowinterFree, fmParallel, 0, data, core);
 }
 
@@ -18,6 +18,7 @@
 // http://www.gnu.org/copyleft/gpl.html .
 
 #include <stdio.h>
+#include <string.h>
 
 #include <VSHelper.h>
 
@@ -102,15 +103,9 @@ void PadReferenceFrame_##PixelType(uint8_t *refFrame8, int refPitch, int hPad, i
     PadCorner_##PixelType(refFrame + hPad + width + (vPad + height) * refPitch,                         \
                           pfoff[(height - 1) * refPitch + width - 1], hPad, vPad, refPitch);            \
                                                                                                         \
-    /* Up */                                                                                            \
-    for (int i = 0; i < width; i++) {                                                                   \
-        value = pfoff[i];                                                                               \
-        p = refFrame + hPad + i;                                                                        \
-        for (int j = 0; j < vPad; j++) {                                                                \
-            p[0] = value;                                                                               \
-            p += refPitch;                                                                              \
-        }                                                                                               \
-    }                                                                                                   \
+    /* Up, one whole row at a time */                                                                   \
+    for (int j = 0; j < vPad; j++)                                                                      \
+        memcpy(refFrame + j * refPitch + hPad, pfoff, width * sizeof(PixelType));                       \
                                                                                                         \
     /* Left */                                                                                          \
     for (int i = 0; i < height; i++) {                                                                  \
@@ -129,14 +124,9 @@ void PadReferenceFrame_##PixelType(uint8_t *refFrame8, int refPitch, int hPad, i
     }                                                                                                   \
                                                                                                         \
     /* Down */                                                                                          \
-    for (int i = 0; i < width; i++) {                                                                   \
-        value = pfoff[i + (height - 1) * refPitch];                                                     \
-        p = refFrame + hPad + i + (height + vPad) * refPitch;                                           \
-        for (int j = 0; j < vPad; j++) {                                                                \
-            p[0] = value;                                                                               \
-            p += refPitch;                                                                              \
-        }                                                                                               \
-    }                                                                                                   \
+    for (int j = 0; j < vPad; j++)                                                                      \
+        memcpy(refFrame + (height + vPad + j) * refPitch + hPad, pfoff + (height - 1) * refPitch,       \
+               width * sizeof(PixelType));                                                              \
 }
 
 PadReferenceFrame(uint8_t)
@@ -238,6 +228,14 @@ void mvpRefine(MVPlane *mvp, int sharp) {
             refine[0] = HorizontalBilinear_uint16_t;
             refine[1] = VerticalBilinear_uint16_t;
             refine[2] = DiagonalBilinear_uint16_t;
+
+            if (mvp->isse) {
+#if defined(MVTOOLS_X86)
+                refine[0] = mvtools_HorizontalBilinear_u16_sse2;
+                refine[1] = mvtools_VerticalBilinear_u16_sse2;
+                refine[2] = mvtools_DiagonalBilinear_u16_sse2;
+#endif
+            }
         }
     } else if (sharp == SharpBicubic) {
         if (mvp->bytesPerSample == 1) {
@@ -254,6 +252,13 @@ void mvpRefine(MVPlane *mvp, int sharp) {
         } else {
             refine[0] = refine[2] = HorizontalBicubic_uint16_t;
             refine[1] = VerticalBicubic_uint16_t;
+
+            if (mvp->isse) {
+#if defined(MVTOOLS_X86)
+                refine[0] = refine[2] = mvtools_HorizontalBicubic_u16_sse2;
+                refine[1] = mvtools_VerticalBicubic_u16_sse2;
+#endif
+            }
         }
     } else { // Wiener
         if (mvp->bytesPerSample == 1) {
@@ -269,6 +274,13 @@ void mvpRefine(MVPlane *mvp, int sharp) {
         } else {
             refine[0] = refine[2] = HorizontalWiener_uint16_t;
             refine[1] = VerticalWiener_uint16_t;
+
+            if (mvp->isse) {
+#if defined(MVTOOLS_X86)
+                refine[0] = refine[2] = mvtools_HorizontalWiener_u16_sse2;
+                refine[1] = mvtools_VerticalWiener_u16_sse2;
+#endif
+            }
         }
     }
 
@@ -313,6 +325,12 @@ void mvpRefine(MVPlane *mvp, int sharp) {
             }
         } else {
             avg = Average2_uint16_t;
+
+            if (mvp->isse) {
+#if defined(MVTOOLS_X86)
+                avg = mvtools_Average2_u16_sse2;
+#endif
+            }
         }
 
         // now interpolate intermediate
@@ -568,6 +586,15 @@ const uint8_t *mvpGetAbsolutePelPointer(const MVPlane *mvp, int nX, int nY) {
     return ret;
 }
 
+
+// Fills pSubplanes with the nPel * nPel subplanes' pointers to their first pixel
+// after the padding, in the order mvpGetAbsolutePointer uses.
+void mvpGetSubplanePointers(const MVPlane *mvp, const uint8_t **pSubplanes) {
+    for (int y = 0; y < mvp->nPel; y++)
+        for (int x = 0; x < mvp->nPel; x++)
+            pSubplanes[y * mvp->nPel + x] = mvpGetPointer(mvp, x, y);
+}
+
 /******************************************************************************
  *                                                                             *
  *  MVFrame : a MVFrame is a threesome of MVPlane, some undefined, some        *
@@ -681,6 +708,7 @@ void mvgofInit(MVGroupOfFrames *mvgof, int nLevelCount, int nWidth, int nHeight,
     mvgof->xRatioUV = xRatioUV;
     mvgof->yRatioUV = yRatioUV;
     mvgof->bitsPerSample = bitsPerSample;
+    mvgof->pRefined = NULL;
 
     mvgof->frames = (MVFrame **)malloc(mvgof->nLevelCount * sizeof(MVFrame *));
 
@@ -705,6 +733,9 @@ void mvgofDeinit(MVGroupOfFrames *mvgof) {
 
     free(mvgof->frames);
     mvgof->frames = NULL;
+
+    free(mvgof->pRefined);
+    mvgof->pRefined = NULL;
 }
 
 
@@ -722,6 +753,50 @@ void mvgofUpdate(MVGroupOfFrames *mvgof, uint8_t **pSrc, int *pitch) {
 }
 
 
+void mvgofUpdateLazy(MVGroupOfFrames *mvgof, uint8_t **pSrc, int *pitch, int sharp) {
+    for (int i = 0; i < mvgof->nLevelCount; i++) {
+        uint8_t *planes[3] = { NULL };
+
+        for (int plane = 0; plane < 3; plane++) {
+            if (pSrc[plane])
+                planes[plane] = pSrc[plane] + PlaneSuperOffset(plane, mvgof->nHeight[plane], i, 1, mvgof->nVPad[plane], pitch[plane], mvgof->yRatioUV);
+        }
+
+        mvfUpdate(mvgof->frames[i], planes, pitch);
+    }
+
+    // The other subplanes of the finest level are interpolated here, the same way Super would have done it.
+    MVFrame *finest = mvgof->frames[0];
+    int nSubplanes = mvgof->nPel * mvgof->nPel - 1;
+
+    size_t size = 0;
+    for (int plane = 0; plane < 3; plane++) {
+        if (pSrc[plane] && finest->planes[plane])
+            size += (size_t)nSubplanes * pitch[plane] * finest->planes[plane]->nPaddedHeight;
+    }
+
+    // Cleared, like Super's frames, because the pel 4 interpolation doesn't write the last column or row of some subplanes.
+    free(mvgof->pRefined);
+    mvgof->pRefined = (uint8_t *)calloc(size, 1);
+
+    uint8_t *pRefined = mvgof->pRefined;
+
+    for (int plane = 0; plane < 3; plane++) {
+        MVPlane *mvp = finest->planes[plane];
+
+        if (!pSrc[plane] || !mvp)
+            continue;
+
+        for (int i = 1; i <= nSubplanes; i++) {
+            mvp->pPlane[i] = pRefined;
+            pRefined += mvp->nPitch * mvp->nPaddedHeight;
+        }
+
+        mvpRefine(mvp, sharp);
+    }
+}
+
+
 MVFrame *mvgofGetFrame(MVGroupOfFrames *mvgof, int nLevel) {
     if ((nLevel < 0) || (nLevel >= mvgof->nLevelCount))
         return NULL;
@@ -108,6 +108,8 @@ const uint8_t *mvpGetPointerPel4(const MVPlane *mvp, int nX, int nY);
 
 const uint8_t *mvpGetAbsolutePelPointer(const MVPlane *mvp, int nX, int nY);
 
+void mvpGetSubplanePointers(const MVPlane *mvp, const uint8_t **pSubplanes);
+
 
 typedef struct MVFrame {
     MVPlane *planes[3];
@@ -149,6 +151,8 @@ typedef struct MVGroupOfFrames {
     int xRatioUV;
     int yRatioUV;
     int bitsPerSample;
+
+    uint8_t *pRefined; // subplanes interpolated by mvgofUpdateLazy
 } MVGroupOfFrames;
 
 
@@ -158,6 +162,9 @@ void mvgofDeinit(MVGroupOfFrames *mvgof);
 
 void mvgofUpdate(MVGroupOfFrames *mvgof, uint8_t **pSrc, int *pitch);
 
+// For super frames made with lazy=True, which only contain the pel 1 planes.
+void mvgofUpdateLazy(MVGroupOfFrames *mvgof, uint8_t **pSrc, int *pitch, int sharp);
+
 MVFrame *mvgofGetFrame(MVGroupOfFrames *mvgof, int nLevel);
 
 void mvgofSetPlane(MVGroupOfFrames *mvgof, const uint8_t *pNewSrc, int nNewPitch, int plane);
@@ -111,7 +111,6 @@ static const VSFrameRef *VS_CC mvmaskGetFrame(int n, int activationReason, void
         fgopInit(&fgop, &d->vectors_data);
         const VSMap *mvprops = vsapi->getFramePropsRO(mvn);
         fgopUpdate(&fgop, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
-        vsapi->freeFrame(mvn);
 
         const int kind = d->kind;
         const int nWidth = d->vectors_data.nWidth;
@@ -145,21 +144,21 @@ static const VSFrameRef *VS_CC mvmaskGetFrame(int n, int activationReason, void
 
             if (kind == 0) { // vector length mask
                 for (int j = 0; j < nBlkCount; j++)
-                    smallMask[j] = mvmaskLength(fgopGetBlock(&fgop, 0, j)->vector, nPel, fMaskNormFactor2, fHalfGamma);
+                    smallMask[j] = mvmaskLength(*fgopGetVector(&fgop, 0, j), nPel, fMaskNormFactor2, fHalfGamma);
             } else if (kind == 1) { // SAD mask
                 for (int j = 0; j < nBlkCount; j++)
-                    smallMask[j] = mvmaskSAD(fgopGetBlock(&fgop, 0, j)->vector.sad, fMaskNormFactor, fGamma, nBlkSizeX, nBlkSizeY);
+                    smallMask[j] = mvmaskSAD(fgopGetVector(&fgop, 0, j)->sad, fMaskNormFactor, fGamma, nBlkSizeX, nBlkSizeY);
             } else if (kind == 2) { // occlusion mask
                 MakeVectorOcclusionMaskTime(&fgop, nBlkX, nBlkY, fMaskNormFactor, fGamma, nPel, smallMask, nBlkX, 256, nBlkSizeX - nOverlapX, nBlkSizeY - nOverlapY);
             } else if (kind == 3) { // vector x mask
                 for (int j = 0; j < nBlkCount; j++)
-                    smallMask[j] = fgopGetBlock(&fgop, 0, j)->vector.x + 128; // shited by 128 for signed support
+                    smallMask[j] = fgopGetVector(&fgop, 0, j)->x + 128; // shited by 128 for signed support
             } else if (kind == 4) {                                      // vector y mask
                 for (int j = 0; j < nBlkCount; j++)
-                    smallMask[j] = fgopGetBlock(&fgop, 0, j)->vector.y + 128; // shited by 128 for signed support
+                    smallMask[j] = fgopGetVector(&fgop, 0, j)->y + 128; // shited by 128 for signed support
             } else if (kind == 5) {                                      // vector x mask in U, y mask in V
                 for (int j = 0; j < nBlkCount; j++) {
-                    VECTOR v = fgopGetBlock(&fgop, 0, j)->vector;
+                    VECTOR v = *fgopGetVector(&fgop, 0, j);
                     smallMask[j] = v.x + 128;  // shited by 128 for signed support
                     smallMaskV[j] = v.y + 128; // shited by 128 for signed support
                 }
@@ -168,7 +167,7 @@ static const VSFrameRef *VS_CC mvmaskGetFrame(int n, int activationReason, void
             if (kind == 5) { // do not change luma for kind=5
                 memcpy(pDst[0], pSrc[0], nSrcPitches[0] * nHeight);
             } else {
-                simpleResize(upsizer, pDst[0], nDstPitches[0], smallMask, nBlkX);
+                simpleResize_uint8_t(upsizer, pDst[0], nDstPitches[0], smallMask, nBlkX);
                 if (nWidth > nWidthB)
                     for (int h = 0; h < nHeight; h++)
                         for (int w = nWidthB; w < nWidth; w++)
@@ -178,10 +177,10 @@ static const VSFrameRef *VS_CC mvmaskGetFrame(int n, int activationReason, void
             }
 
             // chroma
-            simpleResize(upsizerUV, pDst[1], nDstPitches[1], smallMask, nBlkX);
+            simpleResize_uint8_t(upsizerUV, pDst[1], nDstPitches[1], smallMask, nBlkX);
 
             if (kind == 5)
-                simpleResize(upsizerUV, pDst[2], nDstPitches[2], smallMaskV, nBlkX);
+                simpleResize_uint8_t(upsizerUV, pDst[2], nDstPitches[2], smallMaskV, nBlkX);
             else
                 memcpy(pDst[2], pDst[1], nHeightUV * nDstPitches[1]);
 
@@ -209,6 +208,7 @@ static const VSFrameRef *VS_CC mvmaskGetFrame(int n, int activationReason, void
         }
 
         fgopDeinit(&fgop);
+        vsapi->freeFrame(mvn);
 
         vsapi->freeFrame(src);
 
@@ -323,8 +323,8 @@ static void VS_CC mvmaskCreate(const VSMap *in, VSMap *out, void *userData, VSCo
     if (d.vi.format->colorFamily == cmGray)
         d.vi.format = vsapi->getFormatPreset(pfYUV444P8, core);
 
-    simpleInit(&d.upsizer, d.nWidthB, d.nHeightB, d.vectors_data.nBlkX, d.vectors_data.nBlkY);
-    simpleInit(&d.upsizerUV, d.nWidthBUV, d.nHeightBUV, d.vectors_data.nBlkX, d.vectors_data.nBlkY);
+    simpleInit(&d.upsizer, d.nWidthB, d.nHeightB, d.vectors_data.nBlkX, d.vectors_data.nBlkY, 1);
+    simpleInit(&d.upsizerUV, d.nWidthBUV, d.nHeightBUV, d.vectors_data.nBlkX, d.vectors_data.nBlkY, 1);
 
 
     data = (MVMaskData *)malloc(sizeof(d));
@@ -8,8 +8,11 @@
 #include "CPU.h"
 #include "DCTFFTW.h"
 #include "Fakery.h"
+#include "GroupOfFramesCache.h"
 #include "GroupOfPlanes.h"
 #include "MVAnalysisData.h"
+#include "ObjectPool.h"
+#include "SearchContext.h"
 
 
 typedef struct MVRecalculateData {
@@ -44,6 +47,8 @@ typedef struct MVRecalculateData {
     int nModeYUV;
 
     int nSuperLevels;
+    int nSuperLazy;
+    int nSuperSharp;
     int nSuperHPad;
     int nSuperVPad;
     int nSuperPel;
@@ -59,6 +64,9 @@ typedef struct MVRecalculateData {
     int fields;
     int tff;
     int tffexists;
+
+    SearchContextParameters contextParams;
+    ObjectPool *contexts;
 } MVRecalculateData;
 
 
@@ -95,9 +103,8 @@ static const VSFrameRef *VS_CC mvrecalculateGetFrame(int n, int activationReason
         }
     } else if (activationReason == arAllFramesReady) {
 
-        GroupOfPlanes vectorFields;
-
-        gopInit(&vectorFields, d->analysisData.nBlkSizeX, d->analysisData.nBlkSizeY, d->analysisData.nLvCount, d->analysisData.nPel, d->analysisData.nMotionFlags, d->analysisData.nCPUFlags, d->analysisData.nOverlapX, d->analysisData.nOverlapY, d->analysisData.nBlkX, d->analysisData.nBlkY, d->analysisData.xRatioUV, d->analysisData.yRatioUV, d->divideExtra, d->vi->format->bitsPerSample);
+        SearchContext *sc = (SearchContext *)poolAcquire(d->contexts);
+        GroupOfPlanes *vectorFields = &sc->gop;
 
 
         const uint8_t *pSrc[3] = { NULL };
@@ -115,7 +122,7 @@ static const VSFrameRef *VS_CC mvrecalculateGetFrame(int n, int activationReason
         int srctff = !!vsapi->propGetInt(srcprops, "_Field", 0, &err);
         if (err && d->fields && !d->tffexists) {
             vsapi->setFilterError("Recalculate: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
-            gopDeinit(&vectorFields);
+            poolRelease(d->contexts, sc);
             vsapi->freeFrame(src);
             return NULL;
         }
@@ -138,11 +145,15 @@ static const VSFrameRef *VS_CC mvrecalculateGetFrame(int n, int activationReason
         const VSMap *mvprops = vsapi->getFramePropsRO(mvn);
 
         fgopUpdate(&fgop, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
-        vsapi->freeFrame(mvn);
 
-        int vectors_size = gopGetArraySize(&vectorFields) * sizeof(int);
+        int vectors_size = gopGetArraySize(vectorFields) * sizeof(int);
         int *vectors = (int *)malloc(vectors_size);
 
+        // Recalculate has a single level.
+        int64_t dctCacheLookups = 0;
+        int64_t dctCacheHits = 0;
+        int dctCacheUsed = 0;
+
         if (fgopIsValid(&fgop) && nref >= 0 && nref < d->vi->numFrames) {
             const VSFrameRef *ref = vsapi->getFrameFilter(nref, d->node, frameCtx);
             const VSMap *refprops = vsapi->getFramePropsRO(ref);
@@ -150,11 +161,12 @@ static const VSFrameRef *VS_CC mvrecalculateGetFrame(int n, int activationReason
             int reftff = !!vsapi->propGetInt(refprops, "_Field", 0, &err);
             if (err && d->fields && !d->tffexists) {
                 vsapi->setFilterError("Recalculate: _Field property not found in input frame. Therefore, you must pass tff argument.", frameCtx);
-                gopDeinit(&vectorFields);
+                poolRelease(d->contexts, sc);
                 vsapi->freeFrame(src);
                 vsapi->freeFrame(ref);
                 free(vectors);
                 fgopDeinit(&fgop);
+                vsapi->freeFrame(mvn);
                 return NULL;
             }
 
@@ -175,43 +187,37 @@ static const VSFrameRef *VS_CC mvrecalculateGetFrame(int n, int activationReason
             }
 
 
-            MVGroupOfFrames pSrcGOF, pRefGOF;
+            const MVAnalysisData *ad = &d->analysisData;
 
-            mvgofInit(&pSrcGOF, d->nSuperLevels, d->analysisData.nWidth, d->analysisData.nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, d->analysisData.xRatioUV, d->analysisData.yRatioUV, d->vi->format->bitsPerSample);
-            mvgofInit(&pRefGOF, d->nSuperLevels, d->analysisData.nWidth, d->analysisData.nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, d->analysisData.xRatioUV, d->analysisData.yRatioUV, d->vi->format->bitsPerSample);
+            int64_t srcSerial = vsapi->propGetInt(srcprops, "Super_serial", 0, &err);
+            int64_t refSerial = vsapi->propGetInt(refprops, "Super_serial", 0, &err);
 
-            // cast away the const, because why not.
-            mvgofUpdate(&pSrcGOF, (uint8_t **)pSrc, nSrcPitch);
-            mvgofUpdate(&pRefGOF, (uint8_t **)pRef, nRefPitch);
+            MVGroupOfFrames *srcGOF = gofcAcquire(pSrc, nSrcPitch, d->nSuperLevels, ad->nWidth, ad->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, ad->xRatioUV, ad->yRatioUV, ad->bitsPerSample, d->nSuperLazy, d->nSuperSharp, srcSerial);
+            MVGroupOfFrames *refGOF = gofcAcquire(pRef, nRefPitch, d->nSuperLevels, ad->nWidth, ad->nHeight, d->nSuperPel, d->nSuperHPad, d->nSuperVPad, d->nSuperModeYUV, d->isse, ad->xRatioUV, ad->yRatioUV, ad->bitsPerSample, d->nSuperLazy, d->nSuperSharp, refSerial);
 
 
-            DCTFFTW *DCTc = NULL;
-            if (d->dctmode != 0) {
-                DCTc = (DCTFFTW *)malloc(sizeof(DCTFFTW));
-                dctInit(DCTc, d->analysisData.nBlkSizeX, d->analysisData.nBlkSizeY, d->dctmode, d->vi->format->bitsPerSample);
-            }
-
+            gopRecalculateMVs(vectorFields, &fgop, srcGOF, refGOF, d->searchType, d->nSearchParam, d->nLambda, d->pnew, vectors, fieldShift, d->thSAD, sc->DCT, d->smooth, d->meander);
 
-            gopRecalculateMVs(&vectorFields, &fgop, &pSrcGOF, &pRefGOF, d->searchType, d->nSearchParam, d->nLambda, d->pnew, vectors, fieldShift, d->thSAD, DCTc, d->smooth, d->meander);
+            if (d->dctmode >= 1 && d->dctmode <= 4) {
+                gopGetDCTCacheStats(vectorFields, &dctCacheLookups, &dctCacheHits);
+                dctCacheUsed = 1;
+            }
 
             if (d->divideExtra) {
                 // make extra level with divided sublocks with median (not estimated) motion
-                gopExtraDivide(&vectorFields, vectors);
+                gopExtraDivide(vectorFields, vectors);
             }
 
-            gopDeinit(&vectorFields);
-            if (DCTc) {
-                dctDeinit(DCTc);
-                free(DCTc);
-            }
-            mvgofDeinit(&pSrcGOF);
-            mvgofDeinit(&pRefGOF);
+            gofcRelease(srcGOF);
+            gofcRelease(refGOF);
+
             vsapi->freeFrame(ref);
         } else {// too close to the beginning or end to do anything
-            gopWriteDefaultToArray(&vectorFields, vectors);
-            gopDeinit(&vectorFields);
+            gopWriteDefaultToArray(vectorFields, vectors);
         }
 
+        poolRelease(d->contexts, sc);
+
         VSFrameRef *dst = vsapi->copyFrame(src, core);
         VSMap *dstprops = vsapi->getFramePropsRW(dst);
 
@@ -229,12 +235,16 @@ static const VSFrameRef *VS_CC mvrecalculateGetFrame(int n, int activationReason
 
         free(vectors);
 
+        if (dctCacheUsed)
+            setDCTCacheStats(dstprops, &dctCacheLookups, &dctCacheHits, 1, vsapi);
+
         // FIXME: Get rid of all mmx shit.
         mvtools_cpu_emms();
 
         vsapi->freeFrame(src);
 
         fgopDeinit(&fgop);
+        vsapi->freeFrame(mvn);
 
         return dst;
     }
@@ -248,6 +258,7 @@ static void VS_CC mvrecalculateFree(void *instanceData, VSCore *core, const VSAP
 
     MVRecalculateData *d = (MVRecalculateData *)instanceData;
 
+    poolFree(d->contexts);
     vsapi->freeNode(d->node);
     vsapi->freeNode(d->vectors);
     free(d);
@@ -336,13 +347,8 @@ static void VS_CC mvrecalculateCreate(const VSMap *in, VSMap *out, void *userDat
         return;
     }
 
-    if (d.dctmode >= 5 &&
-        !((d.analysisData.nBlkSizeX == 4 && d.analysisData.nBlkSizeY == 4) ||
-          (d.analysisData.nBlkSizeX == 8 && d.analysisData.nBlkSizeY == 4) ||
-          (d.analysisData.nBlkSizeX == 8 && d.analysisData.nBlkSizeY == 8) ||
-          (d.analysisData.nBlkSizeX == 16 && d.analysisData.nBlkSizeY == 8) ||
-          (d.analysisData.nBlkSizeX == 16 && d.analysisData.nBlkSizeY == 16))) {
-        vsapi->setError(out, "Recalculate: dct 5..10 can only work with 4x4, 8x4, 8x8, 16x8, and 16x16 blocks.");
+    if (d.dctmode >= 5 && (d.analysisData.nBlkSizeX < 4 || d.analysisData.nBlkSizeY < 4)) {
+        vsapi->setError(out, "Recalculate: dct 5..10 need blocks at least 4 pixels wide and 4 pixels tall.");
         return;
     }
 
@@ -352,19 +358,6 @@ static void VS_CC mvrecalculateCreate(const VSMap *in, VSMap *out, void *userDat
     }
 
 
-    if ((d.analysisData.nBlkSizeX != 4 || d.analysisData.nBlkSizeY != 4) &&
-        (d.analysisData.nBlkSizeX != 8 || d.analysisData.nBlkSizeY != 4) &&
-        (d.analysisData.nBlkSizeX != 8 || d.analysisData.nBlkSizeY != 8) &&
-        (d.analysisData.nBlkSizeX != 16 || d.analysisData.nBlkSizeY != 2) &&
-        (d.analysisData.nBlkSizeX != 16 || d.analysisData.nBlkSizeY != 8) &&
-        (d.analysisData.nBlkSizeX != 16 || d.analysisData.nBlkSizeY != 16) &&
-        (d.analysisData.nBlkSizeX != 32 || d.analysisData.nBlkSizeY != 32) &&
-        (d.analysisData.nBlkSizeX != 32 || d.analysisData.nBlkSizeY != 16)) {
-
-        vsapi->setError(out, "Recalculate: the block size must be 4x4, 8x4, 8x8, 16x2, 16x8, 16x16, 32x16, or 32x32.");
-        return;
-    }
-
 
     if (d.pnew < 0 || d.pnew > 256) {
         vsapi->setError(out, "Recalculate: pnew must be between 0 and 256 (inclusive).");
@@ -426,6 +419,8 @@ static void VS_CC mvrecalculateCreate(const VSMap *in, VSMap *out, void *userDat
     d.nSuperPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[3]));
     d.nSuperModeYUV = int64ToIntS(vsapi->propGetInt(props, "Super_modeyuv", 0, &evil_err[4]));
     d.nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[5]));
+    d.nSuperLazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    d.nSuperSharp = int64ToIntS(vsapi->propGetInt(props, "Super_sharp", 0, &err));
     vsapi->freeFrame(evil);
 
     for (int i = 0; i < 6; i++)
@@ -468,6 +463,15 @@ static void VS_CC mvrecalculateCreate(const VSMap *in, VSMap *out, void *userDat
     d.analysisData.yRatioUV = d.vectors_data.yRatioUV;
     d.analysisData.xRatioUV = d.vectors_data.xRatioUV;
 
+    adataCheckBlockSize(&d.analysisData, d.divideExtra, filter_name, error, sizeof(error));
+    if (error[0]) {
+        vsapi->setError(out, error);
+
+        vsapi->freeNode(d.node);
+        vsapi->freeNode(d.vectors);
+        return;
+    }
+
     d.analysisData.nWidth = d.vectors_data.nWidth;
     d.analysisData.nHeight = d.vectors_data.nHeight;
 
@@ -497,9 +501,6 @@ static void VS_CC mvrecalculateCreate(const VSMap *in, VSMap *out, void *userDat
         d.analysisData.nCPUFlags = cpu_detect();
     }
 
-    if (d.vi->format->bitsPerSample > 8)
-        d.isse = 0; // needed here because MVPlane can't have isse=1 with more than 8 bits
-
     d.analysisData.nPel = d.nSuperPel; //x
 
     int nSuperWidth = d.vi->width;
@@ -535,9 +536,18 @@ static void VS_CC mvrecalculateCreate(const VSMap *in, VSMap *out, void *userDat
     }
 
 
+    d.contextParams.divideExtra = d.divideExtra;
+    d.contextParams.dctmode = d.dctmode;
+    d.contextParams.nThreads = 1;
+    d.contextParams.wavefrontPool = NULL;
+
+
     data = (MVRecalculateData *)malloc(sizeof(d));
     *data = d;
 
+    data->contextParams.analysisData = &data->analysisData;
+    data->contexts = poolCreate(scPoolCreate, scPoolDestroy, &data->contextParams);
+
     vsapi->createFilter(in, out, "Recalculate", mvrecalculateInit, mvrecalculateGetFrame, mvrecalculateFree, fmParallel, 0, data, core);
 }
 
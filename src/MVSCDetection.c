@@ -65,13 +65,13 @@ static const VSFrameRef *VS_CC mvscdetectionGetFrame(int n, int activationReason
         fgopInit(&fgop, &d->vectors_data);
         const VSMap *mvprops = vsapi->getFramePropsRO(mvn);
         fgopUpdate(&fgop, (const int *)vsapi->propGetData(mvprops, prop_MVTools_vectors, 0, NULL));
-        vsapi->freeFrame(mvn);
 
         const char *propNames[2] = { "_SceneChangePrev", "_SceneChangeNext" };
         VSMap *props = vsapi->getFramePropsRW(dst);
         vsapi->propSetInt(props, propNames[!!d->vectors_data.isBackward], !fgopIsUsable(&fgop, d->thscd1, d->thscd2), paReplace);
 
         fgopDeinit(&fgop);
+        vsapi->freeFrame(mvn);
 
         return dst;
     }
@@ -5,6 +5,7 @@
 #include <VapourSynth.h>
 #include <VSHelper.h>
 
+#include "GroupOfFramesCache.h"
 #include "MVFrame.h"
 
 
@@ -21,6 +22,7 @@ typedef struct MVSuperData {
     int sharp;
     int rfilter; // frame reduce filter mode
     int isse;
+    int lazy; // only the pel 1 planes are stored, the consumers interpolate the rest
 
     int nWidth;
     int nHeight;
@@ -83,7 +85,7 @@ static const VSFrameRef *VS_CC mvsuperGetFrame(int n, int activationReason, void
         }
 
         MVGroupOfFrames pSrcGOF;
-        mvgofInit(&pSrcGOF, d->nLevels, d->nWidth, d->nHeight, d->nPel, d->nHPad, d->nVPad, d->nModeYUV, d->isse, d->xRatioUV, d->yRatioUV, d->vi.format->bitsPerSample);
+        mvgofInit(&pSrcGOF, d->nLevels, d->nWidth, d->nHeight, d->lazy ? 1 : d->nPel, d->nHPad, d->nVPad, d->nModeYUV, d->isse, d->xRatioUV, d->yRatioUV, d->vi.format->bitsPerSample);
 
         mvgofUpdate(&pSrcGOF, pDst, nDstPitch);
 
@@ -106,7 +108,7 @@ static const VSFrameRef *VS_CC mvsuperGetFrame(int n, int activationReason, void
                 if (d->nModeYUV & planes[plane])
                     mvpRefineExt(srcPlane, pSrcPel[plane], nSrcPelPitch[plane], d->isPelClipPadded);
             }
-        } else
+        } else if (!d->lazy)
             mvgofRefine(&pSrcGOF, d->nModeYUV, d->sharp);
 
         vsapi->freeFrame(src);
@@ -124,6 +126,14 @@ static const VSFrameRef *VS_CC mvsuperGetFrame(int n, int activationReason, void
             vsapi->propSetInt(props, "Super_pel", d->nPel, paReplace);
             vsapi->propSetInt(props, "Super_modeyuv", d->nModeYUV, paReplace);
             vsapi->propSetInt(props, "Super_levels", d->nLevels, paReplace);
+            vsapi->propSetInt(props, "Super_lazy", d->lazy, paReplace);
+            vsapi->propSetInt(props, "Super_sharp", d->sharp, paReplace);
+        }
+
+        if (d->lazy) {
+            VSMap *props = vsapi->getFramePropsRW(dst);
+
+            vsapi->propSetInt(props, "Super_serial", gofcNewSerial(), paReplace);
         }
 
         return dst;
@@ -181,6 +191,8 @@ static void VS_CC mvsuperCreate(const VSMap *in, VSMap *out, void *userData, VSC
     if (err)
         d.isse = 1;
 
+    d.lazy = !!vsapi->propGetInt(in, "lazy", 0, &err);
+
 
     if ((d.nPel != 1) && (d.nPel != 2) && (d.nPel != 4)) {
         vsapi->setError(out, "Super: pel must be 1, 2, or 4.");
@@ -216,10 +228,6 @@ static void VS_CC mvsuperCreate(const VSMap *in, VSMap *out, void *userData, VSC
     d.nModeYUV = d.chroma ? YUVPLANES : YPLANE;
 
 
-    if (d.vi.format->bitsPerSample > 8)
-        d.isse = 0;
-
-
     d.xRatioUV = 1 << d.vi.format->subSamplingW;
     d.yRatioUV = 1 << d.vi.format->subSamplingH;
 
@@ -242,6 +250,16 @@ static void VS_CC mvsuperCreate(const VSMap *in, VSMap *out, void *userData, VSC
         return;
     }
 
+    if (d.nPel == 1)
+        d.lazy = 0;
+
+    if (d.pelclip && d.lazy) {
+        vsapi->setError(out, "Super: pelclip can't be used with lazy=True.");
+        vsapi->freeNode(d.node);
+        vsapi->freeNode(d.pelclip);
+        return;
+    }
+
     d.usePelClip = 0;
     if (d.pelclip && (d.nPel >= 2)) {
         if ((pelvi->width == d.vi.width * d.nPel) &&
@@ -261,7 +279,7 @@ static void VS_CC mvsuperCreate(const VSMap *in, VSMap *out, void *userData, VSC
     }
 
     d.nSuperWidth = d.nWidth + 2 * d.nHPad;
-    d.nSuperHeight = PlaneSuperOffset(0, d.nHeight, d.nLevels, d.nPel, d.nVPad, d.nSuperWidth, d.yRatioUV) / d.nSuperWidth;
+    d.nSuperHeight = PlaneSuperOffset(0, d.nHeight, d.nLevels, d.lazy ? 1 : d.nPel, d.nVPad, d.nSuperWidth, d.yRatioUV) / d.nSuperWidth;
     if (d.yRatioUV == 2 && d.nSuperHeight & 1)
         d.nSuperHeight++; // even
     if (d.xRatioUV == 2 && d.nSuperWidth & 1)
@@ -277,6 +295,136 @@ static void VS_CC mvsuperCreate(const VSMap *in, VSMap *out, void *userData, VSC
 }
 
 
+typedef struct MVSuperLevelsData {
+    VSNodeRef *super;
+    VSVideoInfo vi;
+
+    int nLevels;
+} MVSuperLevelsData;
+
+
+static void VS_CC mvsuperlevelsInit(VSMap *in, VSMap *out, void **instanceData, VSNode *node, VSCore *core, const VSAPI *vsapi) {
+    (void)in;
+    (void)out;
+    (void)core;
+    MVSuperLevelsData *d = (MVSuperLevelsData *)*instanceData;
+    vsapi->setVideoInfo(&d->vi, 1, node);
+}
+
+
+static const VSFrameRef *VS_CC mvsuperlevelsGetFrame(int n, int activationReason, void **instanceData, void **frameData, VSFrameContext *frameCtx, VSCore *core, const VSAPI *vsapi) {
+    (void)frameData;
+
+    MVSuperLevelsData *d = (MVSuperLevelsData *)*instanceData;
+
+    if (activationReason == arInitial) {
+        vsapi->requestFrameFilter(n, d->super, frameCtx);
+    } else if (activationReason == arAllFramesReady) {
+        const VSFrameRef *src = vsapi->getFrameFilter(n, d->super, frameCtx);
+
+        VSFrameRef *dst = vsapi->newVideoFrame(d->vi.format, d->vi.width, d->vi.height, src, core);
+
+        // The levels are stored one after the other, so the ones kept are at the top.
+        for (int plane = 0; plane < d->vi.format->numPlanes; plane++)
+            vs_bitblt(vsapi->getWritePtr(dst, plane), vsapi->getStride(dst, plane),
+                      vsapi->getReadPtr(src, plane), vsapi->getStride(src, plane),
+                      vsapi->getFrameWidth(dst, plane) * d->vi.format->bytesPerSample, vsapi->getFrameHeight(dst, plane));
+
+        vsapi->freeFrame(src);
+
+        if (n == 0) {
+            VSMap *props = vsapi->getFramePropsRW(dst);
+
+            vsapi->propSetInt(props, "Super_levels", d->nLevels, paReplace);
+        }
+
+        return dst;
+    }
+
+    return 0;
+}
+
+
+static void VS_CC mvsuperlevelsFree(void *instanceData, VSCore *core, const VSAPI *vsapi) {
+    (void)core;
+
+    MVSuperLevelsData *d = (MVSuperLevelsData *)instanceData;
+
+    vsapi->freeNode(d->super);
+    free(d);
+}
+
+
+static void VS_CC mvsuperlevelsCreate(const VSMap *in, VSMap *out, void *userData, VSCore *core, const VSAPI *vsapi) {
+    (void)userData;
+
+    MVSuperLevelsData d;
+    MVSuperLevelsData *data;
+
+    int err;
+
+    d.nLevels = int64ToIntS(vsapi->propGetInt(in, "levels", 0, &err));
+    if (err)
+        d.nLevels = 1;
+
+
+    d.super = vsapi->propGetNode(in, "super", 0, 0);
+    d.vi = *vsapi->getVideoInfo(d.super);
+
+    if (!isConstantFormat(&d.vi)) {
+        vsapi->setError(out, "SuperLevels: super clip must have constant format and dimensions.");
+        vsapi->freeNode(d.super);
+        return;
+    }
+
+#define ERROR_SIZE 1024
+    char errorMsg[ERROR_SIZE] = "SuperLevels: failed to retrieve first frame from super clip. Error message: ";
+    size_t errorLen = strlen(errorMsg);
+    const VSFrameRef *evil = vsapi->getFrame(0, d.super, errorMsg + errorLen, ERROR_SIZE - errorLen);
+#undef ERROR_SIZE
+    if (!evil) {
+        vsapi->setError(out, errorMsg);
+        vsapi->freeNode(d.super);
+        return;
+    }
+    const VSMap *props = vsapi->getFramePropsRO(evil);
+    int evil_err[4];
+    int nHeight = int64ToIntS(vsapi->propGetInt(props, "Super_height", 0, &evil_err[0]));
+    int nVPad = int64ToIntS(vsapi->propGetInt(props, "Super_vpad", 0, &evil_err[1]));
+    int nPel = int64ToIntS(vsapi->propGetInt(props, "Super_pel", 0, &evil_err[2]));
+    int nSuperLevels = int64ToIntS(vsapi->propGetInt(props, "Super_levels", 0, &evil_err[3]));
+    int lazy = !!vsapi->propGetInt(props, "Super_lazy", 0, &err);
+    vsapi->freeFrame(evil);
+
+    for (int i = 0; i < 4; i++)
+        if (evil_err[i]) {
+            vsapi->setError(out, "SuperLevels: required properties not found in first frame of super clip. Maybe clip didn't come from mv.Super? Was the first frame trimmed away?");
+            vsapi->freeNode(d.super);
+            return;
+        }
+
+    if (d.nLevels < 1 || d.nLevels > nSuperLevels) {
+        vsapi->setError(out, "SuperLevels: levels must be between 1 and the number of levels in the super clip (inclusive).");
+        vsapi->freeNode(d.super);
+        return;
+    }
+
+    int yRatioUV = 1 << d.vi.format->subSamplingH;
+
+    // Same as in mvsuperCreate.
+    int nSuperHeight = PlaneSuperOffset(0, nHeight, d.nLevels, lazy ? 1 : nPel, nVPad, d.vi.width, yRatioUV) / d.vi.width;
+    if (yRatioUV == 2 && nSuperHeight & 1)
+        nSuperHeight++;
+    d.vi.height = nSuperHeight;
+
+
+    data = (MVSuperLevelsData *)malloc(sizeof(d));
+    *data = d;
+
+    vsapi->createFilter(in, out, "SuperLevels", mvsuperlevelsInit, mvsuperlevelsGetFrame, mvsuperlevelsFree, fmParallel, 0, data, core);
+}
+
+
 void mvsuperRegister(VSRegisterFunction registerFunc, VSPlugin *plugin) {
     registerFunc("Super",
                  "clip:clip;"
@@ -288,6 +436,11 @@ void mvsuperRegister(VSRegisterFunction registerFunc, VSPlugin *plugin) {
                  "sharp:int:opt;"
                  "rfilter:int:opt;"
                  "pelclip:clip:opt;"
-                 "isse:int:opt;",
+                 "isse:int:opt;"
+                 "lazy:int:opt;",
                  mvsuperCreate, 0, plugin);
+    registerFunc("SuperLevels",
+                 "super:clip;"
+                 "levels:int:opt;",
+                 mvsuperlevelsCreate, 0, plugin);
 }
@@ -19,8 +19,11 @@
 
 #include <math.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "CommonFunctions.h"
+#include "CPU.h"
 #include "MaskFun.h"
 
 #define max(a, b) ((a) > (b) ? (a) : (b))
@@ -33,75 +36,87 @@ static inline void ByteOccMask(uint8_t *occMask, int occlusion, double occnorm,
         *occMask = max(*occMask, min((int)(255 * pow(occlusion * occnorm, fGamma)), 255));
 }
 
-void MakeVectorOcclusionMaskTime(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occMask, int occMaskPitch, int time256, int blkSizeX, int blkSizeY) { // analyse vectors field to detect occlusion
-    memset(occMask, 0, occMaskPitch * nBlkY);
-    int time4096X = time256 * 16 / blkSizeX;
-    int time4096Y = time256 * 16 / blkSizeY;
+void MakeVectorOcclusionStrengths(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occX, uint8_t *occY) {
+    memset(occX, 0, nBlkX * nBlkY);
+    memset(occY, 0, nBlkX * nBlkY);
     double occnorm = 10 / dMaskNormFactor / nPel;
-    int occlusion;
 
     for (int by = 0; by < nBlkY; by++) {
         for (int bx = 0; bx < nBlkX; bx++) {
             int i = bx + by * nBlkX; // current block
-            const FakeBlockData *block = fgopGetBlock(fgop, 0, i);
-            int vx = block->vector.x;
-            int vy = block->vector.y;
+            const VECTOR *vector = fgopGetVector(fgop, 0, i);
             if (bx < nBlkX - 1) { // right neighbor
-                int i1 = i + 1;
-                const FakeBlockData *block1 = fgopGetBlock(fgop, 0, i1);
-                int vx1 = block1->vector.x;
-                if (vx1 < vx) {
-                    occlusion = vx - vx1;
-                    for (int bxi = bx + vx1 * time4096X / 4096; bxi <= bx + vx * time4096X / 4096 + 1 && bxi >= 0 && bxi < nBlkX; bxi++)
-                        ByteOccMask(&occMask[bxi + by * occMaskPitch], occlusion, occnorm, fGamma);
-                }
+                int vx1 = fgopGetVector(fgop, 0, i + 1)->x;
+                if (vx1 < vector->x)
+                    ByteOccMask(&occX[i], vector->x - vx1, occnorm, fGamma);
             }
             if (by < nBlkY - 1) { // bottom neighbor
-                int i1 = i + nBlkX;
-                const FakeBlockData *block1 = fgopGetBlock(fgop, 0, i1);
-                int vy1 = block1->vector.y;
-                if (vy1 < vy) {
-                    occlusion = vy - vy1;
-                    for (int byi = by + vy1 * time4096Y / 4096; byi <= by + vy * time4096Y / 4096 + 1 && byi >= 0 && byi < nBlkY; byi++)
-                        ByteOccMask(&occMask[bx + byi * occMaskPitch], occlusion, occnorm, fGamma);
-                }
+                int vy1 = fgopGetVector(fgop, 0, i + nBlkX)->y;
+                if (vy1 < vector->y)
+                    ByteOccMask(&occY[i], vector->y - vy1, occnorm, fGamma);
             }
         }
     }
 }
 
 
-void MakeVectorSmallMasks(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, uint8_t *VXSmallY, int pitchVXSmallY, uint8_t *VYSmallY, int pitchVYSmallY) {
+void SpreadVectorOcclusionStrengths(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, const uint8_t *occX, const uint8_t *occY, uint8_t *occMask, int occMaskPitch, int time256, int blkSizeX, int blkSizeY) {
+    memset(occMask, 0, occMaskPitch * nBlkY);
+    int time4096X = time256 * 16 / blkSizeX;
+    int time4096Y = time256 * 16 / blkSizeY;
+
+    for (int by = 0; by < nBlkY; by++) {
+        for (int bx = 0; bx < nBlkX; bx++) {
+            int i = bx + by * nBlkX; // current block
+            if (occX[i]) { // right neighbor
+                int vx = fgopGetVector(fgop, 0, i)->x;
+                int vx1 = fgopGetVector(fgop, 0, i + 1)->x;
+                for (int bxi = bx + vx1 * time4096X / 4096; bxi <= bx + vx * time4096X / 4096 + 1 && bxi >= 0 && bxi < nBlkX; bxi++)
+                    occMask[bxi + by * occMaskPitch] = max(occMask[bxi + by * occMaskPitch], occX[i]);
+            }
+            if (occY[i]) { // bottom neighbor
+                int vy = fgopGetVector(fgop, 0, i)->y;
+                int vy1 = fgopGetVector(fgop, 0, i + nBlkX)->y;
+                for (int byi = by + vy1 * time4096Y / 4096; byi <= by + vy * time4096Y / 4096 + 1 && byi >= 0 && byi < nBlkY; byi++)
+                    occMask[bx + byi * occMaskPitch] = max(occMask[bx + byi * occMaskPitch], occY[i]);
+            }
+        }
+    }
+}
+
+
+void MakeVectorOcclusionMaskTime(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occMask, int occMaskPitch, int time256, int blkSizeX, int blkSizeY) { // analyse vectors field to detect occlusion
+    uint8_t *occX = (uint8_t *)malloc(nBlkX * nBlkY * 2);
+    uint8_t *occY = occX + nBlkX * nBlkY;
+
+    MakeVectorOcclusionStrengths(fgop, nBlkX, nBlkY, dMaskNormFactor, fGamma, nPel, occX, occY);
+    SpreadVectorOcclusionStrengths(fgop, nBlkX, nBlkY, occX, occY, occMask, occMaskPitch, time256, blkSizeX, blkSizeY);
+
+    free(occX);
+}
+
+
+void MakeVectorSmallMasks(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, int16_t *VXSmallY, int pitchVXSmallY, int16_t *VYSmallY, int pitchVYSmallY) {
     // make  vector vx and vy small masks
-    // 1. ATTENTION: vectors are assumed SHORT (|vx|, |vy| < 127) !
-    // 2. they will be zeroed if not
-    // 3. added 128 to all values
+    // vectors too long for int16_t are clamped
     for (int by = 0; by < nBlkY; by++) {
         for (int bx = 0; bx < nBlkX; bx++) {
             int i = bx + by * nBlkX;
-            const FakeBlockData *block = fgopGetBlock(fgop, 0, i);
-            int vx = block->vector.x;
-            int vy = block->vector.y;
-            if (vx > 127)
-                vx = 127;
-            else if (vx < -127)
-                vx = -127;
-            if (vy > 127)
-                vy = 127;
-            else if (vy < -127)
-                vy = -127;
-            VXSmallY[bx + by * pitchVXSmallY] = vx + 128; // luma
-            VYSmallY[bx + by * pitchVYSmallY] = vy + 128; // luma
+            const VECTOR *vector = fgopGetVector(fgop, 0, i);
+            int vx = vector->x;
+            int vy = vector->y;
+            VXSmallY[bx + by * pitchVXSmallY] = max(min(vx, INT16_MAX), INT16_MIN); // luma
+            VYSmallY[bx + by * pitchVYSmallY] = max(min(vy, INT16_MAX), INT16_MIN); // luma
         }
     }
 }
 
-void VectorSmallMaskYToHalfUV(uint8_t *VSmallY, int nBlkX, int nBlkY, uint8_t *VSmallUV, int ratioUV) {
+void VectorSmallMaskYToHalfUV(const int16_t *VSmallY, int nBlkX, int nBlkY, int16_t *VSmallUV, int ratioUV) {
     if (ratioUV == 2) {
         // YV12 colorformat
         for (int by = 0; by < nBlkY; by++) {
             for (int bx = 0; bx < nBlkX; bx++) {
-                VSmallUV[bx] = ((VSmallY[bx] - 128) >> 1) + 128; // chroma
+                VSmallUV[bx] = VSmallY[bx] >> 1; // chroma
             }
             VSmallY += nBlkX;
             VSmallUV += nBlkX;
@@ -296,100 +311,41 @@ void Blend(uint8_t *pdst, const uint8_t *psrc, const uint8_t *pref, int height,
 }
 
 
-void Create_LUTV(int time256, int *LUTVB, int *LUTVF) {
-    for (int v = 0; v < 256; v++) {
-        LUTVB[v] = ((v - 128) * (256 - time256)) / 256;
-        LUTVF[v] = ((v - 128) * time256) / 256;
-    }
-}
-
-
 #define RealFlowInter(PixelType) \
-static void RealFlowInter_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *prefB8, const uint8_t *prefF8, int ref_pitch, \
-                   const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
-                   int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF) { \
-    const PixelType *prefB = (const PixelType *)prefB8; \
-    const PixelType *prefF = (const PixelType *)prefF8; \
+static void RealFlowInter_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                   const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                   int VPitch, int width, int height, int time256, int nPel) { \
+    const PixelType *prefB0 = (const PixelType *)prefB[0]; \
+    const PixelType *prefF0 = (const PixelType *)prefF[0]; \
     PixelType *pdst = (PixelType *)pdst8; \
+    const int nLogPel = ilog2(nPel); \
  \
     ref_pitch /= sizeof(PixelType); \
     dst_pitch /= sizeof(PixelType); \
  \
-    if (nPel == 1) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int vxF = LUTVF[VXFullF[w]]; \
-                int vyF = LUTVF[VYFullF[w]]; \
-                int64_t dstF = prefF[vyF * ref_pitch + vxF + w]; \
-                int dstF0 = prefF[w]; /* zero */ \
-                int vxB = LUTVB[VXFullB[w]]; \
-                int vyB = LUTVB[VYFullB[w]]; \
-                int64_t dstB = prefB[vyB * ref_pitch + vxB + w]; \
-                int dstB0 = prefB[w]; /* zero */ \
-                pdst[w] = (PixelType)((((dstF * (255 - MaskF[w]) + ((MaskF[w] * (dstB * (255 - MaskB[w]) + MaskB[w] * dstF0) + 255) >> 8) + 255) >> 8) * (256 - time256) + \
-                                     ((dstB * (255 - MaskB[w]) + ((MaskB[w] * (dstF * (255 - MaskF[w]) + MaskF[w] * dstB0) + 255) >> 8) + 255) >> 8) * time256) >> \
-                                    8); \
-            } \
-            pdst += dst_pitch; \
-            prefB += ref_pitch; \
-            prefF += ref_pitch; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-            MaskB += VPitch; \
-            MaskF += VPitch; \
-        } \
-    } else if (nPel == 2) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int vxF = LUTVF[VXFullF[w]]; \
-                int vyF = LUTVF[VYFullF[w]]; \
-                int dstF = prefF[vyF * ref_pitch + vxF + (w << 1)]; \
-                int dstF0 = prefF[(w << 1)]; /* zero */ \
-                int vxB = LUTVB[VXFullB[w]]; \
-                int vyB = LUTVB[VYFullB[w]]; \
-                int dstB = prefB[vyB * ref_pitch + vxB + (w << 1)]; \
-                int dstB0 = prefB[(w << 1)]; /* zero */ \
-                pdst[w] = (((dstF * (255 - MaskF[w]) + ((MaskF[w] * (dstB * (255 - MaskB[w]) + MaskB[w] * dstF0) + 255) >> 8) + 255) >> 8) * (256 - time256) + \
-                           ((dstB * (255 - MaskB[w]) + ((MaskB[w] * (dstF * (255 - MaskF[w]) + MaskF[w] * dstB0) + 255) >> 8) + 255) >> 8) * time256) >> \
-                          8; \
-            } \
-            pdst += dst_pitch; \
-            prefB += ref_pitch << 1; \
-            prefF += ref_pitch << 1; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-            MaskB += VPitch; \
-            MaskF += VPitch; \
-        } \
-    } else if (nPel == 4) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int vxF = LUTVF[VXFullF[w]]; \
-                int vyF = LUTVF[VYFullF[w]]; \
-                int dstF = prefF[vyF * ref_pitch + vxF + (w << 2)]; \
-                int dstF0 = prefF[(w << 2)]; /* zero */ \
-                int vxB = LUTVB[VXFullB[w]]; \
-                int vyB = LUTVB[VYFullB[w]]; \
-                int dstB = prefB[vyB * ref_pitch + vxB + (w << 2)]; \
-                int dstB0 = prefB[(w << 2)]; /* zero */ \
-                pdst[w] = (((dstF * (255 - MaskF[w]) + ((MaskF[w] * (dstB * (255 - MaskB[w]) + MaskB[w] * dstF0) + 255) >> 8) + 255) >> 8) * (256 - time256) + \
-                           ((dstB * (255 - MaskB[w]) + ((MaskB[w] * (dstF * (255 - MaskF[w]) + MaskF[w] * dstB0) + 255) >> 8) + 255) >> 8) * time256) >> \
-                          8; \
-            } \
-            pdst += dst_pitch; \
-            prefB += ref_pitch << 2; \
-            prefF += ref_pitch << 2; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-            MaskB += VPitch; \
-            MaskF += VPitch; \
+    for (int h = 0; h < height; h++) { \
+        for (int w = 0; w < width; w++) { \
+            int vxF = VectorTimeF(VXFullF[w], time256); \
+            int vyF = VectorTimeF(VYFullF[w], time256); \
+            int64_t dstF = SUBPEL_SAMPLE(PixelType, prefF, ref_pitch, (w << nLogPel) + vxF, (h << nLogPel) + vyF, nLogPel); \
+            int dstF0 = prefF0[w]; /* zero */ \
+            int vxB = VectorTimeB(VXFullB[w], time256); \
+            int vyB = VectorTimeB(VYFullB[w], time256); \
+            int64_t dstB = SUBPEL_SAMPLE(PixelType, prefB, ref_pitch, (w << nLogPel) + vxB, (h << nLogPel) + vyB, nLogPel); \
+            int dstB0 = prefB0[w]; /* zero */ \
+            pdst[w] = (PixelType)((((dstF * (255 - MaskF[w]) + ((MaskF[w] * (dstB * (255 - MaskB[w]) + MaskB[w] * dstF0) + 255) >> 8) + 255) >> 8) * (256 - time256) + \
+                                 ((dstB * (255 - MaskB[w]) + ((MaskB[w] * (dstF * (255 - MaskF[w]) + MaskF[w] * dstB0) + 255) >> 8) + 255) >> 8) * time256) >> \
+                                8); \
         } \
+        pdst += dst_pitch; \
+        prefB0 += ref_pitch; \
+        prefF0 += ref_pitch; \
+        VXFullB += VPitch; \
+        VYFullB += VPitch; \
+        VXFullF += VPitch; \
+        VYFullF += VPitch; \
+        MaskB += VPitch; \
+        MaskF += VPitch; \
     } \
 }
 
@@ -397,15 +353,6 @@ RealFlowInter(uint8_t)
 RealFlowInter(uint16_t)
 
 
-void FlowInter(uint8_t *pdst, int dst_pitch, const uint8_t *prefB, const uint8_t *prefF, int ref_pitch,
-               const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
-               int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF, int bitsPerSample) {
-    if (bitsPerSample == 8)
-        RealFlowInter_uint8_t(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, LUTVB, LUTVF);
-    else
-        RealFlowInter_uint16_t(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, LUTVB, LUTVF);
-}
-
 
 static inline int Median3r(int a, int b, int c) {
     // reduced median - if it is known that a <= c (more fast)
@@ -423,161 +370,60 @@ static inline int Median3r(int a, int b, int c) {
 
 
 #define RealFlowInterExtra(PixelType) \
-static void RealFlowInterExtra_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *prefB8, const uint8_t *prefF8, int ref_pitch, \
-                        const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
-                        int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF, \
-                        const uint8_t *VXFullBB, const uint8_t *VXFullFF, const uint8_t *VYFullBB, const uint8_t *VYFullFF) { \
-    const PixelType *prefB = (const PixelType *)prefB8; \
-    const PixelType *prefF = (const PixelType *)prefF8; \
+static void RealFlowInterExtra_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                        const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                        int VPitch, int width, int height, int time256, int nPel, \
+                        const int16_t *VXFullBB, const int16_t *VXFullFF, const int16_t *VYFullBB, const int16_t *VYFullFF) { \
     PixelType *pdst = (PixelType *)pdst8; \
+    const int nLogPel = ilog2(nPel); \
  \
     ref_pitch /= sizeof(PixelType); \
     dst_pitch /= sizeof(PixelType); \
  \
-    if (nPel == 1) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int vxF = LUTVF[VXFullF[w]]; \
-                int vyF = LUTVF[VYFullF[w]]; \
-                int adrF = vyF * ref_pitch + vxF + w; \
-                int dstF = prefF[adrF]; \
+    for (int h = 0; h < height; h++) { \
+        for (int w = 0; w < width; w++) { \
+            int vxF = VectorTimeF(VXFullF[w], time256); \
+            int vyF = VectorTimeF(VYFullF[w], time256); \
+            int dstF = SUBPEL_SAMPLE(PixelType, prefF, ref_pitch, (w << nLogPel) + vxF, (h << nLogPel) + vyF, nLogPel); \
  \
-                int vxFF = LUTVF[VXFullFF[w]]; \
-                int vyFF = LUTVF[VYFullFF[w]]; \
-                int adrFF = vyFF * ref_pitch + vxFF + w; \
-                int dstFF = prefF[adrFF]; \
+            int vxFF = VectorTimeF(VXFullFF[w], time256); \
+            int vyFF = VectorTimeF(VYFullFF[w], time256); \
+            int dstFF = SUBPEL_SAMPLE(PixelType, prefF, ref_pitch, (w << nLogPel) + vxFF, (h << nLogPel) + vyFF, nLogPel); \
  \
-                int vxB = LUTVB[VXFullB[w]]; \
-                int vyB = LUTVB[VYFullB[w]]; \
-                int adrB = vyB * ref_pitch + vxB + w; \
-                int dstB = prefB[adrB]; \
+            int vxB = VectorTimeB(VXFullB[w], time256); \
+            int vyB = VectorTimeB(VYFullB[w], time256); \
+            int dstB = SUBPEL_SAMPLE(PixelType, prefB, ref_pitch, (w << nLogPel) + vxB, (h << nLogPel) + vyB, nLogPel); \
  \
-                int vxBB = LUTVB[VXFullBB[w]]; \
-                int vyBB = LUTVB[VYFullBB[w]]; \
-                int adrBB = vyBB * ref_pitch + vxBB + w; \
-                int dstBB = prefB[adrBB]; \
+            int vxBB = VectorTimeB(VXFullBB[w], time256); \
+            int vyBB = VectorTimeB(VYFullBB[w], time256); \
+            int dstBB = SUBPEL_SAMPLE(PixelType, prefB, ref_pitch, (w << nLogPel) + vxBB, (h << nLogPel) + vyBB, nLogPel); \
  \
-                /* use median, firstly get min max of compensations */ \
-                int minfb; \
-                int maxfb; \
-                if (dstF > dstB) { \
-                    minfb = dstB; \
-                    maxfb = dstF; \
-                } else { \
-                    maxfb = dstB; \
-                    minfb = dstF; \
-                } \
- \
-                pdst[w] = (((Median3r(minfb, dstBB, maxfb) * MaskF[w] + dstF * (255 - MaskF[w]) + 255) >> 8) * (256 - time256) + \
-                           ((Median3r(minfb, dstFF, maxfb) * MaskB[w] + dstB * (255 - MaskB[w]) + 255) >> 8) * time256) >> \
-                          8; \
+            /* use median, firstly get min max of compensations */ \
+            int minfb; \
+            int maxfb; \
+            if (dstF > dstB) { \
+                minfb = dstB; \
+                maxfb = dstF; \
+            } else { \
+                maxfb = dstB; \
+                minfb = dstF; \
             } \
-            pdst += dst_pitch; \
-            prefB += ref_pitch; \
-            prefF += ref_pitch; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-            MaskB += VPitch; \
-            MaskF += VPitch; \
-            VXFullBB += VPitch; \
-            VYFullBB += VPitch; \
-            VXFullFF += VPitch; \
-            VYFullFF += VPitch; \
-        } \
-    } else if (nPel == 2) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int vxF = LUTVF[VXFullF[w]]; \
-                int vyF = LUTVF[VYFullF[w]]; \
-                int adrF = vyF * ref_pitch + vxF + (w << 1); \
-                int dstF = prefF[adrF]; \
-                int vxFF = LUTVF[VXFullFF[w]]; \
-                int vyFF = LUTVF[VYFullFF[w]]; \
-                int adrFF = vyFF * ref_pitch + vxFF + (w << 1); \
-                int dstFF = prefF[adrFF]; \
-                int vxB = LUTVB[VXFullB[w]]; \
-                int vyB = LUTVB[VYFullB[w]]; \
-                int adrB = vyB * ref_pitch + vxB + (w << 1); \
-                int dstB = prefB[adrB]; \
-                int vxBB = LUTVB[VXFullBB[w]]; \
-                int vyBB = LUTVB[VYFullBB[w]]; \
-                int adrBB = vyBB * ref_pitch + vxBB + (w << 1); \
-                int dstBB = prefB[adrBB]; \
-                /* use median, firsly get min max of compensations */ \
-                int minfb; \
-                int maxfb; \
-                if (dstF > dstB) { \
-                    minfb = dstB; \
-                    maxfb = dstF; \
-                } else { \
-                    maxfb = dstB; \
-                    minfb = dstF; \
-                } \
- \
-                pdst[w] = (((Median3r(minfb, dstBB, maxfb) * MaskF[w] + dstF * (255 - MaskF[w]) + 255) >> 8) * (256 - time256) + \
-                           ((Median3r(minfb, dstFF, maxfb) * MaskB[w] + dstB * (255 - MaskB[w]) + 255) >> 8) * time256) >> \
-                          8; \
-            } \
-            pdst += dst_pitch; \
-            prefB += ref_pitch << 1; \
-            prefF += ref_pitch << 1; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-            MaskB += VPitch; \
-            MaskF += VPitch; \
-            VXFullBB += VPitch; \
-            VYFullBB += VPitch; \
-            VXFullFF += VPitch; \
-            VYFullFF += VPitch; \
-        } \
-    } else if (nPel == 4) { \
-        for (int h = 0; h < height; h++) { \
-            for (int w = 0; w < width; w++) { \
-                int vxF = LUTVF[VXFullF[w]]; \
-                int vyF = LUTVF[VYFullF[w]]; \
-                int dstF = prefF[vyF * ref_pitch + vxF + (w << 2)]; \
-                int vxFF = LUTVF[VXFullFF[w]]; \
-                int vyFF = LUTVF[VYFullFF[w]]; \
-                int dstFF = prefF[vyFF * ref_pitch + vxFF + (w << 2)]; \
-                int vxB = LUTVB[VXFullB[w]]; \
-                int vyB = LUTVB[VYFullB[w]]; \
-                int dstB = prefB[vyB * ref_pitch + vxB + (w << 2)]; \
-                int vxBB = LUTVB[VXFullBB[w]]; \
-                int vyBB = LUTVB[VYFullBB[w]]; \
-                int dstBB = prefB[vyBB * ref_pitch + vxBB + (w << 2)]; \
-                /* use median, firsly get min max of compensations */ \
-                int minfb; \
-                int maxfb; \
-                if (dstF > dstB) { \
-                    minfb = dstB; \
-                    maxfb = dstF; \
-                } else { \
-                    maxfb = dstB; \
-                    minfb = dstF; \
-                } \
  \
-                pdst[w] = (((Median3r(minfb, dstBB, maxfb) * MaskF[w] + dstF * (255 - MaskF[w]) + 255) >> 8) * (256 - time256) + \
-                           ((Median3r(minfb, dstFF, maxfb) * MaskB[w] + dstB * (255 - MaskB[w]) + 255) >> 8) * time256) >> \
-                          8; \
-            } \
-            pdst += dst_pitch; \
-            prefB += ref_pitch << 2; \
-            prefF += ref_pitch << 2; \
-            VXFullB += VPitch; \
-            VYFullB += VPitch; \
-            VXFullF += VPitch; \
-            VYFullF += VPitch; \
-            MaskB += VPitch; \
-            MaskF += VPitch; \
-            VXFullBB += VPitch; \
-            VYFullBB += VPitch; \
-            VXFullFF += VPitch; \
-            VYFullFF += VPitch; \
+            pdst[w] = (((Median3r(minfb, dstBB, maxfb) * MaskF[w] + dstF * (255 - MaskF[w]) + 255) >> 8) * (256 - time256) + \
+                       ((Median3r(minfb, dstFF, maxfb) * MaskB[w] + dstB * (255 - MaskB[w]) + 255) >> 8) * time256) >> \
+                      8; \
         } \
+        pdst += dst_pitch; \
+        VXFullB += VPitch; \
+        VYFullB += VPitch; \
+        VXFullF += VPitch; \
+        VYFullF += VPitch; \
+        MaskB += VPitch; \
+        MaskF += VPitch; \
+        VXFullBB += VPitch; \
+        VYFullBB += VPitch; \
+        VXFullFF += VPitch; \
+        VYFullFF += VPitch; \
     } \
 }
 
@@ -585,24 +431,15 @@ RealFlowInterExtra(uint8_t)
 RealFlowInterExtra(uint16_t)
 
 
-void FlowInterExtra(uint8_t *pdst, int dst_pitch, const uint8_t *prefB, const uint8_t *prefF, int ref_pitch,
-                    const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
-                    int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF,
-                    const uint8_t *VXFullBB, const uint8_t *VXFullFF, const uint8_t *VYFullBB, const uint8_t *VYFullFF, int bitsPerSample) {
-    if (bitsPerSample == 8)
-        RealFlowInterExtra_uint8_t(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, LUTVB, LUTVF, VXFullBB, VXFullFF, VYFullBB, VYFullFF);
-    else
-        RealFlowInterExtra_uint16_t(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, LUTVB, LUTVF, VXFullBB, VXFullFF, VYFullBB, VYFullFF);
-}
-
 
 #define RealFlowInterSimple(PixelType) \
-static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *prefB8, const uint8_t *prefF8, int ref_pitch, \
-                         const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
-                         int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF) { \
-    const PixelType *prefB = (const PixelType *)prefB8; \
-    const PixelType *prefF = (const PixelType *)prefF8; \
+static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                         const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                         int VPitch, int width, int height, int time256, int nPel) { \
+    const PixelType *prefB0 = (const PixelType *)prefB[0]; \
+    const PixelType *prefF0 = (const PixelType *)prefF[0]; \
     PixelType *pdst = (PixelType *)pdst8; \
+    const int nLogPel = ilog2(nPel); \
  \
     ref_pitch /= sizeof(PixelType); \
     dst_pitch /= sizeof(PixelType); \
@@ -611,43 +448,22 @@ static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const
         if (nPel == 1) { \
             for (int h = 0; h < height; h++) { \
                 for (int w = 0; w < width; w += 2) { /* paired for speed */ \
-                    int vxF = (VXFullF[w] - 128) >> 1; \
-                    int vyF = (VYFullF[w] - 128) >> 1; \
+                    int vxF = VXFullF[w] >> 1; \
+                    int vyF = VYFullF[w] >> 1; \
                     int addrF = vyF * ref_pitch + vxF + w; \
-                    int dstF = prefF[addrF]; \
-                    int dstF1 = prefF[addrF + 1]; /* approximation for speed */ \
-                    int vxB = (VXFullB[w] - 128) >> 1; \
-                    int vyB = (VYFullB[w] - 128) >> 1; \
+                    int dstF = prefF0[addrF]; \
+                    int dstF1 = prefF0[addrF + 1]; /* approximation for speed */ \
+                    int vxB = VXFullB[w] >> 1; \
+                    int vyB = VYFullB[w] >> 1; \
                     int addrB = vyB * ref_pitch + vxB + w; \
-                    int dstB = prefB[addrB]; \
-                    int dstB1 = prefB[addrB + 1]; \
+                    int dstB = prefB0[addrB]; \
+                    int dstB1 = prefB0[addrB + 1]; \
                     pdst[w] = (((dstF + dstB) << 8) + (dstB - dstF) * (MaskF[w] - MaskB[w])) >> 9; \
                     pdst[w + 1] = (((dstF1 + dstB1) << 8) + (dstB1 - dstF1) * (MaskF[w + 1] - MaskB[w + 1])) >> 9; \
                 } \
                 pdst += dst_pitch; \
-                prefB += ref_pitch; \
-                prefF += ref_pitch; \
-                VXFullB += VPitch; \
-                VYFullB += VPitch; \
-                VXFullF += VPitch; \
-                VYFullF += VPitch; \
-                MaskB += VPitch; \
-                MaskF += VPitch; \
-            } \
-        } else if (nPel == 2) { \
-            for (int h = 0; h < height; h++) { \
-                for (int w = 0; w < width; w += 1) { \
-                    int vxF = (VXFullF[w] - 128) >> 1; \
-                    int vyF = (VYFullF[w] - 128) >> 1; \
-                    int dstF = prefF[vyF * ref_pitch + vxF + (w << 1)]; \
-                    int vxB = (VXFullB[w] - 128) >> 1; \
-                    int vyB = (VYFullB[w] - 128) >> 1; \
-                    int dstB = prefB[vyB * ref_pitch + vxB + (w << 1)]; \
-                    pdst[w] = (((dstF + dstB) << 8) + (dstB - dstF) * (MaskF[w] - MaskB[w])) >> 9; \
-                } \
-                pdst += dst_pitch; \
-                prefB += ref_pitch << 1; \
-                prefF += ref_pitch << 1; \
+                prefB0 += ref_pitch; \
+                prefF0 += ref_pitch; \
                 VXFullB += VPitch; \
                 VYFullB += VPitch; \
                 VXFullF += VPitch; \
@@ -655,20 +471,18 @@ static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const
                 MaskB += VPitch; \
                 MaskF += VPitch; \
             } \
-        } else if (nPel == 4) { \
+        } else { \
             for (int h = 0; h < height; h++) { \
                 for (int w = 0; w < width; w += 1) { \
-                    int vxF = (VXFullF[w] - 128) >> 1; \
-                    int vyF = (VYFullF[w] - 128) >> 1; \
-                    int dstF = prefF[vyF * ref_pitch + vxF + (w << 2)]; \
-                    int vxB = (VXFullB[w] - 128) >> 1; \
-                    int vyB = (VYFullB[w] - 128) >> 1; \
-                    int dstB = prefB[vyB * ref_pitch + vxB + (w << 2)]; \
+                    int vxF = VXFullF[w] >> 1; \
+                    int vyF = VYFullF[w] >> 1; \
+                    int dstF = SUBPEL_SAMPLE(PixelType, prefF, ref_pitch, (w << nLogPel) + vxF, (h << nLogPel) + vyF, nLogPel); \
+                    int vxB = VXFullB[w] >> 1; \
+                    int vyB = VYFullB[w] >> 1; \
+                    int dstB = SUBPEL_SAMPLE(PixelType, prefB, ref_pitch, (w << nLogPel) + vxB, (h << nLogPel) + vyB, nLogPel); \
                     pdst[w] = (((dstF + dstB) << 8) + (dstB - dstF) * (MaskF[w] - MaskB[w])) >> 9; \
                 } \
                 pdst += dst_pitch; \
-                prefB += ref_pitch << 2; \
-                prefF += ref_pitch << 2; \
                 VXFullB += VPitch; \
                 VYFullB += VPitch; \
                 VXFullF += VPitch; \
@@ -681,16 +495,16 @@ static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const
         if (nPel == 1) { \
             for (int h = 0; h < height; h++) { \
                 for (int w = 0; w < width; w += 2) { /* paired for speed */ \
-                    int vxF = LUTVF[VXFullF[w]]; \
-                    int vyF = LUTVF[VYFullF[w]]; \
+                    int vxF = VectorTimeF(VXFullF[w], time256); \
+                    int vyF = VectorTimeF(VYFullF[w], time256); \
                     int addrF = vyF * ref_pitch + vxF + w; \
-                    int dstF = prefF[addrF]; \
-                    int dstF1 = prefF[addrF + 1]; /* approximation for speed */ \
-                    int vxB = LUTVB[VXFullB[w]]; \
-                    int vyB = LUTVB[VYFullB[w]]; \
+                    int64_t dstF = prefF0[addrF]; \
+                    int64_t dstF1 = prefF0[addrF + 1]; /* approximation for speed */ \
+                    int vxB = VectorTimeB(VXFullB[w], time256); \
+                    int vyB = VectorTimeB(VYFullB[w], time256); \
                     int addrB = vyB * ref_pitch + vxB + w; \
-                    int dstB = prefB[addrB]; \
-                    int dstB1 = prefB[addrB + 1]; \
+                    int64_t dstB = prefB0[addrB]; \
+                    int64_t dstB1 = prefB0[addrB + 1]; \
                     pdst[w] = (((dstF * 255 + (dstB - dstF) * MaskF[w] + 255)) * (256 - time256) + \
                                ((dstB * 255 - (dstB - dstF) * MaskB[w] + 255)) * time256) >> \
                               16; \
@@ -699,31 +513,8 @@ static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const
                                   16; \
                 } \
                 pdst += dst_pitch; \
-                prefB += ref_pitch; \
-                prefF += ref_pitch; \
-                VXFullB += VPitch; \
-                VYFullB += VPitch; \
-                VXFullF += VPitch; \
-                VYFullF += VPitch; \
-                MaskB += VPitch; \
-                MaskF += VPitch; \
-            } \
-        } else if (nPel == 2) { \
-            for (int h = 0; h < height; h++) { \
-                for (int w = 0; w < width; w += 1) { \
-                    int vxF = LUTVF[VXFullF[w]]; \
-                    int vyF = LUTVF[VYFullF[w]]; \
-                    int dstF = prefF[vyF * ref_pitch + vxF + (w << 1)]; \
-                    int vxB = LUTVB[VXFullB[w]]; \
-                    int vyB = LUTVB[VYFullB[w]]; \
-                    int dstB = prefB[vyB * ref_pitch + vxB + (w << 1)]; \
-                    pdst[w] = (((dstF * (255 - MaskF[w]) + dstB * MaskF[w] + 255) >> 8) * (256 - time256) + \
-                               ((dstB * (255 - MaskB[w]) + dstF * MaskB[w] + 255) >> 8) * time256) >> \
-                              8; \
-                } \
-                pdst += dst_pitch; \
-                prefB += ref_pitch << 1; \
-                prefF += ref_pitch << 1; \
+                prefB0 += ref_pitch; \
+                prefF0 += ref_pitch; \
                 VXFullB += VPitch; \
                 VYFullB += VPitch; \
                 VXFullF += VPitch; \
@@ -731,22 +522,20 @@ static void RealFlowInterSimple_##PixelType(uint8_t *pdst8, int dst_pitch, const
                 MaskB += VPitch; \
                 MaskF += VPitch; \
             } \
-        } else if (nPel == 4) { \
+        } else { \
             for (int h = 0; h < height; h++) { \
                 for (int w = 0; w < width; w += 1) { \
-                    int vxF = LUTVF[VXFullF[w]]; \
-                    int vyF = LUTVF[VYFullF[w]]; \
-                    int dstF = prefF[vyF * ref_pitch + vxF + (w << 2)]; \
-                    int vxB = LUTVB[VXFullB[w]]; \
-                    int vyB = LUTVB[VYFullB[w]]; \
-                    int dstB = prefB[vyB * ref_pitch + vxB + (w << 2)]; \
+                    int vxF = VectorTimeF(VXFullF[w], time256); \
+                    int vyF = VectorTimeF(VYFullF[w], time256); \
+                    int dstF = SUBPEL_SAMPLE(PixelType, prefF, ref_pitch, (w << nLogPel) + vxF, (h << nLogPel) + vyF, nLogPel); \
+                    int vxB = VectorTimeB(VXFullB[w], time256); \
+                    int vyB = VectorTimeB(VYFullB[w], time256); \
+                    int dstB = SUBPEL_SAMPLE(PixelType, prefB, ref_pitch, (w << nLogPel) + vxB, (h << nLogPel) + vyB, nLogPel); \
                     pdst[w] = (((dstF * (255 - MaskF[w]) + dstB * MaskF[w] + 255) >> 8) * (256 - time256) + \
                                ((dstB * (255 - MaskB[w]) + dstF * MaskB[w] + 255) >> 8) * time256) >> \
                               8; \
                 } \
                 pdst += dst_pitch; \
-                prefB += ref_pitch << 2; \
-                prefF += ref_pitch << 2; \
                 VXFullB += VPitch; \
                 VYFullB += VPitch; \
                 VXFullF += VPitch; \
@@ -762,13 +551,37 @@ RealFlowInterSimple(uint8_t)
 RealFlowInterSimple(uint16_t)
 
 
-void FlowInterSimple(uint8_t *pdst, int dst_pitch, const uint8_t *prefB, const uint8_t *prefF, int ref_pitch,
-                     const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
-                     int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF, int bitsPerSample) {
-    if (bitsPerSample == 8)
-        RealFlowInterSimple_uint8_t(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, LUTVB, LUTVF);
-    else
-        RealFlowInterSimple_uint16_t(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, LUTVB, LUTVF);
-}
+void selectFlowInterFunctions(FlowInterFunction *flowInter, FlowInterFunction *flowInterSimple, FlowInterExtraFunction *flowInterExtra, int bitsPerSample, int opt) {
+    FlowInterFunction inter = RealFlowInter_uint8_t;
+    FlowInterFunction simple = RealFlowInterSimple_uint8_t;
+    FlowInterExtraFunction extra = RealFlowInterExtra_uint8_t;
 
+    if (bitsPerSample > 8) {
+        inter = RealFlowInter_uint16_t;
+        simple = RealFlowInterSimple_uint16_t;
+        extra = RealFlowInterExtra_uint16_t;
+    }
 
+#if defined(MVTOOLS_X86)
+    if (opt && (cpu_detect() & X264_CPU_AVX2)) {
+        if (bitsPerSample == 8) {
+            inter = mvtools_flowinter_u8_avx2;
+            simple = mvtools_flowintersimple_u8_avx2;
+            extra = mvtools_flowinterextra_u8_avx2;
+        } else {
+            inter = mvtools_flowinter_u16_avx2;
+            simple = mvtools_flowintersimple_u16_avx2;
+            extra = mvtools_flowinterextra_u16_avx2;
+        }
+    }
+#else
+    (void)opt;
+#endif
+
+    if (flowInter)
+        *flowInter = inter;
+    if (flowInterSimple)
+        *flowInterSimple = simple;
+    if (flowInterExtra)
+        *flowInterExtra = extra;
+}
@@ -29,15 +29,21 @@ extern "C" {
 #include "Fakery.h"
 #include "MVFrame.h"
 
+// MakeVectorOcclusionMaskTime in two steps, so that the first one, which
+// doesn't depend on the time, can be reused. It finds the mask value of the
+// occlusion between each block and its right (occX) and bottom (occY)
+// neighbours. Both arrays have nBlkX * nBlkY elements.
+void MakeVectorOcclusionStrengths(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occX, uint8_t *occY);
+// The second step spreads the values over the blocks the occlusions cover at time256.
+void SpreadVectorOcclusionStrengths(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, const uint8_t *occX, const uint8_t *occY, uint8_t *occMask, int occMaskPitch, int time256, int blkSizeX, int blkSizeY);
+
 void MakeVectorOcclusionMaskTime(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occMask, int occMaskPitch, int time256, int blkSizeX, int blkSizeY);
-void VectorMasksToOcclusionMaskTime(uint8_t *VXMask, uint8_t *VYMask, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occMask, int occMaskPitch, int time256, int blkSizeX, int blkSizeY);
 
 void MakeVectorOcclusionMask(const FakeGroupOfPlanes *fgop, int nBlkX, int nBlkY, double dMaskNormFactor, double fGamma, int nPel, uint8_t *occMask, int occMaskPitch);
 
-void VectorMasksToOcclusionMask(uint8_t *VX, uint8_t *VY, int nBlkX, int nBlkY, double fMaskNormFactor, double fGamma, int nPel, uint8_t *smallMask);
-
-void MakeVectorSmallMasks(const FakeGroupOfPlanes *fgop, int nX, int nY, uint8_t *VXSmallY, int pitchVXSmallY, uint8_t *VYSmallY, int pitchVYSmallY);
-void VectorSmallMaskYToHalfUV(uint8_t *VSmallY, int nBlkX, int nBlkY, uint8_t *VSmallUV, int ratioUV);
+// The vector masks hold the vectors as they are, in 1/nPel pixel.
+void MakeVectorSmallMasks(const FakeGroupOfPlanes *fgop, int nX, int nY, int16_t *VXSmallY, int pitchVXSmallY, int16_t *VYSmallY, int pitchVYSmallY);
+void VectorSmallMaskYToHalfUV(const int16_t *VSmallY, int nBlkX, int nBlkY, int16_t *VSmallUV, int ratioUV);
 
 void Merge4PlanesToBig(uint8_t *pel2Plane, int pel2Pitch, const uint8_t *pPlane0, const uint8_t *pPlane1,
                        const uint8_t *pPlane2, const uint8_t *pPlane3, int width, int height, int pitch, int bitsPerSample);
@@ -54,34 +60,57 @@ uint8_t SADToMask(unsigned int sad, unsigned int sadnorm1024);
 void Blend(uint8_t *pdst, const uint8_t *psrc, const uint8_t *pref, int height, int width, int dst_pitch, int src_pitch, int ref_pitch, int time256, int bitsPerSample);
 
 
-// lookup table size 256
-void Create_LUTV(int time256, int *LUTVB, int *LUTVF);
+// The parts of a vector covering time256 / 256 and (256 - time256) / 256 of the interval.
+static inline int VectorTimeF(int v, int time256) {
+    return v * time256 / 256;
+}
+
+static inline int VectorTimeB(int v, int time256) {
+    return v * (256 - time256) / 256;
+}
+
 
-void FlowInter(uint8_t *pdst, int dst_pitch, const uint8_t *prefB, const uint8_t *prefF, int ref_pitch,
-               const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
-               int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF, int bitsPerSample);
+// Sample of a plane refined to 1/nPel pixel, stored as the nPel * nPel subplanes
+// from mvpGetSubplanePointers. x and y are in 1/nPel pixel, pitch in pixels.
+#define SUBPEL_SAMPLE(PixelType, planes, pitch, x, y, nLogPel) \
+    (((const PixelType *)(planes)[(((y) & ((1 << (nLogPel)) - 1)) << (nLogPel)) | ((x) & ((1 << (nLogPel)) - 1))])[((y) >> (nLogPel)) * (pitch) + ((x) >> (nLogPel))])
 
-void FlowInterSimple(uint8_t *pdst, int dst_pitch, const uint8_t *prefB, const uint8_t *prefF, int ref_pitch,
-                     const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
-                     int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF, int bitsPerSample);
+// prefB and prefF are arrays of subplanes, as described above. VPitch is in elements.
 
-void FlowInterExtra(uint8_t *pdst, int dst_pitch, const uint8_t *prefB, const uint8_t *prefF, int ref_pitch,
-                    const uint8_t *VXFullB, const uint8_t *VXFullF, const uint8_t *VYFullB, const uint8_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
-                    int VPitch, int width, int height, int time256, int nPel, const int *LUTVB, const int *LUTVF,
-                    const uint8_t *VXFullBB, const uint8_t *VXFullFF, const uint8_t *VYFullBB, const uint8_t *VYFullFF, int bitsPerSample);
+typedef void (*FlowInterFunction)(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch,
+                                  const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
+                                  int VPitch, int width, int height, int time256, int nPel);
 
-void FlowInterPel(uint8_t *pdst, int dst_pitch, MVPlane *prefB, MVPlane *prefF, int ref_pitch,
-                  uint8_t *VXFullB, uint8_t *VXFullF, uint8_t *VYFullB, uint8_t *VYFullF, uint8_t *MaskB, uint8_t *MaskF,
-                  int VPitch, int width, int height, int time256, int nPel, int *LUTVB, int *LUTVF);
+typedef void (*FlowInterExtraFunction)(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch,
+                                       const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
+                                       int VPitch, int width, int height, int time256, int nPel,
+                                       const int16_t *VXFullBB, const int16_t *VXFullFF, const int16_t *VYFullBB, const int16_t *VYFullFF);
 
-void FlowInterSimplePel(uint8_t *pdst, int dst_pitch, MVPlane *prefB, MVPlane *prefF, int ref_pitch,
-                        uint8_t *VXFullB, uint8_t *VXFullF, uint8_t *VYFullB, uint8_t *VYFullF, uint8_t *MaskB, uint8_t *MaskF,
-                        int VPitch, int width, int height, int time256, int nPel, int *LUTVB, int *LUTVF);
+// Picks the FlowInter, FlowInterSimple, and FlowInterExtra functions for the bit depth.
+// The optimised ones are only used if opt is not 0. Any of the pointers can be NULL.
+void selectFlowInterFunctions(FlowInterFunction *flowInter, FlowInterFunction *flowInterSimple, FlowInterExtraFunction *flowInterExtra, int bitsPerSample, int opt);
 
-void FlowInterExtraPel(uint8_t *pdst, int dst_pitch, MVPlane *prefB, MVPlane *prefF, int ref_pitch,
-                       uint8_t *VXFullB, uint8_t *VXFullF, uint8_t *VYFullB, uint8_t *VYFullF, uint8_t *MaskB, uint8_t *MaskF,
-                       int VPitch, int width, int height, int time256, int nPel, int *LUTVB, int *LUTVF,
-                       uint8_t *VXFullBB, uint8_t *VXFullFF, uint8_t *VYFullBB, uint8_t *VYFullFF);
+#if defined(MVTOOLS_X86)
+// From MaskFun_AVX2.cpp
+#define MK_FLOWINTERFUNC(functionname) void functionname(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                                                         const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                                                         int VPitch, int width, int height, int time256, int nPel)
+
+#define MK_FLOWINTEREXTRAFUNC(functionname) void functionname(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                                                              const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                                                              int VPitch, int width, int height, int time256, int nPel, \
+                                                              const int16_t *VXFullBB, const int16_t *VXFullFF, const int16_t *VYFullBB, const int16_t *VYFullFF)
+
+MK_FLOWINTERFUNC(mvtools_flowinter_u8_avx2);
+MK_FLOWINTERFUNC(mvtools_flowinter_u16_avx2);
+MK_FLOWINTERFUNC(mvtools_flowintersimple_u8_avx2);
+MK_FLOWINTERFUNC(mvtools_flowintersimple_u16_avx2);
+MK_FLOWINTEREXTRAFUNC(mvtools_flowinterextra_u8_avx2);
+MK_FLOWINTEREXTRAFUNC(mvtools_flowinterextra_u16_avx2);
+
+#undef MK_FLOWINTERFUNC
+#undef MK_FLOWINTEREXTRAFUNC
+#endif
 
 #ifdef __cplusplus
 } // extern "C"
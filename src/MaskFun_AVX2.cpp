@@ -0,0 +1,413 @@
+#if defined(MVTOOLS_X86)
+
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "CommonFunctions.h"
+#include "MaskFun.h"
+
+
+#ifdef _WIN32
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+
+// Eight pixels are processed at a time, as 32 bit integers. Only the last
+// group of a row can have fewer than eight (count).
+//
+// The samples pointed to by the vectors are fetched one at a time, because
+// the subplanes of lazy super frames aren't part of the frame, so they can't
+// be reached with a 32 bit offset from one base pointer, and a gather could
+// read a few bytes beyond the end of the padded plane.
+//
+// Everything else stays in the registers. The intermediate values fit in
+// unsigned 32 bit integers even with 16 bit pixels, so the results are the
+// same as those of the C functions.
+
+
+static FORCE_INLINE __m256i loadBytes(const uint8_t *p, int count) {
+    if (count == 8)
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p));
+
+    uint8_t tmp[8] = { 0 };
+    memcpy(tmp, p, count);
+
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)tmp));
+}
+
+
+template <typename PixelType>
+static FORCE_INLINE __m256i loadPixels(const PixelType *p, int count);
+
+template <>
+FORCE_INLINE __m256i loadPixels(const uint8_t *p, int count) {
+    return loadBytes(p, count);
+}
+
+template <>
+FORCE_INLINE __m256i loadPixels(const uint16_t *p, int count) {
+    if (count == 8)
+        return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)p));
+
+    uint16_t tmp[8] = { 0 };
+    memcpy(tmp, p, count * sizeof(uint16_t));
+
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)tmp));
+}
+
+
+template <typename PixelType>
+static FORCE_INLINE void storePixels(PixelType *p, __m256i pixels, int count);
+
+template <>
+FORCE_INLINE void storePixels(uint8_t *p, __m256i pixels, int count) {
+    __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0)));
+    __m128i bytes = _mm_packus_epi16(words, words);
+
+    if (count == 8) {
+        _mm_storel_epi64((__m128i *)p, bytes);
+    } else {
+        uint8_t tmp[16];
+        _mm_storeu_si128((__m128i *)tmp, bytes);
+        memcpy(p, tmp, count);
+    }
+}
+
+template <>
+FORCE_INLINE void storePixels(uint16_t *p, __m256i pixels, int count) {
+    __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0)));
+
+    if (count == 8) {
+        _mm_storeu_si128((__m128i *)p, words);
+    } else {
+        uint16_t tmp[8];
+        _mm_storeu_si128((__m128i *)tmp, words);
+        memcpy(p, tmp, count * sizeof(uint16_t));
+    }
+}
+
+
+// Where the samples are: pel 1 pixel, subpel phase, and the pitch of the subplanes.
+struct SubplaneGeometry {
+    __m128i logPel;
+    __m256i pelMask;
+    __m256i pitch;
+
+    SubplaneGeometry(int nLogPel, int pitchInPixels)
+        : logPel(_mm_cvtsi32_si128(nLogPel))
+        , pelMask(_mm256_set1_epi32((1 << nLogPel) - 1))
+        , pitch(_mm256_set1_epi32(pitchInPixels)) {
+    }
+};
+
+
+// Same as SUBPEL_SAMPLE, for eight positions. x and y are in 1/nPel pixel.
+template <typename PixelType>
+static FORCE_INLINE __m256i fetchSamples(const uint8_t *const *planes, const SubplaneGeometry &geometry, __m256i x, __m256i y, int count) {
+    __m256i subplane = _mm256_or_si256(_mm256_sll_epi32(_mm256_and_si256(y, geometry.pelMask), geometry.logPel),
+                                       _mm256_and_si256(x, geometry.pelMask));
+    __m256i offset = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_sra_epi32(y, geometry.logPel), geometry.pitch),
+                                      _mm256_sra_epi32(x, geometry.logPel));
+
+    alignas(32) int subplanes[8];
+    alignas(32) int offsets[8];
+    alignas(32) int samples[8];
+
+    _mm256_store_si256((__m256i *)subplanes, subplane);
+    _mm256_store_si256((__m256i *)offsets, offset);
+
+    if (count == 8) {
+        for (int i = 0; i < 8; i++)
+            samples[i] = ((const PixelType *)planes[subplanes[i]])[offsets[i]];
+    } else {
+        for (int i = 0; i < 8; i++)
+            samples[i] = i < count ? ((const PixelType *)planes[subplanes[i]])[offsets[i]] : 0;
+    }
+
+    return _mm256_load_si256((const __m256i *)samples);
+}
+
+
+static FORCE_INLINE __m256i mul(__m256i a, __m256i b) {
+    return _mm256_mullo_epi32(a, b);
+}
+
+static FORCE_INLINE __m256i add(__m256i a, __m256i b) {
+    return _mm256_add_epi32(a, b);
+}
+
+static FORCE_INLINE __m256i sub(__m256i a, __m256i b) {
+    return _mm256_sub_epi32(a, b);
+}
+
+
+static FORCE_INLINE __m256i loadVectors(const int16_t *p, int count) {
+    if (count == 8)
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)p));
+
+    int16_t tmp[8] = { 0 };
+    memcpy(tmp, p, count * sizeof(int16_t));
+
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)tmp));
+}
+
+
+// Same as VectorTimeF and VectorTimeB: the division rounds towards 0.
+static FORCE_INLINE __m256i loadTimeVectors(const int16_t *p, __m256i time, int count) {
+    __m256i product = mul(loadVectors(p, count), time);
+    __m256i bias = _mm256_srli_epi32(_mm256_srai_epi32(product, 31), 24);
+
+    return _mm256_srai_epi32(add(product, bias), 8);
+}
+
+
+template <typename PixelType>
+static void flowInter_avx2(uint8_t *pdst8, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch,
+                           const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
+                           int VPitch, int width, int height, int time256, int nPel) {
+    const PixelType *prefB0 = (const PixelType *)prefB[0];
+    const PixelType *prefF0 = (const PixelType *)prefF[0];
+    PixelType *pdst = (PixelType *)pdst8;
+    const int nLogPel = ilog2(nPel);
+
+    ref_pitch /= sizeof(PixelType);
+    dst_pitch /= sizeof(PixelType);
+
+    const SubplaneGeometry geometry(nLogPel, ref_pitch);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i v255 = _mm256_set1_epi32(255);
+    const __m256i weightB = _mm256_set1_epi32(time256);
+    const __m256i weightF = _mm256_set1_epi32(256 - time256);
+    const __m256i timeF = _mm256_set1_epi32(time256);
+    const __m256i timeB = _mm256_set1_epi32(256 - time256);
+
+    for (int h = 0; h < height; h++) {
+        const __m256i y = _mm256_set1_epi32(h << nLogPel);
+
+        for (int w = 0; w < width; w += 8) {
+            const int count = imin(width - w, 8);
+            const __m256i x = _mm256_sll_epi32(add(_mm256_set1_epi32(w), lanes), geometry.logPel);
+
+            __m256i dstF = fetchSamples<PixelType>(prefF, geometry, add(x, loadTimeVectors(VXFullF + w, timeF, count)), add(y, loadTimeVectors(VYFullF + w, timeF, count)), count);
+            __m256i dstB = fetchSamples<PixelType>(prefB, geometry, add(x, loadTimeVectors(VXFullB + w, timeB, count)), add(y, loadTimeVectors(VYFullB + w, timeB, count)), count);
+            __m256i dstF0 = loadPixels(prefF0 + w, count);
+            __m256i dstB0 = loadPixels(prefB0 + w, count);
+            __m256i maskF = loadBytes(MaskF + w, count);
+            __m256i maskB = loadBytes(MaskB + w, count);
+            __m256i invMaskF = sub(v255, maskF);
+            __m256i invMaskB = sub(v255, maskB);
+
+            __m256i weightedF = mul(dstF, invMaskF);
+            __m256i weightedB = mul(dstB, invMaskB);
+
+            __m256i occludedF = _mm256_srli_epi32(add(mul(maskF, add(weightedB, mul(maskB, dstF0))), v255), 8);
+            __m256i occludedB = _mm256_srli_epi32(add(mul(maskB, add(weightedF, mul(maskF, dstB0))), v255), 8);
+
+            __m256i resultF = _mm256_srli_epi32(add(add(weightedF, occludedF), v255), 8);
+            __m256i resultB = _mm256_srli_epi32(add(add(weightedB, occludedB), v255), 8);
+
+            __m256i result = _mm256_srli_epi32(add(mul(resultF, weightF), mul(resultB, weightB)), 8);
+
+            storePixels(pdst + w, result, count);
+        }
+
+        pdst += dst_pitch;
+        prefB0 += ref_pitch;
+        prefF0 += ref_pitch;
+        VXFullB += VPitch;
+        VYFullB += VPitch;
+        VXFullF += VPitch;
+        VYFullF += VPitch;
+        MaskB += VPitch;
+        MaskF += VPitch;
+    }
+}
+
+
+template <typename PixelType>
+static void flowInterExtra_avx2(uint8_t *pdst8, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch,
+                                const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
+                                int VPitch, int width, int height, int time256, int nPel,
+                                const int16_t *VXFullBB, const int16_t *VXFullFF, const int16_t *VYFullBB, const int16_t *VYFullFF) {
+    PixelType *pdst = (PixelType *)pdst8;
+    const int nLogPel = ilog2(nPel);
+
+    ref_pitch /= sizeof(PixelType);
+    dst_pitch /= sizeof(PixelType);
+
+    const SubplaneGeometry geometry(nLogPel, ref_pitch);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i v255 = _mm256_set1_epi32(255);
+    const __m256i weightB = _mm256_set1_epi32(time256);
+    const __m256i weightF = _mm256_set1_epi32(256 - time256);
+    const __m256i timeF = _mm256_set1_epi32(time256);
+    const __m256i timeB = _mm256_set1_epi32(256 - time256);
+
+    for (int h = 0; h < height; h++) {
+        const __m256i y = _mm256_set1_epi32(h << nLogPel);
+
+        for (int w = 0; w < width; w += 8) {
+            const int count = imin(width - w, 8);
+            const __m256i x = _mm256_sll_epi32(add(_mm256_set1_epi32(w), lanes), geometry.logPel);
+
+            __m256i dstF = fetchSamples<PixelType>(prefF, geometry, add(x, loadTimeVectors(VXFullF + w, timeF, count)), add(y, loadTimeVectors(VYFullF + w, timeF, count)), count);
+            __m256i dstFF = fetchSamples<PixelType>(prefF, geometry, add(x, loadTimeVectors(VXFullFF + w, timeF, count)), add(y, loadTimeVectors(VYFullFF + w, timeF, count)), count);
+            __m256i dstB = fetchSamples<PixelType>(prefB, geometry, add(x, loadTimeVectors(VXFullB + w, timeB, count)), add(y, loadTimeVectors(VYFullB + w, timeB, count)), count);
+            __m256i dstBB = fetchSamples<PixelType>(prefB, geometry, add(x, loadTimeVectors(VXFullBB + w, timeB, count)), add(y, loadTimeVectors(VYFullBB + w, timeB, count)), count);
+            __m256i maskF = loadBytes(MaskF + w, count);
+            __m256i maskB = loadBytes(MaskB + w, count);
+
+            // Median3r(minfb, x, maxfb) is x clamped to [minfb, maxfb].
+            __m256i minfb = _mm256_min_epi32(dstF, dstB);
+            __m256i maxfb = _mm256_max_epi32(dstF, dstB);
+            __m256i medianB = _mm256_max_epi32(minfb, _mm256_min_epi32(dstBB, maxfb));
+            __m256i medianF = _mm256_max_epi32(minfb, _mm256_min_epi32(dstFF, maxfb));
+
+            __m256i resultF = _mm256_srli_epi32(add(add(mul(medianB, maskF), mul(dstF, sub(v255, maskF))), v255), 8);
+            __m256i resultB = _mm256_srli_epi32(add(add(mul(medianF, maskB), mul(dstB, sub(v255, maskB))), v255), 8);
+
+            __m256i result = _mm256_srli_epi32(add(mul(resultF, weightF), mul(resultB, weightB)), 8);
+
+            storePixels(pdst + w, result, count);
+        }
+
+        pdst += dst_pitch;
+        VXFullB += VPitch;
+        VYFullB += VPitch;
+        VXFullF += VPitch;
+        VYFullF += VPitch;
+        MaskB += VPitch;
+        MaskF += VPitch;
+        VXFullBB += VPitch;
+        VYFullBB += VPitch;
+        VXFullFF += VPitch;
+        VYFullFF += VPitch;
+    }
+}
+
+
+// With pel 1, the C version uses the vectors of the even pixels for the odd
+// pixels too ("paired for speed"), so this one does the same.
+template <typename PixelType, bool doubleFps, bool paired>
+static void flowInterSimple_avx2(uint8_t *pdst8, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch,
+                                 const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
+                                 int VPitch, int width, int height, int time256, int nPel) {
+    PixelType *pdst = (PixelType *)pdst8;
+    const int nLogPel = ilog2(nPel);
+
+    ref_pitch /= sizeof(PixelType);
+    dst_pitch /= sizeof(PixelType);
+
+    const SubplaneGeometry geometry(nLogPel, ref_pitch);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i v255 = _mm256_set1_epi32(255);
+    const __m256i weightB = _mm256_set1_epi32(time256);
+    const __m256i weightF = _mm256_set1_epi32(256 - time256);
+    const __m256i timeF = _mm256_set1_epi32(time256);
+    const __m256i timeB = _mm256_set1_epi32(256 - time256);
+
+    for (int h = 0; h < height; h++) {
+        const __m256i y = _mm256_set1_epi32(h << nLogPel);
+
+        for (int w = 0; w < width; w += 8) {
+            const int count = imin(width - w, 8);
+            const __m256i x = _mm256_sll_epi32(add(_mm256_set1_epi32(w), lanes), geometry.logPel);
+
+            __m256i vxF, vyF, vxB, vyB;
+            if (doubleFps) {
+                vxF = _mm256_srai_epi32(loadVectors(VXFullF + w, count), 1);
+                vyF = _mm256_srai_epi32(loadVectors(VYFullF + w, count), 1);
+                vxB = _mm256_srai_epi32(loadVectors(VXFullB + w, count), 1);
+                vyB = _mm256_srai_epi32(loadVectors(VYFullB + w, count), 1);
+            } else {
+                vxF = loadTimeVectors(VXFullF + w, timeF, count);
+                vyF = loadTimeVectors(VYFullF + w, timeF, count);
+                vxB = loadTimeVectors(VXFullB + w, timeB, count);
+                vyB = loadTimeVectors(VYFullB + w, timeB, count);
+            }
+
+            if (paired) {
+                vxF = _mm256_shuffle_epi32(vxF, _MM_SHUFFLE(2, 2, 0, 0));
+                vyF = _mm256_shuffle_epi32(vyF, _MM_SHUFFLE(2, 2, 0, 0));
+                vxB = _mm256_shuffle_epi32(vxB, _MM_SHUFFLE(2, 2, 0, 0));
+                vyB = _mm256_shuffle_epi32(vyB, _MM_SHUFFLE(2, 2, 0, 0));
+            }
+
+            __m256i dstF = fetchSamples<PixelType>(prefF, geometry, add(x, vxF), add(y, vyF), count);
+            __m256i dstB = fetchSamples<PixelType>(prefB, geometry, add(x, vxB), add(y, vyB), count);
+            __m256i maskF = loadBytes(MaskF + w, count);
+            __m256i maskB = loadBytes(MaskB + w, count);
+
+            __m256i result;
+            if (doubleFps) {
+                result = _mm256_srli_epi32(add(_mm256_slli_epi32(add(dstF, dstB), 8), mul(sub(dstB, dstF), sub(maskF, maskB))), 9);
+            } else if (paired) {
+                __m256i diff = sub(dstB, dstF);
+                __m256i resultF = add(add(mul(dstF, v255), mul(diff, maskF)), v255);
+                __m256i resultB = add(sub(mul(dstB, v255), mul(diff, maskB)), v255);
+                result = _mm256_srli_epi32(add(mul(resultF, weightF), mul(resultB, weightB)), 16);
+            } else {
+                __m256i resultF = _mm256_srli_epi32(add(add(mul(dstF, sub(v255, maskF)), mul(dstB, maskF)), v255), 8);
+                __m256i resultB = _mm256_srli_epi32(add(add(mul(dstB, sub(v255, maskB)), mul(dstF, maskB)), v255), 8);
+                result = _mm256_srli_epi32(add(mul(resultF, weightF), mul(resultB, weightB)), 8);
+            }
+
+            storePixels(pdst + w, result, count);
+        }
+
+        pdst += dst_pitch;
+        VXFullB += VPitch;
+        VYFullB += VPitch;
+        VXFullF += VPitch;
+        VYFullF += VPitch;
+        MaskB += VPitch;
+        MaskF += VPitch;
+    }
+}
+
+
+template <typename PixelType>
+static void flowInterSimpleDispatch_avx2(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch,
+                                         const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF,
+                                         int VPitch, int width, int height, int time256, int nPel) {
+    if (time256 == 128) {
+        if (nPel == 1)
+            flowInterSimple_avx2<PixelType, true, true>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel);
+        else
+            flowInterSimple_avx2<PixelType, true, false>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel);
+    } else {
+        if (nPel == 1)
+            flowInterSimple_avx2<PixelType, false, true>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel);
+        else
+            flowInterSimple_avx2<PixelType, false, false>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel);
+    }
+}
+
+
+#define DEFINE_FLOWINTER_AVX2(bits) \
+void mvtools_flowinter_u##bits##_avx2(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                                      const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                                      int VPitch, int width, int height, int time256, int nPel) { \
+    flowInter_avx2<uint##bits##_t>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel); \
+} \
+ \
+void mvtools_flowintersimple_u##bits##_avx2(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                                            const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                                            int VPitch, int width, int height, int time256, int nPel) { \
+    flowInterSimpleDispatch_avx2<uint##bits##_t>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel); \
+} \
+ \
+void mvtools_flowinterextra_u##bits##_avx2(uint8_t *pdst, int dst_pitch, const uint8_t *const *prefB, const uint8_t *const *prefF, int ref_pitch, \
+                                           const int16_t *VXFullB, const int16_t *VXFullF, const int16_t *VYFullB, const int16_t *VYFullF, const uint8_t *MaskB, const uint8_t *MaskF, \
+                                           int VPitch, int width, int height, int time256, int nPel, \
+                                           const int16_t *VXFullBB, const int16_t *VXFullFF, const int16_t *VYFullBB, const int16_t *VYFullFF) { \
+    flowInterExtra_avx2<uint##bits##_t>(pdst, dst_pitch, prefB, prefF, ref_pitch, VXFullB, VXFullF, VYFullB, VYFullF, MaskB, MaskF, VPitch, width, height, time256, nPel, VXFullBB, VXFullFF, VYFullBB, VYFullFF); \
+}
+
+DEFINE_FLOWINTER_AVX2(8)
+DEFINE_FLOWINTER_AVX2(16)
+
+#endif // MVTOOLS_X86
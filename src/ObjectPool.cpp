@@ -0,0 +1,59 @@
+#include <mutex>
+#include <vector>
+
+#include "ObjectPool.h"
+
+
+struct ObjectPool {
+    PoolCreateFunction create;
+    PoolDestroyFunction destroy;
+    void *userData;
+
+    std::mutex lock;
+    std::vector<void *> objects;
+};
+
+
+ObjectPool *poolCreate(PoolCreateFunction create, PoolDestroyFunction destroy, void *userData) {
+    ObjectPool *pool = new ObjectPool;
+
+    pool->create = create;
+    pool->destroy = destroy;
+    pool->userData = userData;
+
+    return pool;
+}
+
+
+void poolFree(ObjectPool *pool) {
+    if (!pool)
+        return;
+
+    for (size_t i = 0; i < pool->objects.size(); i++)
+        pool->destroy(pool->objects[i], pool->userData);
+
+    delete pool;
+}
+
+
+void *poolAcquire(ObjectPool *pool) {
+    {
+        std::lock_guard<std::mutex> guard(pool->lock);
+
+        if (!pool->objects.empty()) {
+            void *object = pool->objects.back();
+            pool->objects.pop_back();
+            return object;
+        }
+    }
+
+    // Created outside the lock, because this can take a while.
+    return pool->create(pool->userData);
+}
+
+
+void poolRelease(ObjectPool *pool, void *object) {
+    std::lock_guard<std::mutex> guard(pool->lock);
+
+    pool->objects.push_back(object);
+}
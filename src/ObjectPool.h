@@ -0,0 +1,35 @@
+#ifndef MVTOOLS_OBJECTPOOL_H
+#define MVTOOLS_OBJECTPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// A free list of expensive, fully initialised objects which can be borrowed
+// by whichever thread is running a filter's getFrame function and returned
+// afterwards, so that frames don't have to build them from scratch.
+// At most as many objects are created as there are frames being processed
+// simultaneously.
+
+typedef void *(*PoolCreateFunction)(void *userData);
+typedef void (*PoolDestroyFunction)(void *object, void *userData);
+
+typedef struct ObjectPool ObjectPool;
+
+
+ObjectPool *poolCreate(PoolCreateFunction create, PoolDestroyFunction destroy, void *userData);
+
+// Destroys all the objects in the pool. All borrowed objects must have been returned.
+void poolFree(ObjectPool *pool);
+
+// Returns an object from the pool, or a new one if the pool is empty.
+void *poolAcquire(ObjectPool *pool);
+
+void poolRelease(ObjectPool *pool, void *object);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MVTOOLS_OBJECTPOOL_H
@@ -159,40 +159,187 @@ Overlaps_C(2, 4, uint16_t, uint8_t)
 Overlaps_C(4, 2, uint16_t, uint8_t)
 Overlaps_C(4, 4, uint16_t, uint8_t)
 Overlaps_C(4, 8, uint16_t, uint8_t)
+Overlaps_C(4, 16, uint16_t, uint8_t)
 Overlaps_C(8, 1, uint16_t, uint8_t)
 Overlaps_C(8, 2, uint16_t, uint8_t)
 Overlaps_C(8, 4, uint16_t, uint8_t)
 Overlaps_C(8, 8, uint16_t, uint8_t)
 Overlaps_C(8, 16, uint16_t, uint8_t)
+Overlaps_C(8, 32, uint16_t, uint8_t)
 Overlaps_C(16, 1, uint16_t, uint8_t)
 Overlaps_C(16, 2, uint16_t, uint8_t)
 Overlaps_C(16, 4, uint16_t, uint8_t)
 Overlaps_C(16, 8, uint16_t, uint8_t)
 Overlaps_C(16, 16, uint16_t, uint8_t)
 Overlaps_C(16, 32, uint16_t, uint8_t)
+Overlaps_C(16, 64, uint16_t, uint8_t)
+Overlaps_C(32, 4, uint16_t, uint8_t)
 Overlaps_C(32, 8, uint16_t, uint8_t)
 Overlaps_C(32, 16, uint16_t, uint8_t)
 Overlaps_C(32, 32, uint16_t, uint8_t)
+Overlaps_C(32, 64, uint16_t, uint8_t)
+Overlaps_C(64, 8, uint16_t, uint8_t)
+Overlaps_C(64, 16, uint16_t, uint8_t)
+Overlaps_C(64, 32, uint16_t, uint8_t)
+Overlaps_C(64, 64, uint16_t, uint8_t)
 
 Overlaps_C(2, 2, uint32_t, uint16_t)
 Overlaps_C(2, 4, uint32_t, uint16_t)
 Overlaps_C(4, 2, uint32_t, uint16_t)
 Overlaps_C(4, 4, uint32_t, uint16_t)
 Overlaps_C(4, 8, uint32_t, uint16_t)
+Overlaps_C(4, 16, uint32_t, uint16_t)
 Overlaps_C(8, 1, uint32_t, uint16_t)
 Overlaps_C(8, 2, uint32_t, uint16_t)
 Overlaps_C(8, 4, uint32_t, uint16_t)
 Overlaps_C(8, 8, uint32_t, uint16_t)
 Overlaps_C(8, 16, uint32_t, uint16_t)
+Overlaps_C(8, 32, uint32_t, uint16_t)
 Overlaps_C(16, 1, uint32_t, uint16_t)
 Overlaps_C(16, 2, uint32_t, uint16_t)
 Overlaps_C(16, 4, uint32_t, uint16_t)
 Overlaps_C(16, 8, uint32_t, uint16_t)
 Overlaps_C(16, 16, uint32_t, uint16_t)
 Overlaps_C(16, 32, uint32_t, uint16_t)
+Overlaps_C(16, 64, uint32_t, uint16_t)
+Overlaps_C(32, 4, uint32_t, uint16_t)
 Overlaps_C(32, 8, uint32_t, uint16_t)
 Overlaps_C(32, 16, uint32_t, uint16_t)
 Overlaps_C(32, 32, uint32_t, uint16_t)
+Overlaps_C(32, 64, uint32_t, uint16_t)
+Overlaps_C(64, 8, uint32_t, uint16_t)
+Overlaps_C(64, 16, uint32_t, uint16_t)
+Overlaps_C(64, 32, uint32_t, uint16_t)
+Overlaps_C(64, 64, uint32_t, uint16_t)
+
+
+#if defined(MVTOOLS_X86)
+
+#include <emmintrin.h>
+
+static inline void overlaps_uint32_t_uint16_t_sse2(uint8_t *pDst8, intptr_t nDstPitch, const uint8_t *pSrc8, intptr_t nSrcPitch, int16_t *pWin, intptr_t nWinPitch, int blockWidth, int blockHeight) {
+    /* pWin from 0 to 2048, so the products fit in 32 bits */
+    for (int j = 0; j < blockHeight; j++) {
+        for (int i = 0; i < blockWidth; i += 8) {
+            uint32_t *pDst = (uint32_t *)pDst8 + i;
+            const uint16_t *pSrc = (const uint16_t *)pSrc8 + i;
+
+            __m128i src, win;
+            if (blockWidth == 4) {
+                src = _mm_loadl_epi64((const __m128i *)pSrc);
+                win = _mm_loadl_epi64((const __m128i *)(pWin + i));
+            } else {
+                src = _mm_loadu_si128((const __m128i *)pSrc);
+                win = _mm_loadu_si128((const __m128i *)(pWin + i));
+            }
+
+            __m128i lo = _mm_mullo_epi16(src, win);
+            __m128i hi = _mm_mulhi_epu16(src, win);
+
+            __m128i dst = _mm_loadu_si128((const __m128i *)pDst);
+            dst = _mm_add_epi32(dst, _mm_srli_epi32(_mm_unpacklo_epi16(lo, hi), 6));
+            _mm_storeu_si128((__m128i *)pDst, dst);
+
+            if (blockWidth > 4) {
+                dst = _mm_loadu_si128((const __m128i *)(pDst + 4));
+                dst = _mm_add_epi32(dst, _mm_srli_epi32(_mm_unpackhi_epi16(lo, hi), 6));
+                _mm_storeu_si128((__m128i *)(pDst + 4), dst);
+            }
+        }
+        pDst8 += nDstPitch;
+        pSrc8 += nSrcPitch;
+        pWin += nWinPitch;
+    }
+}
+
+// For the sizes without an assembly version.
+static inline void overlaps_uint16_t_uint8_t_sse2(uint8_t *pDst8, intptr_t nDstPitch, const uint8_t *pSrc8, intptr_t nSrcPitch, int16_t *pWin, intptr_t nWinPitch, int blockWidth, int blockHeight) {
+    __m128i zero = _mm_setzero_si128();
+
+    /* pWin from 0 to 2048, so the products need 32 bits, but not the results */
+    for (int j = 0; j < blockHeight; j++) {
+        for (int i = 0; i < blockWidth; i += 8) {
+            uint16_t *pDst = (uint16_t *)pDst8 + i;
+            const uint8_t *pSrc = pSrc8 + i;
+
+            __m128i src, win, dst;
+            if (blockWidth == 4) {
+                src = _mm_cvtsi32_si128(*(const int *)pSrc);
+                win = _mm_loadl_epi64((const __m128i *)(pWin + i));
+                dst = _mm_loadl_epi64((const __m128i *)pDst);
+            } else {
+                src = _mm_loadl_epi64((const __m128i *)pSrc);
+                win = _mm_loadu_si128((const __m128i *)(pWin + i));
+                dst = _mm_loadu_si128((const __m128i *)pDst);
+            }
+            src = _mm_unpacklo_epi8(src, zero);
+
+            __m128i lo = _mm_mullo_epi16(src, win);
+            __m128i hi = _mm_mulhi_epu16(src, win);
+
+            __m128i overlap = _mm_packs_epi32(_mm_srli_epi32(_mm_unpacklo_epi16(lo, hi), 6),
+                                              _mm_srli_epi32(_mm_unpackhi_epi16(lo, hi), 6));
+            dst = _mm_add_epi16(dst, overlap);
+
+            if (blockWidth == 4)
+                _mm_storel_epi64((__m128i *)pDst, dst);
+            else
+                _mm_storeu_si128((__m128i *)pDst, dst);
+        }
+        pDst8 += nDstPitch;
+        pSrc8 += nSrcPitch;
+        pWin += nWinPitch;
+    }
+}
+
+#define Overlaps_uint8_t_sse2(blockWidth, blockHeight) \
+void mvtools_overlaps_##blockWidth##x##blockHeight##_uint16_t_uint8_t_sse2(uint8_t *pDst8, intptr_t nDstPitch, const uint8_t *pSrc8, intptr_t nSrcPitch, int16_t *pWin, intptr_t nWinPitch) { \
+    overlaps_uint16_t_uint8_t_sse2(pDst8, nDstPitch, pSrc8, nSrcPitch, pWin, nWinPitch, blockWidth, blockHeight); \
+}
+
+Overlaps_uint8_t_sse2(4, 16)
+Overlaps_uint8_t_sse2(8, 32)
+Overlaps_uint8_t_sse2(16, 64)
+Overlaps_uint8_t_sse2(32, 4)
+Overlaps_uint8_t_sse2(32, 64)
+Overlaps_uint8_t_sse2(64, 8)
+Overlaps_uint8_t_sse2(64, 16)
+Overlaps_uint8_t_sse2(64, 32)
+Overlaps_uint8_t_sse2(64, 64)
+
+#define Overlaps_uint16_t_sse2(blockWidth, blockHeight) \
+void mvtools_overlaps_##blockWidth##x##blockHeight##_uint32_t_uint16_t_sse2(uint8_t *pDst8, intptr_t nDstPitch, const uint8_t *pSrc8, intptr_t nSrcPitch, int16_t *pWin, intptr_t nWinPitch) { \
+    overlaps_uint32_t_uint16_t_sse2(pDst8, nDstPitch, pSrc8, nSrcPitch, pWin, nWinPitch, blockWidth, blockHeight); \
+}
+
+Overlaps_uint16_t_sse2(4, 2)
+Overlaps_uint16_t_sse2(4, 4)
+Overlaps_uint16_t_sse2(4, 8)
+Overlaps_uint16_t_sse2(4, 16)
+Overlaps_uint16_t_sse2(8, 1)
+Overlaps_uint16_t_sse2(8, 2)
+Overlaps_uint16_t_sse2(8, 4)
+Overlaps_uint16_t_sse2(8, 8)
+Overlaps_uint16_t_sse2(8, 16)
+Overlaps_uint16_t_sse2(8, 32)
+Overlaps_uint16_t_sse2(16, 1)
+Overlaps_uint16_t_sse2(16, 2)
+Overlaps_uint16_t_sse2(16, 4)
+Overlaps_uint16_t_sse2(16, 8)
+Overlaps_uint16_t_sse2(16, 16)
+Overlaps_uint16_t_sse2(16, 32)
+Overlaps_uint16_t_sse2(16, 64)
+Overlaps_uint16_t_sse2(32, 4)
+Overlaps_uint16_t_sse2(32, 8)
+Overlaps_uint16_t_sse2(32, 16)
+Overlaps_uint16_t_sse2(32, 32)
+Overlaps_uint16_t_sse2(32, 64)
+Overlaps_uint16_t_sse2(64, 8)
+Overlaps_uint16_t_sse2(64, 16)
+Overlaps_uint16_t_sse2(64, 32)
+Overlaps_uint16_t_sse2(64, 64)
+
+#endif
 
 
 #define ToPixels(PixelType2, PixelType) \
@@ -217,3 +364,39 @@ void ToPixels_##PixelType2##_##PixelType(uint8_t *pDst8, int nDstPitch, const ui
 
 ToPixels(uint16_t, uint8_t)
 ToPixels(uint32_t, uint16_t)
+
+
+#if defined(MVTOOLS_X86)
+void ToPixels_uint32_t_uint16_t_sse2(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, int nWidth, int nHeight, int bitsPerSample) {
+    int pixelMax = (1 << bitsPerSample) - 1;
+
+    const __m128i rounder = _mm_set1_epi32(16);
+
+    /* packs_epi32 is signed, hence the bias */
+    const __m128i bias32 = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16(-32768);
+    const __m128i max = _mm_set1_epi16(pixelMax - 32768);
+
+    for (int h = 0; h < nHeight; h++) {
+        const uint32_t *pSrc = (const uint32_t *)pSrc8;
+        uint16_t *pDst = (uint16_t *)pDst8;
+
+        int i = 0;
+        for (; i + 8 <= nWidth; i += 8) {
+            __m128i lo = _mm_srli_epi32(_mm_add_epi32(_mm_loadu_si128((const __m128i *)(pSrc + i)), rounder), 5);
+            __m128i hi = _mm_srli_epi32(_mm_add_epi32(_mm_loadu_si128((const __m128i *)(pSrc + i + 4)), rounder), 5);
+
+            __m128i a = _mm_packs_epi32(_mm_sub_epi32(lo, bias32), _mm_sub_epi32(hi, bias32));
+            a = _mm_xor_si128(_mm_min_epi16(a, max), bias16);
+
+            _mm_storeu_si128((__m128i *)(pDst + i), a);
+        }
+        for (; i < nWidth; i++) {
+            int a = (pSrc[i] + 16) >> 5;
+            pDst[i] = min(pixelMax, a);
+        }
+        pDst8 += nDstPitch;
+        pSrc8 += nSrcPitch;
+    }
+}
+#endif
@@ -54,40 +54,58 @@ MK_CFUNC(mvtools_overlaps_2x4_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_4x2_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_4x4_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_4x8_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_4x16_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_8x1_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_8x2_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_8x4_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_8x8_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_8x16_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_8x32_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_16x1_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_16x2_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_16x4_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_16x8_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_16x16_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_16x32_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_16x64_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_32x4_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_32x8_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_32x16_uint16_t_uint8_t_c);
 MK_CFUNC(mvtools_overlaps_32x32_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_32x64_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_64x8_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_64x16_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_64x32_uint16_t_uint8_t_c);
+MK_CFUNC(mvtools_overlaps_64x64_uint16_t_uint8_t_c);
 
 MK_CFUNC(mvtools_overlaps_2x2_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_2x4_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_4x2_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_4x4_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_4x8_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_4x16_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_8x1_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_8x2_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_8x4_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_8x8_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_8x16_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_8x32_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_16x1_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_16x2_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_16x4_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_16x8_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_16x16_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_16x32_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_16x64_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_32x4_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_32x8_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_32x16_uint32_t_uint16_t_c);
 MK_CFUNC(mvtools_overlaps_32x32_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_32x64_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_64x8_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_64x16_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_64x32_uint32_t_uint16_t_c);
+MK_CFUNC(mvtools_overlaps_64x64_uint32_t_uint16_t_c);
 
 #if defined(MVTOOLS_X86)
 MK_CFUNC(mvtools_overlaps_2x2_sse2);
@@ -109,6 +127,43 @@ MK_CFUNC(mvtools_overlaps_16x32_sse2);
 MK_CFUNC(mvtools_overlaps_32x8_sse2);
 MK_CFUNC(mvtools_overlaps_32x16_sse2);
 MK_CFUNC(mvtools_overlaps_32x32_sse2);
+
+MK_CFUNC(mvtools_overlaps_4x16_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x32_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x64_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x4_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x64_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x8_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x16_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x32_uint16_t_uint8_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x64_uint16_t_uint8_t_sse2);
+
+MK_CFUNC(mvtools_overlaps_4x2_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_4x4_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_4x8_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_4x16_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x1_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x2_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x4_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x8_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x16_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_8x32_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x1_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x2_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x4_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x8_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x16_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x32_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_16x64_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x4_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x8_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x16_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x32_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_32x64_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x8_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x16_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x32_uint32_t_uint16_t_sse2);
+MK_CFUNC(mvtools_overlaps_64x64_uint32_t_uint16_t_sse2);
 #endif
 
 #undef MK_CFUNC
@@ -121,6 +176,10 @@ typedef void (*ToPixelsFunction)(uint8_t *pDst, int nDstPitch,
 void ToPixels_uint16_t_uint8_t(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, int nWidth, int nHeight, int bitsPerSample);
 void ToPixels_uint32_t_uint16_t(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, int nWidth, int nHeight, int bitsPerSample);
 
+#if defined(MVTOOLS_X86)
+void ToPixels_uint32_t_uint16_t_sse2(uint8_t *pDst8, int nDstPitch, const uint8_t *pSrc8, int nSrcPitch, int nWidth, int nHeight, int bitsPerSample);
+#endif
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -25,6 +25,9 @@
 #define max(a, b) ((a) > (b) ? (a) : (b))
 #define min(a, b) ((a) > (b) ? (b) : (a))
 
+// Bytes of transformed reference blocks kept by each thread, for each level.
+#define DCT_CACHE_SIZE (256 * 1024)
+
 
 /* fetch the block in the reference frame, which is pointed by the vector (vx, vy) */
 static inline const uint8_t *pobGetRefBlock(PlaneOfBlocks *pob, int nVx, int nVy) {
@@ -88,50 +91,79 @@ static inline int pobMotionDistorsion(PlaneOfBlocks *pob, int vx, int vy) {
 }
 
 
+/* transform of the reference block, taken from dctCache when it was already computed during this search */
+static const uint8_t *pobGetRefDCT(PlaneOfBlocks *pob, const uint8_t *pRef0) {
+    uint32_t slot = (uint32_t)((uintptr_t)pRef0 * 2654435761u) >> (32 - pob->dctCacheBits);
+    uint8_t *dctRef = pob->dctCache + (size_t)slot * pob->dctCacheStride;
+
+    pob->dctCacheLookups++;
+
+    if (pob->dctCacheKeys[slot] == pRef0) {
+        pob->dctCacheHits++;
+        return dctRef;
+    }
+
+    dctBytes2D(pob->DCT, pRef0, pob->nRefPitch[0], dctRef, pob->dctpitch);
+    pob->dctCacheKeys[slot] = pRef0;
+
+    return dctRef;
+}
+
+
+/* plain luma SAD of the candidate, also setting refLuma */
+static inline int pobSADAndRefLuma(PlaneOfBlocks *pob, const uint8_t *pRef0) {
+    if (pob->SADLUMA) {
+        unsigned int luma;
+        int sad = pob->SADLUMA(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0], &luma);
+        pob->refLuma = luma;
+        return sad;
+    }
+
+    pob->refLuma = pob->LUMA(pRef0, pob->nRefPitch[0]);
+    return pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
+}
+
+
 static int pobLumaSAD(PlaneOfBlocks *pob, const uint8_t *pRef0) {
     int sad = 0;
 
     if (pob->dctmode == 0) {
         sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
     } else if (pob->dctmode == 1) { // dct SAD
-        dctBytes2D(pob->DCT, pRef0, pob->nRefPitch[0], pob->dctRef, pob->dctpitch);
+        const uint8_t *dctRef = pobGetRefDCT(pob, pRef0);
         if (pob->bytesPerSample == 1)
-            sad = (pob->SAD(pob->dctSrc, pob->dctpitch, pob->dctRef, pob->dctpitch) + abs(pob->dctSrc[0] - pob->dctRef[0]) * 3) * pob->nBlkSizeX / 2; //correct reduced DC component
+            sad = (pob->SAD(pob->dctSrc, pob->dctpitch, dctRef, pob->dctpitch) + abs(pob->dctSrc[0] - dctRef[0]) * 3) * pob->nBlkSizeX / 2; //correct reduced DC component
         else {
-            uint16_t *dctSrc16 = (uint16_t *)pob->dctSrc;
-            uint16_t *dctRef16 = (uint16_t *)pob->dctRef;
+            const uint16_t *dctSrc16 = (const uint16_t *)pob->dctSrc;
+            const uint16_t *dctRef16 = (const uint16_t *)dctRef;
 
-            sad = (pob->SAD(pob->dctSrc, pob->dctpitch, pob->dctRef, pob->dctpitch) + abs(dctSrc16[0] - dctRef16[0]) * 3) * pob->nBlkSizeX / 2; //correct reduced DC component
+            sad = (pob->SAD(pob->dctSrc, pob->dctpitch, dctRef, pob->dctpitch) + abs(dctSrc16[0] - dctRef16[0]) * 3) * pob->nBlkSizeX / 2; //correct reduced DC component
         }
     } else if (pob->dctmode == 2) { //  globally (lumaChange) weighted spatial and DCT
         sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
         if (pob->dctweight16 > 0) {
-            dctBytes2D(pob->DCT, pRef0, pob->nRefPitch[0], pob->dctRef, pob->dctpitch);
+            const uint8_t *dctRef = pobGetRefDCT(pob, pRef0);
             int dctsad;
             if (pob->bytesPerSample == 1)
-                dctsad = (pob->SAD(pob->dctSrc, pob->dctpitch, pob->dctRef, pob->dctpitch) + abs(pob->dctSrc[0] - pob->dctRef[0]) * 3) * pob->nBlkSizeX / 2;
+                dctsad = (pob->SAD(pob->dctSrc, pob->dctpitch, dctRef, pob->dctpitch) + abs(pob->dctSrc[0] - dctRef[0]) * 3) * pob->nBlkSizeX / 2;
             else {
-                uint16_t *dctSrc16 = (uint16_t *)pob->dctSrc;
-                uint16_t *dctRef16 = (uint16_t *)pob->dctRef;
+                const uint16_t *dctSrc16 = (const uint16_t *)pob->dctSrc;
+                const uint16_t *dctRef16 = (const uint16_t *)dctRef;
 
-                dctsad = (pob->SAD(pob->dctSrc, pob->dctpitch, pob->dctRef, pob->dctpitch) + abs(dctSrc16[0] - dctRef16[0]) * 3) * pob->nBlkSizeX / 2;
+                dctsad = (pob->SAD(pob->dctSrc, pob->dctpitch, dctRef, pob->dctpitch) + abs(dctSrc16[0] - dctRef16[0]) * 3) * pob->nBlkSizeX / 2;
             }
             sad = (sad * (16 - pob->dctweight16) + dctsad * pob->dctweight16) / 16;
         }
     } else if (pob->dctmode == 3) { // per block adaptive switched from spatial to equal mixed SAD (faster)
-        pob->refLuma = pob->LUMA(pRef0, pob->nRefPitch[0]);
-        sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
+        sad = pobSADAndRefLuma(pob, pRef0);
         if (abs(pob->srcLuma - pob->refLuma) > (pob->srcLuma + pob->refLuma) >> 5) {
-            dctBytes2D(pob->DCT, pRef0, pob->nRefPitch[0], pob->dctRef, pob->dctpitch);
-            int dctsad = pob->SAD(pob->dctSrc, pob->dctpitch, pob->dctRef, pob->dctpitch) * pob->nBlkSizeX / 2;
+            int dctsad = pob->SAD(pob->dctSrc, pob->dctpitch, pobGetRefDCT(pob, pRef0), pob->dctpitch) * pob->nBlkSizeX / 2;
             sad = sad / 2 + dctsad / 2;
         }
     } else if (pob->dctmode == 4) { //  per block adaptive switched from spatial to mixed SAD with more weight of DCT (best?)
-        pob->refLuma = pob->LUMA(pRef0, pob->nRefPitch[0]);
-        sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
+        sad = pobSADAndRefLuma(pob, pRef0);
         if (abs(pob->srcLuma - pob->refLuma) > (pob->srcLuma + pob->refLuma) >> 5) {
-            dctBytes2D(pob->DCT, pRef0, pob->nRefPitch[0], pob->dctRef, pob->dctpitch);
-            int dctsad = pob->SAD(pob->dctSrc, pob->dctpitch, pob->dctRef, pob->dctpitch) * pob->nBlkSizeX / 2;
+            int dctsad = pob->SAD(pob->dctSrc, pob->dctpitch, pobGetRefDCT(pob, pRef0), pob->dctpitch) * pob->nBlkSizeX / 2;
             sad = sad / 4 + dctsad / 2 + dctsad / 4;
         }
     } else if (pob->dctmode == 5) { // dct SAD (SATD)
@@ -143,15 +175,13 @@ static int pobLumaSAD(PlaneOfBlocks *pob, const uint8_t *pRef0) {
             sad = (sad * (16 - pob->dctweight16) + dctsad * pob->dctweight16) / 16;
         }
     } else if (pob->dctmode == 7) { // per block adaptive switched from spatial to equal mixed SAD (faster?)
-        pob->refLuma = pob->LUMA(pRef0, pob->nRefPitch[0]);
-        sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
+        sad = pobSADAndRefLuma(pob, pRef0);
         if (abs(pob->srcLuma - pob->refLuma) > (pob->srcLuma + pob->refLuma) >> 5) {
             int dctsad = pob->SATD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
             sad = sad / 2 + dctsad / 2;
         }
     } else if (pob->dctmode == 8) { //  per block adaptive switched from spatial to mixed SAD with more weight of DCT (faster?)
-        pob->refLuma = pob->LUMA(pRef0, pob->nRefPitch[0]);
-        sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
+        sad = pobSADAndRefLuma(pob, pRef0);
         if (abs(pob->srcLuma - pob->refLuma) > (pob->srcLuma + pob->refLuma) >> 5) {
             int dctsad = pob->SATD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
             sad = sad / 4 + dctsad / 2 + dctsad / 4;
@@ -164,8 +194,7 @@ static int pobLumaSAD(PlaneOfBlocks *pob, const uint8_t *pRef0) {
             sad = (sad * (16 - dctweighthalf) + dctsad * dctweighthalf) / 16;
         }
     } else if (pob->dctmode == 10) { // per block adaptive switched from spatial to mixed SAD, weighted to SAD (faster)
-        pob->refLuma = pob->LUMA(pRef0, pob->nRefPitch[0]);
-        sad = pob->SAD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
+        sad = pobSADAndRefLuma(pob, pRef0);
         if (abs(pob->srcLuma - pob->refLuma) > (pob->srcLuma + pob->refLuma) >> 4) {
             int dctsad = pob->SATD(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0]);
             sad = sad / 2 + dctsad / 4 + sad / 4;
@@ -176,6 +205,29 @@ static int pobLumaSAD(PlaneOfBlocks *pob, const uint8_t *pRef0) {
 }
 
 
+/* luma SAD of the candidate, or anything not smaller than limit if it can't be smaller than that */
+static inline int pobLumaSADLimit(PlaneOfBlocks *pob, const uint8_t *pRef0, int limit) {
+    if (pob->dctmode == 0 && pob->SADLIMIT)
+        return pob->SADLIMIT(pob->pSrc[0], pob->nSrcPitch[0], pRef0, pob->nRefPitch[0], limit);
+
+    return pobLumaSAD(pob, pRef0);
+}
+
+
+/* same for the sum of both chroma SADs */
+static inline int pobChromaSADLimit(PlaneOfBlocks *pob, int vx, int vy, int limit) {
+    if (!pob->SADCHROMALIMIT)
+        return pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, vx, vy), pob->nRefPitch[1]) +
+               pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, vx, vy), pob->nRefPitch[2]);
+
+    int sad = pob->SADCHROMALIMIT(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, vx, vy), pob->nRefPitch[1], limit);
+    if (sad >= limit)
+        return sad;
+
+    return sad + pob->SADCHROMALIMIT(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, vx, vy), pob->nRefPitch[2], limit - sad);
+}
+
+
 /* check if a vector is inside search boundaries */
 static inline int pobIsVectorOK(PlaneOfBlocks *pob, int vx, int vy) {
     return ((vx >= pob->nDxMin) &&
@@ -198,15 +250,16 @@ static inline void pobCheckMV0(PlaneOfBlocks *pob, int vx, int vy) { //here the
         if (cost >= pob->nMinCost)
             return;
 
-        int sad = pobLumaSAD(pob, pobGetRefBlock(pob, vx, vy));
+        // Giving up once the SAD reaches the limit is fine, because the cost
+        // can only reach nMinCost then, and the candidate is rejected below.
+        int sad = pobLumaSADLimit(pob, pobGetRefBlock(pob, vx, vy), pob->nMinCost - cost);
         cost += sad;
         if (cost >= pob->nMinCost)
             return;
 
         int saduv = 0;
         if (pob->chroma) {
-            saduv += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, vx, vy), pob->nRefPitch[1]);
-            saduv += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, vx, vy), pob->nRefPitch[2]);
+            saduv = pobChromaSADLimit(pob, vx, vy, pob->nMinCost - cost);
 
             cost += saduv;
             if (cost >= pob->nMinCost)
@@ -234,15 +287,14 @@ static inline void pobCheckMV(PlaneOfBlocks *pob, int vx, int vy) { //here the c
         if (cost >= pob->nMinCost)
             return;
 
-        int sad = pobLumaSAD(pob, pobGetRefBlock(pob, vx, vy));
+        int sad = pobLumaSADLimit(pob, pobGetRefBlock(pob, vx, vy), pob->nMinCost - cost);
         cost += sad + (int)(((int64_t)pob->penaltyNew * sad) >> 8);
         if (cost >= pob->nMinCost)
             return;
 
         int saduv = 0;
         if (pob->chroma) {
-            saduv += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, vx, vy), pob->nRefPitch[1]);
-            saduv += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, vx, vy), pob->nRefPitch[2]);
+            saduv = pobChromaSADLimit(pob, vx, vy, pob->nMinCost - cost);
 
             cost += saduv + (int)(((int64_t)pob->penaltyNew * saduv) >> 8);
             if (cost >= pob->nMinCost)
@@ -270,15 +322,14 @@ static inline void pobCheckMV2(PlaneOfBlocks *pob, int vx, int vy, int *dir, int
         if (cost >= pob->nMinCost)
             return;
 
-        int sad = pobLumaSAD(pob, pobGetRefBlock(pob, vx, vy));
+        int sad = pobLumaSADLimit(pob, pobGetRefBlock(pob, vx, vy), pob->nMinCost - cost);
         cost += sad + (int)(((int64_t)pob->penaltyNew * sad) >> 8);
         if (cost >= pob->nMinCost)
             return;
 
         int saduv = 0;
         if (pob->chroma) {
-            saduv += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, vx, vy), pob->nRefPitch[1]);
-            saduv += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, vx, vy), pob->nRefPitch[2]);
+            saduv = pobChromaSADLimit(pob, vx, vy, pob->nMinCost - cost);
 
             cost += saduv + (int)(((int64_t)pob->penaltyNew * saduv) >> 8);
             if (cost >= pob->nMinCost)
@@ -294,37 +345,78 @@ static inline void pobCheckMV2(PlaneOfBlocks *pob, int vx, int vy, int *dir, int
 }
 
 
-/* check if the vector (vx, vy) is better, and update dir accordingly, but not bestMV.x, y */
-static inline void pobCheckMVdir(PlaneOfBlocks *pob, int vx, int vy, int *dir, int val) {
-    if (
-        #ifdef ONLY_CHECK_NONDEFAULT_MV
-            ((vx != 0) || (vy != zeroMVfieldShifted.y)) &&
-            ((vx != predictor.x) || (vy != predictor.y)) &&
-            ((vx != globalMVPredictor.x) || (vy != globalMVPredictor.y)) &&
-        #endif
-            pobIsVectorOK(pob, vx, vy)) {
-        int cost = pobMotionDistorsion(pob, vx, vy);
-        if (cost >= pob->nMinCost)
-            return;
+/* check the count vectors in mvs, in order, like pobCheckMV would with pnew = penalty.
+   If dir is not NULL, bestMV.x and y are left alone, and dir gets the value in dirs of
+   the best vector instead. The luma SADs are computed up to four at a time with SADX3
+   and SADX4, so the source block is loaded only once for all of them. */
+static void pobCheckMVs(PlaneOfBlocks *pob, const int (*mvs)[2], int count, int penalty, int *dir, const int *dirs) {
+    for (int first = 0; first < count; first += 4) {
+        int last = min(first + 4, count);
+
+        // nMinCost can only decrease, so the candidates left out here would
+        // also be rejected when their turn comes.
+        int candidates[4];
+        const uint8_t *pRefs[4];
+        int n = 0;
+        for (int i = first; i < last; i++)
+            if (pobIsVectorOK(pob, mvs[i][0], mvs[i][1]) && pobMotionDistorsion(pob, mvs[i][0], mvs[i][1]) < pob->nMinCost) {
+                candidates[n] = i;
+                pRefs[n] = pobGetRefBlock(pob, mvs[i][0], mvs[i][1]);
+                n++;
+            }
 
-        int sad = pobLumaSAD(pob, pobGetRefBlock(pob, vx, vy));
-        cost += sad + (int)(((int64_t)pob->penaltyNew * sad) >> 8);
-        if (cost >= pob->nMinCost)
-            return;
+        unsigned int sads[4];
+        int batched = pob->dctmode == 0 && pob->SADX4 && n >= 3;
+        if (batched) {
+            if (n == 4)
+                pob->SADX4(pob->pSrc[0], pob->nSrcPitch[0], pRefs[0], pRefs[1], pRefs[2], pRefs[3], pob->nRefPitch[0], sads);
+            else
+                pob->SADX3(pob->pSrc[0], pob->nSrcPitch[0], pRefs[0], pRefs[1], pRefs[2], pob->nRefPitch[0], sads);
+        }
 
-        int saduv = 0;
-        if (pob->chroma) {
-            saduv += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, vx, vy), pob->nRefPitch[1]);
-            saduv += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, vx, vy), pob->nRefPitch[2]);
+        for (int j = 0; j < n; j++) {
+            int vx = mvs[candidates[j]][0];
+            int vy = mvs[candidates[j]][1];
 
-            cost += saduv + (int)(((int64_t)pob->penaltyNew * saduv) >> 8);
+            int cost = pobMotionDistorsion(pob, vx, vy);
             if (cost >= pob->nMinCost)
-                return;
+                continue;
+
+            int sad = batched ? (int)sads[j] : pobLumaSADLimit(pob, pRefs[j], pob->nMinCost - cost);
+            cost += sad + (int)(((int64_t)penalty * sad) >> 8);
+            if (cost >= pob->nMinCost)
+                continue;
+
+            int saduv = 0;
+            if (pob->chroma) {
+                saduv = pobChromaSADLimit(pob, vx, vy, pob->nMinCost - cost);
+
+                cost += saduv + (int)(((int64_t)penalty * saduv) >> 8);
+                if (cost >= pob->nMinCost)
+                    continue;
+            }
+
+            if (dir) {
+                *dir = dirs[candidates[j]];
+            } else {
+                pob->bestMV.x = vx;
+                pob->bestMV.y = vy;
+            }
+            pob->nMinCost = cost;
+            pob->bestMV.sad = sad + saduv;
         }
+    }
+}
 
-        pob->nMinCost = cost;
-        pob->bestMV.sad = sad + saduv;
-        *dir = val;
+
+/* add a vector to those waiting to be checked with pobCheckMVs, checking them once there are four */
+static inline void pobQueueMV(PlaneOfBlocks *pob, int (*mvs)[2], int *count, int vx, int vy) {
+    mvs[*count][0] = vx;
+    mvs[*count][1] = vy;
+
+    if (++*count == 4) {
+        pobCheckMVs(pob, (const int (*)[2])mvs, 4, pob->penaltyNew, NULL, NULL);
+        *count = 0;
     }
 }
 
@@ -382,295 +474,1044 @@ static inline int Median(int a, int b, int c) {
 
 
 static void pobSelectFunctions(PlaneOfBlocks *pob) {
-    SADFunction sads[33][33];
-    LUMAFunction lumas[33][33];
-    COPYFunction blits[33][33];
-    SADFunction satds[33][33];
-
-    // valid block sizes for luma: 4x4, 8x4, 8x8, 16x2, 16x8, 16x16, 32x16, 32x32.
+    SADFunction sads[BlockSizeCount];
+    LUMAFunction lumas[BlockSizeCount];
+    COPYFunction blits[BlockSizeCount];
+    SADFunction satds[BlockSizeCount];
+    SADLimitFunction sadlimits[BlockSizeCount];
+    SADx3Function sadx3s[BlockSizeCount];
+    SADx4Function sadx4s[BlockSizeCount];
+    SADLumaFunction sadlumas[BlockSizeCount];
+
+    // The C versions of the SAD functions with a limit, and of those
+    // comparing several reference blocks at once or computing the luma
+    // along with the SAD, are slower than the SSE2 and assembly versions of
+    // the plain ones.
+    int useExtraSADs = 1;
+
+    // The valid block sizes are those of findBlockSize, in MVAnalysisData.c.
     if (pob->bytesPerSample == 1) {
-        sads[2][2] = mvtools_sad_2x2_u8_c;
-        blits[2][2] = mvtools_copy_2x2_u8_c;
-
-        sads[2][4] = mvtools_sad_2x4_u8_c;
-        blits[2][4] = mvtools_copy_2x4_u8_c;
-
-        sads[4][2] = mvtools_sad_4x2_u8_c;
-        blits[4][2] = mvtools_copy_4x2_u8_c;
-
-        sads[4][4] = mvtools_sad_4x4_u8_c;
-        lumas[4][4] = mvtools_luma_4x4_u8_c;
-        blits[4][4] = mvtools_copy_4x4_u8_c;
-        satds[4][4] = mvtools_satd_4x4_u8_c;
-
-        sads[4][8] = mvtools_sad_4x8_u8_c;
-        blits[4][8] = mvtools_copy_4x8_u8_c;
-
-        sads[8][1] = mvtools_sad_8x1_u8_c;
-        blits[8][1] = mvtools_copy_8x1_u8_c;
-
-        sads[8][2] = mvtools_sad_8x2_u8_c;
-        blits[8][2] = mvtools_copy_8x2_u8_c;
-
-        sads[8][4] = mvtools_sad_8x4_u8_c;
-        lumas[8][4] = mvtools_luma_8x4_u8_c;
-        blits[8][4] = mvtools_copy_8x4_u8_c;
-        satds[8][4] = mvtools_satd_8x4_u8_c;
-
-        sads[8][8] = mvtools_sad_8x8_u8_c;
-        lumas[8][8] = mvtools_luma_8x8_u8_c;
-        blits[8][8] = mvtools_copy_8x8_u8_c;
-        satds[8][8] = mvtools_satd_8x8_u8_c;
-
-        sads[8][16] = mvtools_sad_8x16_u8_c;
-        blits[8][16] = mvtools_copy_8x16_u8_c;
-
-        sads[16][1] = mvtools_sad_16x1_u8_c;
-        blits[16][1] = mvtools_copy_16x1_u8_c;
-
-        sads[16][2] = mvtools_sad_16x2_u8_c;
-        lumas[16][2] = mvtools_luma_16x2_u8_c;
-        blits[16][2] = mvtools_copy_16x2_u8_c;
-
-        sads[16][4] = mvtools_sad_16x4_u8_c;
-        blits[16][4] = mvtools_copy_16x4_u8_c;
-
-        sads[16][8] = mvtools_sad_16x8_u8_c;
-        lumas[16][8] = mvtools_luma_16x8_u8_c;
-        blits[16][8] = mvtools_copy_16x8_u8_c;
-        satds[16][8] = mvtools_satd_16x8_u8_c;
-
-        sads[16][16] = mvtools_sad_16x16_u8_c;
-        lumas[16][16] = mvtools_luma_16x16_u8_c;
-        blits[16][16] = mvtools_copy_16x16_u8_c;
-        satds[16][16] = mvtools_satd_16x16_u8_c;
-
-        sads[16][32] = mvtools_sad_16x32_u8_c;
-        blits[16][32] = mvtools_copy_16x32_u8_c;
-
-        sads[32][8] = mvtools_sad_32x8_u8_c;
-        blits[32][8] = mvtools_copy_32x8_u8_c;
-
-        sads[32][16] = mvtools_sad_32x16_u8_c;
-        lumas[32][16] = mvtools_luma_32x16_u8_c;
-        blits[32][16] = mvtools_copy_32x16_u8_c;
-
-        sads[32][32] = mvtools_sad_32x32_u8_c;
-        lumas[32][32] = mvtools_luma_32x32_u8_c;
-        blits[32][32] = mvtools_copy_32x32_u8_c;
+        sads[Block2x2] = mvtools_sad_2x2_u8_c;
+        sadlimits[Block2x2] = mvtools_sad_limit_2x2_u8_c;
+        sadx3s[Block2x2] = mvtools_sad_x3_2x2_u8_c;
+        sadx4s[Block2x2] = mvtools_sad_x4_2x2_u8_c;
+        sadlumas[Block2x2] = mvtools_sad_luma_2x2_u8_c;
+        lumas[Block2x2] = mvtools_luma_2x2_u8_c;
+        blits[Block2x2] = mvtools_copy_2x2_u8_c;
+
+        sads[Block2x4] = mvtools_sad_2x4_u8_c;
+        sadlimits[Block2x4] = mvtools_sad_limit_2x4_u8_c;
+        sadx3s[Block2x4] = mvtools_sad_x3_2x4_u8_c;
+        sadx4s[Block2x4] = mvtools_sad_x4_2x4_u8_c;
+        sadlumas[Block2x4] = mvtools_sad_luma_2x4_u8_c;
+        lumas[Block2x4] = mvtools_luma_2x4_u8_c;
+        blits[Block2x4] = mvtools_copy_2x4_u8_c;
+
+        sads[Block4x2] = mvtools_sad_4x2_u8_c;
+        sadlimits[Block4x2] = mvtools_sad_limit_4x2_u8_c;
+        sadx3s[Block4x2] = mvtools_sad_x3_4x2_u8_c;
+        sadx4s[Block4x2] = mvtools_sad_x4_4x2_u8_c;
+        sadlumas[Block4x2] = mvtools_sad_luma_4x2_u8_c;
+        lumas[Block4x2] = mvtools_luma_4x2_u8_c;
+        blits[Block4x2] = mvtools_copy_4x2_u8_c;
+
+        sads[Block4x4] = mvtools_sad_4x4_u8_c;
+        sadlimits[Block4x4] = mvtools_sad_limit_4x4_u8_c;
+        sadx3s[Block4x4] = mvtools_sad_x3_4x4_u8_c;
+        sadx4s[Block4x4] = mvtools_sad_x4_4x4_u8_c;
+        sadlumas[Block4x4] = mvtools_sad_luma_4x4_u8_c;
+        lumas[Block4x4] = mvtools_luma_4x4_u8_c;
+        blits[Block4x4] = mvtools_copy_4x4_u8_c;
+        satds[Block4x4] = mvtools_satd_4x4_u8_c;
+
+        sads[Block4x8] = mvtools_sad_4x8_u8_c;
+        sadlimits[Block4x8] = mvtools_sad_limit_4x8_u8_c;
+        sadx3s[Block4x8] = mvtools_sad_x3_4x8_u8_c;
+        sadx4s[Block4x8] = mvtools_sad_x4_4x8_u8_c;
+        sadlumas[Block4x8] = mvtools_sad_luma_4x8_u8_c;
+        lumas[Block4x8] = mvtools_luma_4x8_u8_c;
+        blits[Block4x8] = mvtools_copy_4x8_u8_c;
+        satds[Block4x8] = mvtools_satd_4x8_u8_c;
+
+        sads[Block4x16] = mvtools_sad_4x16_u8_c;
+        sadlimits[Block4x16] = mvtools_sad_limit_4x16_u8_c;
+        sadx3s[Block4x16] = mvtools_sad_x3_4x16_u8_c;
+        sadx4s[Block4x16] = mvtools_sad_x4_4x16_u8_c;
+        sadlumas[Block4x16] = mvtools_sad_luma_4x16_u8_c;
+        lumas[Block4x16] = mvtools_luma_4x16_u8_c;
+        blits[Block4x16] = mvtools_copy_4x16_u8_c;
+        satds[Block4x16] = mvtools_satd_4x16_u8_c;
+
+        sads[Block8x1] = mvtools_sad_8x1_u8_c;
+        sadlimits[Block8x1] = mvtools_sad_limit_8x1_u8_c;
+        sadx3s[Block8x1] = mvtools_sad_x3_8x1_u8_c;
+        sadx4s[Block8x1] = mvtools_sad_x4_8x1_u8_c;
+        sadlumas[Block8x1] = mvtools_sad_luma_8x1_u8_c;
+        lumas[Block8x1] = mvtools_luma_8x1_u8_c;
+        blits[Block8x1] = mvtools_copy_8x1_u8_c;
+
+        sads[Block8x2] = mvtools_sad_8x2_u8_c;
+        sadlimits[Block8x2] = mvtools_sad_limit_8x2_u8_c;
+        sadx3s[Block8x2] = mvtools_sad_x3_8x2_u8_c;
+        sadx4s[Block8x2] = mvtools_sad_x4_8x2_u8_c;
+        sadlumas[Block8x2] = mvtools_sad_luma_8x2_u8_c;
+        lumas[Block8x2] = mvtools_luma_8x2_u8_c;
+        blits[Block8x2] = mvtools_copy_8x2_u8_c;
+
+        sads[Block8x4] = mvtools_sad_8x4_u8_c;
+        sadlimits[Block8x4] = mvtools_sad_limit_8x4_u8_c;
+        sadx3s[Block8x4] = mvtools_sad_x3_8x4_u8_c;
+        sadx4s[Block8x4] = mvtools_sad_x4_8x4_u8_c;
+        sadlumas[Block8x4] = mvtools_sad_luma_8x4_u8_c;
+        lumas[Block8x4] = mvtools_luma_8x4_u8_c;
+        blits[Block8x4] = mvtools_copy_8x4_u8_c;
+        satds[Block8x4] = mvtools_satd_8x4_u8_c;
+
+        sads[Block8x8] = mvtools_sad_8x8_u8_c;
+        sadlimits[Block8x8] = mvtools_sad_limit_8x8_u8_c;
+        sadx3s[Block8x8] = mvtools_sad_x3_8x8_u8_c;
+        sadx4s[Block8x8] = mvtools_sad_x4_8x8_u8_c;
+        sadlumas[Block8x8] = mvtools_sad_luma_8x8_u8_c;
+        lumas[Block8x8] = mvtools_luma_8x8_u8_c;
+        blits[Block8x8] = mvtools_copy_8x8_u8_c;
+        satds[Block8x8] = mvtools_satd_8x8_u8_c;
+
+        sads[Block8x16] = mvtools_sad_8x16_u8_c;
+        sadlimits[Block8x16] = mvtools_sad_limit_8x16_u8_c;
+        sadx3s[Block8x16] = mvtools_sad_x3_8x16_u8_c;
+        sadx4s[Block8x16] = mvtools_sad_x4_8x16_u8_c;
+        sadlumas[Block8x16] = mvtools_sad_luma_8x16_u8_c;
+        lumas[Block8x16] = mvtools_luma_8x16_u8_c;
+        blits[Block8x16] = mvtools_copy_8x16_u8_c;
+        satds[Block8x16] = mvtools_satd_8x16_u8_c;
+
+        sads[Block8x32] = mvtools_sad_8x32_u8_c;
+        sadlimits[Block8x32] = mvtools_sad_limit_8x32_u8_c;
+        sadx3s[Block8x32] = mvtools_sad_x3_8x32_u8_c;
+        sadx4s[Block8x32] = mvtools_sad_x4_8x32_u8_c;
+        sadlumas[Block8x32] = mvtools_sad_luma_8x32_u8_c;
+        lumas[Block8x32] = mvtools_luma_8x32_u8_c;
+        blits[Block8x32] = mvtools_copy_8x32_u8_c;
+        satds[Block8x32] = mvtools_satd_8x32_u8_c;
+
+        sads[Block16x1] = mvtools_sad_16x1_u8_c;
+        sadlimits[Block16x1] = mvtools_sad_limit_16x1_u8_c;
+        sadx3s[Block16x1] = mvtools_sad_x3_16x1_u8_c;
+        sadx4s[Block16x1] = mvtools_sad_x4_16x1_u8_c;
+        sadlumas[Block16x1] = mvtools_sad_luma_16x1_u8_c;
+        lumas[Block16x1] = mvtools_luma_16x1_u8_c;
+        blits[Block16x1] = mvtools_copy_16x1_u8_c;
+
+        sads[Block16x2] = mvtools_sad_16x2_u8_c;
+        sadlimits[Block16x2] = mvtools_sad_limit_16x2_u8_c;
+        sadx3s[Block16x2] = mvtools_sad_x3_16x2_u8_c;
+        sadx4s[Block16x2] = mvtools_sad_x4_16x2_u8_c;
+        sadlumas[Block16x2] = mvtools_sad_luma_16x2_u8_c;
+        lumas[Block16x2] = mvtools_luma_16x2_u8_c;
+        blits[Block16x2] = mvtools_copy_16x2_u8_c;
+
+        sads[Block16x4] = mvtools_sad_16x4_u8_c;
+        sadlimits[Block16x4] = mvtools_sad_limit_16x4_u8_c;
+        sadx3s[Block16x4] = mvtools_sad_x3_16x4_u8_c;
+        sadx4s[Block16x4] = mvtools_sad_x4_16x4_u8_c;
+        sadlumas[Block16x4] = mvtools_sad_luma_16x4_u8_c;
+        lumas[Block16x4] = mvtools_luma_16x4_u8_c;
+        blits[Block16x4] = mvtools_copy_16x4_u8_c;
+        satds[Block16x4] = mvtools_satd_16x4_u8_c;
+
+        sads[Block16x8] = mvtools_sad_16x8_u8_c;
+        sadlimits[Block16x8] = mvtools_sad_limit_16x8_u8_c;
+        sadx3s[Block16x8] = mvtools_sad_x3_16x8_u8_c;
+        sadx4s[Block16x8] = mvtools_sad_x4_16x8_u8_c;
+        sadlumas[Block16x8] = mvtools_sad_luma_16x8_u8_c;
+        lumas[Block16x8] = mvtools_luma_16x8_u8_c;
+        blits[Block16x8] = mvtools_copy_16x8_u8_c;
+        satds[Block16x8] = mvtools_satd_16x8_u8_c;
+
+        sads[Block16x16] = mvtools_sad_16x16_u8_c;
+        sadlimits[Block16x16] = mvtools_sad_limit_16x16_u8_c;
+        sadx3s[Block16x16] = mvtools_sad_x3_16x16_u8_c;
+        sadx4s[Block16x16] = mvtools_sad_x4_16x16_u8_c;
+        sadlumas[Block16x16] = mvtools_sad_luma_16x16_u8_c;
+        lumas[Block16x16] = mvtools_luma_16x16_u8_c;
+        blits[Block16x16] = mvtools_copy_16x16_u8_c;
+        satds[Block16x16] = mvtools_satd_16x16_u8_c;
+
+        sads[Block16x32] = mvtools_sad_16x32_u8_c;
+        sadlimits[Block16x32] = mvtools_sad_limit_16x32_u8_c;
+        sadx3s[Block16x32] = mvtools_sad_x3_16x32_u8_c;
+        sadx4s[Block16x32] = mvtools_sad_x4_16x32_u8_c;
+        sadlumas[Block16x32] = mvtools_sad_luma_16x32_u8_c;
+        lumas[Block16x32] = mvtools_luma_16x32_u8_c;
+        blits[Block16x32] = mvtools_copy_16x32_u8_c;
+        satds[Block16x32] = mvtools_satd_16x32_u8_c;
+
+        sads[Block16x64] = mvtools_sad_16x64_u8_c;
+        sadlimits[Block16x64] = mvtools_sad_limit_16x64_u8_c;
+        sadx3s[Block16x64] = mvtools_sad_x3_16x64_u8_c;
+        sadx4s[Block16x64] = mvtools_sad_x4_16x64_u8_c;
+        sadlumas[Block16x64] = mvtools_sad_luma_16x64_u8_c;
+        lumas[Block16x64] = mvtools_luma_16x64_u8_c;
+        blits[Block16x64] = mvtools_copy_16x64_u8_c;
+        satds[Block16x64] = mvtools_satd_16x64_u8_c;
+
+        sads[Block32x4] = mvtools_sad_32x4_u8_c;
+        sadlimits[Block32x4] = mvtools_sad_limit_32x4_u8_c;
+        sadx3s[Block32x4] = mvtools_sad_x3_32x4_u8_c;
+        sadx4s[Block32x4] = mvtools_sad_x4_32x4_u8_c;
+        sadlumas[Block32x4] = mvtools_sad_luma_32x4_u8_c;
+        lumas[Block32x4] = mvtools_luma_32x4_u8_c;
+        blits[Block32x4] = mvtools_copy_32x4_u8_c;
+        satds[Block32x4] = mvtools_satd_32x4_u8_c;
+
+        sads[Block32x8] = mvtools_sad_32x8_u8_c;
+        sadlimits[Block32x8] = mvtools_sad_limit_32x8_u8_c;
+        sadx3s[Block32x8] = mvtools_sad_x3_32x8_u8_c;
+        sadx4s[Block32x8] = mvtools_sad_x4_32x8_u8_c;
+        sadlumas[Block32x8] = mvtools_sad_luma_32x8_u8_c;
+        lumas[Block32x8] = mvtools_luma_32x8_u8_c;
+        blits[Block32x8] = mvtools_copy_32x8_u8_c;
+        satds[Block32x8] = mvtools_satd_32x8_u8_c;
+
+        sads[Block32x16] = mvtools_sad_32x16_u8_c;
+        sadlimits[Block32x16] = mvtools_sad_limit_32x16_u8_c;
+        sadx3s[Block32x16] = mvtools_sad_x3_32x16_u8_c;
+        sadx4s[Block32x16] = mvtools_sad_x4_32x16_u8_c;
+        sadlumas[Block32x16] = mvtools_sad_luma_32x16_u8_c;
+        lumas[Block32x16] = mvtools_luma_32x16_u8_c;
+        blits[Block32x16] = mvtools_copy_32x16_u8_c;
+        satds[Block32x16] = mvtools_satd_32x16_u8_c;
+
+        sads[Block32x32] = mvtools_sad_32x32_u8_c;
+        sadlimits[Block32x32] = mvtools_sad_limit_32x32_u8_c;
+        sadx3s[Block32x32] = mvtools_sad_x3_32x32_u8_c;
+        sadx4s[Block32x32] = mvtools_sad_x4_32x32_u8_c;
+        sadlumas[Block32x32] = mvtools_sad_luma_32x32_u8_c;
+        lumas[Block32x32] = mvtools_luma_32x32_u8_c;
+        blits[Block32x32] = mvtools_copy_32x32_u8_c;
+        satds[Block32x32] = mvtools_satd_32x32_u8_c;
+
+        sads[Block32x64] = mvtools_sad_32x64_u8_c;
+        sadlimits[Block32x64] = mvtools_sad_limit_32x64_u8_c;
+        sadx3s[Block32x64] = mvtools_sad_x3_32x64_u8_c;
+        sadx4s[Block32x64] = mvtools_sad_x4_32x64_u8_c;
+        sadlumas[Block32x64] = mvtools_sad_luma_32x64_u8_c;
+        lumas[Block32x64] = mvtools_luma_32x64_u8_c;
+        blits[Block32x64] = mvtools_copy_32x64_u8_c;
+        satds[Block32x64] = mvtools_satd_32x64_u8_c;
+
+        sads[Block64x8] = mvtools_sad_64x8_u8_c;
+        sadlimits[Block64x8] = mvtools_sad_limit_64x8_u8_c;
+        sadx3s[Block64x8] = mvtools_sad_x3_64x8_u8_c;
+        sadx4s[Block64x8] = mvtools_sad_x4_64x8_u8_c;
+        sadlumas[Block64x8] = mvtools_sad_luma_64x8_u8_c;
+        lumas[Block64x8] = mvtools_luma_64x8_u8_c;
+        blits[Block64x8] = mvtools_copy_64x8_u8_c;
+        satds[Block64x8] = mvtools_satd_64x8_u8_c;
+
+        sads[Block64x16] = mvtools_sad_64x16_u8_c;
+        sadlimits[Block64x16] = mvtools_sad_limit_64x16_u8_c;
+        sadx3s[Block64x16] = mvtools_sad_x3_64x16_u8_c;
+        sadx4s[Block64x16] = mvtools_sad_x4_64x16_u8_c;
+        sadlumas[Block64x16] = mvtools_sad_luma_64x16_u8_c;
+        lumas[Block64x16] = mvtools_luma_64x16_u8_c;
+        blits[Block64x16] = mvtools_copy_64x16_u8_c;
+        satds[Block64x16] = mvtools_satd_64x16_u8_c;
+
+        sads[Block64x32] = mvtools_sad_64x32_u8_c;
+        sadlimits[Block64x32] = mvtools_sad_limit_64x32_u8_c;
+        sadx3s[Block64x32] = mvtools_sad_x3_64x32_u8_c;
+        sadx4s[Block64x32] = mvtools_sad_x4_64x32_u8_c;
+        sadlumas[Block64x32] = mvtools_sad_luma_64x32_u8_c;
+        lumas[Block64x32] = mvtools_luma_64x32_u8_c;
+        blits[Block64x32] = mvtools_copy_64x32_u8_c;
+        satds[Block64x32] = mvtools_satd_64x32_u8_c;
+
+        sads[Block64x64] = mvtools_sad_64x64_u8_c;
+        sadlimits[Block64x64] = mvtools_sad_limit_64x64_u8_c;
+        sadx3s[Block64x64] = mvtools_sad_x3_64x64_u8_c;
+        sadx4s[Block64x64] = mvtools_sad_x4_64x64_u8_c;
+        sadlumas[Block64x64] = mvtools_sad_luma_64x64_u8_c;
+        lumas[Block64x64] = mvtools_luma_64x64_u8_c;
+        blits[Block64x64] = mvtools_copy_64x64_u8_c;
+        satds[Block64x64] = mvtools_satd_64x64_u8_c;
 
         if (pob->isse) {
 #if defined(MVTOOLS_X86)
-            sads[4][2] = mvtools_sad_4x2_sse2;
+            useExtraSADs = 0;
+
+            sads[Block4x2] = mvtools_sad_4x2_sse2;
 
-            sads[4][4] = mvtools_pixel_sad_4x4_mmx2;
-            lumas[4][4] = mvtools_luma_4x4_u8_sse2;
-            satds[4][4] = mvtools_pixel_satd_4x4_mmx2;
+            sads[Block4x4] = mvtools_pixel_sad_4x4_mmx2;
+            lumas[Block4x4] = mvtools_luma_4x4_u8_sse2;
+            satds[Block4x4] = mvtools_pixel_satd_4x4_mmx2;
 
-            sads[4][8] = mvtools_pixel_sad_4x8_mmx2;
+            sads[Block4x8] = mvtools_pixel_sad_4x8_mmx2;
 
-            sads[8][1] = mvtools_sad_8x1_sse2;
+            sads[Block8x1] = mvtools_sad_8x1_sse2;
 
-            sads[8][2] = mvtools_sad_8x2_sse2;
+            sads[Block8x2] = mvtools_sad_8x2_sse2;
 
-            sads[8][4] = mvtools_pixel_sad_8x4_mmx2;
-            lumas[8][4] = mvtools_luma_8x4_u8_sse2;
-            satds[8][4] = mvtools_pixel_satd_8x4_sse2;
+            sads[Block8x4] = mvtools_pixel_sad_8x4_mmx2;
+            lumas[Block8x4] = mvtools_luma_8x4_u8_sse2;
+            satds[Block8x4] = mvtools_pixel_satd_8x4_sse2;
 
-            sads[8][8] = mvtools_pixel_sad_8x8_mmx2;
-            lumas[8][8] = mvtools_luma_8x8_u8_sse2;
-            satds[8][8] = mvtools_pixel_satd_8x8_sse2;
+            sads[Block8x8] = mvtools_pixel_sad_8x8_mmx2;
+            lumas[Block8x8] = mvtools_luma_8x8_u8_sse2;
+            satds[Block8x8] = mvtools_pixel_satd_8x8_sse2;
 
-            sads[8][16] = mvtools_pixel_sad_8x16_sse2;
+            sads[Block8x16] = mvtools_pixel_sad_8x16_sse2;
 
-            sads[16][1] = mvtools_sad_16x1_sse2;
+            sads[Block16x1] = mvtools_sad_16x1_sse2;
 
-            sads[16][2] = mvtools_sad_16x2_sse2;
-            lumas[16][2] = mvtools_luma_16x2_u8_sse2;
+            sads[Block16x2] = mvtools_sad_16x2_sse2;
+            lumas[Block16x2] = mvtools_luma_16x2_u8_sse2;
 
-            sads[16][4] = mvtools_sad_16x4_sse2;
+            sads[Block16x4] = mvtools_sad_16x4_sse2;
 
-            sads[16][8] = mvtools_pixel_sad_16x8_sse2;
-            lumas[16][8] = mvtools_luma_16x8_u8_sse2;
-            satds[16][8] = mvtools_pixel_satd_16x8_sse2;
+            sads[Block16x8] = mvtools_pixel_sad_16x8_sse2;
+            lumas[Block16x8] = mvtools_luma_16x8_u8_sse2;
+            satds[Block16x8] = mvtools_pixel_satd_16x8_sse2;
 
-            sads[16][16] = mvtools_pixel_sad_16x16_sse2;
-            lumas[16][16] = mvtools_luma_16x16_u8_sse2;
-            satds[16][16] = mvtools_pixel_satd_16x16_sse2;
+            sads[Block16x16] = mvtools_pixel_sad_16x16_sse2;
+            lumas[Block16x16] = mvtools_luma_16x16_u8_sse2;
+            satds[Block16x16] = mvtools_pixel_satd_16x16_sse2;
 
-            sads[16][32] = mvtools_sad_16x32_sse2;
+            sads[Block16x32] = mvtools_sad_16x32_sse2;
 
-            sads[32][8] = mvtools_sad_32x8_sse2;
+            sads[Block32x8] = mvtools_sad_32x8_sse2;
 
-            sads[32][16] = mvtools_sad_32x16_sse2;
-            lumas[32][16] = mvtools_luma_32x16_u8_sse2;
+            sads[Block32x16] = mvtools_sad_32x16_sse2;
+            lumas[Block32x16] = mvtools_luma_32x16_u8_sse2;
 
-            sads[32][32] = mvtools_sad_32x32_sse2;
-            lumas[32][32] = mvtools_luma_32x32_u8_sse2;
+            sads[Block32x32] = mvtools_sad_32x32_sse2;
+            lumas[Block32x32] = mvtools_luma_32x32_u8_sse2;
+
+            satds[Block8x16] = mvtools_satd_8x16_u8_sse2;
+            satds[Block8x32] = mvtools_satd_8x32_u8_sse2;
+            satds[Block16x32] = mvtools_satd_16x32_u8_sse2;
+            satds[Block16x64] = mvtools_satd_16x64_u8_sse2;
+            satds[Block32x8] = mvtools_satd_32x8_u8_sse2;
+            satds[Block32x16] = mvtools_satd_32x16_u8_sse2;
+            satds[Block32x32] = mvtools_satd_32x32_u8_sse2;
+            satds[Block32x64] = mvtools_satd_32x64_u8_sse2;
+            satds[Block64x8] = mvtools_satd_64x8_u8_sse2;
+            satds[Block64x16] = mvtools_satd_64x16_u8_sse2;
+            satds[Block64x32] = mvtools_satd_64x32_u8_sse2;
+            satds[Block64x64] = mvtools_satd_64x64_u8_sse2;
 
             if (pob->nCPUFlags & X264_CPU_CACHELINE_64) {
-                sads[8][4] = mvtools_pixel_sad_8x4_cache64_mmx2;
-                sads[8][8] = mvtools_pixel_sad_8x8_cache64_mmx2;
+                sads[Block8x4] = mvtools_pixel_sad_8x4_cache64_mmx2;
+                sads[Block8x8] = mvtools_pixel_sad_8x8_cache64_mmx2;
             }
 
             if (pob->nCPUFlags & X264_CPU_SSE3) {
-                sads[16][8] = mvtools_pixel_sad_16x8_sse3;
-                sads[16][16] = mvtools_pixel_sad_16x16_sse3;
+                sads[Block16x8] = mvtools_pixel_sad_16x8_sse3;
+                sads[Block16x16] = mvtools_pixel_sad_16x16_sse3;
             }
 
             if ((pob->nCPUFlags & X264_CPU_SSSE3) && (pob->nCPUFlags & X264_CPU_CACHELINE_64)) {
-                sads[16][8] = mvtools_pixel_sad_16x8_cache64_ssse3;
-                sads[16][16] = mvtools_pixel_sad_16x16_cache64_ssse3;
+                sads[Block16x8] = mvtools_pixel_sad_16x8_cache64_ssse3;
+                sads[Block16x16] = mvtools_pixel_sad_16x16_cache64_ssse3;
             }
 
             if (pob->nCPUFlags & X264_CPU_SSSE3) {
-                satds[4][4] = mvtools_pixel_satd_4x4_ssse3;
-                satds[8][4] = mvtools_pixel_satd_8x4_ssse3;
-                satds[8][8] = mvtools_pixel_satd_8x8_ssse3;
-                satds[16][8] = mvtools_pixel_satd_16x8_ssse3;
-                satds[16][16] = mvtools_pixel_satd_16x16_ssse3;
+                satds[Block4x4] = mvtools_pixel_satd_4x4_ssse3;
+                satds[Block8x4] = mvtools_pixel_satd_8x4_ssse3;
+                satds[Block8x8] = mvtools_pixel_satd_8x8_ssse3;
+                satds[Block16x8] = mvtools_pixel_satd_16x8_ssse3;
+                satds[Block16x16] = mvtools_pixel_satd_16x16_ssse3;
             }
 
             if (pob->nCPUFlags & X264_CPU_SSE4) {
-                satds[4][4] = mvtools_pixel_satd_4x4_sse4;
-                satds[8][4] = mvtools_pixel_satd_8x4_sse4;
-                satds[8][8] = mvtools_pixel_satd_8x8_sse4;
-                satds[16][8] = mvtools_pixel_satd_16x8_sse4;
-                satds[16][16] = mvtools_pixel_satd_16x16_sse4;
+                satds[Block4x4] = mvtools_pixel_satd_4x4_sse4;
+                satds[Block8x4] = mvtools_pixel_satd_8x4_sse4;
+                satds[Block8x8] = mvtools_pixel_satd_8x8_sse4;
+                satds[Block16x8] = mvtools_pixel_satd_16x8_sse4;
+                satds[Block16x16] = mvtools_pixel_satd_16x16_sse4;
             }
 
             if (pob->nCPUFlags & X264_CPU_AVX) {
-                satds[4][4] = mvtools_pixel_satd_4x4_avx;
-                satds[8][4] = mvtools_pixel_satd_8x4_avx;
-                satds[8][8] = mvtools_pixel_satd_8x8_avx;
-                satds[16][8] = mvtools_pixel_satd_16x8_avx;
-                satds[16][16] = mvtools_pixel_satd_16x16_avx;
+                satds[Block4x4] = mvtools_pixel_satd_4x4_avx;
+                satds[Block8x4] = mvtools_pixel_satd_8x4_avx;
+                satds[Block8x8] = mvtools_pixel_satd_8x8_avx;
+                satds[Block16x8] = mvtools_pixel_satd_16x8_avx;
+                satds[Block16x16] = mvtools_pixel_satd_16x16_avx;
             }
 
             if (pob->nCPUFlags & X264_CPU_XOP) {
-                satds[4][4] = mvtools_pixel_satd_4x4_xop;
-                satds[8][4] = mvtools_pixel_satd_8x4_xop;
-                satds[8][8] = mvtools_pixel_satd_8x8_xop;
-                satds[16][8] = mvtools_pixel_satd_16x8_xop;
-                satds[16][16] = mvtools_pixel_satd_16x16_xop;
+                satds[Block4x4] = mvtools_pixel_satd_4x4_xop;
+                satds[Block8x4] = mvtools_pixel_satd_8x4_xop;
+                satds[Block8x8] = mvtools_pixel_satd_8x8_xop;
+                satds[Block16x8] = mvtools_pixel_satd_16x8_xop;
+                satds[Block16x16] = mvtools_pixel_satd_16x16_xop;
             }
 
             if (pob->nCPUFlags & X264_CPU_AVX2) {
-                satds[8][8] = mvtools_pixel_satd_8x8_avx2;
-                satds[16][8] = mvtools_pixel_satd_16x8_avx2;
-                satds[16][16] = mvtools_pixel_satd_16x16_avx2;
+                useExtraSADs = 1;
+
+                satds[Block8x8] = mvtools_pixel_satd_8x8_avx2;
+                satds[Block16x8] = mvtools_pixel_satd_16x8_avx2;
+                satds[Block16x16] = mvtools_pixel_satd_16x16_avx2;
+                satds[Block8x16] = mvtools_satd_8x16_u8_avx2;
+                satds[Block8x32] = mvtools_satd_8x32_u8_avx2;
+                satds[Block16x32] = mvtools_satd_16x32_u8_avx2;
+                satds[Block16x64] = mvtools_satd_16x64_u8_avx2;
+                satds[Block32x8] = mvtools_satd_32x8_u8_avx2;
+                satds[Block32x16] = mvtools_satd_32x16_u8_avx2;
+                satds[Block32x32] = mvtools_satd_32x32_u8_avx2;
+                satds[Block32x64] = mvtools_satd_32x64_u8_avx2;
+                satds[Block64x8] = mvtools_satd_64x8_u8_avx2;
+                satds[Block64x16] = mvtools_satd_64x16_u8_avx2;
+                satds[Block64x32] = mvtools_satd_64x32_u8_avx2;
+                satds[Block64x64] = mvtools_satd_64x64_u8_avx2;
+
+                sads[Block2x2] = mvtools_sad_2x2_u8_avx2;
+                sadlimits[Block2x2] = mvtools_sad_limit_2x2_u8_avx2;
+                sadx3s[Block2x2] = mvtools_sad_x3_2x2_u8_avx2;
+                sadx4s[Block2x2] = mvtools_sad_x4_2x2_u8_avx2;
+                sadlumas[Block2x2] = mvtools_sad_luma_2x2_u8_avx2;
+                sads[Block2x4] = mvtools_sad_2x4_u8_avx2;
+                sadlimits[Block2x4] = mvtools_sad_limit_2x4_u8_avx2;
+                sadx3s[Block2x4] = mvtools_sad_x3_2x4_u8_avx2;
+                sadx4s[Block2x4] = mvtools_sad_x4_2x4_u8_avx2;
+                sadlumas[Block2x4] = mvtools_sad_luma_2x4_u8_avx2;
+                sads[Block4x2] = mvtools_sad_4x2_u8_avx2;
+                sadlimits[Block4x2] = mvtools_sad_limit_4x2_u8_avx2;
+                sadx3s[Block4x2] = mvtools_sad_x3_4x2_u8_avx2;
+                sadx4s[Block4x2] = mvtools_sad_x4_4x2_u8_avx2;
+                sadlumas[Block4x2] = mvtools_sad_luma_4x2_u8_avx2;
+                sads[Block4x4] = mvtools_sad_4x4_u8_avx2;
+                sadlimits[Block4x4] = mvtools_sad_limit_4x4_u8_avx2;
+                sadx3s[Block4x4] = mvtools_sad_x3_4x4_u8_avx2;
+                sadx4s[Block4x4] = mvtools_sad_x4_4x4_u8_avx2;
+                sadlumas[Block4x4] = mvtools_sad_luma_4x4_u8_avx2;
+                sads[Block4x8] = mvtools_sad_4x8_u8_avx2;
+                sadlimits[Block4x8] = mvtools_sad_limit_4x8_u8_avx2;
+                sadx3s[Block4x8] = mvtools_sad_x3_4x8_u8_avx2;
+                sadx4s[Block4x8] = mvtools_sad_x4_4x8_u8_avx2;
+                sadlumas[Block4x8] = mvtools_sad_luma_4x8_u8_avx2;
+                sads[Block4x16] = mvtools_sad_4x16_u8_avx2;
+                sadlimits[Block4x16] = mvtools_sad_limit_4x16_u8_avx2;
+                sadx3s[Block4x16] = mvtools_sad_x3_4x16_u8_avx2;
+                sadx4s[Block4x16] = mvtools_sad_x4_4x16_u8_avx2;
+                sadlumas[Block4x16] = mvtools_sad_luma_4x16_u8_avx2;
+                sads[Block8x1] = mvtools_sad_8x1_u8_avx2;
+                sadlimits[Block8x1] = mvtools_sad_limit_8x1_u8_avx2;
+                sadx3s[Block8x1] = mvtools_sad_x3_8x1_u8_avx2;
+                sadx4s[Block8x1] = mvtools_sad_x4_8x1_u8_avx2;
+                sadlumas[Block8x1] = mvtools_sad_luma_8x1_u8_avx2;
+                sads[Block8x2] = mvtools_sad_8x2_u8_avx2;
+                sadlimits[Block8x2] = mvtools_sad_limit_8x2_u8_avx2;
+                sadx3s[Block8x2] = mvtools_sad_x3_8x2_u8_avx2;
+                sadx4s[Block8x2] = mvtools_sad_x4_8x2_u8_avx2;
+                sadlumas[Block8x2] = mvtools_sad_luma_8x2_u8_avx2;
+                sads[Block8x4] = mvtools_sad_8x4_u8_avx2;
+                sadlimits[Block8x4] = mvtools_sad_limit_8x4_u8_avx2;
+                sadx3s[Block8x4] = mvtools_sad_x3_8x4_u8_avx2;
+                sadx4s[Block8x4] = mvtools_sad_x4_8x4_u8_avx2;
+                sadlumas[Block8x4] = mvtools_sad_luma_8x4_u8_avx2;
+                sads[Block8x8] = mvtools_sad_8x8_u8_avx2;
+                sadlimits[Block8x8] = mvtools_sad_limit_8x8_u8_avx2;
+                sadx3s[Block8x8] = mvtools_sad_x3_8x8_u8_avx2;
+                sadx4s[Block8x8] = mvtools_sad_x4_8x8_u8_avx2;
+                sadlumas[Block8x8] = mvtools_sad_luma_8x8_u8_avx2;
+                sads[Block8x16] = mvtools_sad_8x16_u8_avx2;
+                sadlimits[Block8x16] = mvtools_sad_limit_8x16_u8_avx2;
+                sadx3s[Block8x16] = mvtools_sad_x3_8x16_u8_avx2;
+                sadx4s[Block8x16] = mvtools_sad_x4_8x16_u8_avx2;
+                sadlumas[Block8x16] = mvtools_sad_luma_8x16_u8_avx2;
+                sads[Block8x32] = mvtools_sad_8x32_u8_avx2;
+                sadlimits[Block8x32] = mvtools_sad_limit_8x32_u8_avx2;
+                sadx3s[Block8x32] = mvtools_sad_x3_8x32_u8_avx2;
+                sadx4s[Block8x32] = mvtools_sad_x4_8x32_u8_avx2;
+                sadlumas[Block8x32] = mvtools_sad_luma_8x32_u8_avx2;
+                sads[Block16x1] = mvtools_sad_16x1_u8_avx2;
+                sadlimits[Block16x1] = mvtools_sad_limit_16x1_u8_avx2;
+                sadx3s[Block16x1] = mvtools_sad_x3_16x1_u8_avx2;
+                sadx4s[Block16x1] = mvtools_sad_x4_16x1_u8_avx2;
+                sadlumas[Block16x1] = mvtools_sad_luma_16x1_u8_avx2;
+                sads[Block16x2] = mvtools_sad_16x2_u8_avx2;
+                sadlimits[Block16x2] = mvtools_sad_limit_16x2_u8_avx2;
+                sadx3s[Block16x2] = mvtools_sad_x3_16x2_u8_avx2;
+                sadx4s[Block16x2] = mvtools_sad_x4_16x2_u8_avx2;
+                sadlumas[Block16x2] = mvtools_sad_luma_16x2_u8_avx2;
+                sads[Block16x4] = mvtools_sad_16x4_u8_avx2;
+                sadlimits[Block16x4] = mvtools_sad_limit_16x4_u8_avx2;
+                sadx3s[Block16x4] = mvtools_sad_x3_16x4_u8_avx2;
+                sadx4s[Block16x4] = mvtools_sad_x4_16x4_u8_avx2;
+                sadlumas[Block16x4] = mvtools_sad_luma_16x4_u8_avx2;
+                sads[Block16x8] = mvtools_sad_16x8_u8_avx2;
+                sadlimits[Block16x8] = mvtools_sad_limit_16x8_u8_avx2;
+                sadx3s[Block16x8] = mvtools_sad_x3_16x8_u8_avx2;
+                sadx4s[Block16x8] = mvtools_sad_x4_16x8_u8_avx2;
+                sadlumas[Block16x8] = mvtools_sad_luma_16x8_u8_avx2;
+                sads[Block16x16] = mvtools_sad_16x16_u8_avx2;
+                sadlimits[Block16x16] = mvtools_sad_limit_16x16_u8_avx2;
+                sadx3s[Block16x16] = mvtools_sad_x3_16x16_u8_avx2;
+                sadx4s[Block16x16] = mvtools_sad_x4_16x16_u8_avx2;
+                sadlumas[Block16x16] = mvtools_sad_luma_16x16_u8_avx2;
+                sads[Block16x32] = mvtools_sad_16x32_u8_avx2;
+                sadlimits[Block16x32] = mvtools_sad_limit_16x32_u8_avx2;
+                sadx3s[Block16x32] = mvtools_sad_x3_16x32_u8_avx2;
+                sadx4s[Block16x32] = mvtools_sad_x4_16x32_u8_avx2;
+                sadlumas[Block16x32] = mvtools_sad_luma_16x32_u8_avx2;
+                sads[Block16x64] = mvtools_sad_16x64_u8_avx2;
+                sadlimits[Block16x64] = mvtools_sad_limit_16x64_u8_avx2;
+                sadx3s[Block16x64] = mvtools_sad_x3_16x64_u8_avx2;
+                sadx4s[Block16x64] = mvtools_sad_x4_16x64_u8_avx2;
+                sadlumas[Block16x64] = mvtools_sad_luma_16x64_u8_avx2;
+                sads[Block32x4] = mvtools_sad_32x4_u8_avx2;
+                sadlimits[Block32x4] = mvtools_sad_limit_32x4_u8_avx2;
+                sadx3s[Block32x4] = mvtools_sad_x3_32x4_u8_avx2;
+                sadx4s[Block32x4] = mvtools_sad_x4_32x4_u8_avx2;
+                sadlumas[Block32x4] = mvtools_sad_luma_32x4_u8_avx2;
+                sads[Block32x8] = mvtools_sad_32x8_u8_avx2;
+                sadlimits[Block32x8] = mvtools_sad_limit_32x8_u8_avx2;
+                sadx3s[Block32x8] = mvtools_sad_x3_32x8_u8_avx2;
+                sadx4s[Block32x8] = mvtools_sad_x4_32x8_u8_avx2;
+                sadlumas[Block32x8] = mvtools_sad_luma_32x8_u8_avx2;
+                sads[Block32x16] = mvtools_sad_32x16_u8_avx2;
+                sadlimits[Block32x16] = mvtools_sad_limit_32x16_u8_avx2;
+                sadx3s[Block32x16] = mvtools_sad_x3_32x16_u8_avx2;
+                sadx4s[Block32x16] = mvtools_sad_x4_32x16_u8_avx2;
+                sadlumas[Block32x16] = mvtools_sad_luma_32x16_u8_avx2;
+                sads[Block32x32] = mvtools_sad_32x32_u8_avx2;
+                sadlimits[Block32x32] = mvtools_sad_limit_32x32_u8_avx2;
+                sadx3s[Block32x32] = mvtools_sad_x3_32x32_u8_avx2;
+                sadx4s[Block32x32] = mvtools_sad_x4_32x32_u8_avx2;
+                sadlumas[Block32x32] = mvtools_sad_luma_32x32_u8_avx2;
+                sads[Block32x64] = mvtools_sad_32x64_u8_avx2;
+                sadlimits[Block32x64] = mvtools_sad_limit_32x64_u8_avx2;
+                sadx3s[Block32x64] = mvtools_sad_x3_32x64_u8_avx2;
+                sadx4s[Block32x64] = mvtools_sad_x4_32x64_u8_avx2;
+                sadlumas[Block32x64] = mvtools_sad_luma_32x64_u8_avx2;
+                sads[Block64x8] = mvtools_sad_64x8_u8_avx2;
+                sadlimits[Block64x8] = mvtools_sad_limit_64x8_u8_avx2;
+                sadx3s[Block64x8] = mvtools_sad_x3_64x8_u8_avx2;
+                sadx4s[Block64x8] = mvtools_sad_x4_64x8_u8_avx2;
+                sadlumas[Block64x8] = mvtools_sad_luma_64x8_u8_avx2;
+                sads[Block64x16] = mvtools_sad_64x16_u8_avx2;
+                sadlimits[Block64x16] = mvtools_sad_limit_64x16_u8_avx2;
+                sadx3s[Block64x16] = mvtools_sad_x3_64x16_u8_avx2;
+                sadx4s[Block64x16] = mvtools_sad_x4_64x16_u8_avx2;
+                sadlumas[Block64x16] = mvtools_sad_luma_64x16_u8_avx2;
+                sads[Block64x32] = mvtools_sad_64x32_u8_avx2;
+                sadlimits[Block64x32] = mvtools_sad_limit_64x32_u8_avx2;
+                sadx3s[Block64x32] = mvtools_sad_x3_64x32_u8_avx2;
+                sadx4s[Block64x32] = mvtools_sad_x4_64x32_u8_avx2;
+                sadlumas[Block64x32] = mvtools_sad_luma_64x32_u8_avx2;
+                sads[Block64x64] = mvtools_sad_64x64_u8_avx2;
+                sadlimits[Block64x64] = mvtools_sad_limit_64x64_u8_avx2;
+                sadx3s[Block64x64] = mvtools_sad_x3_64x64_u8_avx2;
+                sadx4s[Block64x64] = mvtools_sad_x4_64x64_u8_avx2;
+                sadlumas[Block64x64] = mvtools_sad_luma_64x64_u8_avx2;
             }
 #endif
         }
     } else {
-        sads[2][2] = mvtools_sad_2x2_u16_c;
-        blits[2][2] = mvtools_copy_2x2_u16_c;
+        sads[Block2x2] = mvtools_sad_2x2_u16_c;
+        sadlimits[Block2x2] = mvtools_sad_limit_2x2_u16_c;
+        sadx3s[Block2x2] = mvtools_sad_x3_2x2_u16_c;
+        sadx4s[Block2x2] = mvtools_sad_x4_2x2_u16_c;
+        sadlumas[Block2x2] = mvtools_sad_luma_2x2_u16_c;
+        lumas[Block2x2] = mvtools_luma_2x2_u16_c;
+        blits[Block2x2] = mvtools_copy_2x2_u16_c;
+
+        sads[Block2x4] = mvtools_sad_2x4_u16_c;
+        sadlimits[Block2x4] = mvtools_sad_limit_2x4_u16_c;
+        sadx3s[Block2x4] = mvtools_sad_x3_2x4_u16_c;
+        sadx4s[Block2x4] = mvtools_sad_x4_2x4_u16_c;
+        sadlumas[Block2x4] = mvtools_sad_luma_2x4_u16_c;
+        lumas[Block2x4] = mvtools_luma_2x4_u16_c;
+        blits[Block2x4] = mvtools_copy_2x4_u16_c;
+
+        sads[Block4x2] = mvtools_sad_4x2_u16_c;
+        sadlimits[Block4x2] = mvtools_sad_limit_4x2_u16_c;
+        sadx3s[Block4x2] = mvtools_sad_x3_4x2_u16_c;
+        sadx4s[Block4x2] = mvtools_sad_x4_4x2_u16_c;
+        sadlumas[Block4x2] = mvtools_sad_luma_4x2_u16_c;
+        lumas[Block4x2] = mvtools_luma_4x2_u16_c;
+        blits[Block4x2] = mvtools_copy_4x2_u16_c;
+
+        sads[Block4x4] = mvtools_sad_4x4_u16_c;
+        sadlimits[Block4x4] = mvtools_sad_limit_4x4_u16_c;
+        sadx3s[Block4x4] = mvtools_sad_x3_4x4_u16_c;
+        sadx4s[Block4x4] = mvtools_sad_x4_4x4_u16_c;
+        sadlumas[Block4x4] = mvtools_sad_luma_4x4_u16_c;
+        lumas[Block4x4] = mvtools_luma_4x4_u16_c;
+        blits[Block4x4] = mvtools_copy_4x4_u16_c;
+        satds[Block4x4] = mvtools_satd_4x4_u16_c;
+
+        sads[Block4x8] = mvtools_sad_4x8_u16_c;
+        sadlimits[Block4x8] = mvtools_sad_limit_4x8_u16_c;
+        sadx3s[Block4x8] = mvtools_sad_x3_4x8_u16_c;
+        sadx4s[Block4x8] = mvtools_sad_x4_4x8_u16_c;
+        sadlumas[Block4x8] = mvtools_sad_luma_4x8_u16_c;
+        lumas[Block4x8] = mvtools_luma_4x8_u16_c;
+        blits[Block4x8] = mvtools_copy_4x8_u16_c;
+        satds[Block4x8] = mvtools_satd_4x8_u16_c;
+
+        sads[Block4x16] = mvtools_sad_4x16_u16_c;
+        sadlimits[Block4x16] = mvtools_sad_limit_4x16_u16_c;
+        sadx3s[Block4x16] = mvtools_sad_x3_4x16_u16_c;
+        sadx4s[Block4x16] = mvtools_sad_x4_4x16_u16_c;
+        sadlumas[Block4x16] = mvtools_sad_luma_4x16_u16_c;
+        lumas[Block4x16] = mvtools_luma_4x16_u16_c;
+        blits[Block4x16] = mvtools_copy_4x16_u16_c;
+        satds[Block4x16] = mvtools_satd_4x16_u16_c;
+
+        sads[Block8x1] = mvtools_sad_8x1_u16_c;
+        sadlimits[Block8x1] = mvtools_sad_limit_8x1_u16_c;
+        sadx3s[Block8x1] = mvtools_sad_x3_8x1_u16_c;
+        sadx4s[Block8x1] = mvtools_sad_x4_8x1_u16_c;
+        sadlumas[Block8x1] = mvtools_sad_luma_8x1_u16_c;
+        lumas[Block8x1] = mvtools_luma_8x1_u16_c;
+        blits[Block8x1] = mvtools_copy_8x1_u16_c;
+
+        sads[Block8x2] = mvtools_sad_8x2_u16_c;
+        sadlimits[Block8x2] = mvtools_sad_limit_8x2_u16_c;
+        sadx3s[Block8x2] = mvtools_sad_x3_8x2_u16_c;
+        sadx4s[Block8x2] = mvtools_sad_x4_8x2_u16_c;
+        sadlumas[Block8x2] = mvtools_sad_luma_8x2_u16_c;
+        lumas[Block8x2] = mvtools_luma_8x2_u16_c;
+        blits[Block8x2] = mvtools_copy_8x2_u16_c;
+
+        sads[Block8x4] = mvtools_sad_8x4_u16_c;
+        sadlimits[Block8x4] = mvtools_sad_limit_8x4_u16_c;
+        sadx3s[Block8x4] = mvtools_sad_x3_8x4_u16_c;
+        sadx4s[Block8x4] = mvtools_sad_x4_8x4_u16_c;
+        sadlumas[Block8x4] = mvtools_sad_luma_8x4_u16_c;
+        lumas[Block8x4] = mvtools_luma_8x4_u16_c;
+        blits[Block8x4] = mvtools_copy_8x4_u16_c;
+        satds[Block8x4] = mvtools_satd_8x4_u16_c;
+
+        sads[Block8x8] = mvtools_sad_8x8_u16_c;
+        sadlimits[Block8x8] = mvtools_sad_limit_8x8_u16_c;
+        sadx3s[Block8x8] = mvtools_sad_x3_8x8_u16_c;
+        sadx4s[Block8x8] = mvtools_sad_x4_8x8_u16_c;
+        sadlumas[Block8x8] = mvtools_sad_luma_8x8_u16_c;
+        lumas[Block8x8] = mvtools_luma_8x8_u16_c;
+        blits[Block8x8] = mvtools_copy_8x8_u16_c;
+        satds[Block8x8] = mvtools_satd_8x8_u16_c;
+
+        sads[Block8x16] = mvtools_sad_8x16_u16_c;
+        sadlimits[Block8x16] = mvtools_sad_limit_8x16_u16_c;
+        sadx3s[Block8x16] = mvtools_sad_x3_8x16_u16_c;
+        sadx4s[Block8x16] = mvtools_sad_x4_8x16_u16_c;
+        sadlumas[Block8x16] = mvtools_sad_luma_8x16_u16_c;
+        lumas[Block8x16] = mvtools_luma_8x16_u16_c;
+        blits[Block8x16] = mvtools_copy_8x16_u16_c;
+        satds[Block8x16] = mvtools_satd_8x16_u16_c;
+
+        sads[Block8x32] = mvtools_sad_8x32_u16_c;
+        sadlimits[Block8x32] = mvtools_sad_limit_8x32_u16_c;
+        sadx3s[Block8x32] = mvtools_sad_x3_8x32_u16_c;
+        sadx4s[Block8x32] = mvtools_sad_x4_8x32_u16_c;
+        sadlumas[Block8x32] = mvtools_sad_luma_8x32_u16_c;
+        lumas[Block8x32] = mvtools_luma_8x32_u16_c;
+        blits[Block8x32] = mvtools_copy_8x32_u16_c;
+        satds[Block8x32] = mvtools_satd_8x32_u16_c;
+
+        sads[Block16x1] = mvtools_sad_16x1_u16_c;
+        sadlimits[Block16x1] = mvtools_sad_limit_16x1_u16_c;
+        sadx3s[Block16x1] = mvtools_sad_x3_16x1_u16_c;
+        sadx4s[Block16x1] = mvtools_sad_x4_16x1_u16_c;
+        sadlumas[Block16x1] = mvtools_sad_luma_16x1_u16_c;
+        lumas[Block16x1] = mvtools_luma_16x1_u16_c;
+        blits[Block16x1] = mvtools_copy_16x1_u16_c;
+
+        sads[Block16x2] = mvtools_sad_16x2_u16_c;
+        sadlimits[Block16x2] = mvtools_sad_limit_16x2_u16_c;
+        sadx3s[Block16x2] = mvtools_sad_x3_16x2_u16_c;
+        sadx4s[Block16x2] = mvtools_sad_x4_16x2_u16_c;
+        sadlumas[Block16x2] = mvtools_sad_luma_16x2_u16_c;
+        lumas[Block16x2] = mvtools_luma_16x2_u16_c;
+        blits[Block16x2] = mvtools_copy_16x2_u16_c;
+
+        sads[Block16x4] = mvtools_sad_16x4_u16_c;
+        sadlimits[Block16x4] = mvtools_sad_limit_16x4_u16_c;
+        sadx3s[Block16x4] = mvtools_sad_x3_16x4_u16_c;
+        sadx4s[Block16x4] = mvtools_sad_x4_16x4_u16_c;
+        sadlumas[Block16x4] = mvtools_sad_luma_16x4_u16_c;
+        lumas[Block16x4] = mvtools_luma_16x4_u16_c;
+        blits[Block16x4] = mvtools_copy_16x4_u16_c;
+        satds[Block16x4] = mvtools_satd_16x4_u16_c;
+
+        sads[Block16x8] = mvtools_sad_16x8_u16_c;
+        sadlimits[Block16x8] = mvtools_sad_limit_16x8_u16_c;
+        sadx3s[Block16x8] = mvtools_sad_x3_16x8_u16_c;
+        sadx4s[Block16x8] = mvtools_sad_x4_16x8_u16_c;
+        sadlumas[Block16x8] = mvtools_sad_luma_16x8_u16_c;
+        lumas[Block16x8] = mvtools_luma_16x8_u16_c;
+        blits[Block16x8] = mvtools_copy_16x8_u16_c;
+        satds[Block16x8] = mvtools_satd_16x8_u16_c;
+
+        sads[Block16x16] = mvtools_sad_16x16_u16_c;
+        sadlimits[Block16x16] = mvtools_sad_limit_16x16_u16_c;
+        sadx3s[Block16x16] = mvtools_sad_x3_16x16_u16_c;
+        sadx4s[Block16x16] = mvtools_sad_x4_16x16_u16_c;
+        sadlumas[Block16x16] = mvtools_sad_luma_16x16_u16_c;
+        lumas[Block16x16] = mvtools_luma_16x16_u16_c;
+        blits[Block16x16] = mvtools_copy_16x16_u16_c;
+        satds[Block16x16] = mvtools_satd_16x16_u16_c;
+
+        sads[Block16x32] = mvtools_sad_16x32_u16_c;
+        sadlimits[Block16x32] = mvtools_sad_limit_16x32_u16_c;
+        sadx3s[Block16x32] = mvtools_sad_x3_16x32_u16_c;
+        sadx4s[Block16x32] = mvtools_sad_x4_16x32_u16_c;
+        sadlumas[Block16x32] = mvtools_sad_luma_16x32_u16_c;
+        lumas[Block16x32] = mvtools_luma_16x32_u16_c;
+        blits[Block16x32] = mvtools_copy_16x32_u16_c;
+        satds[Block16x32] = mvtools_satd_16x32_u16_c;
+
+        sads[Block16x64] = mvtools_sad_16x64_u16_c;
+        sadlimits[Block16x64] = mvtools_sad_limit_16x64_u16_c;
+        sadx3s[Block16x64] = mvtools_sad_x3_16x64_u16_c;
+        sadx4s[Block16x64] = mvtools_sad_x4_16x64_u16_c;
+        sadlumas[Block16x64] = mvtools_sad_luma_16x64_u16_c;
+        lumas[Block16x64] = mvtools_luma_16x64_u16_c;
+        blits[Block16x64] = mvtools_copy_16x64_u16_c;
+        satds[Block16x64] = mvtools_satd_16x64_u16_c;
+
+        sads[Block32x4] = mvtools_sad_32x4_u16_c;
+        sadlimits[Block32x4] = mvtools_sad_limit_32x4_u16_c;
+        sadx3s[Block32x4] = mvtools_sad_x3_32x4_u16_c;
+        sadx4s[Block32x4] = mvtools_sad_x4_32x4_u16_c;
+        sadlumas[Block32x4] = mvtools_sad_luma_32x4_u16_c;
+        lumas[Block32x4] = mvtools_luma_32x4_u16_c;
+        blits[Block32x4] = mvtools_copy_32x4_u16_c;
+        satds[Block32x4] = mvtools_satd_32x4_u16_c;
+
+        sads[Block32x8] = mvtools_sad_32x8_u16_c;
+        sadlimits[Block32x8] = mvtools_sad_limit_32x8_u16_c;
+        sadx3s[Block32x8] = mvtools_sad_x3_32x8_u16_c;
+        sadx4s[Block32x8] = mvtools_sad_x4_32x8_u16_c;
+        sadlumas[Block32x8] = mvtools_sad_luma_32x8_u16_c;
+        lumas[Block32x8] = mvtools_luma_32x8_u16_c;
+        blits[Block32x8] = mvtools_copy_32x8_u16_c;
+        satds[Block32x8] = mvtools_satd_32x8_u16_c;
+
+        sads[Block32x16] = mvtools_sad_32x16_u16_c;
+        sadlimits[Block32x16] = mvtools_sad_limit_32x16_u16_c;
+        sadx3s[Block32x16] = mvtools_sad_x3_32x16_u16_c;
+        sadx4s[Block32x16] = mvtools_sad_x4_32x16_u16_c;
+        sadlumas[Block32x16] = mvtools_sad_luma_32x16_u16_c;
+        lumas[Block32x16] = mvtools_luma_32x16_u16_c;
+        blits[Block32x16] = mvtools_copy_32x16_u16_c;
+        satds[Block32x16] = mvtools_satd_32x16_u16_c;
+
+        sads[Block32x32] = mvtools_sad_32x32_u16_c;
+        sadlimits[Block32x32] = mvtools_sad_limit_32x32_u16_c;
+        sadx3s[Block32x32] = mvtools_sad_x3_32x32_u16_c;
+        sadx4s[Block32x32] = mvtools_sad_x4_32x32_u16_c;
+        sadlumas[Block32x32] = mvtools_sad_luma_32x32_u16_c;
+        lumas[Block32x32] = mvtools_luma_32x32_u16_c;
+        blits[Block32x32] = mvtools_copy_32x32_u16_c;
+        satds[Block32x32] = mvtools_satd_32x32_u16_c;
+
+        sads[Block32x64] = mvtools_sad_32x64_u16_c;
+        sadlimits[Block32x64] = mvtools_sad_limit_32x64_u16_c;
+        sadx3s[Block32x64] = mvtools_sad_x3_32x64_u16_c;
+        sadx4s[Block32x64] = mvtools_sad_x4_32x64_u16_c;
+        sadlumas[Block32x64] = mvtools_sad_luma_32x64_u16_c;
+        lumas[Block32x64] = mvtools_luma_32x64_u16_c;
+        blits[Block32x64] = mvtools_copy_32x64_u16_c;
+        satds[Block32x64] = mvtools_satd_32x64_u16_c;
+
+        sads[Block64x8] = mvtools_sad_64x8_u16_c;
+        sadlimits[Block64x8] = mvtools_sad_limit_64x8_u16_c;
+        sadx3s[Block64x8] = mvtools_sad_x3_64x8_u16_c;
+        sadx4s[Block64x8] = mvtools_sad_x4_64x8_u16_c;
+        sadlumas[Block64x8] = mvtools_sad_luma_64x8_u16_c;
+        lumas[Block64x8] = mvtools_luma_64x8_u16_c;
+        blits[Block64x8] = mvtools_copy_64x8_u16_c;
+        satds[Block64x8] = mvtools_satd_64x8_u16_c;
+
+        sads[Block64x16] = mvtools_sad_64x16_u16_c;
+        sadlimits[Block64x16] = mvtools_sad_limit_64x16_u16_c;
+        sadx3s[Block64x16] = mvtools_sad_x3_64x16_u16_c;
+        sadx4s[Block64x16] = mvtools_sad_x4_64x16_u16_c;
+        sadlumas[Block64x16] = mvtools_sad_luma_64x16_u16_c;
+        lumas[Block64x16] = mvtools_luma_64x16_u16_c;
+        blits[Block64x16] = mvtools_copy_64x16_u16_c;
+        satds[Block64x16] = mvtools_satd_64x16_u16_c;
+
+        sads[Block64x32] = mvtools_sad_64x32_u16_c;
+        sadlimits[Block64x32] = mvtools_sad_limit_64x32_u16_c;
+        sadx3s[Block64x32] = mvtools_sad_x3_64x32_u16_c;
+        sadx4s[Block64x32] = mvtools_sad_x4_64x32_u16_c;
+        sadlumas[Block64x32] = mvtools_sad_luma_64x32_u16_c;
+        lumas[Block64x32] = mvtools_luma_64x32_u16_c;
+        blits[Block64x32] = mvtools_copy_64x32_u16_c;
+        satds[Block64x32] = mvtools_satd_64x32_u16_c;
+
+        sads[Block64x64] = mvtools_sad_64x64_u16_c;
+        sadlimits[Block64x64] = mvtools_sad_limit_64x64_u16_c;
+        sadx3s[Block64x64] = mvtools_sad_x3_64x64_u16_c;
+        sadx4s[Block64x64] = mvtools_sad_x4_64x64_u16_c;
+        sadlumas[Block64x64] = mvtools_sad_luma_64x64_u16_c;
+        lumas[Block64x64] = mvtools_luma_64x64_u16_c;
+        blits[Block64x64] = mvtools_copy_64x64_u16_c;
+        satds[Block64x64] = mvtools_satd_64x64_u16_c;
 
-        sads[2][4] = mvtools_sad_2x4_u16_c;
-        blits[2][4] = mvtools_copy_2x4_u16_c;
+        if (pob->isse) {
+#if defined(MVTOOLS_X86)
+            useExtraSADs = 0;
+
+            sads[Block2x2] = mvtools_sad_2x2_u16_sse2;
+            sads[Block2x4] = mvtools_sad_2x4_u16_sse2;
+            sads[Block4x2] = mvtools_sad_4x2_u16_sse2;
+            sads[Block4x4] = mvtools_sad_4x4_u16_sse2;
+            sads[Block4x8] = mvtools_sad_4x8_u16_sse2;
+            sads[Block8x1] = mvtools_sad_8x1_u16_sse2;
+            sads[Block8x2] = mvtools_sad_8x2_u16_sse2;
+            sads[Block8x4] = mvtools_sad_8x4_u16_sse2;
+            sads[Block8x8] = mvtools_sad_8x8_u16_sse2;
+            sads[Block8x16] = mvtools_sad_8x16_u16_sse2;
+            sads[Block16x1] = mvtools_sad_16x1_u16_sse2;
+            sads[Block16x2] = mvtools_sad_16x2_u16_sse2;
+            sads[Block16x4] = mvtools_sad_16x4_u16_sse2;
+            sads[Block16x8] = mvtools_sad_16x8_u16_sse2;
+            sads[Block16x16] = mvtools_sad_16x16_u16_sse2;
+            sads[Block16x32] = mvtools_sad_16x32_u16_sse2;
+            sads[Block32x8] = mvtools_sad_32x8_u16_sse2;
+            sads[Block32x16] = mvtools_sad_32x16_u16_sse2;
+            sads[Block32x32] = mvtools_sad_32x32_u16_sse2;
 
-        sads[4][2] = mvtools_sad_4x2_u16_c;
-        blits[4][2] = mvtools_copy_4x2_u16_c;
+            if (pob->nCPUFlags & X264_CPU_AVX2) {
+                useExtraSADs = 1;
+
+                sads[Block2x2] = mvtools_sad_2x2_u16_avx2;
+                sadlimits[Block2x2] = mvtools_sad_limit_2x2_u16_avx2;
+                sadx3s[Block2x2] = mvtools_sad_x3_2x2_u16_avx2;
+                sadx4s[Block2x2] = mvtools_sad_x4_2x2_u16_avx2;
+                sadlumas[Block2x2] = mvtools_sad_luma_2x2_u16_avx2;
+                sads[Block2x4] = mvtools_sad_2x4_u16_avx2;
+                sadlimits[Block2x4] = mvtools_sad_limit_2x4_u16_avx2;
+                sadx3s[Block2x4] = mvtools_sad_x3_2x4_u16_avx2;
+                sadx4s[Block2x4] = mvtools_sad_x4_2x4_u16_avx2;
+                sadlumas[Block2x4] = mvtools_sad_luma_2x4_u16_avx2;
+                sads[Block4x2] = mvtools_sad_4x2_u16_avx2;
+                sadlimits[Block4x2] = mvtools_sad_limit_4x2_u16_avx2;
+                sadx3s[Block4x2] = mvtools_sad_x3_4x2_u16_avx2;
+                sadx4s[Block4x2] = mvtools_sad_x4_4x2_u16_avx2;
+                sadlumas[Block4x2] = mvtools_sad_luma_4x2_u16_avx2;
+                sads[Block4x4] = mvtools_sad_4x4_u16_avx2;
+                sadlimits[Block4x4] = mvtools_sad_limit_4x4_u16_avx2;
+                sadx3s[Block4x4] = mvtools_sad_x3_4x4_u16_avx2;
+                sadx4s[Block4x4] = mvtools_sad_x4_4x4_u16_avx2;
+                sadlumas[Block4x4] = mvtools_sad_luma_4x4_u16_avx2;
+                sads[Block4x8] = mvtools_sad_4x8_u16_avx2;
+                sadlimits[Block4x8] = mvtools_sad_limit_4x8_u16_avx2;
+                sadx3s[Block4x8] = mvtools_sad_x3_4x8_u16_avx2;
+                sadx4s[Block4x8] = mvtools_sad_x4_4x8_u16_avx2;
+                sadlumas[Block4x8] = mvtools_sad_luma_4x8_u16_avx2;
+                sads[Block4x16] = mvtools_sad_4x16_u16_avx2;
+                sadlimits[Block4x16] = mvtools_sad_limit_4x16_u16_avx2;
+                sadx3s[Block4x16] = mvtools_sad_x3_4x16_u16_avx2;
+                sadx4s[Block4x16] = mvtools_sad_x4_4x16_u16_avx2;
+                sadlumas[Block4x16] = mvtools_sad_luma_4x16_u16_avx2;
+                sads[Block8x1] = mvtools_sad_8x1_u16_avx2;
+                sadlimits[Block8x1] = mvtools_sad_limit_8x1_u16_avx2;
+                sadx3s[Block8x1] = mvtools_sad_x3_8x1_u16_avx2;
+                sadx4s[Block8x1] = mvtools_sad_x4_8x1_u16_avx2;
+                sadlumas[Block8x1] = mvtools_sad_luma_8x1_u16_avx2;
+                sads[Block8x2] = mvtools_sad_8x2_u16_avx2;
+                sadlimits[Block8x2] = mvtools_sad_limit_8x2_u16_avx2;
+                sadx3s[Block8x2] = mvtools_sad_x3_8x2_u16_avx2;
+                sadx4s[Block8x2] = mvtools_sad_x4_8x2_u16_avx2;
+                sadlumas[Block8x2] = mvtools_sad_luma_8x2_u16_avx2;
+                sads[Block8x4] = mvtools_sad_8x4_u16_avx2;
+                sadlimits[Block8x4] = mvtools_sad_limit_8x4_u16_avx2;
+                sadx3s[Block8x4] = mvtools_sad_x3_8x4_u16_avx2;
+                sadx4s[Block8x4] = mvtools_sad_x4_8x4_u16_avx2;
+                sadlumas[Block8x4] = mvtools_sad_luma_8x4_u16_avx2;
+                sads[Block8x8] = mvtools_sad_8x8_u16_avx2;
+                sadlimits[Block8x8] = mvtools_sad_limit_8x8_u16_avx2;
+                sadx3s[Block8x8] = mvtools_sad_x3_8x8_u16_avx2;
+                sadx4s[Block8x8] = mvtools_sad_x4_8x8_u16_avx2;
+                sadlumas[Block8x8] = mvtools_sad_luma_8x8_u16_avx2;
+                sads[Block8x16] = mvtools_sad_8x16_u16_avx2;
+                sadlimits[Block8x16] = mvtools_sad_limit_8x16_u16_avx2;
+                sadx3s[Block8x16] = mvtools_sad_x3_8x16_u16_avx2;
+                sadx4s[Block8x16] = mvtools_sad_x4_8x16_u16_avx2;
+                sadlumas[Block8x16] = mvtools_sad_luma_8x16_u16_avx2;
+                sads[Block8x32] = mvtools_sad_8x32_u16_avx2;
+                sadlimits[Block8x32] = mvtools_sad_limit_8x32_u16_avx2;
+                sadx3s[Block8x32] = mvtools_sad_x3_8x32_u16_avx2;
+                sadx4s[Block8x32] = mvtools_sad_x4_8x32_u16_avx2;
+                sadlumas[Block8x32] = mvtools_sad_luma_8x32_u16_avx2;
+                sads[Block16x1] = mvtools_sad_16x1_u16_avx2;
+                sadlimits[Block16x1] = mvtools_sad_limit_16x1_u16_avx2;
+                sadx3s[Block16x1] = mvtools_sad_x3_16x1_u16_avx2;
+                sadx4s[Block16x1] = mvtools_sad_x4_16x1_u16_avx2;
+                sadlumas[Block16x1] = mvtools_sad_luma_16x1_u16_avx2;
+                sads[Block16x2] = mvtools_sad_16x2_u16_avx2;
+                sadlimits[Block16x2] = mvtools_sad_limit_16x2_u16_avx2;
+                sadx3s[Block16x2] = mvtools_sad_x3_16x2_u16_avx2;
+                sadx4s[Block16x2] = mvtools_sad_x4_16x2_u16_avx2;
+                sadlumas[Block16x2] = mvtools_sad_luma_16x2_u16_avx2;
+                sads[Block16x4] = mvtools_sad_16x4_u16_avx2;
+                sadlimits[Block16x4] = mvtools_sad_limit_16x4_u16_avx2;
+                sadx3s[Block16x4] = mvtools_sad_x3_16x4_u16_avx2;
+                sadx4s[Block16x4] = mvtools_sad_x4_16x4_u16_avx2;
+                sadlumas[Block16x4] = mvtools_sad_luma_16x4_u16_avx2;
+                sads[Block16x8] = mvtools_sad_16x8_u16_avx2;
+                sadlimits[Block16x8] = mvtools_sad_limit_16x8_u16_avx2;
+                sadx3s[Block16x8] = mvtools_sad_x3_16x8_u16_avx2;
+                sadx4s[Block16x8] = mvtools_sad_x4_16x8_u16_avx2;
+                sadlumas[Block16x8] = mvtools_sad_luma_16x8_u16_avx2;
+                sads[Block16x16] = mvtools_sad_16x16_u16_avx2;
+                sadlimits[Block16x16] = mvtools_sad_limit_16x16_u16_avx2;
+                sadx3s[Block16x16] = mvtools_sad_x3_16x16_u16_avx2;
+                sadx4s[Block16x16] = mvtools_sad_x4_16x16_u16_avx2;
+                sadlumas[Block16x16] = mvtools_sad_luma_16x16_u16_avx2;
+                sads[Block16x32] = mvtools_sad_16x32_u16_avx2;
+                sadlimits[Block16x32] = mvtools_sad_limit_16x32_u16_avx2;
+                sadx3s[Block16x32] = mvtools_sad_x3_16x32_u16_avx2;
+                sadx4s[Block16x32] = mvtools_sad_x4_16x32_u16_avx2;
+                sadlumas[Block16x32] = mvtools_sad_luma_16x32_u16_avx2;
+                sads[Block16x64] = mvtools_sad_16x64_u16_avx2;
+                sadlimits[Block16x64] = mvtools_sad_limit_16x64_u16_avx2;
+                sadx3s[Block16x64] = mvtools_sad_x3_16x64_u16_avx2;
+                sadx4s[Block16x64] = mvtools_sad_x4_16x64_u16_avx2;
+                sadlumas[Block16x64] = mvtools_sad_luma_16x64_u16_avx2;
+                sads[Block32x4] = mvtools_sad_32x4_u16_avx2;
+                sadlimits[Block32x4] = mvtools_sad_limit_32x4_u16_avx2;
+                sadx3s[Block32x4] = mvtools_sad_x3_32x4_u16_avx2;
+                sadx4s[Block32x4] = mvtools_sad_x4_32x4_u16_avx2;
+                sadlumas[Block32x4] = mvtools_sad_luma_32x4_u16_avx2;
+                sads[Block32x8] = mvtools_sad_32x8_u16_avx2;
+                sadlimits[Block32x8] = mvtools_sad_limit_32x8_u16_avx2;
+                sadx3s[Block32x8] = mvtools_sad_x3_32x8_u16_avx2;
+                sadx4s[Block32x8] = mvtools_sad_x4_32x8_u16_avx2;
+                sadlumas[Block32x8] = mvtools_sad_luma_32x8_u16_avx2;
+                sads[Block32x16] = mvtools_sad_32x16_u16_avx2;
+                sadlimits[Block32x16] = mvtools_sad_limit_32x16_u16_avx2;
+                sadx3s[Block32x16] = mvtools_sad_x3_32x16_u16_avx2;
+                sadx4s[Block32x16] = mvtools_sad_x4_32x16_u16_avx2;
+                sadlumas[Block32x16] = mvtools_sad_luma_32x16_u16_avx2;
+                sads[Block32x32] = mvtools_sad_32x32_u16_avx2;
+                sadlimits[Block32x32] = mvtools_sad_limit_32x32_u16_avx2;
+                sadx3s[Block32x32] = mvtools_sad_x3_32x32_u16_avx2;
+                sadx4s[Block32x32] = mvtools_sad_x4_32x32_u16_avx2;
+                sadlumas[Block32x32] = mvtools_sad_luma_32x32_u16_avx2;
+                sads[Block32x64] = mvtools_sad_32x64_u16_avx2;
+                sadlimits[Block32x64] = mvtools_sad_limit_32x64_u16_avx2;
+                sadx3s[Block32x64] = mvtools_sad_x3_32x64_u16_avx2;
+                sadx4s[Block32x64] = mvtools_sad_x4_32x64_u16_avx2;
+                sadlumas[Block32x64] = mvtools_sad_luma_32x64_u16_avx2;
+                sads[Block64x8] = mvtools_sad_64x8_u16_avx2;
+                sadlimits[Block64x8] = mvtools_sad_limit_64x8_u16_avx2;
+                sadx3s[Block64x8] = mvtools_sad_x3_64x8_u16_avx2;
+                sadx4s[Block64x8] = mvtools_sad_x4_64x8_u16_avx2;
+                sadlumas[Block64x8] = mvtools_sad_luma_64x8_u16_avx2;
+                sads[Block64x16] = mvtools_sad_64x16_u16_avx2;
+                sadlimits[Block64x16] = mvtools_sad_limit_64x16_u16_avx2;
+                sadx3s[Block64x16] = mvtools_sad_x3_64x16_u16_avx2;
+                sadx4s[Block64x16] = mvtools_sad_x4_64x16_u16_avx2;
+                sadlumas[Block64x16] = mvtools_sad_luma_64x16_u16_avx2;
+                sads[Block64x32] = mvtools_sad_64x32_u16_avx2;
+                sadlimits[Block64x32] = mvtools_sad_limit_64x32_u16_avx2;
+                sadx3s[Block64x32] = mvtools_sad_x3_64x32_u16_avx2;
+                sadx4s[Block64x32] = mvtools_sad_x4_64x32_u16_avx2;
+                sadlumas[Block64x32] = mvtools_sad_luma_64x32_u16_avx2;
+                sads[Block64x64] = mvtools_sad_64x64_u16_avx2;
+                sadlimits[Block64x64] = mvtools_sad_limit_64x64_u16_avx2;
+                sadx3s[Block64x64] = mvtools_sad_x3_64x64_u16_avx2;
+                sadx4s[Block64x64] = mvtools_sad_x4_64x64_u16_avx2;
+                sadlumas[Block64x64] = mvtools_sad_luma_64x64_u16_avx2;
+            }
+#endif
+        }
+    }
 
-        sads[4][4] = mvtools_sad_4x4_u16_c;
-        lumas[4][4] = mvtools_luma_4x4_u16_c;
-        blits[4][4] = mvtools_copy_4x4_u16_c;
-        satds[4][4] = mvtools_satd_4x4_u16_c;
 
-        sads[4][8] = mvtools_sad_4x8_u16_c;
-        blits[4][8] = mvtools_copy_4x8_u16_c;
+    int size = findBlockSize(pob->nBlkSizeX, pob->nBlkSizeY);
+    int chromaSize = findBlockSize(pob->nBlkSizeX / pob->xRatioUV, pob->nBlkSizeY / pob->yRatioUV);
 
-        sads[8][1] = mvtools_sad_8x1_u16_c;
-        blits[8][1] = mvtools_copy_8x1_u16_c;
+    pob->SAD = sads[size];
+    pob->LUMA = lumas[size];
+    pob->BLITLUMA = blits[size];
 
-        sads[8][2] = mvtools_sad_8x2_u16_c;
-        blits[8][2] = mvtools_copy_8x2_u16_c;
+    pob->SADCHROMA = sads[chromaSize];
+    pob->BLITCHROMA = blits[chromaSize];
 
-        sads[8][4] = mvtools_sad_8x4_u16_c;
-        lumas[8][4] = mvtools_luma_8x4_u16_c;
-        blits[8][4] = mvtools_copy_8x4_u16_c;
-        satds[8][4] = mvtools_satd_8x4_u16_c;
+    pob->SATD = satds[size];
 
-        sads[8][8] = mvtools_sad_8x8_u16_c;
-        lumas[8][8] = mvtools_luma_8x8_u16_c;
-        blits[8][8] = mvtools_copy_8x8_u16_c;
-        satds[8][8] = mvtools_satd_8x8_u16_c;
+    pob->SADLIMIT = useExtraSADs ? sadlimits[size] : NULL;
+    pob->SADCHROMALIMIT = useExtraSADs ? sadlimits[chromaSize] : NULL;
 
-        sads[8][16] = mvtools_sad_8x16_u16_c;
-        blits[8][16] = mvtools_copy_8x16_u16_c;
+    pob->SADX3 = useExtraSADs ? sadx3s[size] : NULL;
+    pob->SADX4 = useExtraSADs ? sadx4s[size] : NULL;
 
-        sads[16][1] = mvtools_sad_16x1_u16_c;
-        blits[16][1] = mvtools_copy_16x1_u16_c;
+    pob->SADLUMA = useExtraSADs ? sadlumas[size] : NULL;
+}
 
-        sads[16][2] = mvtools_sad_16x2_u16_c;
-        lumas[16][2] = mvtools_luma_16x2_u16_c;
-        blits[16][2] = mvtools_copy_16x2_u16_c;
 
-        sads[16][4] = mvtools_sad_16x4_u16_c;
-        blits[16][4] = mvtools_copy_16x4_u16_c;
+// The buffers every thread searching the plane needs for itself.
+static void pobAllocateBuffers(PlaneOfBlocks *pob) {
+    // 64 required for effective use of x264 sad on Core2
+#define ALIGN_PLANES 64
 
-        sads[16][8] = mvtools_sad_16x8_u16_c;
-        lumas[16][8] = mvtools_luma_16x8_u16_c;
-        blits[16][8] = mvtools_copy_16x8_u16_c;
-        satds[16][8] = mvtools_satd_16x8_u16_c;
+    VS_ALIGNED_MALLOC(&pob->dctSrc, pob->nBlkSizeY * pob->dctpitch, ALIGN_PLANES);
 
-        sads[16][16] = mvtools_sad_16x16_u16_c;
-        lumas[16][16] = mvtools_luma_16x16_u16_c;
-        blits[16][16] = mvtools_copy_16x16_u16_c;
-        satds[16][16] = mvtools_satd_16x16_u16_c;
+    // Only the dct modes which transform the reference blocks need it.
+    pob->dctCache = NULL;
+    pob->dctCacheKeys = NULL;
 
-        sads[16][32] = mvtools_sad_16x32_u16_c;
-        blits[16][32] = mvtools_copy_16x32_u16_c;
+    // Four extra bytes because pixel_sad_4x4_mmx2 reads four bytes more than it should (but doesn't use them in any way).
+    VS_ALIGNED_MALLOC(&pob->pSrc_temp[0], pob->nBlkSizeY * pob->nSrcPitch_temp[0] + 4, ALIGN_PLANES);
+    VS_ALIGNED_MALLOC(&pob->pSrc_temp[1], pob->nBlkSizeY / pob->yRatioUV * pob->nSrcPitch_temp[1] + 4, ALIGN_PLANES);
+    VS_ALIGNED_MALLOC(&pob->pSrc_temp[2], pob->nBlkSizeY / pob->yRatioUV * pob->nSrcPitch_temp[2] + 4, ALIGN_PLANES);
 
-        sads[32][8] = mvtools_sad_32x8_u16_c;
-        blits[32][8] = mvtools_copy_32x8_u16_c;
+#undef ALIGN_PLANES
+}
 
-        sads[32][16] = mvtools_sad_32x16_u16_c;
-        lumas[32][16] = mvtools_luma_32x16_u16_c;
-        blits[32][16] = mvtools_copy_32x16_u16_c;
 
-        sads[32][32] = mvtools_sad_32x32_u16_c;
-        lumas[32][32] = mvtools_luma_32x32_u16_c;
-        blits[32][32] = mvtools_copy_32x32_u16_c;
+static void pobFreeBuffers(PlaneOfBlocks *pob) {
+    VS_ALIGNED_FREE(pob->dctSrc);
 
-        if (pob->isse) {
-#if defined(MVTOOLS_X86)
-            sads[2][2] = mvtools_sad_2x2_u16_sse2;
-            sads[2][4] = mvtools_sad_2x4_u16_sse2;
-            sads[4][2] = mvtools_sad_4x2_u16_sse2;
-            sads[4][4] = mvtools_sad_4x4_u16_sse2;
-            sads[4][8] = mvtools_sad_4x8_u16_sse2;
-            sads[8][1] = mvtools_sad_8x1_u16_sse2;
-            sads[8][2] = mvtools_sad_8x2_u16_sse2;
-            sads[8][4] = mvtools_sad_8x4_u16_sse2;
-            sads[8][8] = mvtools_sad_8x8_u16_sse2;
-            sads[8][16] = mvtools_sad_8x16_u16_sse2;
-            sads[16][1] = mvtools_sad_16x1_u16_sse2;
-            sads[16][2] = mvtools_sad_16x2_u16_sse2;
-            sads[16][4] = mvtools_sad_16x4_u16_sse2;
-            sads[16][8] = mvtools_sad_16x8_u16_sse2;
-            sads[16][16] = mvtools_sad_16x16_u16_sse2;
-            sads[16][32] = mvtools_sad_16x32_u16_sse2;
-            sads[32][8] = mvtools_sad_32x8_u16_sse2;
-            sads[32][16] = mvtools_sad_32x16_u16_sse2;
-            sads[32][32] = mvtools_sad_32x32_u16_sse2;
-#endif
-        }
+    if (pob->dctCache) {
+        VS_ALIGNED_FREE(pob->dctCache);
+        free(pob->dctCacheKeys);
     }
 
+    VS_ALIGNED_FREE(pob->pSrc_temp[0]);
+    VS_ALIGNED_FREE(pob->pSrc_temp[1]);
+    VS_ALIGNED_FREE(pob->pSrc_temp[2]);
+}
+
+
+// Empties the cache of transformed reference blocks, whose addresses may
+// hold other pixels in the next frame, and allocates it the first time.
+static void pobResetDCTCache(PlaneOfBlocks *pob) {
+    pob->dctCacheLookups = 0;
+    pob->dctCacheHits = 0;
+
+    // SATD is computed from both blocks, so there is nothing to keep in modes 5-10.
+    if (pob->dctmode < 1 || pob->dctmode > 4)
+        return;
 
-    pob->SAD = sads[pob->nBlkSizeX][pob->nBlkSizeY];
-    pob->LUMA = lumas[pob->nBlkSizeX][pob->nBlkSizeY];
-    pob->BLITLUMA = blits[pob->nBlkSizeX][pob->nBlkSizeY];
+    if (!pob->dctCache) {
+        pob->dctCacheStride = (pob->nBlkSizeY * pob->dctpitch + 63) & ~63;
 
-    pob->SADCHROMA = sads[pob->nBlkSizeX / pob->xRatioUV][pob->nBlkSizeY / pob->yRatioUV];
-    pob->BLITCHROMA = blits[pob->nBlkSizeX / pob->xRatioUV][pob->nBlkSizeY / pob->yRatioUV];
+        // Not much more than there are blocks in the coarse levels.
+        int slots = min(DCT_CACHE_SIZE / pob->dctCacheStride, pob->nBlkCount * 16);
+        pob->dctCacheBits = 6;
+        while (pob->dctCacheBits < 16 && (2 << pob->dctCacheBits) <= slots)
+            pob->dctCacheBits++;
+
+        VS_ALIGNED_MALLOC(&pob->dctCache, ((size_t)1 << pob->dctCacheBits) * pob->dctCacheStride, 64);
+        pob->dctCacheKeys = (const uint8_t **)malloc(((size_t)1 << pob->dctCacheBits) * sizeof(const uint8_t *));
+    }
 
-    pob->SATD = satds[pob->nBlkSizeX][pob->nBlkSizeY];
+    memset(pob->dctCacheKeys, 0, ((size_t)1 << pob->dctCacheBits) * sizeof(const uint8_t *));
 }
 
 
-void pobInit(PlaneOfBlocks *pob, int _nBlkX, int _nBlkY, int _nBlkSizeX, int _nBlkSizeY, int _nPel, int _nLevel, int _nMotionFlags, int _nCPUFlags, int _nOverlapX, int _nOverlapY, int _xRatioUV, int _yRatioUV, int _bitsPerSample) {
+void pobInit(PlaneOfBlocks *pob, int _nBlkX, int _nBlkY, int _nBlkSizeX, int _nBlkSizeY, int _nPel, int _nLevel, int _nMotionFlags, int _nCPUFlags, int _nOverlapX, int _nOverlapY, int _xRatioUV, int _yRatioUV, int _bitsPerSample, int _nThreads) {
 
     /* constant fields */
 
@@ -712,36 +1553,53 @@ void pobInit(PlaneOfBlocks *pob, int _nBlkX, int _nBlkY, int _nBlkSizeX, int _nB
     pob->vectors = (VECTOR *)malloc(pob->nBlkCount * sizeof(VECTOR));
     memset(pob->vectors, 0, pob->nBlkCount * sizeof(VECTOR));
 
+    pob->sumLumaChange = 0;
+
     /* function's pointers initialization */
     pobSelectFunctions(pob);
 
-    if (!pob->chroma)
+    if (!pob->chroma) {
         pob->SADCHROMA = NULL;
+        pob->SADCHROMALIMIT = NULL;
+    }
 
 
     pob->dctpitch = max(pob->nBlkSizeX, 16) * pob->bytesPerSample;
 
-    // 64 required for effective use of x264 sad on Core2
-#define ALIGN_PLANES 64
-
-    VS_ALIGNED_MALLOC(&pob->dctSrc, pob->nBlkSizeY * pob->dctpitch, ALIGN_PLANES);
-    VS_ALIGNED_MALLOC(&pob->dctRef, pob->nBlkSizeY * pob->dctpitch, ALIGN_PLANES);
-
     pob->nSrcPitch_temp[0] = pob->nBlkSizeX * pob->bytesPerSample;
     pob->nSrcPitch_temp[1] = pob->nBlkSizeX / pob->xRatioUV * pob->bytesPerSample;
     pob->nSrcPitch_temp[2] = pob->nSrcPitch_temp[1];
 
-    // Four extra bytes because pixel_sad_4x4_mmx2 reads four bytes more than it should (but doesn't use them in any way).
-    VS_ALIGNED_MALLOC(&pob->pSrc_temp[0], pob->nBlkSizeY * pob->nSrcPitch_temp[0] + 4, ALIGN_PLANES);
-    VS_ALIGNED_MALLOC(&pob->pSrc_temp[1], pob->nBlkSizeY / pob->yRatioUV * pob->nSrcPitch_temp[1] + 4, ALIGN_PLANES);
-    VS_ALIGNED_MALLOC(&pob->pSrc_temp[2], pob->nBlkSizeY / pob->yRatioUV * pob->nSrcPitch_temp[2] + 4, ALIGN_PLANES);
-
-#undef ALIGN_PLANES
+    pobAllocateBuffers(pob);
 
     pob->freqSize = 8192 * pob->nPel * 2; // half must be more than max vector length, which is (framewidth + Padding) * nPel
     pob->freqArray = (int *)malloc(pob->freqSize * sizeof(int));
 
     pob->verybigSAD = pob->nBlkSizeX * pob->nBlkSizeY * (1 << pob->bitsPerSample);
+
+    pob->temporal = NULL;
+    pob->temporalScale = 1;
+
+    pob->dctCacheLookups = 0;
+    pob->dctCacheHits = 0;
+
+    // A single row can't be split among threads.
+    pob->nThreads = pob->nBlkY > 1 ? min(_nThreads, pob->nBlkY) : 1;
+    pob->workers = NULL;
+    pob->wavefrontPool = NULL;
+    pob->wavefront = NULL;
+    pob->badcountRows = NULL;
+
+    if (pob->nThreads > 1) {
+        pob->workers = (PlaneOfBlocks *)malloc(pob->nThreads * sizeof(PlaneOfBlocks));
+        for (int i = 0; i < pob->nThreads; i++) {
+            pob->workers[i] = *pob;
+            pob->workers[i].workers = NULL;
+            pobAllocateBuffers(&pob->workers[i]);
+        }
+
+        pob->badcountRows = (int *)malloc(pob->nBlkY * sizeof(int));
+    }
 }
 
 
@@ -749,12 +1607,14 @@ void pobDeinit(PlaneOfBlocks *pob) {
     free(pob->vectors);
     free(pob->freqArray);
 
-    VS_ALIGNED_FREE(pob->dctSrc);
-    VS_ALIGNED_FREE(pob->dctRef);
+    pobFreeBuffers(pob);
 
-    VS_ALIGNED_FREE(pob->pSrc_temp[0]);
-    VS_ALIGNED_FREE(pob->pSrc_temp[1]);
-    VS_ALIGNED_FREE(pob->pSrc_temp[2]);
+    if (pob->workers) {
+        for (int i = 0; i < pob->nThreads; i++)
+            pobFreeBuffers(&pob->workers[i]);
+        free(pob->workers);
+        free(pob->badcountRows);
+    }
 }
 
 
@@ -804,6 +1664,14 @@ void pobFetchPredictors(PlaneOfBlocks *pob) {
         pob->predictors[0].sad = pob->predictors[1].sad;
     }
 
+    // Temporal predictor, from the same block of another frame
+    if (pob->temporal) {
+        VECTOR temporal = pob->temporal[pob->blkIdx];
+        temporal.x *= pob->temporalScale;
+        temporal.y *= pob->temporalScale;
+        pob->predictors[4] = pobClipMV(pob, temporal);
+    }
+
     // if there are no other planes, predictor is the median
     if (pob->smallestPlane)
         pob->predictor = pob->predictors[0];
@@ -818,14 +1686,17 @@ void pobNStepSearch(PlaneOfBlocks *pob, int stp) {
         dx = pob->bestMV.x;
         dy = pob->bestMV.y;
 
-        pobCheckMV(pob, dx + length, dy + length);
-        pobCheckMV(pob, dx + length, dy);
-        pobCheckMV(pob, dx + length, dy - length);
-        pobCheckMV(pob, dx, dy - length);
-        pobCheckMV(pob, dx, dy + length);
-        pobCheckMV(pob, dx - length, dy + length);
-        pobCheckMV(pob, dx - length, dy);
-        pobCheckMV(pob, dx - length, dy - length);
+        const int mvs[8][2] = {
+            { dx + length, dy + length },
+            { dx + length, dy },
+            { dx + length, dy - length },
+            { dx, dy - length },
+            { dx, dy + length },
+            { dx - length, dy + length },
+            { dx - length, dy },
+            { dx - length, dy - length },
+        };
+        pobCheckMVs(pob, mvs, 8, pob->penaltyNew, NULL, NULL);
 
         length--;
     }
@@ -981,24 +1852,28 @@ void pobExpandingSearch(PlaneOfBlocks *pob, int r, int s, int mvx, int mvy) {
     // diameter = 2*r + 1, step=s
     // part of true enhaustive search (thin expanding square) around mvx, mvy
     int i, j;
+    int mvs[4][2];
+    int count = 0;
 
     // sides of square without corners
     for (i = -r + s; i < r; i += s) // without corners! - v2.1
     {
-        pobCheckMV(pob, mvx + i, mvy - r);
-        pobCheckMV(pob, mvx + i, mvy + r);
+        pobQueueMV(pob, mvs, &count, mvx + i, mvy - r);
+        pobQueueMV(pob, mvs, &count, mvx + i, mvy + r);
     }
 
     for (j = -r + s; j < r; j += s) {
-        pobCheckMV(pob, mvx - r, mvy + j);
-        pobCheckMV(pob, mvx + r, mvy + j);
+        pobQueueMV(pob, mvs, &count, mvx - r, mvy + j);
+        pobQueueMV(pob, mvs, &count, mvx + r, mvy + j);
     }
 
     // then corners - they are more far from cenrer
-    pobCheckMV(pob, mvx - r, mvy - r);
-    pobCheckMV(pob, mvx - r, mvy + r);
-    pobCheckMV(pob, mvx + r, mvy - r);
-    pobCheckMV(pob, mvx + r, mvy + r);
+    pobQueueMV(pob, mvs, &count, mvx - r, mvy - r);
+    pobQueueMV(pob, mvs, &count, mvx - r, mvy + r);
+    pobQueueMV(pob, mvs, &count, mvx + r, mvy - r);
+    pobQueueMV(pob, mvs, &count, mvx + r, mvy + r);
+
+    pobCheckMVs(pob, (const int (*)[2])mvs, count, pob->penaltyNew, NULL, NULL);
 }
 
 
@@ -1022,12 +1897,16 @@ void pobHex2Search(PlaneOfBlocks *pob, int i_me_range) { //adopted from x264
         //        COPY2_IF_LT( bcost, costs[3], dir, 3 );
         //        COPY2_IF_LT( bcost, costs[4], dir, 4 );
         //        COPY2_IF_LT( bcost, costs[5], dir, 5 );
-        pobCheckMVdir(pob, bmx - 2, bmy, &dir, 0);
-        pobCheckMVdir(pob, bmx - 1, bmy + 2, &dir, 1);
-        pobCheckMVdir(pob, bmx + 1, bmy + 2, &dir, 2);
-        pobCheckMVdir(pob, bmx + 2, bmy, &dir, 3);
-        pobCheckMVdir(pob, bmx + 1, bmy - 2, &dir, 4);
-        pobCheckMVdir(pob, bmx - 1, bmy - 2, &dir, 5);
+        const int mvs[6][2] = {
+            { bmx - 2, bmy },
+            { bmx - 1, bmy + 2 },
+            { bmx + 1, bmy + 2 },
+            { bmx + 2, bmy },
+            { bmx + 1, bmy - 2 },
+            { bmx - 1, bmy - 2 },
+        };
+        static const int dirs[6] = { 0, 1, 2, 3, 4, 5 };
+        pobCheckMVs(pob, mvs, 6, pob->penaltyNew, &dir, dirs);
 
 
         if (dir != -2) {
@@ -1046,9 +1925,13 @@ void pobHex2Search(PlaneOfBlocks *pob, int i_me_range) { //adopted from x264
                 //                COPY2_IF_LT( bcost, costs[1], dir, odir   );
                 //                COPY2_IF_LT( bcost, costs[2], dir, odir+1 );
 
-                pobCheckMVdir(pob, bmx + hex2[odir + 0][0], bmy + hex2[odir + 0][1], &dir, odir - 1);
-                pobCheckMVdir(pob, bmx + hex2[odir + 1][0], bmy + hex2[odir + 1][1], &dir, odir);
-                pobCheckMVdir(pob, bmx + hex2[odir + 2][0], bmy + hex2[odir + 2][1], &dir, odir + 1);
+                const int half[3][2] = {
+                    { bmx + hex2[odir + 0][0], bmy + hex2[odir + 0][1] },
+                    { bmx + hex2[odir + 1][0], bmy + hex2[odir + 1][1] },
+                    { bmx + hex2[odir + 2][0], bmy + hex2[odir + 2][1] },
+                };
+                const int halfDirs[3] = { odir - 1, odir, odir + 1 };
+                pobCheckMVs(pob, half, 3, pob->penaltyNew, &dir, halfDirs);
                 if (dir == -2)
                     break;
                 bmx += hex2[dir + 1][0];
@@ -1069,15 +1952,20 @@ void pobHex2Search(PlaneOfBlocks *pob, int i_me_range) { //adopted from x264
 
 void pobCrossSearch(PlaneOfBlocks *pob, int start, int x_max, int y_max, int mvx, int mvy) { // part of umh  search
 
+    int mvs[4][2];
+    int count = 0;
+
     for (int i = start; i < x_max; i += 2) {
-        pobCheckMV(pob, mvx - i, mvy);
-        pobCheckMV(pob, mvx + i, mvy);
+        pobQueueMV(pob, mvs, &count, mvx - i, mvy);
+        pobQueueMV(pob, mvs, &count, mvx + i, mvy);
     }
 
     for (int j = start; j < y_max; j += 2) {
-        pobCheckMV(pob, mvx, mvy + j);
-        pobCheckMV(pob, mvx, mvy + j);
+        pobQueueMV(pob, mvs, &count, mvx, mvy + j);
+        pobQueueMV(pob, mvs, &count, mvx, mvy + j);
     }
+
+    pobCheckMVs(pob, (const int (*)[2])mvs, count, pob->penaltyNew, NULL, NULL);
 }
 
 
@@ -1097,11 +1985,12 @@ void pobUMHSearch(PlaneOfBlocks *pob, int i_me_range, int omx, int omy) { // rad
             { -4, 2 }, { -4, 1 }, { -4, 0 }, { -4, -1 }, { -4, -2 }, { 4, -2 }, { 4, -1 }, { 4, 0 }, { 4, 1 }, { 4, 2 }, { 2, 3 }, { 0, 4 }, { -2, 3 }, { -2, -3 }, { 0, -4 }, { 2, -3 },
         };
 
+        int mvs[16][2];
         for (int j = 0; j < 16; j++) {
-            int mx = omx + hex4[j][0] * i;
-            int my = omy + hex4[j][1] * i;
-            pobCheckMV(pob, mx, my);
+            mvs[j][0] = omx + hex4[j][0] * i;
+            mvs[j][1] = omy + hex4[j][1] * i;
         }
+        pobCheckMVs(pob, (const int (*)[2])mvs, 16, pob->penaltyNew, NULL, NULL);
     } while (++i <= i_me_range / 4);
 
     //            if( bmy <= mv_y_max )
@@ -1156,6 +2045,20 @@ void pobRefine(PlaneOfBlocks *pob) {
 }
 
 
+// Makes badcount what it would be at this point in the serial scan.
+static void pobSyncBadcount(PlaneOfBlocks *pob) {
+    if (pob->badcountSynced)
+        return;
+
+    if (pob->blky > 0) {
+        wfWait(pob->wavefront, pob->blky - 1, pob->nBlkX);
+        pob->badcount += pob->badcountRows[pob->blky - 1];
+    }
+
+    pob->badcountSynced = 1;
+}
+
+
 void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
 
     pobFetchPredictors(pob);
@@ -1170,11 +2073,30 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
     if (pob->dctmode >= 3) // most use it and it should be fast anyway //if (dctmode == 3 || dctmode == 4) // check it
         pob->srcLuma = pob->LUMA(pob->pSrc[0], pob->nSrcPitch[0]);
 
+    pob->globalMVPredictor = pobClipMV(pob, pob->globalMVPredictor);
+
+    // The zero, global, and median predictors are always checked, so their luma SADs can be computed at once.
+    const uint8_t *pRefZero = pobGetRefBlock(pob, 0, pob->zeroMVfieldShifted.y);
+    const uint8_t *pRefGlobal = pobGetRefBlock(pob, pob->globalMVPredictor.x, pob->globalMVPredictor.y);
+    const uint8_t *pRefPredictor = pobGetRefBlock(pob, pob->predictor.x, pob->predictor.y);
+    int lumaSADs[3];
+
+    if (pob->dctmode == 0 && pob->SADX3) {
+        unsigned int sads[3];
+        pob->SADX3(pob->pSrc[0], pob->nSrcPitch[0], pRefZero, pRefGlobal, pRefPredictor, pob->nRefPitch[0], sads);
+        for (int i = 0; i < 3; i++)
+            lumaSADs[i] = sads[i];
+    } else {
+        lumaSADs[0] = pobLumaSAD(pob, pRefZero);
+        lumaSADs[1] = pobLumaSAD(pob, pRefGlobal);
+        lumaSADs[2] = pobLumaSAD(pob, pRefPredictor);
+    }
+
     // We treat zero alone
     // Do we bias zero with not taking into account distorsion ?
     pob->bestMV.x = pob->zeroMVfieldShifted.x;
     pob->bestMV.y = pob->zeroMVfieldShifted.y;
-    sad = pobLumaSAD(pob, pobGetRefBlock(pob, 0, pob->zeroMVfieldShifted.y));
+    sad = lumaSADs[0];
     if (pob->chroma) {
         sad += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, 0, 0), pob->nRefPitch[1]);
         sad += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, 0, 0), pob->nRefPitch[2]);
@@ -1193,8 +2115,7 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
     }
 
     // Global MV predictor  - added by Fizick
-    pob->globalMVPredictor = pobClipMV(pob, pob->globalMVPredictor);
-    sad = pobLumaSAD(pob, pobGetRefBlock(pob, pob->globalMVPredictor.x, pob->globalMVPredictor.y));
+    sad = lumaSADs[1];
     if (pob->chroma) {
         sad += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, pob->globalMVPredictor.x, pob->globalMVPredictor.y), pob->nRefPitch[1]);
         sad += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, pob->globalMVPredictor.x, pob->globalMVPredictor.y), pob->nRefPitch[2]);
@@ -1213,7 +2134,7 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
         bestMVMany[1] = pob->bestMV; // save bestMV
         nMinCostMany[1] = pob->nMinCost;
     }
-    sad = pobLumaSAD(pob, pobGetRefBlock(pob, pob->predictor.x, pob->predictor.y));
+    sad = lumaSADs[2];
     if (pob->chroma) {
         sad += pob->SADCHROMA(pob->pSrc[1], pob->nSrcPitch[1], pobGetRefBlockU(pob, pob->predictor.x, pob->predictor.y), pob->nRefPitch[1]);
         sad += pob->SADCHROMA(pob->pSrc[2], pob->nSrcPitch[2], pobGetRefBlockV(pob, pob->predictor.x, pob->predictor.y), pob->nRefPitch[2]);
@@ -1234,18 +2155,24 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
     }
 
     // then all the other predictors
-    int npred = 4;
+    int npred = pob->temporal ? 5 : 4;
 
-    for (int i = 0; i < npred; i++) {
-        if (pob->tryMany)
+    if (pob->tryMany) {
+        for (int i = 0; i < npred; i++) {
             pob->nMinCost = pob->verybigSAD + 1;
-        pobCheckMV0(pob, pob->predictors[i].x, pob->predictors[i].y);
-        if (pob->tryMany) {
+            pobCheckMV0(pob, pob->predictors[i].x, pob->predictors[i].y);
             // refine around predictor
             pobRefine(pob);                   // reset bestMV
             bestMVMany[i + 3] = pob->bestMV; // save bestMV
             nMinCostMany[i + 3] = pob->nMinCost;
         }
+    } else {
+        int mvs[5][2];
+        for (int i = 0; i < npred; i++) {
+            mvs[i][0] = pob->predictors[i].x;
+            mvs[i][1] = pob->predictors[i].y;
+        }
+        pobCheckMVs(pob, (const int (*)[2])mvs, npred, 0, NULL, NULL);
     }
 
 
@@ -1257,8 +2184,12 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
                 pob->nMinCost = nMinCostMany[i];
             }
         }
-    } else {
-        // then, we refine, according to the search type
+    } else if (!(pob->temporal &&
+                 pob->bestMV.x == pob->predictors[4].x &&
+                 pob->bestMV.y == pob->predictors[4].y &&
+                 pob->bestMV.sad <= pob->predictors[4].sad)) {
+        // then, we refine, according to the search type,
+        // unless the temporal predictor won and matches at least as well as in its own frame
         pobRefine(pob);
     }
 
@@ -1266,6 +2197,11 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
 
 #define BADCOUNT_LIMIT 16
 
+    // The threshold depends on the number of bad blocks found so far, including
+    // those in the rows above. It can only matter if foundSAD is over badSAD.
+    if (pob->wavefront && pob->blkIdx > 1 && (pob->badSAD < 0 || foundSAD > pob->badSAD))
+        pobSyncBadcount(pob);
+
     if (pob->blkIdx > 1 && foundSAD > (pob->badSAD + pob->badSAD * pob->badcount / BADCOUNT_LIMIT)) {
         // bad vector, try wide search
         // with some soft limit (BADCOUNT_LIMIT) of bad cured vectors (time consumed)
@@ -1299,6 +2235,212 @@ void pobPseudoEPZSearch(PlaneOfBlocks *pob) {
 }
 
 
+static inline void pobSetSearchBoundaries(PlaneOfBlocks *pob) {
+    // decreased padding of coarse levels
+    int nHPaddingScaled = pob->pSrcFrame->planes[0]->nHPadding >> pob->nLogScale;
+    int nVPaddingScaled = pob->pSrcFrame->planes[0]->nVPadding >> pob->nLogScale;
+    /* computes search boundaries */
+    pob->nDxMax = pob->nPel * (pob->pSrcFrame->planes[0]->nPaddedWidth - pob->x[0] - pob->nBlkSizeX - pob->pSrcFrame->planes[0]->nHPadding + nHPaddingScaled);
+    pob->nDyMax = pob->nPel * (pob->pSrcFrame->planes[0]->nPaddedHeight - pob->y[0] - pob->nBlkSizeY - pob->pSrcFrame->planes[0]->nVPadding + nVPaddingScaled);
+    pob->nDxMin = -pob->nPel * (pob->x[0] - pob->pSrcFrame->planes[0]->nHPadding + nHPaddingScaled);
+    pob->nDyMin = -pob->nPel * (pob->y[0] - pob->pSrcFrame->planes[0]->nVPadding + nVPaddingScaled);
+}
+
+
+static void pobSearchMVsRow(PlaneOfBlocks *pob, int blky, int *pBlkData, int nLambdaLevel, int lsad, int pnew, int meander) {
+    pob->blky = blky;
+
+    pob->y[0] = pob->pSrcFrame->planes[0]->nVPadding + (pob->nBlkSizeY - pob->nOverlapY) * pob->blky;
+    if (pob->pSrcFrame->nMode & UPLANE)
+        pob->y[1] = pob->pSrcFrame->planes[1]->nVPadding + ((pob->nBlkSizeY - pob->nOverlapY) >> pob->nLogyRatioUV) * pob->blky;
+    if (pob->pSrcFrame->nMode & VPLANE)
+        pob->y[2] = pob->pSrcFrame->planes[2]->nVPadding + ((pob->nBlkSizeY - pob->nOverlapY) >> pob->nLogyRatioUV) * pob->blky;
+
+    if (pob->wavefront) {
+        // Only this row's bad blocks until pobSyncBadcount is called.
+        pob->badcount = 0;
+        pob->badcountSynced = 0;
+    }
+
+    pob->blkScanDir = (pob->blky % 2 == 0 || meander == 0) ? 1 : -1;
+    // meander (alternate) scan blocks (even row left to right, odd row right to left)
+    int blkxStart = (pob->blky % 2 == 0 || meander == 0) ? 0 : pob->nBlkX - 1;
+    if (pob->blkScanDir == 1) { // start with leftmost block
+        pob->x[0] = pob->pSrcFrame->planes[0]->nHPadding;
+        if (pob->chroma) {
+            pob->x[1] = pob->pSrcFrame->planes[1]->nHPadding;
+            pob->x[2] = pob->pSrcFrame->planes[2]->nHPadding;
+        }
+    } else { // start with rightmost block, but it is already set at prev row
+        pob->x[0] = pob->pSrcFrame->planes[0]->nHPadding + (pob->nBlkSizeX - pob->nOverlapX) * (pob->nBlkX - 1);
+        if (pob->chroma) {
+            pob->x[1] = pob->pSrcFrame->planes[1]->nHPadding + ((pob->nBlkSizeX - pob->nOverlapX) / pob->xRatioUV) * (pob->nBlkX - 1);
+            pob->x[2] = pob->pSrcFrame->planes[2]->nHPadding + ((pob->nBlkSizeX - pob->nOverlapX) / pob->xRatioUV) * (pob->nBlkX - 1);
+        }
+    }
+    for (int iblkx = 0; iblkx < pob->nBlkX; iblkx++) {
+        // The predictors come from the block above and the one to its right.
+        if (pob->wavefront && pob->blky > 0)
+            wfWait(pob->wavefront, pob->blky - 1, min(iblkx + 2, pob->nBlkX));
+
+        pob->blkx = blkxStart + iblkx * pob->blkScanDir;
+        pob->blkIdx = pob->blky * pob->nBlkX + pob->blkx;
+        pob->iter = 0;
+
+        pob->pSrc[0] = mvpGetAbsolutePelPointer(pob->pSrcFrame->planes[0], pob->x[0], pob->y[0]);
+        if (pob->chroma) {
+            pob->pSrc[1] = mvpGetAbsolutePelPointer(pob->pSrcFrame->planes[1], pob->x[1], pob->y[1]);
+            pob->pSrc[2] = mvpGetAbsolutePelPointer(pob->pSrcFrame->planes[2], pob->x[2], pob->y[2]);
+        }
+
+        pob->nSrcPitch[0] = pob->pSrcFrame->planes[0]->nPitch;
+        //create aligned copy
+        pob->BLITLUMA(pob->pSrc_temp[0], pob->nSrcPitch_temp[0], pob->pSrc[0], pob->nSrcPitch[0]);
+        //set the to the aligned copy
+        pob->pSrc[0] = pob->pSrc_temp[0];
+        pob->nSrcPitch[0] = pob->nSrcPitch_temp[0];
+        if (pob->chroma) {
+            pob->nSrcPitch[1] = pob->pSrcFrame->planes[1]->nPitch;
+            pob->nSrcPitch[2] = pob->pSrcFrame->planes[2]->nPitch;
+            pob->BLITCHROMA(pob->pSrc_temp[1], pob->nSrcPitch_temp[1], pob->pSrc[1], pob->nSrcPitch[1]);
+            pob->BLITCHROMA(pob->pSrc_temp[2], pob->nSrcPitch_temp[2], pob->pSrc[2], pob->nSrcPitch[2]);
+            pob->pSrc[1] = pob->pSrc_temp[1];
+            pob->pSrc[2] = pob->pSrc_temp[2];
+            pob->nSrcPitch[1] = pob->nSrcPitch_temp[1];
+            pob->nSrcPitch[2] = pob->nSrcPitch_temp[2];
+        }
+
+        if (pob->blky == 0)
+            pob->nLambda = 0;
+        else
+            pob->nLambda = nLambdaLevel;
+
+        pob->penaltyNew = pnew; // penalty for new vector
+        pob->LSAD = lsad;       // SAD limit for lambda using
+        // may be they must be scaled by nPel ?
+
+        pobSetSearchBoundaries(pob);
+
+        /* search the mv */
+        pob->predictor = pobClipMV(pob, pob->vectors[pob->blkIdx]);
+        pob->predictors[4] = pobClipMV(pob, zeroMV);
+
+        pobPseudoEPZSearch(pob);
+
+        /* write the results */
+        pBlkData[pob->blkx * N_PER_BLOCK + 0] = pob->bestMV.x;
+        pBlkData[pob->blkx * N_PER_BLOCK + 1] = pob->bestMV.y;
+        pBlkData[pob->blkx * N_PER_BLOCK + 2] = pob->bestMV.sad;
+
+
+        if (pob->smallestPlane)
+            pob->sumLumaChange += pob->LUMA(pobGetRefBlock(pob, 0, 0), pob->nRefPitch[0]) - pob->LUMA(pob->pSrc[0], pob->nSrcPitch[0]);
+
+        /* increment indexes & pointers */
+        if (iblkx < pob->nBlkX - 1) {
+            pob->x[0] += (pob->nBlkSizeX - pob->nOverlapX) * pob->blkScanDir;
+            if (pob->pSrcFrame->nMode & UPLANE)
+                pob->x[1] += ((pob->nBlkSizeX - pob->nOverlapX) >> pob->nLogxRatioUV) * pob->blkScanDir;
+            if (pob->pSrcFrame->nMode & VPLANE)
+                pob->x[2] += ((pob->nBlkSizeX - pob->nOverlapX) >> pob->nLogxRatioUV) * pob->blkScanDir;
+
+            if (pob->wavefront)
+                wfReport(pob->wavefront, pob->blky, iblkx + 1);
+        }
+    }
+
+    if (pob->wavefront) {
+        // The row above is finished by now.
+        pobSyncBadcount(pob);
+        pob->badcountRows[pob->blky] = pob->badcount;
+        wfReport(pob->wavefront, pob->blky, pob->nBlkX);
+    }
+}
+
+
+// In the serial scan every block clips globalMVPredictor to its own search
+// boundaries and hands the result over to the next block. This computes the
+// value the first block of row blky receives, starting from the unclipped one.
+static void pobClipGlobalMVPredictorToRow(PlaneOfBlocks *pob, int blky) {
+    int xSettled = 0;
+
+    for (int row = 0; row < blky; row++) {
+        pob->y[0] = pob->pSrcFrame->planes[0]->nVPadding + (pob->nBlkSizeY - pob->nOverlapY) * row;
+
+        if (xSettled) {
+            // All blocks of a row have the same vertical boundaries.
+            pob->x[0] = pob->pSrcFrame->planes[0]->nHPadding;
+            pobSetSearchBoundaries(pob);
+            pob->globalMVPredictor.y = pobClipMVy(pob, pob->globalMVPredictor.y);
+            continue;
+        }
+
+        int previousX = pob->globalMVPredictor.x;
+
+        for (int blkx = 0; blkx < pob->nBlkX; blkx++) {
+            pob->x[0] = pob->pSrcFrame->planes[0]->nHPadding + (pob->nBlkSizeX - pob->nOverlapX) * blkx;
+            pobSetSearchBoundaries(pob);
+            pob->globalMVPredictor = pobClipMV(pob, pob->globalMVPredictor);
+        }
+
+        // Every row clips x the same way, so once a row leaves it alone, so do the rest.
+        xSettled = pob->globalMVPredictor.x == previousX;
+    }
+}
+
+
+typedef struct SearchRowArguments {
+    PlaneOfBlocks *pob;
+    int *pBlkData;
+    int nLambdaLevel;
+    int lsad;
+    int pnew;
+} SearchRowArguments;
+
+
+static void pobSearchMVsWavefrontRow(Wavefront *wf, int thread, int row, void *userData) {
+    SearchRowArguments *args = (SearchRowArguments *)userData;
+    PlaneOfBlocks *worker = &args->pob->workers[thread];
+
+    worker->wavefront = wf;
+
+    worker->globalMVPredictor = args->pob->globalMVPredictor;
+    pobClipGlobalMVPredictorToRow(worker, row);
+
+    pobSearchMVsRow(worker, row, args->pBlkData + row * worker->nBlkX * N_PER_BLOCK, args->nLambdaLevel, args->lsad, args->pnew, 0);
+
+    worker->wavefront = NULL;
+}
+
+
+// Gives the worker the search parameters of pob, keeping its own buffers.
+static void pobPrepareWorker(const PlaneOfBlocks *pob, PlaneOfBlocks *worker, DCTFFTW *DCT) {
+    uint8_t *dctSrc = worker->dctSrc;
+    uint8_t *dctCache = worker->dctCache;
+    const uint8_t **dctCacheKeys = worker->dctCacheKeys;
+    int dctCacheBits = worker->dctCacheBits;
+    int dctCacheStride = worker->dctCacheStride;
+    uint8_t *pSrc_temp[3] = { worker->pSrc_temp[0], worker->pSrc_temp[1], worker->pSrc_temp[2] };
+
+    *worker = *pob;
+
+    worker->dctSrc = dctSrc;
+    worker->dctCache = dctCache;
+    worker->dctCacheKeys = dctCacheKeys;
+    worker->dctCacheBits = dctCacheBits;
+    worker->dctCacheStride = dctCacheStride;
+    for (int i = 0; i < 3; i++)
+        worker->pSrc_temp[i] = pSrc_temp[i];
+
+    worker->workers = NULL;
+    worker->DCT = DCT;
+    worker->planeSAD = 0;
+    worker->sumLumaChange = 0;
+
+    pobResetDCTCache(worker);
+}
+
+
 void pobSearchMVs(PlaneOfBlocks *pob, MVFrame *pSrcFrame, MVFrame *pRefFrame,
                   SearchType st, int stp, int lambda, int lsad, int pnew,
                   int plevel, int *out, VECTOR *globalMVec,
@@ -1319,6 +2461,13 @@ void pobSearchMVs(PlaneOfBlocks *pob, MVFrame *pSrcFrame, MVFrame *pRefFrame,
     pob->globalMVPredictor.y = pob->nPel * globalMVec->y + fieldShift;
     pob->globalMVPredictor.sad = globalMVec->sad;
 
+    if (pob->smallestPlane) {
+        // The same PlaneOfBlocks is reused for many frames. Nothing is interpolated
+        // into the coarsest level, so its predictions must start from zero every time.
+        memset(pob->vectors, 0, pob->nBlkCount * sizeof(VECTOR));
+        pob->sumLumaChange = 0;
+    }
+
     // write the plane's header
     pobWriteHeaderToArray(pob, out);
 
@@ -1327,16 +2476,6 @@ void pobSearchMVs(PlaneOfBlocks *pob, MVFrame *pSrcFrame, MVFrame *pRefFrame,
     pob->pSrcFrame = pSrcFrame;
     pob->pRefFrame = pRefFrame;
 
-
-    pob->y[0] = pob->pSrcFrame->planes[0]->nVPadding;
-
-    if (pob->pSrcFrame->nMode & UPLANE) {
-        pob->y[1] = pob->pSrcFrame->planes[1]->nVPadding;
-    }
-    if (pob->pSrcFrame->nMode & VPLANE) {
-        pob->y[2] = pob->pSrcFrame->planes[2]->nVPadding;
-    }
-
     pob->nSrcPitch[0] = pob->pSrcFrame->planes[0]->nPitch;
     if (pob->chroma) {
         pob->nSrcPitch[1] = pob->pSrcFrame->planes[1]->nPitch;
@@ -1363,105 +2502,62 @@ void pobSearchMVs(PlaneOfBlocks *pob, MVFrame *pSrcFrame, MVFrame *pRefFrame,
     pob->planeSAD = 0;
     pob->badcount = 0;
     pob->tryMany = tryMany;
+    pob->dctCacheLookups = 0;
+    pob->dctCacheHits = 0;
     // Functions using float must not be used here
 
-    for (pob->blky = 0; pob->blky < pob->nBlkY; pob->blky++) {
-        pob->blkScanDir = (pob->blky % 2 == 0 || meander == 0) ? 1 : -1;
-        // meander (alternate) scan blocks (even row left to right, odd row right to left)
-        int blkxStart = (pob->blky % 2 == 0 || meander == 0) ? 0 : pob->nBlkX - 1;
-        if (pob->blkScanDir == 1) { // start with leftmost block
-            pob->x[0] = pob->pSrcFrame->planes[0]->nHPadding;
-            if (pob->chroma) {
-                pob->x[1] = pob->pSrcFrame->planes[1]->nHPadding;
-                pob->x[2] = pob->pSrcFrame->planes[2]->nHPadding;
-            }
-        } else { // start with rightmost block, but it is already set at prev row
-            pob->x[0] = pob->pSrcFrame->planes[0]->nHPadding + (pob->nBlkSizeX - pob->nOverlapX) * (pob->nBlkX - 1);
-            if (pob->chroma) {
-                pob->x[1] = pob->pSrcFrame->planes[1]->nHPadding + ((pob->nBlkSizeX - pob->nOverlapX) / pob->xRatioUV) * (pob->nBlkX - 1);
-                pob->x[2] = pob->pSrcFrame->planes[2]->nHPadding + ((pob->nBlkSizeX - pob->nOverlapX) / pob->xRatioUV) * (pob->nBlkX - 1);
-            }
-        }
-        for (int iblkx = 0; iblkx < pob->nBlkX; iblkx++) {
-            pob->blkx = blkxStart + iblkx * pob->blkScanDir;
-            pob->blkIdx = pob->blky * pob->nBlkX + pob->blkx;
-            pob->iter = 0;
+    // With meander the rows depend on each other entirely. The pool is shared
+    // by the frames being searched at the same time, and when another one is
+    // using it, this frame is searched by the calling thread alone.
+    int parallel = 0;
 
-            pob->pSrc[0] = mvpGetAbsolutePelPointer(pob->pSrcFrame->planes[0], pob->x[0], pob->y[0]);
-            if (pob->chroma) {
-                pob->pSrc[1] = mvpGetAbsolutePelPointer(pob->pSrcFrame->planes[1], pob->x[1], pob->y[1]);
-                pob->pSrc[2] = mvpGetAbsolutePelPointer(pob->pSrcFrame->planes[2], pob->x[2], pob->y[2]);
-            }
+    if (pob->workers && pob->wavefrontPool && !meander) {
+        for (int i = 0; i < pob->nThreads; i++)
+            pobPrepareWorker(pob, &pob->workers[i], pob->DCT ? &DCT[i] : NULL);
 
-            pob->nSrcPitch[0] = pob->pSrcFrame->planes[0]->nPitch;
-            //create aligned copy
-            pob->BLITLUMA(pob->pSrc_temp[0], pob->nSrcPitch_temp[0], pob->pSrc[0], pob->nSrcPitch[0]);
-            //set the to the aligned copy
-            pob->pSrc[0] = pob->pSrc_temp[0];
-            pob->nSrcPitch[0] = pob->nSrcPitch_temp[0];
-            if (pob->chroma) {
-                pob->nSrcPitch[1] = pob->pSrcFrame->planes[1]->nPitch;
-                pob->nSrcPitch[2] = pob->pSrcFrame->planes[2]->nPitch;
-                pob->BLITCHROMA(pob->pSrc_temp[1], pob->nSrcPitch_temp[1], pob->pSrc[1], pob->nSrcPitch[1]);
-                pob->BLITCHROMA(pob->pSrc_temp[2], pob->nSrcPitch_temp[2], pob->pSrc[2], pob->nSrcPitch[2]);
-                pob->pSrc[1] = pob->pSrc_temp[1];
-                pob->pSrc[2] = pob->pSrc_temp[2];
-                pob->nSrcPitch[1] = pob->nSrcPitch_temp[1];
-                pob->nSrcPitch[2] = pob->nSrcPitch_temp[2];
-            }
+        SearchRowArguments args = { pob, pBlkData, nLambdaLevel, lsad, pnew };
 
-            if (pob->blky == 0)
-                pob->nLambda = 0;
-            else
-                pob->nLambda = nLambdaLevel;
+        parallel = wfRun(pob->wavefrontPool, pob->nBlkY, pob->nThreads, pobSearchMVsWavefrontRow, &args);
+    }
 
-            pob->penaltyNew = pnew; // penalty for new vector
-            pob->LSAD = lsad;       // SAD limit for lambda using
-            // may be they must be scaled by nPel ?
+    if (parallel) {
+        for (int i = 0; i < pob->nThreads; i++) {
+            pob->planeSAD += pob->workers[i].planeSAD;
+            pob->sumLumaChange += pob->workers[i].sumLumaChange;
+            pob->dctCacheLookups += pob->workers[i].dctCacheLookups;
+            pob->dctCacheHits += pob->workers[i].dctCacheHits;
+        }
+        pob->badcount = pob->badcountRows[pob->nBlkY - 1];
+    } else {
+        pobResetDCTCache(pob);
 
-            // decreased padding of coarse levels
-            int nHPaddingScaled = pob->pSrcFrame->planes[0]->nHPadding >> pob->nLogScale;
-            int nVPaddingScaled = pob->pSrcFrame->planes[0]->nVPadding >> pob->nLogScale;
-            /* computes search boundaries */
-            pob->nDxMax = pob->nPel * (pob->pSrcFrame->planes[0]->nPaddedWidth - pob->x[0] - pob->nBlkSizeX - pob->pSrcFrame->planes[0]->nHPadding + nHPaddingScaled);
-            pob->nDyMax = pob->nPel * (pob->pSrcFrame->planes[0]->nPaddedHeight - pob->y[0] - pob->nBlkSizeY - pob->pSrcFrame->planes[0]->nVPadding + nVPaddingScaled);
-            pob->nDxMin = -pob->nPel * (pob->x[0] - pob->pSrcFrame->planes[0]->nHPadding + nHPaddingScaled);
-            pob->nDyMin = -pob->nPel * (pob->y[0] - pob->pSrcFrame->planes[0]->nVPadding + nVPaddingScaled);
+        for (int blky = 0; blky < pob->nBlkY; blky++)
+            pobSearchMVsRow(pob, blky, pBlkData + blky * pob->nBlkX * N_PER_BLOCK, nLambdaLevel, lsad, pnew, meander);
+    }
 
-            /* search the mv */
-            pob->predictor = pobClipMV(pob, pob->vectors[pob->blkIdx]);
-            pob->predictors[4] = pobClipMV(pob, zeroMV);
+    if (pob->smallestPlane)
+        *pmeanLumaChange = pob->sumLumaChange / pob->nBlkCount; // for all finer planes
+}
 
-            pobPseudoEPZSearch(pob);
 
-            /* write the results */
-            pBlkData[pob->blkx * N_PER_BLOCK + 0] = pob->bestMV.x;
-            pBlkData[pob->blkx * N_PER_BLOCK + 1] = pob->bestMV.y;
-            pBlkData[pob->blkx * N_PER_BLOCK + 2] = pob->bestMV.sad;
+void pobSeedMVs(PlaneOfBlocks *pob, const int *seed, int scale, int *out) {
+    pob->dctCacheLookups = 0;
+    pob->dctCacheHits = 0;
 
+    pobWriteHeaderToArray(pob, out);
 
-            if (pob->smallestPlane)
-                pob->sumLumaChange += pob->LUMA(pobGetRefBlock(pob, 0, 0), pob->nRefPitch[0]) - pob->LUMA(pob->pSrc[0], pob->nSrcPitch[0]);
+    seed++;
+    out++;
 
-            /* increment indexes & pointers */
-            if (iblkx < pob->nBlkX - 1) {
-                pob->x[0] += (pob->nBlkSizeX - pob->nOverlapX) * pob->blkScanDir;
-                if (pob->pSrcFrame->nMode & UPLANE)
-                    pob->x[1] += ((pob->nBlkSizeX - pob->nOverlapX) >> pob->nLogxRatioUV) * pob->blkScanDir;
-                if (pob->pSrcFrame->nMode & VPLANE)
-                    pob->x[2] += ((pob->nBlkSizeX - pob->nOverlapX) >> pob->nLogxRatioUV) * pob->blkScanDir;
-            }
-        }
-        pBlkData += pob->nBlkX * N_PER_BLOCK;
+    for (int i = 0; i < pob->nBlkCount; i++) {
+        pob->vectors[i].x = seed[i * N_PER_BLOCK + 0] * scale;
+        pob->vectors[i].y = seed[i * N_PER_BLOCK + 1] * scale;
+        pob->vectors[i].sad = seed[i * N_PER_BLOCK + 2];
 
-        pob->y[0] += (pob->nBlkSizeY - pob->nOverlapY);
-        if (pob->pSrcFrame->nMode & UPLANE)
-            pob->y[1] += ((pob->nBlkSizeY - pob->nOverlapY) >> pob->nLogyRatioUV);
-        if (pob->pSrcFrame->nMode & VPLANE)
-            pob->y[2] += ((pob->nBlkSizeY - pob->nOverlapY) >> pob->nLogyRatioUV);
+        out[i * N_PER_BLOCK + 0] = pob->vectors[i].x;
+        out[i * N_PER_BLOCK + 1] = pob->vectors[i].y;
+        out[i * N_PER_BLOCK + 2] = pob->vectors[i].sad;
     }
-    if (pob->smallestPlane)
-        *pmeanLumaChange = pob->sumLumaChange / pob->nBlkCount; // for all finer planes
 }
 
 
@@ -1474,12 +2570,15 @@ void pobRecalculateMVs(PlaneOfBlocks *pob, const FakeGroupOfPlanes *fgop, MVFram
     else
         pob->dctmode = pob->DCT->dctmode;
     pob->dctweight16 = 8; //min(16,abs(*pmeanLumaChange)/(nBlkSizeX*nBlkSizeY)); //equal dct and spatial weights for meanLumaChange=8 (empirical)
+    pobResetDCTCache(pob);
     pob->zeroMVfieldShifted.x = 0;
     pob->zeroMVfieldShifted.y = fieldShift;
     pob->globalMVPredictor.x = 0;          //nPel*globalMVec->x;// there is no global
     pob->globalMVPredictor.y = fieldShift; //nPel*globalMVec->y + fieldShift;
     pob->globalMVPredictor.sad = 9999999;  //globalMVec->sad;
 
+    pob->sumLumaChange = 0;
+
     // write the plane's header
     pobWriteHeaderToArray(pob, out);
 
@@ -1603,10 +2702,10 @@ void pobRecalculateMVs(PlaneOfBlocks *pob, const FakeGroupOfPlanes *fgop, MVFram
             VECTOR vectorOld; // interpolated or nearest
 
             if (smooth == 1) { // interpolate
-                VECTOR vectorOld1 = fgopGetBlock(fgop, 0, blkxold1 + blkyold1 * nBlkXold)->vector; // 4 old nearest vectors (may coinside)
-                VECTOR vectorOld2 = fgopGetBlock(fgop, 0, blkxold2 + blkyold1 * nBlkXold)->vector;
-                VECTOR vectorOld3 = fgopGetBlock(fgop, 0, blkxold1 + blkyold2 * nBlkXold)->vector;
-                VECTOR vectorOld4 = fgopGetBlock(fgop, 0, blkxold2 + blkyold2 * nBlkXold)->vector;
+                VECTOR vectorOld1 = *fgopGetVector(fgop, 0, blkxold1 + blkyold1 * nBlkXold); // 4 old nearest vectors (may coinside)
+                VECTOR vectorOld2 = *fgopGetVector(fgop, 0, blkxold2 + blkyold1 * nBlkXold);
+                VECTOR vectorOld3 = *fgopGetVector(fgop, 0, blkxold1 + blkyold2 * nBlkXold);
+                VECTOR vectorOld4 = *fgopGetVector(fgop, 0, blkxold2 + blkyold2 * nBlkXold);
 
                 // interpolate
                 int vector1_x = vectorOld1.x * nStepXold + deltaX * (vectorOld2.x - vectorOld1.x); // scaled by nStepXold to skip slow division
@@ -1623,13 +2722,13 @@ void pobRecalculateMVs(PlaneOfBlocks *pob, const FakeGroupOfPlanes *fgop, MVFram
 
             } else { // nearest
                 if (deltaX * 2 < nStepXold && deltaY * 2 < nStepYold)
-                    vectorOld = fgopGetBlock(fgop, 0, blkxold1 + blkyold1 * nBlkXold)->vector;
+                    vectorOld = *fgopGetVector(fgop, 0, blkxold1 + blkyold1 * nBlkXold);
                 else if (deltaX * 2 >= nStepXold && deltaY * 2 < nStepYold)
-                    vectorOld = fgopGetBlock(fgop, 0, blkxold2 + blkyold1 * nBlkXold)->vector;
+                    vectorOld = *fgopGetVector(fgop, 0, blkxold2 + blkyold1 * nBlkXold);
                 else if (deltaX * 2 < nStepXold && deltaY * 2 >= nStepYold)
-                    vectorOld = fgopGetBlock(fgop, 0, blkxold1 + blkyold2 * nBlkXold)->vector;
+                    vectorOld = *fgopGetVector(fgop, 0, blkxold1 + blkyold2 * nBlkXold);
                 else //(deltaX*2>=nStepXold && deltaY*2>=nStepYold )
-                    vectorOld = fgopGetBlock(fgop, 0, blkxold2 + blkyold2 * nBlkXold)->vector;
+                    vectorOld = *fgopGetVector(fgop, 0, blkxold2 + blkyold2 * nBlkXold);
             }
 
             // scale vector to new nPel
@@ -1923,3 +3022,13 @@ void pobEstimateGlobalMVDoubled(PlaneOfBlocks *pob, VECTOR *globalMVec) {
         globalMVec->y = 2 * mediany;
     }
 }
+
+
+int pobGetVectorSpread(const PlaneOfBlocks *pob, const VECTOR *globalMVec) {
+    // the vectors are doubled too, and globalMVec is in pixels
+    int64_t sum = 0;
+    for (int i = 0; i < pob->nBlkCount; i++)
+        sum += abs(2 * pob->vectors[i].x - pob->nPel * globalMVec->x) + abs(2 * pob->vectors[i].y - pob->nPel * globalMVec->y);
+
+    return (int)(sum * 16 / ((int64_t)pob->nPel * pob->nBlkCount));
+}
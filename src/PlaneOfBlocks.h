@@ -27,6 +27,7 @@
 #include "CommonFunctions.h"
 #include "Luma.h"
 #include "DCTFFTW.h"
+#include "Wavefront.h"
 
 #define MAX_PREDICTOR 20 // right now 5 should be enough (TSchniede)
 
@@ -63,6 +64,11 @@ typedef struct PlaneOfBlocks {
     COPYFunction BLITCHROMA;
     SADFunction SADCHROMA;
     SADFunction SATD; /* SATD function, (similar to SAD), used as replacement to dct */
+    SADLimitFunction SADLIMIT; /* SAD functions giving up early, NULL where they would be slower */
+    SADLimitFunction SADCHROMALIMIT;
+    SADx3Function SADX3; /* luma SADs of several candidates at once, NULL where they would be slower */
+    SADx4Function SADX4;
+    SADLumaFunction SADLUMA; /* luma SAD and sum of the reference block at once, NULL where it would be slower */
 
     VECTOR *vectors; /* motion vectors of the blocks */
     /* before the search, contains the hierachal predictor */
@@ -114,7 +120,8 @@ typedef struct PlaneOfBlocks {
     int badrange;     // wide search radius
     int64_t planeSAD; // summary SAD of plane
     int badcount;     // number of bad blocks refined
-    int temporal;    // use temporal predictor
+    const VECTOR *temporal; // vectors of another frame, one per block, checked as an extra predictor, or NULL
+    int temporalScale;      // -1 if they point the other way
     int tryMany;     // try refine around many predictors
 
     int iter;
@@ -124,7 +131,12 @@ typedef struct PlaneOfBlocks {
 
     DCTFFTW *DCT;
     uint8_t *dctSrc;
-    uint8_t *dctRef;
+    uint8_t *dctCache;            // transforms of reference blocks, direct-mapped by their address, NULL until needed
+    const uint8_t **dctCacheKeys; // address of the block in each slot of dctCache, cleared at every search
+    int dctCacheBits;             // log2 of the number of slots
+    int dctCacheStride;           // size of a slot
+    int64_t dctCacheLookups;      // reference blocks whose transform was needed during the last search
+    int64_t dctCacheHits;         // how many of them were in dctCache
     int dctpitch;
     int dctmode;
     int srcLuma;
@@ -137,15 +149,28 @@ typedef struct PlaneOfBlocks {
 
     int nSrcPitch_temp[3];
     uint8_t *pSrc_temp[3]; //for easy WRITE access to temp block
+
+    /* wavefront search */
+
+    int nThreads;
+    struct PlaneOfBlocks *workers; // nThreads copies with their own working fields, NULL if the search is serial
+    WavefrontPool *wavefrontPool;  // threads running the workers, not owned, NULL if the search is serial
+    Wavefront *wavefront;          // set in the workers during the search
+    int *badcountRows;             // badcount at the end of each row, shared by the workers
+    int badcountSynced;            // badcount includes the rows above the current one
 } PlaneOfBlocks;
 
 
-void pobInit(PlaneOfBlocks *pob, int _nBlkX, int _nBlkY, int _nBlkSizeX, int _nBlkSizeY, int _nPel, int _nLevel, int _nMotionFlags, int _nCPUFlags, int _nOverlapX, int _nOverlapY, int _xRatioUV, int _yRatioUV, int _bitsPerSample);
+void pobInit(PlaneOfBlocks *pob, int _nBlkX, int _nBlkY, int _nBlkSizeX, int _nBlkSizeY, int _nPel, int _nLevel, int _nMotionFlags, int _nCPUFlags, int _nOverlapX, int _nOverlapY, int _xRatioUV, int _yRatioUV, int _bitsPerSample, int _nThreads);
 
 void pobDeinit(PlaneOfBlocks *pob);
 
 void pobEstimateGlobalMVDoubled(PlaneOfBlocks *pob, VECTOR *globalMVec);
 
+// Mean distance, in 1/16 pixel of the next finer plane, between the plane's
+// vectors and globalMVec, as returned by pobEstimateGlobalMVDoubled.
+int pobGetVectorSpread(const PlaneOfBlocks *pob, const VECTOR *globalMVec);
+
 int pobGetArraySize(PlaneOfBlocks *pob, int divideMode);
 
 void pobInterpolatePrediction(PlaneOfBlocks *pob, const PlaneOfBlocks *pob2);
@@ -154,6 +179,11 @@ void pobRecalculateMVs(PlaneOfBlocks *pob, const FakeGroupOfPlanes *fgop, MVFram
 
 void pobSearchMVs(PlaneOfBlocks *pob, MVFrame *pSrcFrame, MVFrame *pRefFrame, SearchType st, int stp, int lambda, int lsad, int pnew, int plevel, int *out, VECTOR *globalMVec, int fieldShift, DCTFFTW *DCT, int *pmeanLumaChange, int pzero, int pglobal, int64_t badSAD, int badrange, int meander, int tryMany);
 
+// Takes the plane's vectors from the same plane of another search's output,
+// multiplied by scale, instead of searching them. seed and out point to the
+// plane's header.
+void pobSeedMVs(PlaneOfBlocks *pob, const int *seed, int scale, int *out);
+
 int pobWriteDefaultToArray(PlaneOfBlocks *pob, int *array, int divideMode);
 
 #endif
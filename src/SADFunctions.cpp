@@ -34,40 +34,358 @@ DEFINE_SAD(2, 4, 8)
 DEFINE_SAD(4, 2, 8)
 DEFINE_SAD(4, 4, 8)
 DEFINE_SAD(4, 8, 8)
+DEFINE_SAD(4, 16, 8)
 DEFINE_SAD(8, 1, 8)
 DEFINE_SAD(8, 2, 8)
 DEFINE_SAD(8, 4, 8)
 DEFINE_SAD(8, 8, 8)
 DEFINE_SAD(8, 16, 8)
+DEFINE_SAD(8, 32, 8)
 DEFINE_SAD(16, 1, 8)
 DEFINE_SAD(16, 2, 8)
 DEFINE_SAD(16, 4, 8)
 DEFINE_SAD(16, 8, 8)
 DEFINE_SAD(16, 16, 8)
 DEFINE_SAD(16, 32, 8)
+DEFINE_SAD(16, 64, 8)
+DEFINE_SAD(32, 4, 8)
 DEFINE_SAD(32, 8, 8)
 DEFINE_SAD(32, 16, 8)
 DEFINE_SAD(32, 32, 8)
+DEFINE_SAD(32, 64, 8)
+DEFINE_SAD(64, 8, 8)
+DEFINE_SAD(64, 16, 8)
+DEFINE_SAD(64, 32, 8)
+DEFINE_SAD(64, 64, 8)
 
 DEFINE_SAD(2, 2, 16)
 DEFINE_SAD(2, 4, 16)
 DEFINE_SAD(4, 2, 16)
 DEFINE_SAD(4, 4, 16)
 DEFINE_SAD(4, 8, 16)
+DEFINE_SAD(4, 16, 16)
 DEFINE_SAD(8, 1, 16)
 DEFINE_SAD(8, 2, 16)
 DEFINE_SAD(8, 4, 16)
 DEFINE_SAD(8, 8, 16)
 DEFINE_SAD(8, 16, 16)
+DEFINE_SAD(8, 32, 16)
 DEFINE_SAD(16, 1, 16)
 DEFINE_SAD(16, 2, 16)
 DEFINE_SAD(16, 4, 16)
 DEFINE_SAD(16, 8, 16)
 DEFINE_SAD(16, 16, 16)
 DEFINE_SAD(16, 32, 16)
+DEFINE_SAD(16, 64, 16)
+DEFINE_SAD(32, 4, 16)
 DEFINE_SAD(32, 8, 16)
 DEFINE_SAD(32, 16, 16)
 DEFINE_SAD(32, 32, 16)
+DEFINE_SAD(32, 64, 16)
+DEFINE_SAD(64, 8, 16)
+DEFINE_SAD(64, 16, 16)
+DEFINE_SAD(64, 32, 16)
+DEFINE_SAD(64, 64, 16)
+
+
+#define DEFINE_SAD_LIMIT(width, height, bits) \
+unsigned int mvtools_sad_limit_##width##x##height##_u##bits##_c(const uint8_t *pSrc8, intptr_t nSrcPitch, const uint8_t *pRef8, intptr_t nRefPitch, unsigned int limit) { \
+    unsigned int sum = 0;                                                       \
+    for (int y = 0; y < height; y++) {                                          \
+        for (int x = 0; x < width; x++) {                                       \
+            const uint##bits##_t *pSrc = (const uint##bits##_t *)pSrc8;         \
+            const uint##bits##_t *pRef = (const uint##bits##_t *)pRef8;         \
+            sum += SADABS(pSrc[x] - pRef[x]);                                   \
+        }                                                                       \
+        pSrc8 += nSrcPitch;                                                     \
+        pRef8 += nRefPitch;                                                     \
+        if ((y & 3) == 3 && sum >= limit)                                       \
+            return sum;                                                         \
+    }                                                                           \
+    return sum;                                                                 \
+}
+
+DEFINE_SAD_LIMIT(2, 2, 8)
+DEFINE_SAD_LIMIT(2, 4, 8)
+DEFINE_SAD_LIMIT(4, 2, 8)
+DEFINE_SAD_LIMIT(4, 4, 8)
+DEFINE_SAD_LIMIT(4, 8, 8)
+DEFINE_SAD_LIMIT(4, 16, 8)
+DEFINE_SAD_LIMIT(8, 1, 8)
+DEFINE_SAD_LIMIT(8, 2, 8)
+DEFINE_SAD_LIMIT(8, 4, 8)
+DEFINE_SAD_LIMIT(8, 8, 8)
+DEFINE_SAD_LIMIT(8, 16, 8)
+DEFINE_SAD_LIMIT(8, 32, 8)
+DEFINE_SAD_LIMIT(16, 1, 8)
+DEFINE_SAD_LIMIT(16, 2, 8)
+DEFINE_SAD_LIMIT(16, 4, 8)
+DEFINE_SAD_LIMIT(16, 8, 8)
+DEFINE_SAD_LIMIT(16, 16, 8)
+DEFINE_SAD_LIMIT(16, 32, 8)
+DEFINE_SAD_LIMIT(16, 64, 8)
+DEFINE_SAD_LIMIT(32, 4, 8)
+DEFINE_SAD_LIMIT(32, 8, 8)
+DEFINE_SAD_LIMIT(32, 16, 8)
+DEFINE_SAD_LIMIT(32, 32, 8)
+DEFINE_SAD_LIMIT(32, 64, 8)
+DEFINE_SAD_LIMIT(64, 8, 8)
+DEFINE_SAD_LIMIT(64, 16, 8)
+DEFINE_SAD_LIMIT(64, 32, 8)
+DEFINE_SAD_LIMIT(64, 64, 8)
+
+DEFINE_SAD_LIMIT(2, 2, 16)
+DEFINE_SAD_LIMIT(2, 4, 16)
+DEFINE_SAD_LIMIT(4, 2, 16)
+DEFINE_SAD_LIMIT(4, 4, 16)
+DEFINE_SAD_LIMIT(4, 8, 16)
+DEFINE_SAD_LIMIT(4, 16, 16)
+DEFINE_SAD_LIMIT(8, 1, 16)
+DEFINE_SAD_LIMIT(8, 2, 16)
+DEFINE_SAD_LIMIT(8, 4, 16)
+DEFINE_SAD_LIMIT(8, 8, 16)
+DEFINE_SAD_LIMIT(8, 16, 16)
+DEFINE_SAD_LIMIT(8, 32, 16)
+DEFINE_SAD_LIMIT(16, 1, 16)
+DEFINE_SAD_LIMIT(16, 2, 16)
+DEFINE_SAD_LIMIT(16, 4, 16)
+DEFINE_SAD_LIMIT(16, 8, 16)
+DEFINE_SAD_LIMIT(16, 16, 16)
+DEFINE_SAD_LIMIT(16, 32, 16)
+DEFINE_SAD_LIMIT(16, 64, 16)
+DEFINE_SAD_LIMIT(32, 4, 16)
+DEFINE_SAD_LIMIT(32, 8, 16)
+DEFINE_SAD_LIMIT(32, 16, 16)
+DEFINE_SAD_LIMIT(32, 32, 16)
+DEFINE_SAD_LIMIT(32, 64, 16)
+DEFINE_SAD_LIMIT(64, 8, 16)
+DEFINE_SAD_LIMIT(64, 16, 16)
+DEFINE_SAD_LIMIT(64, 32, 16)
+DEFINE_SAD_LIMIT(64, 64, 16)
+
+
+#define DEFINE_SAD_LUMA(width, height, bits) \
+unsigned int mvtools_sad_luma_##width##x##height##_u##bits##_c(const uint8_t *pSrc8, intptr_t nSrcPitch, const uint8_t *pRef8, intptr_t nRefPitch, unsigned int *refLuma) { \
+    unsigned int sum = 0;                                                       \
+    unsigned int luma = 0;                                                      \
+    for (int y = 0; y < height; y++) {                                          \
+        for (int x = 0; x < width; x++) {                                       \
+            const uint##bits##_t *pSrc = (const uint##bits##_t *)pSrc8;         \
+            const uint##bits##_t *pRef = (const uint##bits##_t *)pRef8;         \
+            sum += SADABS(pSrc[x] - pRef[x]);                                   \
+            luma += pRef[x];                                                    \
+        }                                                                       \
+        pSrc8 += nSrcPitch;                                                     \
+        pRef8 += nRefPitch;                                                     \
+    }                                                                           \
+    *refLuma = luma;                                                            \
+    return sum;                                                                 \
+}
+
+DEFINE_SAD_LUMA(2, 2, 8)
+DEFINE_SAD_LUMA(2, 4, 8)
+DEFINE_SAD_LUMA(4, 2, 8)
+DEFINE_SAD_LUMA(4, 4, 8)
+DEFINE_SAD_LUMA(4, 8, 8)
+DEFINE_SAD_LUMA(4, 16, 8)
+DEFINE_SAD_LUMA(8, 1, 8)
+DEFINE_SAD_LUMA(8, 2, 8)
+DEFINE_SAD_LUMA(8, 4, 8)
+DEFINE_SAD_LUMA(8, 8, 8)
+DEFINE_SAD_LUMA(8, 16, 8)
+DEFINE_SAD_LUMA(8, 32, 8)
+DEFINE_SAD_LUMA(16, 1, 8)
+DEFINE_SAD_LUMA(16, 2, 8)
+DEFINE_SAD_LUMA(16, 4, 8)
+DEFINE_SAD_LUMA(16, 8, 8)
+DEFINE_SAD_LUMA(16, 16, 8)
+DEFINE_SAD_LUMA(16, 32, 8)
+DEFINE_SAD_LUMA(16, 64, 8)
+DEFINE_SAD_LUMA(32, 4, 8)
+DEFINE_SAD_LUMA(32, 8, 8)
+DEFINE_SAD_LUMA(32, 16, 8)
+DEFINE_SAD_LUMA(32, 32, 8)
+DEFINE_SAD_LUMA(32, 64, 8)
+DEFINE_SAD_LUMA(64, 8, 8)
+DEFINE_SAD_LUMA(64, 16, 8)
+DEFINE_SAD_LUMA(64, 32, 8)
+DEFINE_SAD_LUMA(64, 64, 8)
+
+DEFINE_SAD_LUMA(2, 2, 16)
+DEFINE_SAD_LUMA(2, 4, 16)
+DEFINE_SAD_LUMA(4, 2, 16)
+DEFINE_SAD_LUMA(4, 4, 16)
+DEFINE_SAD_LUMA(4, 8, 16)
+DEFINE_SAD_LUMA(4, 16, 16)
+DEFINE_SAD_LUMA(8, 1, 16)
+DEFINE_SAD_LUMA(8, 2, 16)
+DEFINE_SAD_LUMA(8, 4, 16)
+DEFINE_SAD_LUMA(8, 8, 16)
+DEFINE_SAD_LUMA(8, 16, 16)
+DEFINE_SAD_LUMA(8, 32, 16)
+DEFINE_SAD_LUMA(16, 1, 16)
+DEFINE_SAD_LUMA(16, 2, 16)
+DEFINE_SAD_LUMA(16, 4, 16)
+DEFINE_SAD_LUMA(16, 8, 16)
+DEFINE_SAD_LUMA(16, 16, 16)
+DEFINE_SAD_LUMA(16, 32, 16)
+DEFINE_SAD_LUMA(16, 64, 16)
+DEFINE_SAD_LUMA(32, 4, 16)
+DEFINE_SAD_LUMA(32, 8, 16)
+DEFINE_SAD_LUMA(32, 16, 16)
+DEFINE_SAD_LUMA(32, 32, 16)
+DEFINE_SAD_LUMA(32, 64, 16)
+DEFINE_SAD_LUMA(64, 8, 16)
+DEFINE_SAD_LUMA(64, 16, 16)
+DEFINE_SAD_LUMA(64, 32, 16)
+DEFINE_SAD_LUMA(64, 64, 16)
+
+
+template <int width, int height, typename PixelType, int count>
+static FORCE_INLINE void Sad_xN_C(const uint8_t *pSrc8, intptr_t nSrcPitch, const uint8_t **pRef8, intptr_t nRefPitch, unsigned int *sads) {
+    for (int n = 0; n < count; n++)
+        sads[n] = 0;
+
+    for (int y = 0; y < height; y++) {
+        const PixelType *pSrc = (const PixelType *)pSrc8;
+
+        for (int x = 0; x < width; x++)
+            for (int n = 0; n < count; n++)
+                sads[n] += SADABS(pSrc[x] - ((const PixelType *)pRef8[n])[x]);
+
+        pSrc8 += nSrcPitch;
+        for (int n = 0; n < count; n++)
+            pRef8[n] += nRefPitch;
+    }
+}
+
+#define DEFINE_SAD_X3(width, height, bits) \
+void mvtools_sad_x3_##width##x##height##_u##bits##_c(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, intptr_t nRefPitch, unsigned int *sads) { \
+    const uint8_t *pRef[3] = { pRef0, pRef1, pRef2 }; \
+    Sad_xN_C<width, height, uint##bits##_t, 3>(pSrc, nSrcPitch, pRef, nRefPitch, sads); \
+}
+
+#define DEFINE_SAD_X4(width, height, bits) \
+void mvtools_sad_x4_##width##x##height##_u##bits##_c(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, const uint8_t *pRef3, intptr_t nRefPitch, unsigned int *sads) { \
+    const uint8_t *pRef[4] = { pRef0, pRef1, pRef2, pRef3 }; \
+    Sad_xN_C<width, height, uint##bits##_t, 4>(pSrc, nSrcPitch, pRef, nRefPitch, sads); \
+}
+
+DEFINE_SAD_X3(2, 2, 8)
+DEFINE_SAD_X3(2, 4, 8)
+DEFINE_SAD_X3(4, 2, 8)
+DEFINE_SAD_X3(4, 4, 8)
+DEFINE_SAD_X3(4, 8, 8)
+DEFINE_SAD_X3(4, 16, 8)
+DEFINE_SAD_X3(8, 1, 8)
+DEFINE_SAD_X3(8, 2, 8)
+DEFINE_SAD_X3(8, 4, 8)
+DEFINE_SAD_X3(8, 8, 8)
+DEFINE_SAD_X3(8, 16, 8)
+DEFINE_SAD_X3(8, 32, 8)
+DEFINE_SAD_X3(16, 1, 8)
+DEFINE_SAD_X3(16, 2, 8)
+DEFINE_SAD_X3(16, 4, 8)
+DEFINE_SAD_X3(16, 8, 8)
+DEFINE_SAD_X3(16, 16, 8)
+DEFINE_SAD_X3(16, 32, 8)
+DEFINE_SAD_X3(16, 64, 8)
+DEFINE_SAD_X3(32, 4, 8)
+DEFINE_SAD_X3(32, 8, 8)
+DEFINE_SAD_X3(32, 16, 8)
+DEFINE_SAD_X3(32, 32, 8)
+DEFINE_SAD_X3(32, 64, 8)
+DEFINE_SAD_X3(64, 8, 8)
+DEFINE_SAD_X3(64, 16, 8)
+DEFINE_SAD_X3(64, 32, 8)
+DEFINE_SAD_X3(64, 64, 8)
+
+DEFINE_SAD_X3(2, 2, 16)
+DEFINE_SAD_X3(2, 4, 16)
+DEFINE_SAD_X3(4, 2, 16)
+DEFINE_SAD_X3(4, 4, 16)
+DEFINE_SAD_X3(4, 8, 16)
+DEFINE_SAD_X3(4, 16, 16)
+DEFINE_SAD_X3(8, 1, 16)
+DEFINE_SAD_X3(8, 2, 16)
+DEFINE_SAD_X3(8, 4, 16)
+DEFINE_SAD_X3(8, 8, 16)
+DEFINE_SAD_X3(8, 16, 16)
+DEFINE_SAD_X3(8, 32, 16)
+DEFINE_SAD_X3(16, 1, 16)
+DEFINE_SAD_X3(16, 2, 16)
+DEFINE_SAD_X3(16, 4, 16)
+DEFINE_SAD_X3(16, 8, 16)
+DEFINE_SAD_X3(16, 16, 16)
+DEFINE_SAD_X3(16, 32, 16)
+DEFINE_SAD_X3(16, 64, 16)
+DEFINE_SAD_X3(32, 4, 16)
+DEFINE_SAD_X3(32, 8, 16)
+DEFINE_SAD_X3(32, 16, 16)
+DEFINE_SAD_X3(32, 32, 16)
+DEFINE_SAD_X3(32, 64, 16)
+DEFINE_SAD_X3(64, 8, 16)
+DEFINE_SAD_X3(64, 16, 16)
+DEFINE_SAD_X3(64, 32, 16)
+DEFINE_SAD_X3(64, 64, 16)
+
+DEFINE_SAD_X4(2, 2, 8)
+DEFINE_SAD_X4(2, 4, 8)
+DEFINE_SAD_X4(4, 2, 8)
+DEFINE_SAD_X4(4, 4, 8)
+DEFINE_SAD_X4(4, 8, 8)
+DEFINE_SAD_X4(4, 16, 8)
+DEFINE_SAD_X4(8, 1, 8)
+DEFINE_SAD_X4(8, 2, 8)
+DEFINE_SAD_X4(8, 4, 8)
+DEFINE_SAD_X4(8, 8, 8)
+DEFINE_SAD_X4(8, 16, 8)
+DEFINE_SAD_X4(8, 32, 8)
+DEFINE_SAD_X4(16, 1, 8)
+DEFINE_SAD_X4(16, 2, 8)
+DEFINE_SAD_X4(16, 4, 8)
+DEFINE_SAD_X4(16, 8, 8)
+DEFINE_SAD_X4(16, 16, 8)
+DEFINE_SAD_X4(16, 32, 8)
+DEFINE_SAD_X4(16, 64, 8)
+DEFINE_SAD_X4(32, 4, 8)
+DEFINE_SAD_X4(32, 8, 8)
+DEFINE_SAD_X4(32, 16, 8)
+DEFINE_SAD_X4(32, 32, 8)
+DEFINE_SAD_X4(32, 64, 8)
+DEFINE_SAD_X4(64, 8, 8)
+DEFINE_SAD_X4(64, 16, 8)
+DEFINE_SAD_X4(64, 32, 8)
+DEFINE_SAD_X4(64, 64, 8)
+
+DEFINE_SAD_X4(2, 2, 16)
+DEFINE_SAD_X4(2, 4, 16)
+DEFINE_SAD_X4(4, 2, 16)
+DEFINE_SAD_X4(4, 4, 16)
+DEFINE_SAD_X4(4, 8, 16)
+DEFINE_SAD_X4(4, 16, 16)
+DEFINE_SAD_X4(8, 1, 16)
+DEFINE_SAD_X4(8, 2, 16)
+DEFINE_SAD_X4(8, 4, 16)
+DEFINE_SAD_X4(8, 8, 16)
+DEFINE_SAD_X4(8, 16, 16)
+DEFINE_SAD_X4(8, 32, 16)
+DEFINE_SAD_X4(16, 1, 16)
+DEFINE_SAD_X4(16, 2, 16)
+DEFINE_SAD_X4(16, 4, 16)
+DEFINE_SAD_X4(16, 8, 16)
+DEFINE_SAD_X4(16, 16, 16)
+DEFINE_SAD_X4(16, 32, 16)
+DEFINE_SAD_X4(16, 64, 16)
+DEFINE_SAD_X4(32, 4, 16)
+DEFINE_SAD_X4(32, 8, 16)
+DEFINE_SAD_X4(32, 16, 16)
+DEFINE_SAD_X4(32, 32, 16)
+DEFINE_SAD_X4(32, 64, 16)
+DEFINE_SAD_X4(64, 8, 16)
+DEFINE_SAD_X4(64, 16, 16)
+DEFINE_SAD_X4(64, 32, 16)
+DEFINE_SAD_X4(64, 64, 16)
 
 
 #define HADAMARD4(d0, d1, d2, d3, s0, s1, s2, s3) \
@@ -347,7 +665,8 @@ static FORCE_INLINE unsigned int Satd_16x16_C(const uint8_t *pSrc, intptr_t nSrc
         return Real_Satd_16x16_C<PixelType, uint32_t, uint64_t>(pSrc, nSrcPitch, pRef, nRefPitch);
 }
 
-// Only handles 4x4, 8x4, 8x8, 8x16, 16x8, and 16x16.
+// Blocks other than 4x4, 8x4, 8x8, and 16x16 are split into 16x16 blocks
+// when possible, otherwise into 8x4 or 4x4 blocks.
 template <int nBlkWidth, int nBlkHeight, typename PixelType>
 static FORCE_INLINE unsigned int Satd_C(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch) {
     if (nBlkWidth == 4 && nBlkHeight == 4)
@@ -359,15 +678,25 @@ static FORCE_INLINE unsigned int Satd_C(const uint8_t *pSrc, intptr_t nSrcPitch,
     else if (nBlkWidth == 16 && nBlkHeight == 16)
         return Satd_16x16_C<PixelType>(pSrc, nSrcPitch, pRef, nRefPitch);
     else {
-        int bytesPerSample = sizeof(PixelType);
-
-        unsigned int sum = Satd_8x4_C<PixelType>(pSrc, nSrcPitch, pRef, nRefPitch) + Satd_8x4_C<PixelType>(pSrc + 4 * nSrcPitch, nSrcPitch, pRef + 4 * nRefPitch, nRefPitch);
-
-        if (nBlkWidth == 16)
-            sum += Satd_8x4_C<PixelType>(pSrc + 8 * bytesPerSample, nSrcPitch, pRef + 8 * bytesPerSample, nRefPitch) + Satd_8x4_C<PixelType>(pSrc + 8 * bytesPerSample + 4 * nSrcPitch, nSrcPitch, pRef + 8 * bytesPerSample + 4 * nSrcPitch, nRefPitch);
-
-        if (nBlkHeight == 16)
-            sum += Satd_8x4_C<PixelType>(pSrc + 8 * nSrcPitch, nSrcPitch, pRef + 8 * nRefPitch, nRefPitch) + Satd_8x4_C<PixelType>(pSrc + 12 * nSrcPitch, nSrcPitch, pRef + 12 * nRefPitch, nRefPitch);
+        const int bytesPerSample = sizeof(PixelType);
+        const int tileWidth = (nBlkWidth % 16 == 0 && nBlkHeight % 16 == 0) ? 16 : (nBlkWidth % 8 == 0 ? 8 : 4);
+        const int tileHeight = tileWidth == 16 ? 16 : 4;
+
+        unsigned int sum = 0;
+
+        for (int y = 0; y < nBlkHeight; y += tileHeight) {
+            for (int x = 0; x < nBlkWidth; x += tileWidth) {
+                const uint8_t *pSrcTile = pSrc + y * nSrcPitch + x * bytesPerSample;
+                const uint8_t *pRefTile = pRef + y * nRefPitch + x * bytesPerSample;
+
+                if (tileWidth == 16)
+                    sum += Satd_16x16_C<PixelType>(pSrcTile, nSrcPitch, pRefTile, nRefPitch);
+                else if (tileWidth == 8)
+                    sum += Satd_8x4_C<PixelType>(pSrcTile, nSrcPitch, pRefTile, nRefPitch);
+                else
+                    sum += Satd_4x4_C<PixelType>(pSrcTile, nSrcPitch, pRefTile, nRefPitch);
+            }
+        }
 
         return sum;
     }
@@ -379,13 +708,96 @@ unsigned int mvtools_satd_##width##x##height##_u##bits##_c(const uint8_t *pSrc8,
 }
 
 DEFINE_SATD(4, 4, 8)
+DEFINE_SATD(4, 8, 8)
+DEFINE_SATD(4, 16, 8)
 DEFINE_SATD(8, 4, 8)
 DEFINE_SATD(8, 8, 8)
+DEFINE_SATD(8, 16, 8)
+DEFINE_SATD(8, 32, 8)
+DEFINE_SATD(16, 4, 8)
 DEFINE_SATD(16, 8, 8)
 DEFINE_SATD(16, 16, 8)
+DEFINE_SATD(16, 32, 8)
+DEFINE_SATD(16, 64, 8)
+DEFINE_SATD(32, 4, 8)
+DEFINE_SATD(32, 8, 8)
+DEFINE_SATD(32, 16, 8)
+DEFINE_SATD(32, 32, 8)
+DEFINE_SATD(32, 64, 8)
+DEFINE_SATD(64, 8, 8)
+DEFINE_SATD(64, 16, 8)
+DEFINE_SATD(64, 32, 8)
+DEFINE_SATD(64, 64, 8)
 
 DEFINE_SATD(4, 4, 16)
+DEFINE_SATD(4, 8, 16)
+DEFINE_SATD(4, 16, 16)
 DEFINE_SATD(8, 4, 16)
 DEFINE_SATD(8, 8, 16)
+DEFINE_SATD(8, 16, 16)
+DEFINE_SATD(8, 32, 16)
+DEFINE_SATD(16, 4, 16)
 DEFINE_SATD(16, 8, 16)
 DEFINE_SATD(16, 16, 16)
+DEFINE_SATD(16, 32, 16)
+DEFINE_SATD(16, 64, 16)
+DEFINE_SATD(32, 4, 16)
+DEFINE_SATD(32, 8, 16)
+DEFINE_SATD(32, 16, 16)
+DEFINE_SATD(32, 32, 16)
+DEFINE_SATD(32, 64, 16)
+DEFINE_SATD(64, 8, 16)
+DEFINE_SATD(64, 16, 16)
+DEFINE_SATD(64, 32, 16)
+DEFINE_SATD(64, 64, 16)
+
+
+#if defined(MVTOOLS_X86)
+
+// Blocks larger than those of the assembly SATD functions are split into
+// 16x16 blocks when possible, otherwise into 8x8 blocks.
+template <int nBlkWidth, int nBlkHeight, SADFunction satd16x16, SADFunction satd8x8>
+static unsigned int Satd_Tiled(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch) {
+    const int tileSize = (nBlkWidth % 16 == 0 && nBlkHeight % 16 == 0) ? 16 : 8;
+
+    unsigned int sum = 0;
+
+    for (int y = 0; y < nBlkHeight; y += tileSize)
+        for (int x = 0; x < nBlkWidth; x += tileSize)
+            sum += (tileSize == 16 ? satd16x16 : satd8x8)(pSrc + y * nSrcPitch + x, nSrcPitch, pRef + y * nRefPitch + x, nRefPitch);
+
+    return sum;
+}
+
+#define DEFINE_SATD_TILED(width, height, opt) \
+unsigned int mvtools_satd_##width##x##height##_u8_##opt(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch) { \
+    return Satd_Tiled<width, height, mvtools_pixel_satd_16x16_##opt, mvtools_pixel_satd_8x8_##opt>(pSrc, nSrcPitch, pRef, nRefPitch); \
+}
+
+DEFINE_SATD_TILED(8, 16, sse2)
+DEFINE_SATD_TILED(8, 32, sse2)
+DEFINE_SATD_TILED(16, 32, sse2)
+DEFINE_SATD_TILED(16, 64, sse2)
+DEFINE_SATD_TILED(32, 8, sse2)
+DEFINE_SATD_TILED(32, 16, sse2)
+DEFINE_SATD_TILED(32, 32, sse2)
+DEFINE_SATD_TILED(32, 64, sse2)
+DEFINE_SATD_TILED(64, 8, sse2)
+DEFINE_SATD_TILED(64, 16, sse2)
+DEFINE_SATD_TILED(64, 32, sse2)
+DEFINE_SATD_TILED(64, 64, sse2)
+
+DEFINE_SATD_TILED(8, 16, avx2)
+DEFINE_SATD_TILED(8, 32, avx2)
+DEFINE_SATD_TILED(16, 32, avx2)
+DEFINE_SATD_TILED(16, 64, avx2)
+DEFINE_SATD_TILED(32, 8, avx2)
+DEFINE_SATD_TILED(32, 16, avx2)
+DEFINE_SATD_TILED(32, 32, avx2)
+DEFINE_SATD_TILED(32, 64, avx2)
+DEFINE_SATD_TILED(64, 8, avx2)
+DEFINE_SATD_TILED(64, 16, avx2)
+DEFINE_SATD_TILED(64, 32, avx2)
+DEFINE_SATD_TILED(64, 64, avx2)
+
+#endif // MVTOOLS_X86
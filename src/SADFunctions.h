@@ -30,8 +30,35 @@ extern "C" {
 typedef unsigned int (*SADFunction)(const uint8_t *pSrc, intptr_t nSrcPitch,
                                     const uint8_t *pRef, intptr_t nRefPitch);
 
+// Same as SADFunction, but may give up once the sum reaches limit. The
+// result is exact if it is smaller than limit, otherwise it is only at least
+// limit. How often the sum is checked depends on the implementation.
+typedef unsigned int (*SADLimitFunction)(const uint8_t *pSrc, intptr_t nSrcPitch,
+                                         const uint8_t *pRef, intptr_t nRefPitch,
+                                         unsigned int limit);
+
+// Compare one source block with three or four reference blocks, like
+// x264's sad_x3 and sad_x4, storing the SADs in sads.
+typedef void (*SADx3Function)(const uint8_t *pSrc, intptr_t nSrcPitch,
+                              const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, intptr_t nRefPitch,
+                              unsigned int *sads);
+
+typedef void (*SADx4Function)(const uint8_t *pSrc, intptr_t nSrcPitch,
+                              const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, const uint8_t *pRef3, intptr_t nRefPitch,
+                              unsigned int *sads);
+
+// Same as SADFunction, but also stores the sum of the reference block's
+// pixels in refLuma, like a LUMAFunction, reading it only once.
+typedef unsigned int (*SADLumaFunction)(const uint8_t *pSrc, intptr_t nSrcPitch,
+                                        const uint8_t *pRef, intptr_t nRefPitch,
+                                        unsigned int *refLuma);
+
 
 #define MK_CFUNC(functionname) unsigned int functionname(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch)
+#define MK_CFUNC_LIMIT(functionname) unsigned int functionname(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch, unsigned int limit)
+#define MK_CFUNC_X3(functionname) void functionname(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, intptr_t nRefPitch, unsigned int *sads)
+#define MK_CFUNC_X4(functionname) void functionname(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, const uint8_t *pRef3, intptr_t nRefPitch, unsigned int *sads)
+#define MK_CFUNC_LUMA(functionname) unsigned int functionname(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch, unsigned int *refLuma)
 
 // From SADFunctions.cpp
 MK_CFUNC(mvtools_sad_2x2_u8_c);
@@ -39,40 +66,290 @@ MK_CFUNC(mvtools_sad_2x4_u8_c);
 MK_CFUNC(mvtools_sad_4x2_u8_c);
 MK_CFUNC(mvtools_sad_4x4_u8_c);
 MK_CFUNC(mvtools_sad_4x8_u8_c);
+MK_CFUNC(mvtools_sad_4x16_u8_c);
 MK_CFUNC(mvtools_sad_8x1_u8_c);
 MK_CFUNC(mvtools_sad_8x2_u8_c);
 MK_CFUNC(mvtools_sad_8x4_u8_c);
 MK_CFUNC(mvtools_sad_8x8_u8_c);
 MK_CFUNC(mvtools_sad_8x16_u8_c);
+MK_CFUNC(mvtools_sad_8x32_u8_c);
 MK_CFUNC(mvtools_sad_16x1_u8_c);
 MK_CFUNC(mvtools_sad_16x2_u8_c);
 MK_CFUNC(mvtools_sad_16x4_u8_c);
 MK_CFUNC(mvtools_sad_16x8_u8_c);
 MK_CFUNC(mvtools_sad_16x16_u8_c);
 MK_CFUNC(mvtools_sad_16x32_u8_c);
+MK_CFUNC(mvtools_sad_16x64_u8_c);
+MK_CFUNC(mvtools_sad_32x4_u8_c);
 MK_CFUNC(mvtools_sad_32x8_u8_c);
 MK_CFUNC(mvtools_sad_32x16_u8_c);
 MK_CFUNC(mvtools_sad_32x32_u8_c);
+MK_CFUNC(mvtools_sad_32x64_u8_c);
+MK_CFUNC(mvtools_sad_64x8_u8_c);
+MK_CFUNC(mvtools_sad_64x16_u8_c);
+MK_CFUNC(mvtools_sad_64x32_u8_c);
+MK_CFUNC(mvtools_sad_64x64_u8_c);
 
 MK_CFUNC(mvtools_sad_2x2_u16_c);
 MK_CFUNC(mvtools_sad_2x4_u16_c);
 MK_CFUNC(mvtools_sad_4x2_u16_c);
 MK_CFUNC(mvtools_sad_4x4_u16_c);
 MK_CFUNC(mvtools_sad_4x8_u16_c);
+MK_CFUNC(mvtools_sad_4x16_u16_c);
 MK_CFUNC(mvtools_sad_8x1_u16_c);
 MK_CFUNC(mvtools_sad_8x2_u16_c);
 MK_CFUNC(mvtools_sad_8x4_u16_c);
 MK_CFUNC(mvtools_sad_8x8_u16_c);
 MK_CFUNC(mvtools_sad_8x16_u16_c);
+MK_CFUNC(mvtools_sad_8x32_u16_c);
 MK_CFUNC(mvtools_sad_16x1_u16_c);
 MK_CFUNC(mvtools_sad_16x2_u16_c);
 MK_CFUNC(mvtools_sad_16x4_u16_c);
 MK_CFUNC(mvtools_sad_16x8_u16_c);
 MK_CFUNC(mvtools_sad_16x16_u16_c);
 MK_CFUNC(mvtools_sad_16x32_u16_c);
+MK_CFUNC(mvtools_sad_16x64_u16_c);
+MK_CFUNC(mvtools_sad_32x4_u16_c);
 MK_CFUNC(mvtools_sad_32x8_u16_c);
 MK_CFUNC(mvtools_sad_32x16_u16_c);
 MK_CFUNC(mvtools_sad_32x32_u16_c);
+MK_CFUNC(mvtools_sad_32x64_u16_c);
+MK_CFUNC(mvtools_sad_64x8_u16_c);
+MK_CFUNC(mvtools_sad_64x16_u16_c);
+MK_CFUNC(mvtools_sad_64x32_u16_c);
+MK_CFUNC(mvtools_sad_64x64_u16_c);
+
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x2_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x4_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x2_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x4_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x8_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x16_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x1_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x2_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x4_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x8_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x16_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x32_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x1_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x2_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x4_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x8_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x16_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x32_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x64_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x4_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x8_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x16_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x32_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x64_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x8_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x16_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x32_u8_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x64_u8_c);
+
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x2_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x4_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x2_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x4_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x8_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x16_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x1_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x2_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x4_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x8_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x16_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x32_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x1_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x2_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x4_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x8_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x16_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x32_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x64_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x4_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x8_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x16_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x32_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x64_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x8_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x16_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x32_u16_c);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x64_u16_c);
+
+MK_CFUNC_X3(mvtools_sad_x3_2x2_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_2x4_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x2_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x4_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x8_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x16_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x1_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x2_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x4_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x8_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x16_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x32_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x1_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x2_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x4_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x8_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x16_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x32_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x64_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x4_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x8_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x16_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x32_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x64_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x8_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x16_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x32_u8_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x64_u8_c);
+
+MK_CFUNC_X3(mvtools_sad_x3_2x2_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_2x4_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x2_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x4_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x8_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_4x16_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x1_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x2_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x4_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x8_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x16_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_8x32_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x1_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x2_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x4_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x8_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x16_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x32_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_16x64_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x4_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x8_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x16_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x32_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_32x64_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x8_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x16_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x32_u16_c);
+MK_CFUNC_X3(mvtools_sad_x3_64x64_u16_c);
+
+MK_CFUNC_X4(mvtools_sad_x4_2x2_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_2x4_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x2_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x4_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x8_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x16_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x1_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x2_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x4_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x8_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x16_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x32_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x1_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x2_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x4_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x8_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x16_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x32_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x64_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x4_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x8_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x16_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x32_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x64_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x8_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x16_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x32_u8_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x64_u8_c);
+
+MK_CFUNC_X4(mvtools_sad_x4_2x2_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_2x4_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x2_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x4_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x8_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_4x16_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x1_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x2_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x4_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x8_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x16_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_8x32_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x1_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x2_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x4_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x8_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x16_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x32_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_16x64_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x4_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x8_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x16_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x32_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_32x64_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x8_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x16_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x32_u16_c);
+MK_CFUNC_X4(mvtools_sad_x4_64x64_u16_c);
+
+MK_CFUNC_LUMA(mvtools_sad_luma_2x2_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_2x4_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x2_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x4_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x8_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x16_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x1_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x2_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x4_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x8_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x16_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x32_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x1_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x2_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x4_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x8_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x16_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x32_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x64_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x4_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x8_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x16_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x32_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x64_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x8_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x16_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x32_u8_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x64_u8_c);
+
+MK_CFUNC_LUMA(mvtools_sad_luma_2x2_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_2x4_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x2_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x4_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x8_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x16_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x1_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x2_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x4_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x8_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x16_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x32_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x1_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x2_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x4_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x8_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x16_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x32_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x64_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x4_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x8_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x16_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x32_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x64_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x8_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x16_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x32_u16_c);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x64_u16_c);
 
 
 #if defined(MVTOOLS_X86)
@@ -109,6 +386,297 @@ MK_CFUNC(mvtools_sad_32x8_u16_sse2);
 MK_CFUNC(mvtools_sad_32x16_u16_sse2);
 MK_CFUNC(mvtools_sad_32x32_u16_sse2);
 
+// From SADFunctions_AVX2.cpp
+MK_CFUNC(mvtools_sad_2x2_u8_avx2);
+MK_CFUNC(mvtools_sad_2x4_u8_avx2);
+MK_CFUNC(mvtools_sad_4x2_u8_avx2);
+MK_CFUNC(mvtools_sad_4x4_u8_avx2);
+MK_CFUNC(mvtools_sad_4x8_u8_avx2);
+MK_CFUNC(mvtools_sad_4x16_u8_avx2);
+MK_CFUNC(mvtools_sad_8x1_u8_avx2);
+MK_CFUNC(mvtools_sad_8x2_u8_avx2);
+MK_CFUNC(mvtools_sad_8x4_u8_avx2);
+MK_CFUNC(mvtools_sad_8x8_u8_avx2);
+MK_CFUNC(mvtools_sad_8x16_u8_avx2);
+MK_CFUNC(mvtools_sad_8x32_u8_avx2);
+MK_CFUNC(mvtools_sad_16x1_u8_avx2);
+MK_CFUNC(mvtools_sad_16x2_u8_avx2);
+MK_CFUNC(mvtools_sad_16x4_u8_avx2);
+MK_CFUNC(mvtools_sad_16x8_u8_avx2);
+MK_CFUNC(mvtools_sad_16x16_u8_avx2);
+MK_CFUNC(mvtools_sad_16x32_u8_avx2);
+MK_CFUNC(mvtools_sad_16x64_u8_avx2);
+MK_CFUNC(mvtools_sad_32x4_u8_avx2);
+MK_CFUNC(mvtools_sad_32x8_u8_avx2);
+MK_CFUNC(mvtools_sad_32x16_u8_avx2);
+MK_CFUNC(mvtools_sad_32x32_u8_avx2);
+MK_CFUNC(mvtools_sad_32x64_u8_avx2);
+MK_CFUNC(mvtools_sad_64x8_u8_avx2);
+MK_CFUNC(mvtools_sad_64x16_u8_avx2);
+MK_CFUNC(mvtools_sad_64x32_u8_avx2);
+MK_CFUNC(mvtools_sad_64x64_u8_avx2);
+
+MK_CFUNC(mvtools_sad_2x2_u16_avx2);
+MK_CFUNC(mvtools_sad_2x4_u16_avx2);
+MK_CFUNC(mvtools_sad_4x2_u16_avx2);
+MK_CFUNC(mvtools_sad_4x4_u16_avx2);
+MK_CFUNC(mvtools_sad_4x8_u16_avx2);
+MK_CFUNC(mvtools_sad_4x16_u16_avx2);
+MK_CFUNC(mvtools_sad_8x1_u16_avx2);
+MK_CFUNC(mvtools_sad_8x2_u16_avx2);
+MK_CFUNC(mvtools_sad_8x4_u16_avx2);
+MK_CFUNC(mvtools_sad_8x8_u16_avx2);
+MK_CFUNC(mvtools_sad_8x16_u16_avx2);
+MK_CFUNC(mvtools_sad_8x32_u16_avx2);
+MK_CFUNC(mvtools_sad_16x1_u16_avx2);
+MK_CFUNC(mvtools_sad_16x2_u16_avx2);
+MK_CFUNC(mvtools_sad_16x4_u16_avx2);
+MK_CFUNC(mvtools_sad_16x8_u16_avx2);
+MK_CFUNC(mvtools_sad_16x16_u16_avx2);
+MK_CFUNC(mvtools_sad_16x32_u16_avx2);
+MK_CFUNC(mvtools_sad_16x64_u16_avx2);
+MK_CFUNC(mvtools_sad_32x4_u16_avx2);
+MK_CFUNC(mvtools_sad_32x8_u16_avx2);
+MK_CFUNC(mvtools_sad_32x16_u16_avx2);
+MK_CFUNC(mvtools_sad_32x32_u16_avx2);
+MK_CFUNC(mvtools_sad_32x64_u16_avx2);
+MK_CFUNC(mvtools_sad_64x8_u16_avx2);
+MK_CFUNC(mvtools_sad_64x16_u16_avx2);
+MK_CFUNC(mvtools_sad_64x32_u16_avx2);
+MK_CFUNC(mvtools_sad_64x64_u16_avx2);
+
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x2_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x4_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x2_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x4_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x8_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x16_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x1_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x2_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x4_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x8_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x16_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x32_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x1_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x2_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x4_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x8_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x16_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x32_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x64_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x4_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x8_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x16_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x32_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x64_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x8_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x16_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x32_u8_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x64_u8_avx2);
+
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x2_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_2x4_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x2_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x4_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x8_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_4x16_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x1_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x2_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x4_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x8_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x16_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_8x32_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x1_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x2_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x4_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x8_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x16_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x32_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_16x64_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x4_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x8_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x16_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x32_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_32x64_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x8_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x16_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x32_u16_avx2);
+MK_CFUNC_LIMIT(mvtools_sad_limit_64x64_u16_avx2);
+
+MK_CFUNC_X3(mvtools_sad_x3_2x2_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_2x4_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x2_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x4_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x8_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x16_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x1_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x2_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x4_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x8_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x16_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x32_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x1_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x2_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x4_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x8_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x16_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x32_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x64_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x4_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x8_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x16_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x32_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x64_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x8_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x16_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x32_u8_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x64_u8_avx2);
+
+MK_CFUNC_X3(mvtools_sad_x3_2x2_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_2x4_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x2_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x4_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x8_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_4x16_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x1_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x2_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x4_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x8_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x16_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_8x32_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x1_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x2_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x4_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x8_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x16_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x32_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_16x64_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x4_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x8_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x16_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x32_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_32x64_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x8_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x16_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x32_u16_avx2);
+MK_CFUNC_X3(mvtools_sad_x3_64x64_u16_avx2);
+
+MK_CFUNC_X4(mvtools_sad_x4_2x2_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_2x4_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x2_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x4_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x8_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x16_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x1_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x2_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x4_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x8_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x16_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x32_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x1_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x2_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x4_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x8_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x16_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x32_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x64_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x4_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x8_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x16_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x32_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x64_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x8_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x16_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x32_u8_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x64_u8_avx2);
+
+MK_CFUNC_X4(mvtools_sad_x4_2x2_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_2x4_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x2_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x4_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x8_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_4x16_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x1_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x2_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x4_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x8_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x16_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_8x32_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x1_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x2_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x4_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x8_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x16_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x32_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_16x64_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x4_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x8_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x16_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x32_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_32x64_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x8_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x16_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x32_u16_avx2);
+MK_CFUNC_X4(mvtools_sad_x4_64x64_u16_avx2);
+
+MK_CFUNC_LUMA(mvtools_sad_luma_2x2_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_2x4_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x2_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x4_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x8_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x16_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x1_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x2_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x4_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x8_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x16_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x32_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x1_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x2_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x4_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x8_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x16_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x32_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x64_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x4_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x8_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x16_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x32_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x64_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x8_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x16_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x32_u8_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x64_u8_avx2);
+
+MK_CFUNC_LUMA(mvtools_sad_luma_2x2_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_2x4_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x2_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x4_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x8_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_4x16_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x1_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x2_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x4_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x8_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x16_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_8x32_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x1_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x2_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x4_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x8_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x16_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x32_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_16x64_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x4_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x8_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x16_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x32_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_32x64_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x8_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x16_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x32_u16_avx2);
+MK_CFUNC_LUMA(mvtools_sad_luma_64x64_u16_avx2);
+
 // From sad-a.asm - stolen from x264
 MK_CFUNC(mvtools_pixel_sad_4x4_mmx2);
 MK_CFUNC(mvtools_pixel_sad_4x8_mmx2);
@@ -148,16 +716,48 @@ MK_CFUNC(mvtools_pixel_ssd_16x16_mmx);
 
 // From SADFunctions.cpp
 MK_CFUNC(mvtools_satd_4x4_u8_c);
+MK_CFUNC(mvtools_satd_4x8_u8_c);
+MK_CFUNC(mvtools_satd_4x16_u8_c);
 MK_CFUNC(mvtools_satd_8x4_u8_c);
 MK_CFUNC(mvtools_satd_8x8_u8_c);
+MK_CFUNC(mvtools_satd_8x16_u8_c);
+MK_CFUNC(mvtools_satd_8x32_u8_c);
+MK_CFUNC(mvtools_satd_16x4_u8_c);
 MK_CFUNC(mvtools_satd_16x8_u8_c);
 MK_CFUNC(mvtools_satd_16x16_u8_c);
+MK_CFUNC(mvtools_satd_16x32_u8_c);
+MK_CFUNC(mvtools_satd_16x64_u8_c);
+MK_CFUNC(mvtools_satd_32x4_u8_c);
+MK_CFUNC(mvtools_satd_32x8_u8_c);
+MK_CFUNC(mvtools_satd_32x16_u8_c);
+MK_CFUNC(mvtools_satd_32x32_u8_c);
+MK_CFUNC(mvtools_satd_32x64_u8_c);
+MK_CFUNC(mvtools_satd_64x8_u8_c);
+MK_CFUNC(mvtools_satd_64x16_u8_c);
+MK_CFUNC(mvtools_satd_64x32_u8_c);
+MK_CFUNC(mvtools_satd_64x64_u8_c);
 
 MK_CFUNC(mvtools_satd_4x4_u16_c);
+MK_CFUNC(mvtools_satd_4x8_u16_c);
+MK_CFUNC(mvtools_satd_4x16_u16_c);
 MK_CFUNC(mvtools_satd_8x4_u16_c);
 MK_CFUNC(mvtools_satd_8x8_u16_c);
+MK_CFUNC(mvtools_satd_8x16_u16_c);
+MK_CFUNC(mvtools_satd_8x32_u16_c);
+MK_CFUNC(mvtools_satd_16x4_u16_c);
 MK_CFUNC(mvtools_satd_16x8_u16_c);
 MK_CFUNC(mvtools_satd_16x16_u16_c);
+MK_CFUNC(mvtools_satd_16x32_u16_c);
+MK_CFUNC(mvtools_satd_16x64_u16_c);
+MK_CFUNC(mvtools_satd_32x4_u16_c);
+MK_CFUNC(mvtools_satd_32x8_u16_c);
+MK_CFUNC(mvtools_satd_32x16_u16_c);
+MK_CFUNC(mvtools_satd_32x32_u16_c);
+MK_CFUNC(mvtools_satd_32x64_u16_c);
+MK_CFUNC(mvtools_satd_64x8_u16_c);
+MK_CFUNC(mvtools_satd_64x16_u16_c);
+MK_CFUNC(mvtools_satd_64x32_u16_c);
+MK_CFUNC(mvtools_satd_64x64_u16_c);
 
 
 #if defined(MVTOOLS_X86)
@@ -198,9 +798,40 @@ MK_CFUNC(mvtools_pixel_satd_8x8_avx2);
 MK_CFUNC(mvtools_pixel_satd_16x8_avx2);
 MK_CFUNC(mvtools_pixel_satd_16x16_avx2);
 
+// From SADFunctions.cpp, made of the 16x16 or 8x8 functions above
+MK_CFUNC(mvtools_satd_8x16_u8_sse2);
+MK_CFUNC(mvtools_satd_8x32_u8_sse2);
+MK_CFUNC(mvtools_satd_16x32_u8_sse2);
+MK_CFUNC(mvtools_satd_16x64_u8_sse2);
+MK_CFUNC(mvtools_satd_32x8_u8_sse2);
+MK_CFUNC(mvtools_satd_32x16_u8_sse2);
+MK_CFUNC(mvtools_satd_32x32_u8_sse2);
+MK_CFUNC(mvtools_satd_32x64_u8_sse2);
+MK_CFUNC(mvtools_satd_64x8_u8_sse2);
+MK_CFUNC(mvtools_satd_64x16_u8_sse2);
+MK_CFUNC(mvtools_satd_64x32_u8_sse2);
+MK_CFUNC(mvtools_satd_64x64_u8_sse2);
+
+MK_CFUNC(mvtools_satd_8x16_u8_avx2);
+MK_CFUNC(mvtools_satd_8x32_u8_avx2);
+MK_CFUNC(mvtools_satd_16x32_u8_avx2);
+MK_CFUNC(mvtools_satd_16x64_u8_avx2);
+MK_CFUNC(mvtools_satd_32x8_u8_avx2);
+MK_CFUNC(mvtools_satd_32x16_u8_avx2);
+MK_CFUNC(mvtools_satd_32x32_u8_avx2);
+MK_CFUNC(mvtools_satd_32x64_u8_avx2);
+MK_CFUNC(mvtools_satd_64x8_u8_avx2);
+MK_CFUNC(mvtools_satd_64x16_u8_avx2);
+MK_CFUNC(mvtools_satd_64x32_u8_avx2);
+MK_CFUNC(mvtools_satd_64x64_u8_avx2);
+
 #endif // MVTOOLS_X86
 
 #undef MK_CFUNC
+#undef MK_CFUNC_LIMIT
+#undef MK_CFUNC_X3
+#undef MK_CFUNC_X4
+#undef MK_CFUNC_LUMA
 
 #ifdef __cplusplus
 } // extern "C"
@@ -0,0 +1,691 @@
+#if defined(MVTOOLS_X86)
+
+#include <immintrin.h>
+
+#include "SADFunctions.h"
+
+
+#ifdef _WIN32
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+
+// Loads one row of a block narrower than 16 bytes into the low bytes of a register.
+template <unsigned rowBytes>
+static FORCE_INLINE __m128i loadRow(const uint8_t *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+
+template <>
+FORCE_INLINE __m128i loadRow<8>(const uint8_t *p) {
+    return _mm_loadl_epi64((const __m128i *)p);
+}
+
+template <>
+FORCE_INLINE __m128i loadRow<4>(const uint8_t *p) {
+    return _mm_cvtsi32_si128(*(const int *)p);
+}
+
+template <>
+FORCE_INLINE __m128i loadRow<2>(const uint8_t *p) {
+    return _mm_cvtsi32_si128(*(const uint16_t *)p);
+}
+
+
+// Packs `rows` consecutive rows of a narrow block into one register.
+template <unsigned rowBytes, unsigned rows>
+struct RowLoader {
+    static FORCE_INLINE __m128i load(const uint8_t *p, intptr_t pitch) {
+        __m128i lo = RowLoader<rowBytes, rows / 2>::load(p, pitch);
+        __m128i hi = RowLoader<rowBytes, rows / 2>::load(p + (rows / 2) * pitch, pitch);
+        return _mm_or_si128(lo, _mm_slli_si128(hi, (rows / 2) * rowBytes));
+    }
+};
+
+template <unsigned rowBytes>
+struct RowLoader<rowBytes, 1> {
+    static FORCE_INLINE __m128i load(const uint8_t *p, intptr_t) {
+        return loadRow<rowBytes>(p);
+    }
+};
+
+template <unsigned rowBytes>
+struct RowLoader<rowBytes, 0> {
+    static FORCE_INLINE __m128i load(const uint8_t *, intptr_t) {
+        return _mm_setzero_si128();
+    }
+};
+
+
+// Sums of absolute differences, as 32 bit integers.
+template <typename PixelType>
+struct AbsDiff;
+
+template <>
+struct AbsDiff<uint8_t> {
+    static FORCE_INLINE __m256i sum(__m256i a, __m256i b) {
+        return _mm256_sad_epu8(a, b);
+    }
+
+    static FORCE_INLINE __m128i sum(__m128i a, __m128i b) {
+        return _mm_sad_epu8(a, b);
+    }
+};
+
+template <>
+struct AbsDiff<uint16_t> {
+    static FORCE_INLINE __m256i sum(__m256i a, __m256i b) {
+        __m256i diff = _mm256_sub_epi16(_mm256_max_epu16(a, b), _mm256_min_epu16(a, b));
+        __m256i zero = _mm256_setzero_si256();
+        return _mm256_add_epi32(_mm256_unpacklo_epi16(diff, zero), _mm256_unpackhi_epi16(diff, zero));
+    }
+
+    static FORCE_INLINE __m128i sum(__m128i a, __m128i b) {
+        __m128i diff = _mm_sub_epi16(_mm_max_epu16(a, b), _mm_min_epu16(a, b));
+        __m128i zero = _mm_setzero_si128();
+        return _mm_add_epi32(_mm_unpacklo_epi16(diff, zero), _mm_unpackhi_epi16(diff, zero));
+    }
+};
+
+
+// Sums of pixels, as 32 bit integers.
+template <typename PixelType>
+struct PixelSum;
+
+template <>
+struct PixelSum<uint8_t> {
+    static FORCE_INLINE __m256i sum(__m256i a) {
+        return _mm256_sad_epu8(a, _mm256_setzero_si256());
+    }
+
+    static FORCE_INLINE __m128i sum(__m128i a) {
+        return _mm_sad_epu8(a, _mm_setzero_si128());
+    }
+};
+
+template <>
+struct PixelSum<uint16_t> {
+    static FORCE_INLINE __m256i sum(__m256i a) {
+        __m256i zero = _mm256_setzero_si256();
+        return _mm256_add_epi32(_mm256_unpacklo_epi16(a, zero), _mm256_unpackhi_epi16(a, zero));
+    }
+
+    static FORCE_INLINE __m128i sum(__m128i a) {
+        __m128i zero = _mm_setzero_si128();
+        return _mm_add_epi32(_mm_unpacklo_epi16(a, zero), _mm_unpackhi_epi16(a, zero));
+    }
+};
+
+
+static FORCE_INLINE unsigned int horizontalSum(__m128i sum) {
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (unsigned int)_mm_cvtsi128_si32(sum);
+}
+
+
+template <unsigned width, unsigned height, typename PixelType>
+static unsigned int sad_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch) {
+    const unsigned rowBytes = width * sizeof(PixelType);
+
+    if (rowBytes >= 32) {
+        __m256i sum = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y++) {
+            for (unsigned x = 0; x < rowBytes; x += 32) {
+                __m256i src = _mm256_loadu_si256((const __m256i *)(pSrc + x));
+                __m256i ref = _mm256_loadu_si256((const __m256i *)(pRef + x));
+                sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+            }
+
+            pSrc += nSrcPitch;
+            pRef += nRefPitch;
+        }
+
+        return horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+    }
+
+    // Narrow blocks: several rows go in each register.
+    const unsigned rowsPerLane = 16 / rowBytes < height ? 16 / rowBytes : height;
+
+    if (height >= 2 * rowsPerLane) {
+        __m256i sum = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y += 2 * rowsPerLane) {
+            __m256i src = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pSrc + rowsPerLane * nSrcPitch, nSrcPitch), 1);
+            __m256i ref = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pRef, nRefPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pRef + rowsPerLane * nRefPitch, nRefPitch), 1);
+            sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+
+            pSrc += 2 * rowsPerLane * nSrcPitch;
+            pRef += 2 * rowsPerLane * nRefPitch;
+        }
+
+        return horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+    }
+
+    // The whole block fits in 16 bytes.
+    __m128i src = RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch);
+    __m128i ref = RowLoader<rowBytes, rowsPerLane>::load(pRef, nRefPitch);
+
+    return horizontalSum(AbsDiff<PixelType>::sum(src, ref));
+}
+
+
+// Like sad_avx2, but checks the sum against limit every four rows, or after
+// every step for blocks narrower than 16 bytes, where a step can cover 8 or 16
+// rows. Blocks done in a single step are not checked at all.
+template <unsigned width, unsigned height, typename PixelType>
+static unsigned int sad_limit_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch, unsigned int limit) {
+    const unsigned rowBytes = width * sizeof(PixelType);
+
+    if (rowBytes >= 32) {
+        __m256i sum = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y++) {
+            for (unsigned x = 0; x < rowBytes; x += 32) {
+                __m256i src = _mm256_loadu_si256((const __m256i *)(pSrc + x));
+                __m256i ref = _mm256_loadu_si256((const __m256i *)(pRef + x));
+                sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+            }
+
+            pSrc += nSrcPitch;
+            pRef += nRefPitch;
+
+            if ((y & 3) == 3 || y == height - 1) {
+                unsigned int partial = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+                if (partial >= limit || y == height - 1)
+                    return partial;
+            }
+        }
+    }
+
+    const unsigned rowsPerLane = 16 / rowBytes < height ? 16 / rowBytes : height;
+
+    // Rows of 16 bytes go two at a time, so the sum is checked every other step.
+    if (rowBytes == 16 && height > 4) {
+        __m256i sum = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y += 2) {
+            __m256i src = _mm256_inserti128_si256(_mm256_castsi128_si256(loadRow<16>(pSrc)), loadRow<16>(pSrc + nSrcPitch), 1);
+            __m256i ref = _mm256_inserti128_si256(_mm256_castsi128_si256(loadRow<16>(pRef)), loadRow<16>(pRef + nRefPitch), 1);
+            sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+
+            pSrc += 2 * nSrcPitch;
+            pRef += 2 * nRefPitch;
+
+            if ((y & 3) == 2) {
+                unsigned int partial = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+                if (partial >= limit || y == height - 2)
+                    return partial;
+            }
+        }
+    }
+
+    if (rowBytes < 16 && height > 2 * rowsPerLane) {
+        __m256i sum = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y += 2 * rowsPerLane) {
+            __m256i src = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pSrc + rowsPerLane * nSrcPitch, nSrcPitch), 1);
+            __m256i ref = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pRef, nRefPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pRef + rowsPerLane * nRefPitch, nRefPitch), 1);
+            sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+
+            pSrc += 2 * rowsPerLane * nSrcPitch;
+            pRef += 2 * rowsPerLane * nRefPitch;
+
+            unsigned int partial = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+            if (partial >= limit || y + 2 * rowsPerLane == height)
+                return partial;
+        }
+    }
+
+    // Blocks of up to four rows, or small enough to be done in a single step.
+    return sad_avx2<width, height, PixelType>(pSrc, nSrcPitch, pRef, nRefPitch);
+}
+
+
+// Like sad_avx2, but also sums the reference block's pixels, which are
+// already loaded.
+template <unsigned width, unsigned height, typename PixelType>
+static unsigned int sad_luma_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch, unsigned int *refLuma) {
+    const unsigned rowBytes = width * sizeof(PixelType);
+
+    if (rowBytes >= 32) {
+        __m256i sum = _mm256_setzero_si256();
+        __m256i luma = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y++) {
+            for (unsigned x = 0; x < rowBytes; x += 32) {
+                __m256i src = _mm256_loadu_si256((const __m256i *)(pSrc + x));
+                __m256i ref = _mm256_loadu_si256((const __m256i *)(pRef + x));
+                sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+                luma = _mm256_add_epi32(luma, PixelSum<PixelType>::sum(ref));
+            }
+
+            pSrc += nSrcPitch;
+            pRef += nRefPitch;
+        }
+
+        *refLuma = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(luma), _mm256_extracti128_si256(luma, 1)));
+        return horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+    }
+
+    const unsigned rowsPerLane = 16 / rowBytes < height ? 16 / rowBytes : height;
+
+    if (height >= 2 * rowsPerLane) {
+        __m256i sum = _mm256_setzero_si256();
+        __m256i luma = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y += 2 * rowsPerLane) {
+            __m256i src = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pSrc + rowsPerLane * nSrcPitch, nSrcPitch), 1);
+            __m256i ref = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pRef, nRefPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pRef + rowsPerLane * nRefPitch, nRefPitch), 1);
+            sum = _mm256_add_epi32(sum, AbsDiff<PixelType>::sum(src, ref));
+            luma = _mm256_add_epi32(luma, PixelSum<PixelType>::sum(ref));
+
+            pSrc += 2 * rowsPerLane * nSrcPitch;
+            pRef += 2 * rowsPerLane * nRefPitch;
+        }
+
+        *refLuma = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(luma), _mm256_extracti128_si256(luma, 1)));
+        return horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1)));
+    }
+
+    // The whole block fits in 16 bytes. The unused bytes are zero, so they
+    // don't change the sum.
+    __m128i src = RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch);
+    __m128i ref = RowLoader<rowBytes, rowsPerLane>::load(pRef, nRefPitch);
+
+    *refLuma = horizontalSum(PixelSum<PixelType>::sum(ref));
+    return horizontalSum(AbsDiff<PixelType>::sum(src, ref));
+}
+
+
+// Like sad_avx2, but with count reference blocks, so that each part of the
+// source block is loaded only once.
+template <unsigned width, unsigned height, typename PixelType, unsigned count>
+static FORCE_INLINE void sad_xn_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t **pRef, intptr_t nRefPitch, unsigned int *sads) {
+    const unsigned rowBytes = width * sizeof(PixelType);
+
+    if (rowBytes >= 32) {
+        __m256i sum[count];
+        for (unsigned n = 0; n < count; n++)
+            sum[n] = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y++) {
+            for (unsigned x = 0; x < rowBytes; x += 32) {
+                __m256i src = _mm256_loadu_si256((const __m256i *)(pSrc + x));
+                for (unsigned n = 0; n < count; n++)
+                    sum[n] = _mm256_add_epi32(sum[n], AbsDiff<PixelType>::sum(src, _mm256_loadu_si256((const __m256i *)(pRef[n] + x))));
+            }
+
+            pSrc += nSrcPitch;
+            for (unsigned n = 0; n < count; n++)
+                pRef[n] += nRefPitch;
+        }
+
+        for (unsigned n = 0; n < count; n++)
+            sads[n] = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum[n]), _mm256_extracti128_si256(sum[n], 1)));
+
+        return;
+    }
+
+    const unsigned rowsPerLane = 16 / rowBytes < height ? 16 / rowBytes : height;
+
+    if (height >= 2 * rowsPerLane) {
+        __m256i sum[count];
+        for (unsigned n = 0; n < count; n++)
+            sum[n] = _mm256_setzero_si256();
+
+        for (unsigned y = 0; y < height; y += 2 * rowsPerLane) {
+            __m256i src = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch)),
+                                                  RowLoader<rowBytes, rowsPerLane>::load(pSrc + rowsPerLane * nSrcPitch, nSrcPitch), 1);
+            for (unsigned n = 0; n < count; n++) {
+                __m256i ref = _mm256_inserti128_si256(_mm256_castsi128_si256(RowLoader<rowBytes, rowsPerLane>::load(pRef[n], nRefPitch)),
+                                                      RowLoader<rowBytes, rowsPerLane>::load(pRef[n] + rowsPerLane * nRefPitch, nRefPitch), 1);
+                sum[n] = _mm256_add_epi32(sum[n], AbsDiff<PixelType>::sum(src, ref));
+                pRef[n] += 2 * rowsPerLane * nRefPitch;
+            }
+
+            pSrc += 2 * rowsPerLane * nSrcPitch;
+        }
+
+        for (unsigned n = 0; n < count; n++)
+            sads[n] = horizontalSum(_mm_add_epi32(_mm256_castsi256_si128(sum[n]), _mm256_extracti128_si256(sum[n], 1)));
+
+        return;
+    }
+
+    __m128i src = RowLoader<rowBytes, rowsPerLane>::load(pSrc, nSrcPitch);
+
+    for (unsigned n = 0; n < count; n++)
+        sads[n] = horizontalSum(AbsDiff<PixelType>::sum(src, RowLoader<rowBytes, rowsPerLane>::load(pRef[n], nRefPitch)));
+}
+
+
+#define DEFINE_SAD_AVX2(width, height, bits) \
+unsigned int mvtools_sad_##width##x##height##_u##bits##_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch) { \
+    return sad_avx2<width, height, uint##bits##_t>(pSrc, nSrcPitch, pRef, nRefPitch); \
+}
+
+DEFINE_SAD_AVX2(2, 2, 8)
+DEFINE_SAD_AVX2(2, 4, 8)
+DEFINE_SAD_AVX2(4, 2, 8)
+DEFINE_SAD_AVX2(4, 4, 8)
+DEFINE_SAD_AVX2(4, 8, 8)
+DEFINE_SAD_AVX2(4, 16, 8)
+DEFINE_SAD_AVX2(8, 1, 8)
+DEFINE_SAD_AVX2(8, 2, 8)
+DEFINE_SAD_AVX2(8, 4, 8)
+DEFINE_SAD_AVX2(8, 8, 8)
+DEFINE_SAD_AVX2(8, 16, 8)
+DEFINE_SAD_AVX2(8, 32, 8)
+DEFINE_SAD_AVX2(16, 1, 8)
+DEFINE_SAD_AVX2(16, 2, 8)
+DEFINE_SAD_AVX2(16, 4, 8)
+DEFINE_SAD_AVX2(16, 8, 8)
+DEFINE_SAD_AVX2(16, 16, 8)
+DEFINE_SAD_AVX2(16, 32, 8)
+DEFINE_SAD_AVX2(16, 64, 8)
+DEFINE_SAD_AVX2(32, 4, 8)
+DEFINE_SAD_AVX2(32, 8, 8)
+DEFINE_SAD_AVX2(32, 16, 8)
+DEFINE_SAD_AVX2(32, 32, 8)
+DEFINE_SAD_AVX2(32, 64, 8)
+DEFINE_SAD_AVX2(64, 8, 8)
+DEFINE_SAD_AVX2(64, 16, 8)
+DEFINE_SAD_AVX2(64, 32, 8)
+DEFINE_SAD_AVX2(64, 64, 8)
+
+DEFINE_SAD_AVX2(2, 2, 16)
+DEFINE_SAD_AVX2(2, 4, 16)
+DEFINE_SAD_AVX2(4, 2, 16)
+DEFINE_SAD_AVX2(4, 4, 16)
+DEFINE_SAD_AVX2(4, 8, 16)
+DEFINE_SAD_AVX2(4, 16, 16)
+DEFINE_SAD_AVX2(8, 1, 16)
+DEFINE_SAD_AVX2(8, 2, 16)
+DEFINE_SAD_AVX2(8, 4, 16)
+DEFINE_SAD_AVX2(8, 8, 16)
+DEFINE_SAD_AVX2(8, 16, 16)
+DEFINE_SAD_AVX2(8, 32, 16)
+DEFINE_SAD_AVX2(16, 1, 16)
+DEFINE_SAD_AVX2(16, 2, 16)
+DEFINE_SAD_AVX2(16, 4, 16)
+DEFINE_SAD_AVX2(16, 8, 16)
+DEFINE_SAD_AVX2(16, 16, 16)
+DEFINE_SAD_AVX2(16, 32, 16)
+DEFINE_SAD_AVX2(16, 64, 16)
+DEFINE_SAD_AVX2(32, 4, 16)
+DEFINE_SAD_AVX2(32, 8, 16)
+DEFINE_SAD_AVX2(32, 16, 16)
+DEFINE_SAD_AVX2(32, 32, 16)
+DEFINE_SAD_AVX2(32, 64, 16)
+DEFINE_SAD_AVX2(64, 8, 16)
+DEFINE_SAD_AVX2(64, 16, 16)
+DEFINE_SAD_AVX2(64, 32, 16)
+DEFINE_SAD_AVX2(64, 64, 16)
+
+
+#define DEFINE_SAD_LIMIT_AVX2(width, height, bits) \
+unsigned int mvtools_sad_limit_##width##x##height##_u##bits##_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch, unsigned int limit) { \
+    return sad_limit_avx2<width, height, uint##bits##_t>(pSrc, nSrcPitch, pRef, nRefPitch, limit); \
+}
+
+DEFINE_SAD_LIMIT_AVX2(2, 2, 8)
+DEFINE_SAD_LIMIT_AVX2(2, 4, 8)
+DEFINE_SAD_LIMIT_AVX2(4, 2, 8)
+DEFINE_SAD_LIMIT_AVX2(4, 4, 8)
+DEFINE_SAD_LIMIT_AVX2(4, 8, 8)
+DEFINE_SAD_LIMIT_AVX2(4, 16, 8)
+DEFINE_SAD_LIMIT_AVX2(8, 1, 8)
+DEFINE_SAD_LIMIT_AVX2(8, 2, 8)
+DEFINE_SAD_LIMIT_AVX2(8, 4, 8)
+DEFINE_SAD_LIMIT_AVX2(8, 8, 8)
+DEFINE_SAD_LIMIT_AVX2(8, 16, 8)
+DEFINE_SAD_LIMIT_AVX2(8, 32, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 1, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 2, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 4, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 8, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 16, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 32, 8)
+DEFINE_SAD_LIMIT_AVX2(16, 64, 8)
+DEFINE_SAD_LIMIT_AVX2(32, 4, 8)
+DEFINE_SAD_LIMIT_AVX2(32, 8, 8)
+DEFINE_SAD_LIMIT_AVX2(32, 16, 8)
+DEFINE_SAD_LIMIT_AVX2(32, 32, 8)
+DEFINE_SAD_LIMIT_AVX2(32, 64, 8)
+DEFINE_SAD_LIMIT_AVX2(64, 8, 8)
+DEFINE_SAD_LIMIT_AVX2(64, 16, 8)
+DEFINE_SAD_LIMIT_AVX2(64, 32, 8)
+DEFINE_SAD_LIMIT_AVX2(64, 64, 8)
+
+DEFINE_SAD_LIMIT_AVX2(2, 2, 16)
+DEFINE_SAD_LIMIT_AVX2(2, 4, 16)
+DEFINE_SAD_LIMIT_AVX2(4, 2, 16)
+DEFINE_SAD_LIMIT_AVX2(4, 4, 16)
+DEFINE_SAD_LIMIT_AVX2(4, 8, 16)
+DEFINE_SAD_LIMIT_AVX2(4, 16, 16)
+DEFINE_SAD_LIMIT_AVX2(8, 1, 16)
+DEFINE_SAD_LIMIT_AVX2(8, 2, 16)
+DEFINE_SAD_LIMIT_AVX2(8, 4, 16)
+DEFINE_SAD_LIMIT_AVX2(8, 8, 16)
+DEFINE_SAD_LIMIT_AVX2(8, 16, 16)
+DEFINE_SAD_LIMIT_AVX2(8, 32, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 1, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 2, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 4, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 8, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 16, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 32, 16)
+DEFINE_SAD_LIMIT_AVX2(16, 64, 16)
+DEFINE_SAD_LIMIT_AVX2(32, 4, 16)
+DEFINE_SAD_LIMIT_AVX2(32, 8, 16)
+DEFINE_SAD_LIMIT_AVX2(32, 16, 16)
+DEFINE_SAD_LIMIT_AVX2(32, 32, 16)
+DEFINE_SAD_LIMIT_AVX2(32, 64, 16)
+DEFINE_SAD_LIMIT_AVX2(64, 8, 16)
+DEFINE_SAD_LIMIT_AVX2(64, 16, 16)
+DEFINE_SAD_LIMIT_AVX2(64, 32, 16)
+DEFINE_SAD_LIMIT_AVX2(64, 64, 16)
+
+
+#define DEFINE_SAD_LUMA_AVX2(width, height, bits) \
+unsigned int mvtools_sad_luma_##width##x##height##_u##bits##_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef, intptr_t nRefPitch, unsigned int *refLuma) { \
+    return sad_luma_avx2<width, height, uint##bits##_t>(pSrc, nSrcPitch, pRef, nRefPitch, refLuma); \
+}
+
+DEFINE_SAD_LUMA_AVX2(2, 2, 8)
+DEFINE_SAD_LUMA_AVX2(2, 4, 8)
+DEFINE_SAD_LUMA_AVX2(4, 2, 8)
+DEFINE_SAD_LUMA_AVX2(4, 4, 8)
+DEFINE_SAD_LUMA_AVX2(4, 8, 8)
+DEFINE_SAD_LUMA_AVX2(4, 16, 8)
+DEFINE_SAD_LUMA_AVX2(8, 1, 8)
+DEFINE_SAD_LUMA_AVX2(8, 2, 8)
+DEFINE_SAD_LUMA_AVX2(8, 4, 8)
+DEFINE_SAD_LUMA_AVX2(8, 8, 8)
+DEFINE_SAD_LUMA_AVX2(8, 16, 8)
+DEFINE_SAD_LUMA_AVX2(8, 32, 8)
+DEFINE_SAD_LUMA_AVX2(16, 1, 8)
+DEFINE_SAD_LUMA_AVX2(16, 2, 8)
+DEFINE_SAD_LUMA_AVX2(16, 4, 8)
+DEFINE_SAD_LUMA_AVX2(16, 8, 8)
+DEFINE_SAD_LUMA_AVX2(16, 16, 8)
+DEFINE_SAD_LUMA_AVX2(16, 32, 8)
+DEFINE_SAD_LUMA_AVX2(16, 64, 8)
+DEFINE_SAD_LUMA_AVX2(32, 4, 8)
+DEFINE_SAD_LUMA_AVX2(32, 8, 8)
+DEFINE_SAD_LUMA_AVX2(32, 16, 8)
+DEFINE_SAD_LUMA_AVX2(32, 32, 8)
+DEFINE_SAD_LUMA_AVX2(32, 64, 8)
+DEFINE_SAD_LUMA_AVX2(64, 8, 8)
+DEFINE_SAD_LUMA_AVX2(64, 16, 8)
+DEFINE_SAD_LUMA_AVX2(64, 32, 8)
+DEFINE_SAD_LUMA_AVX2(64, 64, 8)
+
+DEFINE_SAD_LUMA_AVX2(2, 2, 16)
+DEFINE_SAD_LUMA_AVX2(2, 4, 16)
+DEFINE_SAD_LUMA_AVX2(4, 2, 16)
+DEFINE_SAD_LUMA_AVX2(4, 4, 16)
+DEFINE_SAD_LUMA_AVX2(4, 8, 16)
+DEFINE_SAD_LUMA_AVX2(4, 16, 16)
+DEFINE_SAD_LUMA_AVX2(8, 1, 16)
+DEFINE_SAD_LUMA_AVX2(8, 2, 16)
+DEFINE_SAD_LUMA_AVX2(8, 4, 16)
+DEFINE_SAD_LUMA_AVX2(8, 8, 16)
+DEFINE_SAD_LUMA_AVX2(8, 16, 16)
+DEFINE_SAD_LUMA_AVX2(8, 32, 16)
+DEFINE_SAD_LUMA_AVX2(16, 1, 16)
+DEFINE_SAD_LUMA_AVX2(16, 2, 16)
+DEFINE_SAD_LUMA_AVX2(16, 4, 16)
+DEFINE_SAD_LUMA_AVX2(16, 8, 16)
+DEFINE_SAD_LUMA_AVX2(16, 16, 16)
+DEFINE_SAD_LUMA_AVX2(16, 32, 16)
+DEFINE_SAD_LUMA_AVX2(16, 64, 16)
+DEFINE_SAD_LUMA_AVX2(32, 4, 16)
+DEFINE_SAD_LUMA_AVX2(32, 8, 16)
+DEFINE_SAD_LUMA_AVX2(32, 16, 16)
+DEFINE_SAD_LUMA_AVX2(32, 32, 16)
+DEFINE_SAD_LUMA_AVX2(32, 64, 16)
+DEFINE_SAD_LUMA_AVX2(64, 8, 16)
+DEFINE_SAD_LUMA_AVX2(64, 16, 16)
+DEFINE_SAD_LUMA_AVX2(64, 32, 16)
+DEFINE_SAD_LUMA_AVX2(64, 64, 16)
+
+#define DEFINE_SAD_X3_AVX2(width, height, bits) \
+void mvtools_sad_x3_##width##x##height##_u##bits##_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, intptr_t nRefPitch, unsigned int *sads) { \
+    const uint8_t *pRef[3] = { pRef0, pRef1, pRef2 }; \
+    sad_xn_avx2<width, height, uint##bits##_t, 3>(pSrc, nSrcPitch, pRef, nRefPitch, sads); \
+}
+
+#define DEFINE_SAD_X4_AVX2(width, height, bits) \
+void mvtools_sad_x4_##width##x##height##_u##bits##_avx2(const uint8_t *pSrc, intptr_t nSrcPitch, const uint8_t *pRef0, const uint8_t *pRef1, const uint8_t *pRef2, const uint8_t *pRef3, intptr_t nRefPitch, unsigned int *sads) { \
+    const uint8_t *pRef[4] = { pRef0, pRef1, pRef2, pRef3 }; \
+    sad_xn_avx2<width, height, uint##bits##_t, 4>(pSrc, nSrcPitch, pRef, nRefPitch, sads); \
+}
+
+DEFINE_SAD_X3_AVX2(2, 2, 8)
+DEFINE_SAD_X3_AVX2(2, 4, 8)
+DEFINE_SAD_X3_AVX2(4, 2, 8)
+DEFINE_SAD_X3_AVX2(4, 4, 8)
+DEFINE_SAD_X3_AVX2(4, 8, 8)
+DEFINE_SAD_X3_AVX2(4, 16, 8)
+DEFINE_SAD_X3_AVX2(8, 1, 8)
+DEFINE_SAD_X3_AVX2(8, 2, 8)
+DEFINE_SAD_X3_AVX2(8, 4, 8)
+DEFINE_SAD_X3_AVX2(8, 8, 8)
+DEFINE_SAD_X3_AVX2(8, 16, 8)
+DEFINE_SAD_X3_AVX2(8, 32, 8)
+DEFINE_SAD_X3_AVX2(16, 1, 8)
+DEFINE_SAD_X3_AVX2(16, 2, 8)
+DEFINE_SAD_X3_AVX2(16, 4, 8)
+DEFINE_SAD_X3_AVX2(16, 8, 8)
+DEFINE_SAD_X3_AVX2(16, 16, 8)
+DEFINE_SAD_X3_AVX2(16, 32, 8)
+DEFINE_SAD_X3_AVX2(16, 64, 8)
+DEFINE_SAD_X3_AVX2(32, 4, 8)
+DEFINE_SAD_X3_AVX2(32, 8, 8)
+DEFINE_SAD_X3_AVX2(32, 16, 8)
+DEFINE_SAD_X3_AVX2(32, 32, 8)
+DEFINE_SAD_X3_AVX2(32, 64, 8)
+DEFINE_SAD_X3_AVX2(64, 8, 8)
+DEFINE_SAD_X3_AVX2(64, 16, 8)
+DEFINE_SAD_X3_AVX2(64, 32, 8)
+DEFINE_SAD_X3_AVX2(64, 64, 8)
+
+DEFINE_SAD_X3_AVX2(2, 2, 16)
+DEFINE_SAD_X3_AVX2(2, 4, 16)
+DEFINE_SAD_X3_AVX2(4, 2, 16)
+DEFINE_SAD_X3_AVX2(4, 4, 16)
+DEFINE_SAD_X3_AVX2(4, 8, 16)
+DEFINE_SAD_X3_AVX2(4, 16, 16)
+DEFINE_SAD_X3_AVX2(8, 1, 16)
+DEFINE_SAD_X3_AVX2(8, 2, 16)
+DEFINE_SAD_X3_AVX2(8, 4, 16)
+DEFINE_SAD_X3_AVX2(8, 8, 16)
+DEFINE_SAD_X3_AVX2(8, 16, 16)
+DEFINE_SAD_X3_AVX2(8, 32, 16)
+DEFINE_SAD_X3_AVX2(16, 1, 16)
+DEFINE_SAD_X3_AVX2(16, 2, 16)
+DEFINE_SAD_X3_AVX2(16, 4, 16)
+DEFINE_SAD_X3_AVX2(16, 8, 16)
+DEFINE_SAD_X3_AVX2(16, 16, 16)
+DEFINE_SAD_X3_AVX2(16, 32, 16)
+DEFINE_SAD_X3_AVX2(16, 64, 16)
+DEFINE_SAD_X3_AVX2(32, 4, 16)
+DEFINE_SAD_X3_AVX2(32, 8, 16)
+DEFINE_SAD_X3_AVX2(32, 16, 16)
+DEFINE_SAD_X3_AVX2(32, 32, 16)
+DEFINE_SAD_X3_AVX2(32, 64, 16)
+DEFINE_SAD_X3_AVX2(64, 8, 16)
+DEFINE_SAD_X3_AVX2(64, 16, 16)
+DEFINE_SAD_X3_AVX2(64, 32, 16)
+DEFINE_SAD_X3_AVX2(64, 64, 16)
+
+DEFINE_SAD_X4_AVX2(2, 2, 8)
+DEFINE_SAD_X4_AVX2(2, 4, 8)
+DEFINE_SAD_X4_AVX2(4, 2, 8)
+DEFINE_SAD_X4_AVX2(4, 4, 8)
+DEFINE_SAD_X4_AVX2(4, 8, 8)
+DEFINE_SAD_X4_AVX2(4, 16, 8)
+DEFINE_SAD_X4_AVX2(8, 1, 8)
+DEFINE_SAD_X4_AVX2(8, 2, 8)
+DEFINE_SAD_X4_AVX2(8, 4, 8)
+DEFINE_SAD_X4_AVX2(8, 8, 8)
+DEFINE_SAD_X4_AVX2(8, 16, 8)
+DEFINE_SAD_X4_AVX2(8, 32, 8)
+DEFINE_SAD_X4_AVX2(16, 1, 8)
+DEFINE_SAD_X4_AVX2(16, 2, 8)
+DEFINE_SAD_X4_AVX2(16, 4, 8)
+DEFINE_SAD_X4_AVX2(16, 8, 8)
+DEFINE_SAD_X4_AVX2(16, 16, 8)
+DEFINE_SAD_X4_AVX2(16, 32, 8)
+DEFINE_SAD_X4_AVX2(16, 64, 8)
+DEFINE_SAD_X4_AVX2(32, 4, 8)
+DEFINE_SAD_X4_AVX2(32, 8, 8)
+DEFINE_SAD_X4_AVX2(32, 16, 8)
+DEFINE_SAD_X4_AVX2(32, 32, 8)
+DEFINE_SAD_X4_AVX2(32, 64, 8)
+DEFINE_SAD_X4_AVX2(64, 8, 8)
+DEFINE_SAD_X4_AVX2(64, 16, 8)
+DEFINE_SAD_X4_AVX2(64, 32, 8)
+DEFINE_SAD_X4_AVX2(64, 64, 8)
+
+DEFINE_SAD_X4_AVX2(2, 2, 16)
+DEFINE_SAD_X4_AVX2(2, 4, 16)
+DEFINE_SAD_X4_AVX2(4, 2, 16)
+DEFINE_SAD_X4_AVX2(4, 4, 16)
+DEFINE_SAD_X4_AVX2(4, 8, 16)
+DEFINE_SAD_X4_AVX2(4, 16, 16)
+DEFINE_SAD_X4_AVX2(8, 1, 16)
+DEFINE_SAD_X4_AVX2(8, 2, 16)
+DEFINE_SAD_X4_AVX2(8, 4, 16)
+DEFINE_SAD_X4_AVX2(8, 8, 16)
+DEFINE_SAD_X4_AVX2(8, 16, 16)
+DEFINE_SAD_X4_AVX2(8, 32, 16)
+DEFINE_SAD_X4_AVX2(16, 1, 16)
+DEFINE_SAD_X4_AVX2(16, 2, 16)
+DEFINE_SAD_X4_AVX2(16, 4, 16)
+DEFINE_SAD_X4_AVX2(16, 8, 16)
+DEFINE_SAD_X4_AVX2(16, 16, 16)
+DEFINE_SAD_X4_AVX2(16, 32, 16)
+DEFINE_SAD_X4_AVX2(16, 64, 16)
+DEFINE_SAD_X4_AVX2(32, 4, 16)
+DEFINE_SAD_X4_AVX2(32, 8, 16)
+DEFINE_SAD_X4_AVX2(32, 16, 16)
+DEFINE_SAD_X4_AVX2(32, 32, 16)
+DEFINE_SAD_X4_AVX2(32, 64, 16)
+DEFINE_SAD_X4_AVX2(64, 8, 16)
+DEFINE_SAD_X4_AVX2(64, 16, 16)
+DEFINE_SAD_X4_AVX2(64, 32, 16)
+DEFINE_SAD_X4_AVX2(64, 64, 16)
+
+#endif // MVTOOLS_X86
@@ -0,0 +1,72 @@
+#include <stdlib.h>
+
+#include <VSHelper.h>
+
+#include "ScratchArena.h"
+
+
+#define ARENA_ALIGNMENT 64
+
+
+struct ScratchBlock {
+    ScratchBlock *next;
+    void *buffer;
+};
+
+
+size_t arenaBufferSize(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+
+void *arenaAlloc(ScratchArena *arena, size_t size) {
+    size = arenaBufferSize(size);
+
+    if (arena->size - arena->used >= size) {
+        void *buffer = arena->base + arena->used;
+        arena->used += size;
+        return buffer;
+    }
+
+    ScratchBlock *block = (ScratchBlock *)malloc(sizeof(ScratchBlock));
+    block->buffer = vs_aligned_malloc(size, ARENA_ALIGNMENT);
+    block->next = arena->overflow;
+    arena->overflow = block;
+
+    return block->buffer;
+}
+
+
+void arenaReset(ScratchArena *arena) {
+    while (arena->overflow) {
+        ScratchBlock *next = arena->overflow->next;
+        vs_aligned_free(arena->overflow->buffer);
+        free(arena->overflow);
+        arena->overflow = next;
+    }
+
+    arena->used = 0;
+}
+
+
+void *arenaPoolCreate(void *userData) {
+    ScratchArena *arena = (ScratchArena *)malloc(sizeof(ScratchArena));
+
+    arena->size = *(const size_t *)userData;
+    arena->base = (unsigned char *)vs_aligned_malloc(arena->size ? arena->size : ARENA_ALIGNMENT, ARENA_ALIGNMENT);
+    arena->used = 0;
+    arena->overflow = NULL;
+
+    return arena;
+}
+
+
+void arenaPoolDestroy(void *object, void *userData) {
+    (void)userData;
+
+    ScratchArena *arena = (ScratchArena *)object;
+
+    arenaReset(arena);
+    vs_aligned_free(arena->base);
+    free(arena);
+}
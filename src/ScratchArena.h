@@ -0,0 +1,46 @@
+#ifndef MVTOOLS_SCRATCHARENA_H
+#define MVTOOLS_SCRATCHARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+
+// One block of memory for all the temporary buffers a filter's getFrame
+// function needs. The filter adds up their sizes with arenaBufferSize when
+// it is created, and keeps the arenas in an ObjectPool, so that the memory
+// is allocated once per thread rather than a few dozen times per frame.
+typedef struct ScratchBlock ScratchBlock;
+
+typedef struct ScratchArena {
+    unsigned char *base;
+    size_t size;
+    size_t used;
+
+    ScratchBlock *overflow; // buffers that didn't fit, freed by arenaReset
+} ScratchArena;
+
+
+// The room a buffer of size bytes takes in an arena.
+size_t arenaBufferSize(size_t size);
+
+// Buffers are aligned to 64 bytes. They remain valid until arenaReset.
+// If the arena is full the buffer is allocated separately.
+void *arenaAlloc(ScratchArena *arena, size_t size);
+
+// Makes all the memory available again.
+void arenaReset(ScratchArena *arena);
+
+// Callbacks for poolCreate. userData must point to a size_t, the size of the arenas.
+// Arenas returned to the pool must have been reset.
+void *arenaPoolCreate(void *userData);
+
+void arenaPoolDestroy(void *object, void *userData);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MVTOOLS_SCRATCHARENA_H
@@ -0,0 +1,51 @@
+#include <stdlib.h>
+
+#include "SearchContext.h"
+
+
+SearchContext *scCreate(const SearchContextParameters *params) {
+    const MVAnalysisData *ad = params->analysisData;
+
+    SearchContext *sc = (SearchContext *)malloc(sizeof(SearchContext));
+
+    gopInit(&sc->gop, ad->nBlkSizeX, ad->nBlkSizeY, ad->nLvCount, ad->nPel, ad->nMotionFlags, ad->nCPUFlags, ad->nOverlapX, ad->nOverlapY, ad->nBlkX, ad->nBlkY, ad->xRatioUV, ad->yRatioUV, params->divideExtra, ad->bitsPerSample, params->nThreads);
+
+    sc->DCT = NULL;
+    if (params->dctmode != 0) {
+        sc->DCT = (DCTFFTW *)malloc(params->nThreads * sizeof(DCTFFTW));
+        for (int i = 0; i < params->nThreads; i++)
+            dctInit(&sc->DCT[i], ad->nBlkSizeX, ad->nBlkSizeY, params->dctmode, ad->bitsPerSample, !!(ad->nMotionFlags & MOTION_USE_ISSE));
+    }
+
+    if (params->wavefrontPool)
+        gopSetWavefrontPool(&sc->gop, params->wavefrontPool);
+
+    sc->nThreads = params->nThreads;
+
+    return sc;
+}
+
+
+void scFree(SearchContext *sc) {
+    gopDeinit(&sc->gop);
+
+    if (sc->DCT) {
+        for (int i = 0; i < sc->nThreads; i++)
+            dctDeinit(&sc->DCT[i]);
+        free(sc->DCT);
+    }
+
+    free(sc);
+}
+
+
+void *scPoolCreate(void *userData) {
+    return scCreate((const SearchContextParameters *)userData);
+}
+
+
+void scPoolDestroy(void *object, void *userData) {
+    (void)userData;
+
+    scFree((SearchContext *)object);
+}
@@ -0,0 +1,48 @@
+#ifndef MVTOOLS_SEARCHCONTEXT_H
+#define MVTOOLS_SEARCHCONTEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "DCTFFTW.h"
+#include "GroupOfPlanes.h"
+#include "MVAnalysisData.h"
+#include "Wavefront.h"
+
+
+// Everything Analyse and Recalculate need in order to search one frame.
+// Building it involves a lot of small allocations, with dct != 0 creating an
+// FFTW plan under a global lock, and with several threads starting them, so
+// it is kept in an ObjectPool and reused from one frame to the next.
+typedef struct SearchContext {
+    GroupOfPlanes gop;
+
+    int nThreads;
+    DCTFFTW *DCT; // one for each of the search's threads, NULL when dctmode is 0
+} SearchContext;
+
+
+typedef struct SearchContextParameters {
+    const MVAnalysisData *analysisData;
+    int divideExtra;
+    int dctmode;
+    int nThreads; // threads for the search of a single frame
+    WavefrontPool *wavefrontPool; // shared by all the contexts, NULL when nThreads is 1
+} SearchContextParameters;
+
+
+SearchContext *scCreate(const SearchContextParameters *params);
+
+void scFree(SearchContext *sc);
+
+// Callbacks for poolCreate. userData must point to a SearchContextParameters.
+void *scPoolCreate(void *userData);
+
+void scPoolDestroy(void *object, void *userData);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MVTOOLS_SEARCHCONTEXT_H
@@ -4,9 +4,11 @@
 // Only the name and the basic algorithm remain.
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <VSHelper.h>
 
+#include "CPU.h"
 #include "SimpleResize.h"
 
 
@@ -35,6 +37,12 @@ static void InitTables(int *offsets, int *weights, int out, int in) {
             weight = position - leftmost - offset;
         }
 
+        // With a single input pixel, don't point before it.
+        if (offset < 0) {
+            offset = 0;
+            weight = 0.0f;
+        }
+
         offsets[i] = offset;
 
         weights[i] = (int)(weight * 32768);
@@ -42,7 +50,9 @@ static void InitTables(int *offsets, int *weights, int out, int in) {
 }
 
 
-void simpleInit(SimpleResize *simple, int dst_width, int dst_height, int src_width, int src_height) {
+void simpleInit(SimpleResize *simple, int dst_width, int dst_height, int src_width, int src_height, int opt) {
+    int padded_width = (dst_width + 7) & ~7;
+
     simple->src_width = src_width;
     simple->src_height = src_height;
     simple->dst_width = dst_width;
@@ -53,11 +63,36 @@ void simpleInit(SimpleResize *simple, int dst_width, int dst_height, int src_wid
     // Weight of the second line of the pair.
     simple->vertical_weights = (int *)malloc(dst_height * sizeof(int));
 
-    simple->horizontal_offsets = (int *)malloc(dst_width * sizeof(int));
-    simple->horizontal_weights = (int *)malloc(dst_width * sizeof(int));
+    simple->horizontal_offsets = (int *)malloc(padded_width * sizeof(int));
+    simple->horizontal_weights = (int *)malloc(padded_width * sizeof(int));
+    simple->horizontal_shuffles = (int *)malloc(padded_width * sizeof(int));
 
     InitTables(simple->horizontal_offsets, simple->horizontal_weights, dst_width, src_width);
     InitTables(simple->vertical_offsets, simple->vertical_weights, dst_height, src_height);
+
+    int *offsets = simple->horizontal_offsets;
+
+    for (int x = dst_width; x < padded_width; x++) {
+        offsets[x] = offsets[dst_width - 1];
+        simple->horizontal_weights[x] = simple->horizontal_weights[dst_width - 1];
+    }
+
+    // The offsets never decrease, so only the group's last pixel needs checking.
+    // It also needs the source pixel to the right of its offset.
+    for (int x = 0; x < padded_width; x += 8) {
+        int fits = offsets[x + 7] + 1 - offsets[x] < 8;
+
+        for (int i = 0; i < 8; i++)
+            simple->horizontal_shuffles[x + i] = fits ? offsets[x + i] - offsets[x] : -1;
+    }
+
+    simple->avx2 = 0;
+#if defined(MVTOOLS_X86)
+    if (opt && (cpu_detect() & X264_CPU_AVX2))
+        simple->avx2 = 1;
+#else
+    (void)opt;
+#endif
 }
 
 
@@ -66,40 +101,130 @@ void simpleDeinit(SimpleResize *simple) {
     free(simple->vertical_weights);
     free(simple->horizontal_offsets);
     free(simple->horizontal_weights);
+    free(simple->horizontal_shuffles);
     memset(simple, 0, sizeof(SimpleResize));
 }
 
 
-// Thread-safe.
-void simpleResize(const SimpleResize *simple, uint8_t *dstp, int dst_stride, const uint8_t *srcp, int src_stride) {
-    const uint8_t *srcp1;
-    const uint8_t *srcp2;
+// The results are rounded towards minus infinity, like they were when the
+// vectors were stored with a bias of 128.
+#define RealSimpleResize(PixelType) \
+static void RealSimpleResize_##PixelType(const SimpleResize *simple, PixelType *dstp, int dst_stride, const PixelType *srcp, int src_stride) { \
+    const PixelType *srcp1; \
+    const PixelType *srcp2; \
+ \
+    PixelType *workp = (PixelType *)malloc(simple->src_width * sizeof(PixelType)); \
+ \
+    for (int y = 0; y < simple->dst_height; y++) { \
+        int weight_bottom = simple->vertical_weights[y]; \
+        int weight_top = 32768 - weight_bottom; \
+ \
+        srcp1 = srcp + simple->vertical_offsets[y] * src_stride; \
+        srcp2 = simple->vertical_offsets[y] + 1 < simple->src_height ? srcp1 + src_stride : srcp1; \
+ \
+        /* vertical */ \
+        for (int x = 0; x < simple->src_width; x++) { \
+            workp[x] = (srcp1[x] * weight_top + srcp2[x] * weight_bottom + 16384) >> 15; \
+        } \
+ \
+        /* horizontal */ \
+        for (int x = 0; x < simple->dst_width; x++) { \
+            int weight_right = simple->horizontal_weights[x]; \
+            int weight_left = 32768 - weight_right; \
+            int offset = simple->horizontal_offsets[x]; \
+            int offset_right = offset + 1 < simple->src_width ? offset + 1 : offset; \
+ \
+            dstp[x] = (workp[offset] * weight_left + workp[offset_right] * weight_right + 16384) >> 15; \
+        } \
+ \
+        dstp += dst_stride; \
+    } \
+ \
+    free(workp); \
+}
+
+RealSimpleResize(uint8_t)
+RealSimpleResize(int16_t)
+
+
+static inline void resizeVertical_int16_t(const SimpleResize *simple, int16_t *workp, const int16_t *srcp, int src_stride, int y) {
+    int weight_bottom = simple->vertical_weights[y];
+    int weight_top = 32768 - weight_bottom;
+
+    const int16_t *srcp1 = srcp + simple->vertical_offsets[y] * src_stride;
+    // With a single source row, its weight is 0, but it must not be read.
+    const int16_t *srcp2 = simple->vertical_offsets[y] + 1 < simple->src_height ? srcp1 + src_stride : srcp1;
+
+    for (int x = 0; x < simple->src_width; x++)
+        workp[x] = (srcp1[x] * weight_top + srcp2[x] * weight_bottom + 16384) >> 15;
+}
+
+
+static inline void resizeHorizontal_int16_t(const SimpleResize *simple, int16_t *dstp, const int16_t *workp) {
+    for (int x = 0; x < simple->dst_width; x++) {
+        int weight_right = simple->horizontal_weights[x];
+        int weight_left = 32768 - weight_right;
+        int offset = simple->horizontal_offsets[x];
+        int offset_right = offset + 1 < simple->src_width ? offset + 1 : offset;
+
+        dstp[x] = (workp[offset] * weight_left + workp[offset_right] * weight_right + 16384) >> 15;
+    }
+}
 
-    uint8_t *workp = (uint8_t *)malloc(simple->src_width);
+
+static void RealSimpleResizeVectors(const SimpleResize *simple, int16_t *dstp_x, int16_t *dstp_y, int dst_stride, const int16_t *srcp_x, const int16_t *srcp_y, int src_stride) {
+    int16_t *workp_x = (int16_t *)malloc(simple->src_width * 2 * sizeof(int16_t));
+    int16_t *workp_y = workp_x + simple->src_width;
 
     for (int y = 0; y < simple->dst_height; y++) {
-        int weight_bottom = simple->vertical_weights[y];
-        int weight_top = 32768 - weight_bottom;
+        resizeVertical_int16_t(simple, workp_x, srcp_x, src_stride, y);
+        resizeVertical_int16_t(simple, workp_y, srcp_y, src_stride, y);
 
-        srcp1 = srcp + simple->vertical_offsets[y] * src_stride;
-        srcp2 = srcp1 + src_stride;
+        resizeHorizontal_int16_t(simple, dstp_x, workp_x);
+        resizeHorizontal_int16_t(simple, dstp_y, workp_y);
 
-        // vertical
-        for (int x = 0; x < simple->src_width; x++) {
-            workp[x] = (srcp1[x] * weight_top + srcp2[x] * weight_bottom + 16384) / 32768;
-        }
+        dstp_x += dst_stride;
+        dstp_y += dst_stride;
+    }
 
-        // horizontal
-        for (int x = 0; x < simple->dst_width; x++) {
-            int weight_right = simple->horizontal_weights[x];
-            int weight_left = 32768 - weight_right;
-            int offset = simple->horizontal_offsets[x];
+    free(workp_x);
+}
 
-            dstp[x] = (workp[offset] * weight_left + workp[offset + 1] * weight_right + 16384) / 32768;
-        }
 
-        dstp += dst_stride;
+// Thread-safe.
+void simpleResize_uint8_t(const SimpleResize *simple, uint8_t *dstp, int dst_stride, const uint8_t *srcp, int src_stride) {
+#if defined(MVTOOLS_X86)
+    if (simple->avx2) {
+        mvtools_simpleresize_uint8_t_avx2(simple, dstp, dst_stride, srcp, src_stride);
+        return;
+    }
+#endif
+
+    RealSimpleResize_uint8_t(simple, dstp, dst_stride, srcp, src_stride);
+}
+
+
+// Thread-safe.
+void simpleResize_int16_t(const SimpleResize *simple, int16_t *dstp, int dst_stride, const int16_t *srcp, int src_stride) {
+#if defined(MVTOOLS_X86)
+    if (simple->avx2) {
+        mvtools_simpleresize_int16_t_avx2(simple, dstp, dst_stride, srcp, src_stride);
+        return;
+    }
+#endif
+
+    RealSimpleResize_int16_t(simple, dstp, dst_stride, srcp, src_stride);
+}
+
+
+// Thread-safe.
+void simpleResizeVectors(const SimpleResize *simple, int16_t *dstp_x, int16_t *dstp_y, int dst_stride, const int16_t *srcp_x, const int16_t *srcp_y, int src_stride) {
+#if defined(MVTOOLS_X86)
+    if (simple->avx2) {
+        mvtools_simpleresizevectors_avx2(simple, dstp_x, dstp_y, dst_stride, srcp_x, srcp_y, src_stride);
+        return;
     }
+#endif
 
-    free(workp);
+    RealSimpleResizeVectors(simple, dstp_x, dstp_y, dst_stride, srcp_x, srcp_y, src_stride);
 }
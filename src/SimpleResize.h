@@ -37,14 +37,32 @@ typedef struct SimpleResize {
     int *vertical_offsets;
     int *vertical_weights;
 
+    // These three have dst_width rounded up to a multiple of 8 elements.
     int *horizontal_offsets;
     int *horizontal_weights;
+    // For each group of 8 destination pixels, the offsets relative to the
+    // group's first one, or -1 if the group needs more than 8 source pixels.
+    int *horizontal_shuffles;
+
+    int avx2;
 } SimpleResize;
 
 
-void simpleInit(SimpleResize *simple, int dst_width, int dst_height, int src_width, int src_height);
+// opt enables the AVX2 functions, if the CPU supports them.
+void simpleInit(SimpleResize *simple, int dst_width, int dst_height, int src_width, int src_height, int opt);
 void simpleDeinit(SimpleResize *simple);
-void simpleResize(const SimpleResize *simple, uint8_t *dstp, int dst_stride, const uint8_t *srcp, int src_stride);
+// Strides are in elements. The int16_t version is for the motion vector masks.
+void simpleResize_uint8_t(const SimpleResize *simple, uint8_t *dstp, int dst_stride, const uint8_t *srcp, int src_stride);
+void simpleResize_int16_t(const SimpleResize *simple, int16_t *dstp, int dst_stride, const int16_t *srcp, int src_stride);
+// Resizes the horizontal and vertical components of a vector field in one go.
+void simpleResizeVectors(const SimpleResize *simple, int16_t *dstp_x, int16_t *dstp_y, int dst_stride, const int16_t *srcp_x, const int16_t *srcp_y, int src_stride);
+
+#if defined(MVTOOLS_X86)
+// From SimpleResize_AVX2.cpp
+void mvtools_simpleresize_uint8_t_avx2(const SimpleResize *simple, uint8_t *dstp, int dst_stride, const uint8_t *srcp, int src_stride);
+void mvtools_simpleresize_int16_t_avx2(const SimpleResize *simple, int16_t *dstp, int dst_stride, const int16_t *srcp, int src_stride);
+void mvtools_simpleresizevectors_avx2(const SimpleResize *simple, int16_t *dstp_x, int16_t *dstp_y, int dst_stride, const int16_t *srcp_x, const int16_t *srcp_y, int src_stride);
+#endif
 
 
 #ifdef __cplusplus
@@ -0,0 +1,215 @@
+#if defined(MVTOOLS_X86)
+
+#include <cstdlib>
+#include <cstring>
+
+#include <immintrin.h>
+
+#include "SimpleResize.h"
+
+
+#ifdef _WIN32
+#define FORCE_INLINE __forceinline
+#else
+#define FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
+
+// Eight pixels are processed at a time, as 32 bit integers, like in the C
+// functions, so the results are the same.
+//
+// The rows produced by the vertical pass are kept as 32 bit integers. When
+// the eight destination pixels of a group need no more than eight
+// consecutive source pixels, which is always the case when upsampling by at
+// least 2, those are loaded at once and distributed with the permutations
+// computed by simpleInit. Otherwise they are gathered.
+
+
+template <typename PixelType>
+static FORCE_INLINE __m256i loadPixels(const PixelType *p, int count);
+
+template <>
+FORCE_INLINE __m256i loadPixels(const uint8_t *p, int count) {
+    if (count == 8)
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)p));
+
+    uint8_t tmp[8] = { 0 };
+    memcpy(tmp, p, count);
+
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)tmp));
+}
+
+template <>
+FORCE_INLINE __m256i loadPixels(const int16_t *p, int count) {
+    if (count == 8)
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)p));
+
+    int16_t tmp[8] = { 0 };
+    memcpy(tmp, p, count * sizeof(int16_t));
+
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)tmp));
+}
+
+
+template <typename PixelType>
+static FORCE_INLINE void storePixels(PixelType *p, __m256i pixels, int count);
+
+template <>
+FORCE_INLINE void storePixels(uint8_t *p, __m256i pixels, int count) {
+    __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0)));
+    __m128i bytes = _mm_packus_epi16(words, words);
+
+    if (count == 8) {
+        _mm_storel_epi64((__m128i *)p, bytes);
+    } else {
+        uint8_t tmp[16];
+        _mm_storeu_si128((__m128i *)tmp, bytes);
+        memcpy(p, tmp, count);
+    }
+}
+
+template <>
+FORCE_INLINE void storePixels(int16_t *p, __m256i pixels, int count) {
+    __m128i words = _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packs_epi32(pixels, pixels), _MM_SHUFFLE(3, 1, 2, 0)));
+
+    if (count == 8) {
+        _mm_storeu_si128((__m128i *)p, words);
+    } else {
+        int16_t tmp[8];
+        _mm_storeu_si128((__m128i *)tmp, words);
+        memcpy(p, tmp, count * sizeof(int16_t));
+    }
+}
+
+
+// (a * weight_a + b * weight_b + 16384) >> 15
+static FORCE_INLINE __m256i blend(__m256i a, __m256i b, __m256i weight_a, __m256i weight_b) {
+    __m256i sum = _mm256_add_epi32(_mm256_mullo_epi32(a, weight_a), _mm256_mullo_epi32(b, weight_b));
+
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(16384)), 15);
+}
+
+
+// Room for the last group of the vertical pass, plus eight more for the
+// permutations, which can start at the last source pixel.
+static int *allocateRow(const SimpleResize *simple) {
+    int width = ((simple->src_width + 7) & ~7) + 8;
+
+    int *workp = (int *)malloc(width * sizeof(int));
+    memset(workp + width - 8, 0, 8 * sizeof(int));
+
+    return workp;
+}
+
+
+template <typename PixelType>
+static FORCE_INLINE void resizeVertical(const SimpleResize *simple, int *workp, const PixelType *srcp, int src_stride, int y) {
+    __m256i weight_bottom = _mm256_set1_epi32(simple->vertical_weights[y]);
+    __m256i weight_top = _mm256_sub_epi32(_mm256_set1_epi32(32768), weight_bottom);
+
+    const PixelType *srcp1 = srcp + simple->vertical_offsets[y] * src_stride;
+    // With a single source row, its weight is 0, but it must not be read.
+    const PixelType *srcp2 = simple->vertical_offsets[y] + 1 < simple->src_height ? srcp1 + src_stride : srcp1;
+
+    for (int x = 0; x < simple->src_width; x += 8) {
+        int count = simple->src_width - x < 8 ? simple->src_width - x : 8;
+
+        __m256i top = loadPixels(srcp1 + x, count);
+        __m256i bottom = loadPixels(srcp2 + x, count);
+
+        _mm256_storeu_si256((__m256i *)(workp + x), blend(top, bottom, weight_top, weight_bottom));
+    }
+}
+
+
+// The weights and offsets of eight destination pixels, loaded once for all
+// the rows they are applied to.
+struct HorizontalGroup {
+    __m256i weight_left;
+    __m256i weight_right;
+    __m256i offsets;
+    int first_offset;
+    bool shuffled;
+
+    FORCE_INLINE HorizontalGroup(const SimpleResize *simple, int x)
+        : weight_right(_mm256_loadu_si256((const __m256i *)(simple->horizontal_weights + x)))
+        , first_offset(simple->horizontal_offsets[x])
+        , shuffled(simple->horizontal_shuffles[x] >= 0) {
+        weight_left = _mm256_sub_epi32(_mm256_set1_epi32(32768), weight_right);
+        offsets = _mm256_loadu_si256((const __m256i *)((shuffled ? simple->horizontal_shuffles : simple->horizontal_offsets) + x));
+    }
+
+    FORCE_INLINE __m256i resize(const int *workp) const {
+        __m256i left, right;
+
+        if (shuffled) {
+            __m256i pixels = _mm256_loadu_si256((const __m256i *)(workp + first_offset));
+
+            left = _mm256_permutevar8x32_epi32(pixels, offsets);
+            right = _mm256_permutevar8x32_epi32(pixels, _mm256_add_epi32(offsets, _mm256_set1_epi32(1)));
+        } else {
+            left = _mm256_i32gather_epi32(workp, offsets, 4);
+            right = _mm256_i32gather_epi32(workp + 1, offsets, 4);
+        }
+
+        return blend(left, right, weight_left, weight_right);
+    }
+};
+
+
+template <typename PixelType>
+static void simpleResize_avx2(const SimpleResize *simple, PixelType *dstp, int dst_stride, const PixelType *srcp, int src_stride) {
+    int *workp = allocateRow(simple);
+
+    for (int y = 0; y < simple->dst_height; y++) {
+        resizeVertical(simple, workp, srcp, src_stride, y);
+
+        for (int x = 0; x < simple->dst_width; x += 8) {
+            int count = simple->dst_width - x < 8 ? simple->dst_width - x : 8;
+
+            storePixels(dstp + x, HorizontalGroup(simple, x).resize(workp), count);
+        }
+
+        dstp += dst_stride;
+    }
+
+    free(workp);
+}
+
+
+void mvtools_simpleresize_uint8_t_avx2(const SimpleResize *simple, uint8_t *dstp, int dst_stride, const uint8_t *srcp, int src_stride) {
+    simpleResize_avx2(simple, dstp, dst_stride, srcp, src_stride);
+}
+
+
+void mvtools_simpleresize_int16_t_avx2(const SimpleResize *simple, int16_t *dstp, int dst_stride, const int16_t *srcp, int src_stride) {
+    simpleResize_avx2(simple, dstp, dst_stride, srcp, src_stride);
+}
+
+
+void mvtools_simpleresizevectors_avx2(const SimpleResize *simple, int16_t *dstp_x, int16_t *dstp_y, int dst_stride, const int16_t *srcp_x, const int16_t *srcp_y, int src_stride) {
+    int *workp_x = allocateRow(simple);
+    int *workp_y = allocateRow(simple);
+
+    for (int y = 0; y < simple->dst_height; y++) {
+        resizeVertical(simple, workp_x, srcp_x, src_stride, y);
+        resizeVertical(simple, workp_y, srcp_y, src_stride, y);
+
+        for (int x = 0; x < simple->dst_width; x += 8) {
+            int count = simple->dst_width - x < 8 ? simple->dst_width - x : 8;
+
+            HorizontalGroup group(simple, x);
+
+            storePixels(dstp_x + x, group.resize(workp_x), count);
+            storePixels(dstp_y + x, group.resize(workp_y), count);
+        }
+
+        dstp_x += dst_stride;
+        dstp_y += dst_stride;
+    }
+
+    free(workp_x);
+    free(workp_y);
+}
+
+#endif // MVTOOLS_X86
@@ -0,0 +1,183 @@
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Wavefront.h"
+
+
+// Number of times wfWait checks the progress before going to sleep. Usually
+// the row above is only a block ahead, so it is worth waiting a little.
+#define WAVEFRONT_SPINS 64
+
+
+struct Wavefront {
+    std::unique_ptr<std::atomic<int>[]> progress;
+    std::atomic<int> nextRow;
+
+    int rows;
+    WavefrontRowFunction rowFunction;
+    void *userData;
+
+    // wfReport only takes the mutex when some thread sleeps in wfWait.
+    std::atomic<int> sleepers;
+    std::mutex mutex;
+    std::condition_variable reported;
+};
+
+
+struct WavefrontPool {
+    std::vector<std::thread> threads;
+
+    std::mutex busy; // held by the wfRun using the pool
+
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+
+    Wavefront *wf;       // the current grid
+    int nThreads;        // threads working on it, including the caller of wfRun
+    unsigned generation; // incremented for every grid
+    int running;         // pool threads still working on the current grid
+    bool quit;
+};
+
+
+static void wfWorker(Wavefront *wf, int thread) {
+    while (true) {
+        int row = wf->nextRow.fetch_add(1);
+        if (row >= wf->rows)
+            break;
+
+        wf->rowFunction(wf, thread, row, wf->userData);
+    }
+}
+
+
+static void wfPoolThread(WavefrontPool *pool, int thread) {
+    unsigned generation = 0;
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+
+    while (true) {
+        pool->started.wait(lock, [&] { return pool->quit || pool->generation != generation; });
+
+        if (pool->quit)
+            break;
+
+        generation = pool->generation;
+
+        if (thread >= pool->nThreads)
+            continue;
+
+        Wavefront *wf = pool->wf;
+
+        lock.unlock();
+        wfWorker(wf, thread);
+        lock.lock();
+
+        if (--pool->running == 0)
+            pool->finished.notify_one();
+    }
+}
+
+
+WavefrontPool *wfCreatePool(int nThreads) {
+    WavefrontPool *pool = new WavefrontPool;
+
+    pool->wf = nullptr;
+    pool->nThreads = 0;
+    pool->generation = 0;
+    pool->running = 0;
+    pool->quit = false;
+
+    pool->threads.reserve(nThreads - 1);
+    for (int i = 1; i < nThreads; i++)
+        pool->threads.emplace_back(wfPoolThread, pool, i);
+
+    return pool;
+}
+
+
+void wfFreePool(WavefrontPool *pool) {
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->quit = true;
+    }
+    pool->started.notify_all();
+
+    for (size_t i = 0; i < pool->threads.size(); i++)
+        pool->threads[i].join();
+
+    delete pool;
+}
+
+
+int wfRun(WavefrontPool *pool, int rows, int nThreads, WavefrontRowFunction rowFunction, void *userData) {
+    std::unique_lock<std::mutex> busy(pool->busy, std::try_to_lock);
+    if (!busy.owns_lock())
+        return 0;
+
+    Wavefront wf;
+
+    wf.progress.reset(new std::atomic<int>[rows]);
+    for (int i = 0; i < rows; i++)
+        wf.progress[i].store(0, std::memory_order_relaxed);
+    wf.nextRow.store(0);
+
+    wf.rows = rows;
+    wf.rowFunction = rowFunction;
+    wf.userData = userData;
+
+    wf.sleepers.store(0);
+
+    if (nThreads > (int)pool->threads.size() + 1)
+        nThreads = (int)pool->threads.size() + 1;
+
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        pool->wf = &wf;
+        pool->nThreads = nThreads;
+        pool->running = nThreads - 1;
+        pool->generation++;
+    }
+    pool->started.notify_all();
+
+    wfWorker(&wf, 0);
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->finished.wait(lock, [&] { return pool->running == 0; });
+    pool->wf = nullptr;
+
+    return 1;
+}
+
+
+void wfReport(Wavefront *wf, int row, int progress) {
+    // Sequentially consistent, like the accesses to sleepers in wfWait, so that
+    // either this sees the sleeper or the sleeper sees the progress.
+    wf->progress[row].store(progress);
+
+    if (wf->sleepers.load() > 0) {
+        std::lock_guard<std::mutex> lock(wf->mutex);
+        wf->reported.notify_all();
+    }
+}
+
+
+void wfWait(Wavefront *wf, int row, int progress) {
+    for (int i = 0; i < WAVEFRONT_SPINS; i++) {
+        if (wf->progress[row].load(std::memory_order_acquire) >= progress)
+            return;
+        std::this_thread::yield();
+    }
+
+    // The row above is far behind, e.g. when there are more threads than free
+    // cores, so sleep instead of taking the CPU from it.
+    std::unique_lock<std::mutex> lock(wf->mutex);
+    wf->sleepers.fetch_add(1);
+    wf->reported.wait(lock, [&] { return wf->progress[row].load() >= progress; });
+    wf->sleepers.fetch_sub(1);
+}
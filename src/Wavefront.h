@@ -0,0 +1,47 @@
+#ifndef MVTOOLS_WAVEFRONT_H
+#define MVTOOLS_WAVEFRONT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// Processes the rows of a grid with several threads, where the items of
+// one row may depend on items of the row above. Each row keeps a count of
+// its finished items, which the row below can wait for.
+
+typedef struct Wavefront Wavefront;
+
+// Threads kept waiting for wfRun, so that they are not started again for
+// every grid. A pool may be shared by several threads calling wfRun, but only
+// one of them can use it at a time.
+typedef struct WavefrontPool WavefrontPool;
+
+typedef void (*WavefrontRowFunction)(Wavefront *wf, int thread, int row, void *userData);
+
+
+// Starts nThreads - 1 threads, the calling thread of wfRun being the last one.
+WavefrontPool *wfCreatePool(int nThreads);
+
+void wfFreePool(WavefrontPool *pool);
+
+// Calls rowFunction once for every row in [0, rows), using nThreads threads
+// of the pool, at most as many as it was created with, including the calling
+// thread. thread is between 0 and nThreads - 1.
+// Rows are started in order, so a row only ever waits for rows that are
+// already running. Returns 1 when all rows are done, or 0 without calling
+// rowFunction if another wfRun is using the pool.
+int wfRun(WavefrontPool *pool, int rows, int nThreads, WavefrontRowFunction rowFunction, void *userData);
+
+// Announces that the first `progress` items of `row` are finished.
+// Everything written before this call is visible to the threads waiting for it.
+void wfReport(Wavefront *wf, int row, int progress);
+
+// Waits until the first `progress` items of `row` are finished.
+void wfWait(Wavefront *wf, int row, int progress);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // MVTOOLS_WAVEFRONT_H